@@ -0,0 +1,29 @@
+#
+# Copyright (C) 2010 Tonchidot Corporation.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+# The few ndk-build definitions that the module makefiles under jni/ rely
+# on, so that a host build can include them unchanged and the source lists
+# stay in a single place.
+
+my-dir = $(patsubst %/,%,$(dir $(lastword $(MAKEFILE_LIST))))
+
+CLEAR_VARS := $(O3D_HOST_DIR)/o3d-host-clear-vars.mk
+BUILD_STATIC_LIBRARY := $(O3D_HOST_DIR)/o3d-host-static-library.mk
+
+include $(O3D_DIR)/build/make/o3d-imports.mk
+
+# Modules are linked directly, there is no need for a combined library
+O3D_BUILD_COMBINED_LIBRARY := $(O3D_HOST_DIR)/o3d-host-clear-vars.mk
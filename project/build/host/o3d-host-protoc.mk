@@ -0,0 +1,121 @@
+#
+# Copyright (C) 2010 Tonchidot Corporation.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+# The protocol buffer compiler, built from the bundled sources so the
+# generated code matches the bundled runtime. The prebuilt protoc next to
+# them only runs on Mac OS X hosts.
+
+PROTOBUF_DIR := $(O3D_NATIVE_DIR)/third_party/protobuf
+PROTOBUF_SRC := $(PROTOBUF_DIR)/current/src/google/protobuf
+
+O3D_HOST_PROTOC := $(OUT)/bin/protoc
+
+PROTOC_SRC_FILES := \
+  $(addprefix stubs/, \
+    common.cc \
+    once.cc \
+    strutil.cc \
+    substitute.cc \
+    structurally_valid.cc \
+  ) \
+  extension_set.cc \
+  extension_set_heavy.cc \
+  generated_message_util.cc \
+  generated_message_reflection.cc \
+  message_lite.cc \
+  message.cc \
+  repeated_field.cc \
+  wire_format_lite.cc \
+  wire_format.cc \
+  descriptor.cc \
+  descriptor.pb.cc \
+  descriptor_database.cc \
+  dynamic_message.cc \
+  reflection_ops.cc \
+  service.cc \
+  text_format.cc \
+  unknown_field_set.cc \
+  $(addprefix io/, \
+    coded_stream.cc \
+    gzip_stream.cc \
+    printer.cc \
+    tokenizer.cc \
+    zero_copy_stream.cc \
+    zero_copy_stream_impl.cc \
+    zero_copy_stream_impl_lite.cc \
+  ) \
+  $(addprefix compiler/, \
+    code_generator.cc \
+    command_line_interface.cc \
+    importer.cc \
+    main.cc \
+    parser.cc \
+    plugin.cc \
+    plugin.pb.cc \
+    subprocess.cc \
+    zip_writer.cc \
+    $(addprefix cpp/, \
+      cpp_enum.cc \
+      cpp_enum_field.cc \
+      cpp_extension.cc \
+      cpp_field.cc \
+      cpp_file.cc \
+      cpp_generator.cc \
+      cpp_helpers.cc \
+      cpp_message.cc \
+      cpp_message_field.cc \
+      cpp_primitive_field.cc \
+      cpp_service.cc \
+      cpp_string_field.cc \
+    ) \
+    $(addprefix java/, \
+      java_enum.cc \
+      java_enum_field.cc \
+      java_extension.cc \
+      java_field.cc \
+      java_file.cc \
+      java_generator.cc \
+      java_helpers.cc \
+      java_message.cc \
+      java_message_field.cc \
+      java_primitive_field.cc \
+      java_service.cc \
+      java_string_field.cc \
+    ) \
+    python/python_generator.cc \
+  )
+
+PROTOC_OBJS := $(addprefix $(OUT)/obj/protoc/,$(PROTOC_SRC_FILES:.cc=.o))
+
+# The iOS configuration is the one that matches a stock GNU libstdc++
+PROTOC_FLAGS := \
+  -O2 \
+  -std=gnu++98 \
+  -I$(PROTOBUF_DIR)/ios-config \
+  -I$(PROTOBUF_DIR)/include \
+  -I$(O3D_NATIVE_DIR)/third_party/zlib/include \
+
+$(OUT)/obj/protoc/%.o: $(PROTOBUF_SRC)/%.cc
+	@mkdir -p $(dir $@)
+	@echo "Compile++   : protoc <= $*.cc"
+	$(O3D_HOST_QUIET)$(CXX) $(PROTOC_FLAGS) -MMD -MP -c $< -o $@
+
+$(O3D_HOST_PROTOC): $(PROTOC_OBJS) $(call o3d-host-lib,zlib)
+	@mkdir -p $(dir $@)
+	@echo "Executable  : protoc"
+	$(O3D_HOST_QUIET)$(CXX) $^ -o $@ -lpthread
+
+-include $(PROTOC_OBJS:.o=.d)
@@ -0,0 +1,63 @@
+#
+# Copyright (C) 2010 Tonchidot Corporation.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+# Generates the compile and archive rules for a module recorded by
+# o3d-host-static-library.mk. Generated protocol buffer sources live
+# under $(OUT)/gen, mirroring their location in jni/.
+
+define o3d-host-module
+$(1).REL := $$(patsubst $$(O3D_NATIVE_DIR)/%,%,$$(patsubst $$(O3D_NATIVE_DIR),.,$$($(1).PATH)))
+$(1).GEN := $$(OUT)/gen/$$($(1).REL)
+$(1).PROTO_HEADERS := $$(addprefix $$($(1).GEN)/,$$(patsubst %.pb.cc,%.pb.h,$$(filter %.pb.cc,$$($(1).SRC_FILES))))
+$(1).OBJS := $$(addprefix $$(OUT)/obj/$(1)/,$$(addsuffix .o,$$($(1).SRC_FILES)))
+$(1).INCLUDES := $$(addprefix -I,$$(sort $$(dir $$($(1).PROTO_HEADERS))) $$($(1).C_INCLUDES))
+
+$$($(1).OBJS): PRIVATE_FLAGS := $$($(1).CFLAGS) $$($(1).INCLUDES)
+$$($(1).OBJS): | $$($(1).PROTO_HEADERS)
+
+$$(OUT)/obj/$(1)/%.c.o: $$($(1).PATH)/%.c
+	@mkdir -p $$(dir $$@)
+	@echo "Compile     : $(1) <= $$*.c"
+	$$(O3D_HOST_QUIET)$$(CC) $$(O3D_HOST_CFLAGS) $$(PRIVATE_FLAGS) -MMD -MP -c $$< -o $$@
+
+$$(OUT)/obj/$(1)/%$$($(1).CPP_EXTENSION).o: $$($(1).PATH)/%$$($(1).CPP_EXTENSION)
+	@mkdir -p $$(dir $$@)
+	@echo "Compile++   : $(1) <= $$*$$($(1).CPP_EXTENSION)"
+	$$(O3D_HOST_QUIET)$$(CXX) $$(O3D_HOST_CFLAGS) $$(O3D_HOST_CXXFLAGS) $$(PRIVATE_FLAGS) -MMD -MP -c $$< -o $$@
+
+$$(OUT)/obj/$(1)/%.pb.cc.o: $$($(1).GEN)/%.pb.cc
+	@mkdir -p $$(dir $$@)
+	@echo "Compile++   : $(1) <= $$*.pb.cc"
+	$$(O3D_HOST_QUIET)$$(CXX) $$(O3D_HOST_CFLAGS) $$(O3D_HOST_CXXFLAGS) $$(PRIVATE_FLAGS) -MMD -MP -c $$< -o $$@
+
+$$(call o3d-host-lib,$(1)): $$($(1).OBJS)
+	@mkdir -p $$(dir $$@)
+	@echo "StaticLib   : lib$(1).a"
+	@rm -f $$@
+	$$(O3D_HOST_QUIET)$$(AR) crs $$@ $$^
+
+-include $$($(1).OBJS:.o=.d)
+endef
+
+$(OUT)/gen/%.pb.cc $(OUT)/gen/%.pb.h: $(O3D_NATIVE_DIR)/%.proto $(O3D_HOST_PROTOC)
+	@mkdir -p $(dir $@)
+	@echo "Protobuf    : $(notdir $<)"
+	$(O3D_HOST_QUIET)$(O3D_HOST_PROTOC) --cpp_out=$(dir $@) --proto_path=$(dir $<) $<
+
+$(foreach module,$(O3D_HOST_MODULES),$(eval $(call o3d-host-module,$(module))))
+
+# Keep the generated sources, they are not intermediate files
+.PRECIOUS: $(OUT)/gen/%.pb.cc $(OUT)/gen/%.pb.h
@@ -0,0 +1,28 @@
+#
+# Copyright (C) 2010 Tonchidot Corporation.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+# Records a module declared by a jni/ makefile; the rules are generated by
+# o3d-host-rules.mk once every module is known. Modules listed in
+# O3D_HOST_SKIPPED_MODULES (the device renderer) are dropped here.
+
+ifeq ($(filter $(LOCAL_MODULE),$(O3D_HOST_SKIPPED_MODULES)),)
+O3D_HOST_MODULES += $(LOCAL_MODULE)
+$(LOCAL_MODULE).PATH := $(LOCAL_PATH)
+$(LOCAL_MODULE).CPP_EXTENSION := $(if $(LOCAL_CPP_EXTENSION),$(LOCAL_CPP_EXTENSION),.cpp)
+$(LOCAL_MODULE).CFLAGS := $(filter-out $(O3D_HOST_FILTERED_CFLAGS),$(LOCAL_CFLAGS))
+$(LOCAL_MODULE).C_INCLUDES := $(LOCAL_C_INCLUDES)
+$(LOCAL_MODULE).SRC_FILES := $(LOCAL_SRC_FILES)
+endif
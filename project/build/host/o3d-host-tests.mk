@@ -0,0 +1,129 @@
+#
+# Copyright (C) 2010 Tonchidot Corporation.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+# The unit tests that build and pass against the stub renderer, in one
+# executable, with the Google Test copy bundled with protobuf. The others
+# depend on test data or on code that is not in this tree anymore.
+#
+#   make -C project/build/host test [GTEST_FILTER=Pattern]
+
+GTEST_DIR := $(O3D_NATIVE_DIR)/third_party/protobuf/current/gtest
+
+# This Google Test runs death tests on a stack it sets up for clone(), which
+# crashes with current glibc versions; fork() works as well.
+$(OUT)/obj/gtest/gtest-all.o: $(GTEST_DIR)/src/gtest-all.cc
+	@mkdir -p $(dir $@)
+	@echo "Compile++   : gtest <= gtest-all.cc"
+	$(O3D_HOST_QUIET)$(CXX) -O2 $(O3D_HOST_CXXFLAGS) -DGTEST_HAS_CLONE=0 -I$(GTEST_DIR) -I$(GTEST_DIR)/include -MMD -MP -c $< -o $@
+
+$(call o3d-host-lib,gtest): $(OUT)/obj/gtest/gtest-all.o
+	@mkdir -p $(dir $@)
+	@echo "StaticLib   : libgtest.a"
+	@rm -f $@
+	$(O3D_HOST_QUIET)$(AR) crs $@ $^
+
+-include $(OUT)/obj/gtest/gtest-all.d
+
+O3D_HOST_TEST_SRC_FILES := \
+  $(addprefix base/cross/, \
+    log_test.cc \
+  ) \
+  $(addprefix core/cross/, \
+    bounding_box_test.cc \
+    buffer_shadow_test.cc \
+    class_manager_test.cc \
+    client_info_test.cc \
+    client_test.cc \
+    counter_test.cc \
+    draw_element_test.cc \
+    draw_list_test.cc \
+    draw_pass_test.cc \
+    element_test.cc \
+    event_manager_test.cc \
+    features_test.cc \
+    field_test.cc \
+    float_n_test.cc \
+    frame_profiler_test.cc \
+    function_test.cc \
+    image_utils_test.cc \
+    material_test.cc \
+    mesh_simplifier_test.cc \
+    object_base_test.cc \
+    occlusion_buffer_test.cc \
+    pack_test.cc \
+    param_array_test.cc \
+    param_object_test.cc \
+    param_operation_test.cc \
+    param_test.cc \
+    pick_buffer_test.cc \
+    pickable_registry_test.cc \
+    primitive_test.cc \
+    ray_intersection_info_test.cc \
+    render_graph_schedule_test.cc \
+    render_node_test.cc \
+    render_stats_test.cc \
+    render_surface_test.cc \
+    service_locator_test.cc \
+    slab_allocator_test.cc \
+    smart_ptr_test.cc \
+    state_set_test.cc \
+    state_test.cc \
+    stream_bank_test.cc \
+    texture_base_test.cc \
+    texture_residency_manager_test.cc \
+    texture_test.cc \
+    transform_test.cc \
+    tree_traversal_test.cc \
+    vector_map_test.cc \
+    vertex_source_test.cc \
+    visitor_base_test.cc \
+    weak_ptr_test.cc \
+    worker_pool_test.cc \
+    $(addprefix gpu2d/, \
+      arena_test.cc \
+    ) \
+  ) \
+  $(addprefix import/cross/, \
+    destination_buffer_test.cc \
+    mapped_zip_archive_test.cc \
+    memory_buffer_test.cc \
+  ) \
+  $(addprefix extra/cross/, \
+    binary_test.cc \
+    resource_cache_test.cc \
+  ) \
+  $(addprefix utils/cross/, \
+    base64_test.cc \
+    dataurl_test.cc \
+    json_writer_test.cc \
+  )
+
+# The tests include their shared globals from tests/common/win, which is
+# here rather than in jni/.
+$(eval $(call o3d-host-executable,o3dtests,\
+  $(O3D_HOST_DIR)/tests/testing_main.cc \
+  $(O3D_NATIVE_DIR)/core/cross/fake_vertex_source.cc \
+  $(addprefix $(O3D_NATIVE_DIR)/,$(O3D_HOST_TEST_SRC_FILES)),\
+  -I$(O3D_HOST_DIR) -I$(GTEST_DIR)/include $(sort $(dir $(addprefix -I,$(O3D_HOST_PROTO_HEADERS)))),\
+  $(call o3d-host-lib,gtest)))
+
+# The stub textures don't keep their pixels for these to read back.
+O3D_HOST_TEST_EXCLUDED := Texture2DTest.*
+
+test: $(call o3d-host-exe,o3dtests)
+	$(call o3d-host-exe,o3dtests) --gtest_filter=$(or $(GTEST_FILTER),*)-$(O3D_HOST_TEST_EXCLUDED)
+
+.PHONY: test
@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The globals the unit tests share, set up by testing_main.cc before the
+// tests run. The path is the one the tests have always included.
+
+#pragma once
+#include <string>
+#include <gtest/gtest.h>
+#include "core/cross/display_window.h"
+#include "core/cross/renderer.h"
+#include "core/cross/service_locator.h"
+
+extern o3d::ServiceLocator* g_service_locator;
+extern o3d::Renderer* g_renderer;
+extern o3d::DisplayWindow* g_display_window;
+// Directory holding the test data: bitmap_test/, unittest_data/.
+extern std::string* g_program_path;
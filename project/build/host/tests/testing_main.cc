@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Runs the unit tests with the services a client has, and the stub
+// renderer in place of a GPU.
+
+#include <libgen.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tests/common/win/testing_common.h"
+#include "core/cross/class_manager.h"
+#include "core/cross/client_info.h"
+#include "core/cross/evaluation_counter.h"
+#include "core/cross/features.h"
+#include "core/cross/object_manager.h"
+#include "core/cross/profiler.h"
+#include "base/cross/scoped_ptr.h"
+#include "core/cross/renderer_stub.h"
+
+o3d::ServiceLocator* g_service_locator = NULL;
+o3d::Renderer* g_renderer = NULL;
+o3d::DisplayWindow* g_display_window = NULL;
+std::string* g_program_path = NULL;
+
+namespace {
+
+class fake_window_t: public o3d::DisplayWindow {
+ public:
+  ~fake_window_t() { }
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  char* program = strdup(argv[0]);
+  std::string program_path(dirname(program));
+  free(program);
+  g_program_path = &program_path;
+
+  o3d::ServiceLocator service_locator;
+  g_service_locator = &service_locator;
+  fake_window_t display_window;
+  g_display_window = &display_window;
+  {
+    o3d::EvaluationCounter evaluation_counter(&service_locator);
+    o3d::ClassManager class_manager(&service_locator);
+    o3d::ClientInfoManager client_info_manager(&service_locator);
+    o3d::ObjectManager object_manager(&service_locator);
+    o3d::Profiler profiler(&service_locator);
+    o3d::Features features(&service_locator);
+    o3d::base::scoped_ptr<o3d::Renderer> renderer(
+        o3d::RendererStub::CreateDefault(&service_locator));
+    if (renderer->Init(display_window, true) != o3d::Renderer::SUCCESS) {
+      fprintf(stderr, "Can't initialize the renderer\n");
+      return 1;
+    }
+    g_renderer = renderer.get();
+
+    int result = RUN_ALL_TESTS();
+    g_renderer = NULL;
+    return result;
+  }
+}
+
+/* vim: set sw=2 ts=2 sts=2 expandtab ff=unix: */
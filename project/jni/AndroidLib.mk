@@ -29,5 +29,6 @@ LOCAL_SRC_FILES := \
   scaledquadparams.cpp \
   camspacequad.cpp \
   billboard.cpp \
+  benchmark.cpp \
 
 include $(O3D_BUILD_MODULE)
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "base/cross/config.h"
+#include <pthread.h>
+
+namespace o3d {
+	namespace base {
+
+		// A non-recursive mutex.
+		class Lock {
+		public:
+			Lock() { pthread_mutex_init(&mMutex, 0); }
+			~Lock() { pthread_mutex_destroy(&mMutex); }
+
+			void Acquire() { pthread_mutex_lock(&mMutex); }
+			void Release() { pthread_mutex_unlock(&mMutex); }
+			bool Try() { return pthread_mutex_trylock(&mMutex) == 0; }
+
+		private:
+			friend class ConditionVariable;
+			pthread_mutex_t mMutex;
+
+			O3D_DISALLOW_COPY_AND_ASSIGN(Lock);
+		};
+
+		// Holds a Lock for the duration of a scope.
+		class AutoLock {
+		public:
+			explicit AutoLock(Lock& lock): mLock(lock) { mLock.Acquire(); }
+			~AutoLock() { mLock.Release(); }
+
+		private:
+			Lock& mLock;
+
+			O3D_DISALLOW_COPY_AND_ASSIGN(AutoLock);
+		};
+
+		// Condition variable bound to a Lock, which must be held
+		// by the caller of Wait().
+		class ConditionVariable {
+		public:
+			explicit ConditionVariable(Lock& lock): mLock(lock) { pthread_cond_init(&mCond, 0); }
+			~ConditionVariable() { pthread_cond_destroy(&mCond); }
+
+			void Wait() { pthread_cond_wait(&mCond, &mLock.mMutex); }
+			void Signal() { pthread_cond_signal(&mCond); }
+			void Broadcast() { pthread_cond_broadcast(&mCond); }
+
+		private:
+			Lock& mLock;
+			pthread_cond_t mCond;
+
+			O3D_DISALLOW_COPY_AND_ASSIGN(ConditionVariable);
+		};
+
+	} // namespace base
+} // namespace o3d
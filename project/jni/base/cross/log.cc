@@ -14,6 +14,12 @@
  * limitations under the License.
  */
 #include "base/cross/log.h"
+#include "base/cross/lock.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <streambuf>
 
 #if defined(OS_ANDROID)
 // Android only provide syslog() for kernel debugging,
@@ -26,3 +32,353 @@
 // Simple STDERR output
 #include "base/cross/log_default.inl.cc"
 #endif
+
+namespace o3d {
+	namespace base {
+
+		namespace {
+
+			// Longer messages are cut.
+			const size_t kMaxMessageLength = 1024;
+
+			// Number of messages waiting to be written, a power of two.
+			const unsigned kQueueLength = 256;
+
+			// Formats into a fixed buffer, dropping what doesn't fit.
+			class FixedStreamBuf : public std::streambuf {
+			public:
+				FixedStreamBuf(char* buffer, size_t size) {
+					// Keeps room for the terminating null.
+					setp(buffer, buffer + size - 1);
+				}
+
+				void Reset() { setp(pbase(), epptr()); }
+
+				const char* Terminate() {
+					*pptr() = '\0';
+					return pbase();
+				}
+
+			protected:
+				virtual int_type overflow(int_type) { return traits_type::eof(); }
+			};
+
+			// A message in the queue. |sequence| tells who owns the record: it is
+			// its position for the next logging thread to fill it, its position
+			// plus one once filled for the writer, and its position plus
+			// kQueueLength once written.
+			struct Record {
+				volatile unsigned sequence;
+				LogLevel level;
+				const char* tag;
+				char text[kMaxMessageLength];
+			};
+
+			struct LogState {
+				LogState()
+					: level(O3D_MINIMUM_LOG_LEVEL),
+					  asynchronous(true),
+					  writer_started(false),
+					  writer_waiting(false),
+					  enqueue_pos(0),
+					  dequeue_pos(0),
+					  written_pos(0),
+					  dropped(0),
+					  writer(NULL),
+					  wake(lock),
+					  drained(lock) {
+					for(unsigned ii = 0; ii < kQueueLength; ++ii) {
+						records[ii].sequence = ii;
+					}
+
+					pthread_key_create(&buffer_key, &DeleteBuffer);
+				}
+
+				static void DeleteBuffer(void* buffer);
+
+				volatile int level;
+				volatile bool asynchronous;
+				bool writer_started;
+				volatile bool writer_waiting;
+				Record records[kQueueLength];
+				// Next position to fill, shared by the logging threads.
+				volatile unsigned enqueue_pos;
+				// Next position to write, only used by the writer.
+				unsigned dequeue_pos;
+				// Position written up to, guarded by |lock|.
+				unsigned written_pos;
+				volatile unsigned dropped;
+				// Set by SetLogWriter, or NULL for the platform's.
+				LogWriter volatile writer;
+				pthread_key_t buffer_key;
+				Lock lock;
+				ConditionVariable wake;
+				ConditionVariable drained;
+			};
+
+			// Never destroyed, so that threads can still log during exit.
+			LogState& GetState() {
+				static LogState* state = new LogState;
+				return *state;
+			}
+
+			void Write(LogLevel level, const char* tag, const char* text) {
+				LogWriter writer = GetState().writer;
+				(writer ? writer : &WriteLogMessage)(level, tag, text);
+			}
+
+			bool Enqueue(LogLevel level, const char* tag, const char* text) {
+				LogState& state = GetState();
+				unsigned pos = state.enqueue_pos;
+
+				for(;;) {
+					Record& record = state.records[pos & (kQueueLength - 1)];
+					int diff = static_cast<int>(record.sequence - pos);
+
+					if(diff < 0) {
+						// Full.
+						return false;
+					}
+
+					if(diff == 0 &&
+					        __sync_bool_compare_and_swap(&state.enqueue_pos, pos, pos + 1)) {
+						record.level = level;
+						record.tag = tag;
+						strncpy(record.text, text, kMaxMessageLength - 1);
+						record.text[kMaxMessageLength - 1] = '\0';
+						// Make sure the record is written before it is published.
+						__sync_synchronize();
+						record.sequence = pos + 1;
+						return true;
+					}
+
+					pos = state.enqueue_pos;
+				}
+			}
+
+			// Writes the oldest message of the queue, if any.
+			bool WriteNext() {
+				LogState& state = GetState();
+				Record& record = state.records[state.dequeue_pos & (kQueueLength - 1)];
+
+				if(record.sequence != state.dequeue_pos + 1) {
+					return false;
+				}
+
+				__sync_synchronize();
+				Write(record.level, record.tag, record.text);
+				__sync_synchronize();
+				record.sequence = state.dequeue_pos + kQueueLength;
+				++state.dequeue_pos;
+				return true;
+			}
+
+			void* WriterMain(void*) {
+				LogState& state = GetState();
+
+				for(;;) {
+					while(WriteNext()) { }
+
+					unsigned dropped = __sync_lock_test_and_set(&state.dropped, 0);
+
+					if(dropped) {
+						char text[64];
+						snprintf(text, sizeof(text), "%u log messages dropped", dropped);
+						Write(WARNING, O3D_LOG_TAG, text);
+					}
+
+					AutoLock lock(state.lock);
+					state.written_pos = state.dequeue_pos;
+					state.drained.Broadcast();
+					// A logging thread that sees |writer_waiting| signals under the
+					// lock, so it can't signal between our check and our wait.
+					state.writer_waiting = true;
+					__sync_synchronize();
+					const Record& next =
+					    state.records[state.dequeue_pos & (kQueueLength - 1)];
+
+					if(next.sequence != state.dequeue_pos + 1) {
+						state.wake.Wait();
+					}
+
+					state.writer_waiting = false;
+				}
+
+				return NULL;
+			}
+
+			void FlushAtExit() {
+				FlushLog();
+			}
+
+			// Starts the writer the first time a message is queued. Returns false
+			// if it couldn't be started.
+			bool StartWriter() {
+				LogState& state = GetState();
+				AutoLock lock(state.lock);
+
+				if(!state.writer_started) {
+					pthread_t thread;
+
+					if(pthread_create(&thread, NULL, &WriterMain, NULL) != 0) {
+						state.asynchronous = false;
+						return false;
+					}
+
+					pthread_detach(thread);
+					atexit(&FlushAtExit);
+					state.writer_started = true;
+				}
+
+				return true;
+			}
+
+			inline uint64_t GetMonotonicSeconds() {
+				struct timespec now;
+				clock_gettime(CLOCK_MONOTONIC, &now);
+				return now.tv_sec;
+			}
+
+		}  // anonymous namespace
+
+		struct LogBuffer {
+			LogBuffer()
+				: streambuf(text, sizeof(text)),
+				  stream(&streambuf),
+				  in_use(false) {
+			}
+
+			char text[kMaxMessageLength];
+			FixedStreamBuf streambuf;
+			std::ostream stream;
+			bool in_use;
+		};
+
+		void LogState::DeleteBuffer(void* buffer) {
+			delete static_cast<LogBuffer*>(buffer);
+		}
+
+		void SetLogLevel(LogLevel level) {
+			GetState().level = level;
+		}
+
+		LogLevel GetLogLevel() {
+			return static_cast<LogLevel>(GetState().level);
+		}
+
+		void SetAsynchronousLogging(bool asynchronous) {
+			if(!asynchronous) {
+				FlushLog();
+			}
+
+			GetState().asynchronous = asynchronous;
+		}
+
+		void SetLogWriter(LogWriter writer) {
+			GetState().writer = writer;
+		}
+
+		void FlushLog() {
+			LogState& state = GetState();
+			AutoLock lock(state.lock);
+
+			if(!state.writer_started) {
+				return;
+			}
+
+			unsigned target = state.enqueue_pos;
+
+			while(static_cast<int>(state.written_pos - target) < 0) {
+				state.wake.Signal();
+				state.drained.Wait();
+			}
+		}
+
+		FullLogger::FullLogger(LogLevel level, const char* tag)
+			: mBuffer(NULL),
+			  mStream(NULL),
+			  mLevel(level),
+			  mTag(tag) {
+			LogState& state = GetState();
+
+			if(level < state.level && level != FATAL) {
+				return;
+			}
+
+			mBuffer = static_cast<LogBuffer*>(pthread_getspecific(state.buffer_key));
+
+			if(!mBuffer) {
+				mBuffer = new LogBuffer;
+				pthread_setspecific(state.buffer_key, mBuffer);
+			}
+
+			// Something logged while formatting a message gets its own buffer.
+			if(mBuffer->in_use) {
+				mBuffer = new LogBuffer;
+			}
+
+			mBuffer->in_use = true;
+			mBuffer->streambuf.Reset();
+			mBuffer->stream.clear();
+			mStream = &mBuffer->stream;
+		}
+
+		FullLogger::~FullLogger() {
+			if(!mStream) {
+				return;
+			}
+
+			LogState& state = GetState();
+			const char* text = mBuffer->streambuf.Terminate();
+
+			if(mLevel == FATAL) {
+				// Written after what was logged before, and before aborting.
+				FlushLog();
+				Write(mLevel, mTag, text);
+				abort();
+			}
+
+			bool queued = false;
+
+			if(state.asynchronous && StartWriter()) {
+				queued = Enqueue(mLevel, mTag, text);
+
+				if(queued) {
+					__sync_synchronize();
+
+					if(state.writer_waiting) {
+						AutoLock lock(state.lock);
+						state.wake.Signal();
+					}
+				}
+				else if(mLevel == INFO) {
+					__sync_add_and_fetch(&state.dropped, 1);
+					queued = true;
+				}
+			}
+
+			if(!queued) {
+				Write(mLevel, mTag, text);
+			}
+
+			if(mBuffer == pthread_getspecific(state.buffer_key)) {
+				mBuffer->in_use = false;
+			}
+			else {
+				delete mBuffer;
+			}
+		}
+
+		bool LogRateLimiter::Allow() {
+			unsigned now = static_cast<unsigned>(GetMonotonicSeconds());
+			unsigned second = mSecond;
+
+			if(now != second && __sync_bool_compare_and_swap(&mSecond, second, now)) {
+				mCount = 0;
+			}
+
+			return __sync_add_and_fetch(&mCount, 1) <= mPerSecond;
+		}
+
+	} // namespace base
+} // namespace o3d
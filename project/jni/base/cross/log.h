@@ -16,6 +16,7 @@
 #pragma once
 
 #include "base/cross/config.h"
+#include <ostream>
 #include <sstream>
 #include <algorithm>
 #include <stdlib.h>
@@ -45,20 +46,61 @@ enum LogLevel {
 namespace o3d {
 	namespace base {
 
+		struct LogBuffer;
+
+		// Sets the lowest level logged at run time. Messages under it are not
+		// formatted, but their arguments are still evaluated. Levels under
+		// O3D_MINIMUM_LOG_LEVEL are compiled out and can't be turned back on.
+		void SetLogLevel(LogLevel level);
+		LogLevel GetLogLevel();
+
+		// By default messages are formatted by the thread logging them and
+		// written by a background thread, so that logging doesn't wait on the
+		// log facility. Messages logged while the queue is full are dropped and
+		// counted, except warnings and errors, which are written right away.
+		void SetAsynchronousLogging(bool asynchronous);
+
+		// Waits until the messages logged so far have been written.
+		void FlushLog();
+
+		// Writes a formatted message to a log facility.
+		typedef void (*LogWriter)(LogLevel level, const char* tag, const char* message);
+
+		// Sends the messages to |writer| instead of the platform's log facility,
+		// or back to it with NULL. |writer| is called from the background thread
+		// as well as from the logging threads.
+		void SetLogWriter(LogWriter writer);
+
 		class FullLogger {
 		public:
-			FullLogger(LogLevel level, const char* tag): mLevel(level), mTag(tag) { }
-			// The destructor will send mStream.str() to the right logging facility.
+			FullLogger(LogLevel level, const char* tag);
+			// The destructor will send the message to the right logging facility.
 			~FullLogger();
 			template<typename T> FullLogger& operator<<(const T& t) {
-				// Actually record stuff
-				mStream << t;
+				// Actually record stuff, unless filtered out at run time.
+				if(mStream) *mStream << t;
+
 				return *this;
 			}
 		private:
-			std::ostringstream mStream;
-			LogLevel           mLevel;
-			std::string        mTag;
+			// Per thread, so formatting doesn't allocate.
+			LogBuffer*    mBuffer;
+			std::ostream* mStream;
+			LogLevel      mLevel;
+			const char*   mTag;
+		};
+
+		// Lets through at most |per_second| messages a second, from any thread.
+		// Declared static at a logging site by O3D_LOG_RATE_LIMITED.
+		class LogRateLimiter {
+		public:
+			explicit LogRateLimiter(unsigned per_second)
+				: mPerSecond(per_second), mSecond(0), mCount(0) { }
+			bool Allow();
+		private:
+			unsigned          mPerSecond;
+			volatile unsigned mSecond;
+			volatile unsigned mCount;
 		};
 
 		class FakeLogger {
@@ -93,6 +135,8 @@ namespace o3d {
 #define O3D_LOG(level)               O3D_LOG_NAKED(level) << "[" << __FILE__ << ":" << O3D_PRIV_STRING(__LINE__) << "] "
 #define O3D_LOG_IF(level, condition) if (condition) O3D_LOG(level)
 #define O3D_LOG_FIRST_N(level, n)    for(static int O3D_PRIV_UVAR (1+2*(n)); (O3D_PRIV_UVAR=std::max(O3D_PRIV_UVAR-1,0));) if (O3D_PRIV_UVAR&1) break; else O3D_LOG(level)
+// Logs at most n messages a second from this line, for code called every frame.
+#define O3D_LOG_RATE_LIMITED(level, n) O3D_LOG_IF(level, __extension__ ({ static o3d::base::LogRateLimiter O3D_PRIV_UVAR (n); O3D_PRIV_UVAR.Allow(); }))
 
 #ifndef NDEBUG
 #define O3D_ASSERT(condition)      O3D_LOG_IF(FATAL, !(condition)) << "Assertion failed [" << O3D_PRIV_STRING(condition) << "] " << O3D_PRIV_FUNCTION_SUFFIX
@@ -32,12 +32,10 @@ namespace o3d {
 			}
 		}
 
-		FullLogger::~FullLogger() {
+		static void WriteLogMessage(LogLevel level, const char* tag, const char* message) {
 			// Sometimes, __android_log_assert() traps the process *before* the message
 			// gets sent to the log, so I don't use it.
-			__android_log_write(translateLogLevel(mLevel), mTag.c_str(), mStream.str().c_str());
-
-			if(mLevel == FATAL) abort();
+			__android_log_write(translateLogLevel(level), tag, message);
 		}
 
 	} // namespace base
@@ -18,10 +18,10 @@
 namespace o3d {
 	namespace base {
 
-		FullLogger::~FullLogger() {
-			std::cerr << mTag << " [";
+		static void WriteLogMessage(LogLevel level, const char* tag, const char* message) {
+			std::cerr << tag << " [";
 
-			switch(mLevel) {
+			switch(level) {
 			default:
 			case INFO:
 				std::cerr << "I";
@@ -37,9 +37,7 @@ namespace o3d {
 				break;
 			}
 
-			std::cerr << "] " << mStream.str() << "\n";
-
-			if(mLevel == FATAL) abort();
+			std::cerr << "] " << message << "\n";
 		}
 
 	} // namespace base
@@ -32,17 +32,15 @@ namespace o3d {
 				return LOG_ALERT;
 			}
 		}
-		FullLogger::~FullLogger() {
-			openlog(mTag.c_str(), LOG_PID | LOG_PERROR, LOG_USER);
+		static void WriteLogMessage(LogLevel level, const char* tag, const char* message) {
+			openlog(tag, LOG_PID | LOG_PERROR, LOG_USER);
 			std::vector<std::string> lines;
-			SplitString(mStream.str(), '\n', &lines);
+			SplitString(message, '\n', &lines);
 
 			for(size_t i(0); i < lines.size(); ++i)
-				syslog(translateLogLevel(mLevel), lines[i].c_str());
+				syslog(translateLogLevel(level), "%s", lines[i].c_str());
 
 			closelog();
-
-			if(mLevel == FATAL) abort();
 		}
 
 	} // namespace base
@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Tests the asynchronous logging of base/cross/log.h.
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include "tests/common/win/testing_common.h"
+#include "base/cross/lock.h"
+#include "base/cross/log.h"
+
+namespace o3d {
+	namespace base {
+
+		namespace {
+
+			// Number of messages the queue holds.
+			const int kQueueLength = 256;
+
+			// A message logged by the tests, without its file and line.
+			struct Message {
+				LogLevel level;
+				std::string text;
+			};
+
+			Lock g_lock;
+			ConditionVariable g_changed(g_lock);
+			std::vector<Message> g_messages;
+			// Whether the message "block" holds the writer until released.
+			bool g_block = false;
+			bool g_blocked = false;
+
+			// Keeps the messages logged from this file, and the count of the
+			// dropped ones.
+			void CaptureMessage(LogLevel level, const char* tag, const char* text) {
+				const char* start = strstr(text, "log_test.cc:");
+
+				if(start) {
+					start = strstr(start, "] ") + 2;
+				}
+				else if(strstr(text, "log messages dropped")) {
+					start = text;
+				}
+				else {
+					return;
+				}
+
+				AutoLock lock(g_lock);
+				Message message = { level, start };
+				g_messages.push_back(message);
+
+				if(message.text == "block") {
+					g_blocked = true;
+					g_changed.Broadcast();
+
+					while(g_block) {
+						g_changed.Wait();
+					}
+				}
+			}
+
+			unsigned GetMonotonicSeconds() {
+				struct timespec now;
+				clock_gettime(CLOCK_MONOTONIC, &now);
+				return static_cast<unsigned>(now.tv_sec);
+			}
+
+		}  // anonymous namespace
+
+		class LogTest : public testing::Test {
+		protected:
+			virtual void SetUp();
+			virtual void TearDown();
+
+			// The messages written so far.
+			std::vector<Message> messages() {
+				AutoLock lock(g_lock);
+				return g_messages;
+			}
+
+		private:
+			LogLevel level_;
+		};
+
+		void LogTest::SetUp() {
+			level_ = GetLogLevel();
+			SetLogLevel(INFO);
+			// Leaves out what other tests logged.
+			FlushLog();
+			g_messages.clear();
+			SetLogWriter(&CaptureMessage);
+		}
+
+		void LogTest::TearDown() {
+			FlushLog();
+			SetLogWriter(NULL);
+			SetAsynchronousLogging(true);
+			SetLogLevel(level_);
+		}
+
+		// Messages are written in the order they were logged, once flushed.
+		TEST_F(LogTest, FlushWritesInOrder) {
+			for(int ii = 0; ii < 100; ++ii) {
+				O3D_LOG(INFO) << "message " << ii;
+			}
+
+			FlushLog();
+			std::vector<Message> written(messages());
+			ASSERT_EQ(100u, written.size());
+
+			for(int ii = 0; ii < 100; ++ii) {
+				char text[32];
+				snprintf(text, sizeof(text), "message %d", ii);
+				EXPECT_EQ(text, written[ii].text);
+				EXPECT_EQ(INFO, written[ii].level);
+			}
+		}
+
+		// With the queue full, information messages are dropped and counted,
+		// while warnings are written right away.
+		TEST_F(LogTest, FullQueueDropsInformation) {
+			{
+				AutoLock lock(g_lock);
+				g_block = true;
+				g_blocked = false;
+			}
+
+			O3D_LOG(INFO) << "block";
+			{
+				AutoLock lock(g_lock);
+
+				while(!g_blocked) {
+					g_changed.Wait();
+				}
+			}
+			// The message being written still takes its place in the queue.
+			const int kDropped = 10;
+
+			for(int ii = 0; ii < kQueueLength - 1 + kDropped; ++ii) {
+				O3D_LOG(INFO) << "queued " << ii;
+			}
+
+			O3D_LOG(WARNING) << "while full";
+			{
+				AutoLock lock(g_lock);
+				g_block = false;
+				g_changed.Broadcast();
+			}
+			FlushLog();
+			std::vector<Message> written(messages());
+			ASSERT_EQ(static_cast<size_t>(kQueueLength + 2), written.size());
+			EXPECT_EQ("block", written[0].text);
+			EXPECT_EQ("while full", written[1].text);
+			EXPECT_EQ(WARNING, written[1].level);
+			EXPECT_EQ("queued 0", written[2].text);
+			char text[32];
+			snprintf(text, sizeof(text), "queued %d", kQueueLength - 2);
+			EXPECT_EQ(text, written[kQueueLength].text);
+			snprintf(text, sizeof(text), "%d log messages dropped", kDropped);
+			EXPECT_EQ(text, written[kQueueLength + 1].text);
+			EXPECT_EQ(WARNING, written[kQueueLength + 1].level);
+		}
+
+		// Messages under the level set aren't written, though their arguments
+		// are evaluated.
+		TEST_F(LogTest, SetLogLevelFilters) {
+			SetLogLevel(WARNING);
+			EXPECT_EQ(WARNING, GetLogLevel());
+			int evaluated = 0;
+			O3D_LOG(INFO) << "filtered " << ++evaluated;
+			O3D_LOG(WARNING) << "kept";
+			O3D_LOG(ERROR) << "kept too";
+			FlushLog();
+			EXPECT_EQ(1, evaluated);
+			std::vector<Message> written(messages());
+			ASSERT_EQ(2u, written.size());
+			EXPECT_EQ("kept", written[0].text);
+			EXPECT_EQ("kept too", written[1].text);
+		}
+
+		// Without the background thread, messages are written before the
+		// logging statement returns.
+		TEST_F(LogTest, SynchronousLogging) {
+			SetAsynchronousLogging(false);
+			O3D_LOG(INFO) << "now";
+			std::vector<Message> written(messages());
+			ASSERT_EQ(1u, written.size());
+			EXPECT_EQ("now", written[0].text);
+		}
+
+		// A rate limited line logs at most its count in a second.
+		TEST_F(LogTest, RateLimited) {
+			unsigned start = GetMonotonicSeconds();
+
+			for(int ii = 0; ii < 10; ++ii) {
+				O3D_LOG_RATE_LIMITED(INFO, 3) << "limited " << ii;
+			}
+
+			unsigned end = GetMonotonicSeconds();
+			FlushLog();
+			std::vector<Message> written(messages());
+
+			// The count starts again if the loop crossed into the next second.
+			if(start == end) {
+				ASSERT_EQ(3u, written.size());
+				EXPECT_EQ("limited 2", written[2].text);
+			}
+			else {
+				EXPECT_LE(3u, written.size());
+				EXPECT_GE(6u, written.size());
+			}
+
+			EXPECT_EQ("limited 0", written[0].text);
+		}
+
+		// A fatal message is written after the messages still queued, and then
+		// aborts.
+		TEST(LogDeathTest, FatalFlushesFirst) {
+			// The writer thread of the tests run before wouldn't be forked.
+			::testing::FLAGS_gtest_death_test_style = "threadsafe";
+			EXPECT_DEATH({
+				SetLogLevel(INFO);
+				O3D_LOG(INFO) << "queued before";
+				O3D_LOG(FATAL) << "the fatal one";
+			}, "queued before(.|\n)*the fatal one");
+		}
+
+	}  // namespace base
+}  // namespace o3d
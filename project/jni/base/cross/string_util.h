@@ -11,6 +11,8 @@
 
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
+#include <strings.h>
 #include <string>
 #include <vector>
 
@@ -407,7 +409,9 @@ struct ToUnsigned<signed char> {
 };
 template<>
 struct ToUnsigned<wchar_t> {
-	typedef unsigned wchar_t Unsigned;
+	// wchar_t is 32 bits on Android and Linux; "unsigned wchar_t" is a GCC 4
+	// extension.
+	typedef unsigned int Unsigned;
 };
 template<>
 struct ToUnsigned<short> {
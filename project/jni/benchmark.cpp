@@ -0,0 +1,400 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "benchmark.h"
+#include "camera.h"
+#include "core/cross/client.h"
+#include "core/cross/file_resource.h"
+#include "core/cross/frame_profiler.h"
+#include "core/cross/object_manager.h"
+#include "core/cross/pack.h"
+#include "core/cross/renderer.h"
+#include "core/cross/skin.h"
+#include "core/cross/transform.h"
+#include "extra/cross/binary.h"
+#include "extra/cross/bounding_boxes_extra.h"
+#include "extra/cross/primitive_picking.h"
+#include "import/cross/collada.h"
+#include "materials.h"
+#include "render_graph.h"
+#include "scene.h"
+#include "utils/cross/structured_writer.h"
+
+namespace o3d_utils {
+	using namespace o3d;
+
+	namespace {
+
+		// Animation times are spread over that many seconds.
+		const float kAnimationLength = 10.0f;
+
+		struct CompressionMode {
+			extra::TCompressionAlgorithm algorithm;
+			const char* name;
+		};
+
+		const CompressionMode kCompressionModes[] = {
+			{ extra::COMPRESSION_NONE, "none" },
+			{ extra::COMPRESSION_GZIP, "gzip" },
+			{ extra::COMPRESSION_LZMA, "lzma" },
+		};
+
+		// Loads the textures a binary file refers to from the file system.
+		class FileResourceProvider : public extra::IExternalResourceProvider {
+		public:
+			virtual ExternalResource::Ref GetExternalResourceForURI(
+			    Pack& pack, const std::string& uri) {
+				ExternalResource::Ref resource(new FileResource(uri));
+
+				if(!resource->data()) {
+					return ExternalResource::Ref();
+				}
+
+				return resource;
+			}
+		};
+
+		// Resets the peak resident set size of the process. Needs Linux 4.0
+		// or later; on failure the peak keeps counting from the process start.
+		void ResetPeakMemory() {
+			FILE* file = fopen("/proc/self/clear_refs", "w");
+
+			if(file) {
+				fputs("5", file);
+				fclose(file);
+			}
+		}
+
+		// Returns the peak resident set size of the process, in KB, or 0 if
+		// it can't be read.
+		unsigned GetPeakMemoryKb() {
+			FILE* file = fopen("/proc/self/status", "r");
+			unsigned peak_kb = 0;
+
+			if(file) {
+				char line[128];
+
+				while(fgets(line, sizeof(line), file)) {
+					if(sscanf(line, "VmHWM: %u kB", &peak_kb) == 1) {
+						break;
+					}
+				}
+
+				fclose(file);
+			}
+
+			return peak_kb;
+		}
+
+		// Opens the object reporting a stage, so that the caller can add its
+		// own properties before closing it with EndStage. The peak memory is
+		// the one since the last ResetPeakMemory.
+		void BeginStage(StructuredWriter* writer, const char* stage,
+		                double time_ms) {
+			writer->BeginCompacting();
+			writer->OpenObject();
+			writer->WritePropertyName("stage");
+			writer->WriteString(stage);
+			writer->WritePropertyName("timeMs");
+			writer->WriteFloat(static_cast<float>(time_ms));
+			writer->WritePropertyName("peakKb");
+			writer->WriteUnsignedInt(GetPeakMemoryKb());
+		}
+
+		void EndStage(StructuredWriter* writer) {
+			writer->CloseObject();
+			writer->EndCompacting();
+		}
+
+		// Measures a stage from its construction to Finish, which begins the
+		// stage's report.
+		class StageMeasure {
+		public:
+			StageMeasure() {
+				ResetPeakMemory();
+				start_ = FrameProfiler::GetTimeNs();
+			}
+
+			void Finish(StructuredWriter* writer, const char* stage) {
+				BeginStage(writer, stage,
+				           (FrameProfiler::GetTimeNs() - start_) / 1000000.0);
+			}
+
+		private:
+			uint64_t start_;
+		};
+
+		// Sets the animation time and evaluates the world matrix of each
+		// transform of the model.
+		void EvaluateAnimation(Client* client,
+		                       ParamFloat* time,
+		                       const std::vector<Transform*>& transforms,
+		                       float seconds) {
+			time->set_value(seconds);
+			client->InvalidateAllParameters();
+
+			for(size_t ii = 0; ii < transforms.size(); ++ii) {
+				transforms[ii]->GetUpdatedWorldMatrix();
+			}
+		}
+
+		float GetAnimationTime(int step, int num_steps) {
+			return kAnimationLength * step / std::max(1, num_steps);
+		}
+
+		// Deterministic random numbers in [0, 1], so that runs cast the same
+		// rays.
+		float NextRandom(unsigned* seed) {
+			*seed = *seed * 1103515245u + 12345u;
+			return ((*seed >> 8) & 0xffff) / 65535.0f;
+		}
+
+	}  // anonymous namespace
+
+	Benchmark::Options::Options()
+		: num_frames(100),
+		  num_animation_steps(100),
+		  num_rays(1000),
+		  import_threads(0) {
+	}
+
+	Benchmark::Benchmark(Client* client,
+	                     ViewInfo* view_info,
+	                     StructuredWriter* writer,
+	                     const Options& options)
+		: client_(client),
+		  view_info_(view_info),
+		  writer_(writer),
+		  options_(options) {
+	}
+
+	void Benchmark::Begin() {
+		writer_->OpenObject();
+		writer_->WritePropertyName("models");
+		writer_->OpenArray();
+	}
+
+	void Benchmark::End() {
+		writer_->CloseArray();
+		writer_->CloseObject();
+		writer_->Close();
+	}
+
+	bool Benchmark::RunModel(const std::string& filename) {
+		O3D_LOG(INFO) << "Benchmarking " << filename;
+		writer_->OpenObject();
+		writer_->WritePropertyName("file");
+		writer_->WriteString(filename);
+		writer_->WritePropertyName("stages");
+		writer_->OpenArray();
+		Pack* pack = client_->CreatePack();
+		Transform* root = pack->Create<Transform>();
+		pack->set_root(root);
+		ParamFloat* time = root->CreateParam<ParamFloat>("time");
+		Collada::Options collada_options;
+		collada_options.up_axis = Vector3(0.0f, 1.0f, 0.0f);
+		collada_options.num_threads = options_.import_threads;
+		// Import.
+		StageMeasure import_measure;
+		bool imported = Collada::Import(pack, filename, root, time,
+		                                collada_options);
+
+		if(imported) {
+			Materials::PrepareMaterials(pack, view_info_, NULL);
+		}
+
+		import_measure.Finish(writer_, "import");
+		writer_->WritePropertyName("succeeded");
+		writer_->WriteBool(imported);
+		EndStage(writer_);
+
+		if(imported) {
+			// Shape preparation.
+			StageMeasure prepare_measure;
+			Scene::PrepareShapes(pack);
+			prepare_measure.Finish(writer_, "prepareShapes");
+			writer_->WritePropertyName("shapes");
+			writer_->WriteUnsignedInt(pack->GetByClass<Shape>().size());
+			EndStage(writer_);
+			extra::updateBoundingBoxes(*root);
+			FileResourceProvider resource_provider;
+
+			// Binary export and load, for each compression mode.
+			for(size_t mm = 0; mm < o3d_arraysize(kCompressionModes); ++mm) {
+				const CompressionMode& mode = kCompressionModes[mm];
+				std::ostringstream output;
+				StageMeasure export_measure;
+				bool saved = extra::SaveToBinaryStream(output, *root, mode.algorithm);
+				export_measure.Finish(writer_, "export");
+				writer_->WritePropertyName("compression");
+				writer_->WriteString(mode.name);
+				writer_->WritePropertyName("succeeded");
+				writer_->WriteBool(saved);
+				writer_->WritePropertyName("bytes");
+				writer_->WriteUnsignedInt(output.str().size());
+				EndStage(writer_);
+
+				if(!saved) {
+					continue;
+				}
+
+				std::istringstream input(output.str());
+				Pack* binary_pack = client_->CreatePack();
+				StageMeasure load_measure;
+				Transform* binary_root = extra::LoadFromBinaryStream(
+				                             input, *binary_pack, resource_provider);
+				load_measure.Finish(writer_, "load");
+				writer_->WritePropertyName("compression");
+				writer_->WriteString(mode.name);
+				writer_->WritePropertyName("succeeded");
+				writer_->WriteBool(binary_root != NULL);
+				EndStage(writer_);
+				binary_pack->service_locator()->GetService<ObjectManager>()->DestroyPack(
+				    binary_pack);
+			}
+
+			std::vector<Transform*> transforms = pack->GetByClass<Transform>();
+			std::vector<SkinEval*> skin_evals = pack->GetByClass<SkinEval>();
+			// Curves, through the world matrices they animate.
+			StageMeasure curve_measure;
+
+			for(int ii = 0; ii < options_.num_animation_steps; ++ii) {
+				EvaluateAnimation(client_, time, transforms,
+				                  GetAnimationTime(ii, options_.num_animation_steps));
+			}
+
+			curve_measure.Finish(writer_, "curves");
+			writer_->WritePropertyName("steps");
+			writer_->WriteInt(options_.num_animation_steps);
+			writer_->WritePropertyName("transforms");
+			writer_->WriteUnsignedInt(transforms.size());
+			EndStage(writer_);
+
+			// Skinning. The bones are posed outside of the measure.
+			if(!skin_evals.empty()) {
+				uint64_t skinning_ns = 0;
+				ResetPeakMemory();
+
+				for(int ii = 0; ii < options_.num_animation_steps; ++ii) {
+					EvaluateAnimation(client_, time, transforms,
+					                  GetAnimationTime(ii, options_.num_animation_steps));
+					uint64_t start = FrameProfiler::GetTimeNs();
+
+					for(size_t ss = 0; ss < skin_evals.size(); ++ss) {
+						skin_evals[ss]->UpdateOutputs();
+					}
+
+					skinning_ns += FrameProfiler::GetTimeNs() - start;
+				}
+
+				BeginStage(writer_, "skinning", skinning_ns / 1000000.0);
+				writer_->WritePropertyName("steps");
+				writer_->WriteInt(options_.num_animation_steps);
+				writer_->WritePropertyName("skins");
+				writer_->WriteUnsignedInt(skin_evals.size());
+				EndStage(writer_);
+			}
+
+			// Frames, of which the traversal and sort times are reported on top
+			// of the total.
+			Renderer* renderer = pack->service_locator()->GetService<Renderer>();
+			RenderStats* render_stats = renderer->render_stats();
+			double traversal_ms = 0.0;
+			double sort_ms = 0.0;
+			root->SetParent(view_info_->tree_root());
+			extra::updateBoundingBoxes(*view_info_->tree_root());
+			CameraInfo* camera_info = Camera::getCameraFitToScene(
+			                              view_info_->tree_root(),
+			                              static_cast<float>(renderer->width()),
+			                              static_cast<float>(renderer->height()));
+			view_info_->draw_context()->set_view(camera_info->view);
+			view_info_->draw_context()->set_projection(camera_info->projection);
+			delete camera_info;
+			StageMeasure frame_measure;
+
+			for(int ii = 0; ii < options_.num_frames; ++ii) {
+				time->set_value(GetAnimationTime(ii, options_.num_frames));
+				client_->RenderClient(false);
+				traversal_ms += render_stats->last()[RenderStats::TRAVERSAL_TIME];
+				sort_ms += render_stats->last()[RenderStats::SORT_TIME];
+			}
+
+			frame_measure.Finish(writer_, "frames");
+			writer_->WritePropertyName("frames");
+			writer_->WriteInt(options_.num_frames);
+			writer_->WritePropertyName("traversalMs");
+			writer_->WriteFloat(static_cast<float>(traversal_ms));
+			writer_->WritePropertyName("sortMs");
+			writer_->WriteFloat(static_cast<float>(sort_ms));
+			EndStage(writer_);
+			root->SetParent(NULL);
+
+			// Picking, with rays from around the model to random points in its
+			// bounding box.
+			BoundingBox box = root->bounding_box();
+
+			if(box.valid()) {
+				Point3 center = lerp(0.5f, box.min_extent(), box.max_extent());
+				Vector3 extent = box.max_extent() - box.min_extent();
+				float radius = std::max(length(extent), 0.001f);
+				unsigned seed = 1;
+				int hits = 0;
+				StageMeasure picking_measure;
+
+				for(int ii = 0; ii < options_.num_rays; ++ii) {
+					Vector3 from(NextRandom(&seed) - 0.5f,
+					             NextRandom(&seed) - 0.5f,
+					             NextRandom(&seed) - 0.5f);
+
+					if(lengthSqr(from) < 0.0001f) {
+						from = Vector3(0.0f, 0.0f, 1.0f);
+					}
+
+					Point3 origin = center + normalize(from) * radius;
+					Point3 target(
+					    box.min_extent().getX() + extent.getX() * NextRandom(&seed),
+					    box.min_extent().getY() + extent.getY() * NextRandom(&seed),
+					    box.min_extent().getZ() + extent.getZ() * NextRandom(&seed));
+					Point3 intersection;
+					float distance;
+
+					if(extra::intersectRayWithTree(origin, normalize(target - origin),
+					                               *root, intersection, distance)) {
+						++hits;
+					}
+				}
+
+				picking_measure.Finish(writer_, "picking");
+				writer_->WritePropertyName("rays");
+				writer_->WriteInt(options_.num_rays);
+				writer_->WritePropertyName("hits");
+				writer_->WriteInt(hits);
+				EndStage(writer_);
+			}
+		}
+
+		pack->service_locator()->GetService<ObjectManager>()->DestroyPack(pack);
+		writer_->CloseArray();
+		writer_->CloseObject();
+		return imported;
+	}
+
+}  // namespace o3d_utils
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef O3D_UTILS_BENCHMARK_H_
+#define O3D_UTILS_BENCHMARK_H_
+
+#include <string>
+#include "base/cross/config.h"
+
+namespace o3d {
+
+	class Client;
+	class StructuredWriter;
+
+}  // namespace o3d.
+
+namespace o3d_utils {
+
+	class ViewInfo;
+
+// Measures the stages a COLLADA model goes through, from import to being
+// rendered and picked, and writes how long each stage took and the peak
+// memory it needed, so that runs can be compared over time.
+//
+// The report is an object with a "models" array holding one object per
+// model run, each with a "stages" array of objects like
+//   {"stage":"export","compression":"lzma","timeMs":12.5,"peakKb":20480,
+//    "bytes":123456}
+// Peak memory is the peak resident set size of the process during the
+// stage. It is only measured on Linux, and only per stage on kernels that
+// allow resetting it; otherwise it is the peak since the process started.
+	class Benchmark {
+	public:
+		struct Options {
+			Options();
+
+			// Number of frames rendered to measure traversal and sorting.
+			int num_frames;
+
+			// Number of animation times curves and skins are evaluated at.
+			int num_animation_steps;
+
+			// Number of rays cast at the model.
+			int num_rays;
+
+			// Number of threads the COLLADA importer converts geometry with.
+			unsigned int import_threads;
+		};
+
+		// The client must have a working renderer for the frames to be
+		// measured. The model is rendered through |view_info|.
+		Benchmark(o3d::Client* client,
+		          ViewInfo* view_info,
+		          o3d::StructuredWriter* writer,
+		          const Options& options);
+
+		// Opens and closes the report. RunModel can be called any number of
+		// times in between.
+		void Begin();
+		void End();
+
+		// Runs all the stages on the COLLADA file |filename|. Returns false if
+		// it couldn't be imported, in which case only the import is reported.
+		bool RunModel(const std::string& filename);
+
+	private:
+		o3d::Client* client_;
+		ViewInfo* view_info_;
+		o3d::StructuredWriter* writer_;
+		Options options_;
+
+		O3D_DISALLOW_COPY_AND_ASSIGN(Benchmark);
+	};
+
+}  // namespace o3d_utils
+
+#endif  // O3D_UTILS_BENCHMARK_H_
@@ -18,6 +18,8 @@ LOCAL_SRC_FILES := $(addprefix cross/, \
   bitmap_tga.cc \
   bounding_box.cc \
   buffer.cc \
+  buffer_shadow.cc \
+  class_index.cc \
   class_manager.cc \
   clear_buffer.cc \
   client.cc \
@@ -40,33 +42,42 @@ LOCAL_SRC_FILES := $(addprefix cross/, \
   features.cc \
   field.cc \
   file_resource.cc \
+  file_texture_source.cc \
+  frame_profiler.cc \
   function.cc \
   iclass_manager.cc \
   id_manager.cc \
   ierror_status.cc \
   image_utils.cc \
+  lod_generator.cc \
   material.cc \
   math_utilities.cc \
   matrix4_axis_rotation.cc \
   matrix4_composition.cc \
   matrix4_scale.cc \
   matrix4_translation.cc \
+  mesh_simplifier.cc \
   named_object.cc \
   object_base.cc \
   object_manager.cc \
+  occlusion_buffer.cc \
   pack.cc \
   param.cc \
   param_array.cc \
   param_cache.cc \
   param_object.cc \
   param_operation.cc \
+  pick_buffer.cc \
+  pickable_registry.cc \
   picking_context.cc \
   precompile.cc \
   primitive.cc \
   profiler.cc \
   ray_intersection_info.cc \
   render_context.cc \
+  render_graph_schedule.cc \
   render_node.cc \
+  render_stats.cc \
   render_surface.cc \
   render_surface_set.cc \
   renderer.cc \
@@ -75,6 +86,7 @@ LOCAL_SRC_FILES := $(addprefix cross/, \
   service_locator.cc \
   shape.cc \
   skin.cc \
+  slab_allocator.cc \
   standard_param.cc \
   state.cc \
   state_set.cc \
@@ -82,12 +94,14 @@ LOCAL_SRC_FILES := $(addprefix cross/, \
   stream_bank.cc \
   texture.cc \
   texture_base.cc \
+  texture_residency_manager.cc \
   timer.cc \
   transform.cc \
   transformation_context.cc \
   tree_traversal.cc \
   vertex_source.cc \
   viewport.cc \
+  worker_pool.cc \
   )
 
 include $(O3D_BUILD_MODULE)
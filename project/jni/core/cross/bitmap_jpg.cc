@@ -162,7 +162,7 @@ namespace o3d {
 		// length |jpeg_data_length|
 		size_t jpeg_data_length = stream->GetTotalStreamLength();
 		const uint8_t* jpeg_data = stream->GetDirectMemoryPointer();
-		JPEGMemoryReader(&cinfo, jpeg_data, jpeg_data_length);
+		JPEGMemoryReader reader(&cinfo, jpeg_data, jpeg_data_length);
 		// Step 3: read the JPEG header and allocate storage
 		jpeg_read_header(&cinfo, TRUE);
 		// Set the Bitmap member variables from the jpeg_decompress_struct fields.
@@ -34,6 +34,7 @@
 
 #include "core/cross/buffer.h"
 #include "core/cross/client_info.h"
+#include "core/cross/element.h"
 #include "core/cross/pointer_utils.h"
 #include "core/cross/renderer.h"
 #include "core/cross/features.h"
@@ -117,7 +118,9 @@ namespace o3d {
 		  stride_(0),
 		  num_elements_(0),
 		  access_mode_(NONE),
-		  lock_count_(0) {
+		  lock_count_(0),
+		  locked_for_writing_(false),
+		  usage_(DYNAMIC_USAGE) {
 	}
 
 	Buffer::~Buffer() {
@@ -382,6 +385,11 @@ namespace o3d {
 
 			++lock_count_;
 			*buffer_data = locked_data_;
+
+			if(access_mode != READ_ONLY) {
+				locked_for_writing_ = true;
+			}
+
 			return true;
 		}
 		else {
@@ -402,12 +410,35 @@ namespace o3d {
 		--lock_count_;
 
 		if(lock_count_ == 0) {
+			if(locked_for_writing_) {
+				locked_for_writing_ = false;
+
+				for(unsigned ii = 0; ii < bounding_box_elements_.size(); ++ii) {
+					bounding_box_elements_[ii]->MarkBoundingBoxDirty();
+				}
+			}
+
 			return ConcreteUnlock();
 		}
 
 		return true;
 	}
 
+	void Buffer::AddBoundingBoxElement(Element* element) {
+		bounding_box_elements_.push_back(element);
+	}
+
+	void Buffer::RemoveBoundingBoxElement(Element* element) {
+		std::vector<Element*>::iterator iter =
+		    std::find(bounding_box_elements_.begin(),
+		              bounding_box_elements_.end(),
+		              element);
+
+		if(iter != bounding_box_elements_.end()) {
+			bounding_box_elements_.erase(iter);
+		}
+	}
+
 	bool Buffer::Set(o3d::RawData* raw_data) {
 		O3D_ASSERT(raw_data);
 		return Set(raw_data, 0, raw_data->GetLength());
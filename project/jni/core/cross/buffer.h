@@ -46,6 +46,22 @@ namespace o3d {
 
 	class RawData;
 	class Features;
+	class Element;
+	class Buffer;
+
+// Provides the data of a static buffer again, for buffers that don't keep a
+// copy of it in main memory, after the graphics context was lost or when the
+// buffer is locked again.
+	class BufferSource : public RefCounted {
+	public:
+		typedef SmartPointer<BufferSource> Ref;
+
+		virtual ~BufferSource() {}
+
+		// Sets the data of |buffer|, which already has its fields and elements,
+		// by locking it or through its fields. Returns false on failure.
+		virtual bool RestoreBuffer(Buffer* buffer) = 0;
+	};
 
 // class Buffer -----------------------------
 //
@@ -73,6 +89,14 @@ namespace o3d {
 			READ_WRITE = 3,
 		};
 
+		// Defines how often the data of a buffer changes. Renderers that keep a
+		// copy of buffers in main memory release it for static buffers that
+		// have a source, once their data is uploaded.
+		enum Usage {
+			DYNAMIC_USAGE,
+			STATIC_USAGE,
+		};
+
 		// Yes, 65534 is the correct number. Specifically the Intel 945 only allows
 		// 65534 elements.
 		static const unsigned MAX_SMALL_INDEX = 65534;
@@ -190,6 +214,39 @@ namespace o3d {
 		         size_t offset,
 		         size_t length);
 
+		// Registers an Element whose bounding box was computed from the data of
+		// this buffer. Its bounding box gets flagged as dirty each time the
+		// buffer is unlocked after being locked for writing. This is an
+		// internal function. Use Element::UpdateBoundingBox.
+		void AddBoundingBoxElement(Element* element);
+
+		// Unregisters an Element registered with AddBoundingBoxElement.
+		void RemoveBoundingBoxElement(Element* element);
+
+		// How often the data of the buffer changes. Defaults to DYNAMIC_USAGE.
+		// Set it, and the source, before the data is set.
+		Usage usage() const {
+			return usage_;
+		}
+
+		void set_usage(Usage usage) {
+			usage_ = usage;
+		}
+
+		// Where the data of the buffer can be set from again, or NULL.
+		BufferSource* source() const {
+			return source_.Get();
+		}
+
+		void set_source(BufferSource* source) {
+			source_ = BufferSource::Ref(source);
+		}
+
+		// Number of bytes used by the copy of the buffer kept in main memory.
+		virtual size_t GetCpuMemorySize() const {
+			return 0;
+		}
+
 	protected:
 		// The concrete version of AllocateElements.
 		virtual bool ConcreteAllocate(size_t size_in_bytes) = 0;
@@ -249,6 +306,16 @@ namespace o3d {
 		// Pointer to data when it's locked.
 		void* locked_data_;
 
+		// True if the buffer was locked for writing since it was last unlocked.
+		bool locked_for_writing_;
+
+		// Elements whose bounding boxes depend on the data of this buffer.
+		std::vector<Element*> bounding_box_elements_;
+
+		Usage usage_;
+
+		BufferSource::Ref source_;
+
 		O3D_DECL_CLASS(Buffer, NamedObject);
 	};
 
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/cross/buffer_shadow.h"
+#include "core/cross/error.h"
+
+namespace o3d {
+
+	BufferShadow::BufferShadow(Buffer* buffer)
+		: buffer_(buffer),
+		  data_(NULL),
+		  read_only_(true),
+		  keep_(false) {
+	}
+
+	void BufferShadow::Allocate(size_t size_in_bytes) {
+		data_.reset(new char[size_in_bytes]);
+		keep_ = false;
+	}
+
+	void BufferShadow::Free() {
+		data_.reset(NULL);
+	}
+
+	char* BufferShadow::Lock(Buffer::AccessMode access_mode) {
+		// A static buffer locked after releasing its shadow needs it from now on.
+		if(!data_.get()) {
+			keep_ = true;
+
+			if(!Restore()) {
+				return NULL;
+			}
+		}
+
+		read_only_ = (access_mode == Buffer::READ_ONLY);
+		return data_.get();
+	}
+
+	void BufferShadow::Uploaded() {
+		if(!keep_ &&
+		        buffer_->usage() == Buffer::STATIC_USAGE &&
+		        buffer_->source() != NULL) {
+			data_.reset(NULL);
+		}
+	}
+
+	bool BufferShadow::Restore() {
+		data_.reset(new char[buffer_->GetSizeInBytes()]);
+
+		if(!buffer_->source() || !buffer_->source()->RestoreBuffer(buffer_)) {
+			// Don't keep bytes the source never set for later locks to upload.
+			data_.reset(NULL);
+			O3D_ERROR(buffer_->service_locator())
+			        << "Unable to restore the data of buffer \"" << buffer_->name() << "\"";
+			return false;
+		}
+
+		return true;
+	}
+
+	size_t BufferShadow::GetCpuMemorySize() const {
+		return data_.get() ? buffer_->GetSizeInBytes() : 0;
+	}
+
+}  // namespace o3d
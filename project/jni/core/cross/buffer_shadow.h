@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "core/cross/buffer.h"
+
+namespace o3d {
+
+	// Copy of the data of a buffer kept in main memory, for renderers that
+	// can't read their buffers back nor map them. The copy of a static buffer
+	// with a source is released once uploaded. It is set again from the source
+	// when the buffer gets locked, and kept from then on, or when the graphics
+	// context is restored, and released again.
+	class BufferShadow {
+	public:
+		explicit BufferShadow(Buffer* buffer);
+
+		// Allocates a shadow of |size_in_bytes| for a newly allocated buffer.
+		void Allocate(size_t size_in_bytes);
+
+		void Free();
+
+		// Returns the shadow for the buffer to be locked with, setting it again
+		// from the source if it was released. Returns NULL on failure.
+		char* Lock(Buffer::AccessMode access_mode);
+
+		// Whether the last lock was for reading only, so that there is nothing
+		// to upload on unlock.
+		bool read_only() const {
+			return read_only_;
+		}
+
+		// Tells the shadow it was uploaded after a lock for writing. Static
+		// buffers with a source release it.
+		void Uploaded();
+
+		// Sets a released shadow again from the source, which locks the buffer
+		// for writing: the data gets uploaded and the shadow released again.
+		// If the source fails, the shadow is left released.
+		bool Restore();
+
+		// The shadow, or NULL if it was released.
+		char* data() const {
+			return data_.get();
+		}
+
+		// Number of bytes the shadow takes.
+		size_t GetCpuMemorySize() const;
+
+	private:
+		Buffer* buffer_;
+		::o3d::base::scoped_array<char> data_;
+		bool read_only_;
+
+		// Whether the shadow is kept even if the buffer is static, because it
+		// was locked again after being released.
+		bool keep_;
+
+		O3D_DISALLOW_COPY_AND_ASSIGN(BufferShadow);
+	};
+
+}  // namespace o3d
@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Tests BufferShadow, through a buffer that keeps its data the way the GLES2
+// buffers do.
+
+#include <string.h>
+#include <vector>
+#include "tests/common/win/testing_common.h"
+#include "core/cross/buffer_shadow.h"
+#include "core/cross/object_manager.h"
+#include "core/cross/service_dependency.h"
+
+namespace o3d {
+
+	namespace {
+
+// Sets the data of a buffer with a single UInt32 field to its indices.
+		class IotaBufferSource : public BufferSource {
+		public:
+			IotaBufferSource() : restores_(0), fail_(false) {}
+
+			virtual bool RestoreBuffer(Buffer* buffer) {
+				uint32_t* data = NULL;
+
+				if(fail_) {
+					return false;
+				}
+
+				if(!buffer->LockAs(Buffer::WRITE_ONLY, &data)) {
+					return false;
+				}
+
+				for(uint32_t i = 0; i < buffer->num_elements(); ++i) {
+					data[i] = i;
+				}
+
+				++restores_;
+				return buffer->Unlock();
+			}
+
+			int restores() const {
+				return restores_;
+			}
+
+			// Makes RestoreBuffer fail, as when the data it reads is gone.
+			void set_fail(bool fail) {
+				fail_ = fail;
+			}
+
+		private:
+			int restores_;
+			bool fail_;
+		};
+
+// A vertex buffer whose device memory is a vector, kept in sync with a
+// BufferShadow the way VertexBufferGLES2 keeps its GL buffer.
+		class ShadowedVertexBuffer : public VertexBuffer {
+		public:
+			explicit ShadowedVertexBuffer(ServiceLocator* service_locator)
+				: VertexBuffer(service_locator),
+				  shadow_(this),
+				  uploads_(0) {
+			}
+
+			~ShadowedVertexBuffer() {
+				ConcreteFree();
+			}
+
+			// Loses the device memory, then sets it again the way
+			// VertexBufferGLES2::OnContextRestored does.
+			bool RestoreContext() {
+				device_.assign(device_.size(), 0);
+
+				if(shadow_.data()) {
+					memcpy(&device_[0], shadow_.data(), device_.size());
+					return true;
+				}
+
+				if(num_elements() && source()) {
+					return shadow_.Restore();
+				}
+
+				return true;
+			}
+
+			// The data as last uploaded.
+			const uint32_t* device() const {
+				return reinterpret_cast<const uint32_t*>(&device_[0]);
+			}
+
+			int uploads() const {
+				return uploads_;
+			}
+
+			virtual size_t GetCpuMemorySize() const {
+				return shadow_.GetCpuMemorySize();
+			}
+
+		protected:
+			virtual bool ConcreteAllocate(size_t size_in_bytes) {
+				device_.assign(size_in_bytes, 0);
+				shadow_.Allocate(size_in_bytes);
+				return true;
+			}
+
+			virtual void ConcreteFree() {
+				device_.clear();
+				shadow_.Free();
+			}
+
+			virtual bool ConcreteLock(AccessMode access_mode, void** buffer_data) {
+				*buffer_data = shadow_.Lock(access_mode);
+				return *buffer_data != NULL;
+			}
+
+			virtual bool ConcreteUnlock() {
+				if(!shadow_.read_only()) {
+					memcpy(&device_[0], shadow_.data(), device_.size());
+					++uploads_;
+					shadow_.Uploaded();
+				}
+
+				return true;
+			}
+
+		private:
+			BufferShadow shadow_;
+			std::vector<char> device_;
+			int uploads_;
+		};
+
+	}  // anonymous namespace
+
+	class BufferShadowTest : public testing::Test {
+	protected:
+		static const unsigned kSize = 100;
+
+		BufferShadowTest()
+			: object_manager_(g_service_locator) {
+		}
+
+		virtual void SetUp();
+
+		// Creates a buffer of kSize UInt32s, with |usage|, set from source().
+		ShadowedVertexBuffer* CreateBuffer(Buffer::Usage usage, bool with_source);
+
+		IotaBufferSource* source() {
+			return source_;
+		}
+
+	private:
+		ServiceDependency<ObjectManager> object_manager_;
+		std::vector<Buffer::Ref> buffers_;
+		SmartPointer<IotaBufferSource> source_;
+	};
+
+	void BufferShadowTest::SetUp() {
+		source_ = SmartPointer<IotaBufferSource>(new IotaBufferSource);
+	}
+
+	ShadowedVertexBuffer* BufferShadowTest::CreateBuffer(Buffer::Usage usage, bool with_source) {
+		ShadowedVertexBuffer* buffer = new ShadowedVertexBuffer(g_service_locator);
+		buffers_.push_back(Buffer::Ref(buffer));
+		EXPECT_TRUE(buffer->CreateField(UInt32Field::GetApparentClass(), 1) != NULL);
+		buffer->set_usage(usage);
+
+		if(with_source) {
+			buffer->set_source(source_.Get());
+		}
+
+		EXPECT_TRUE(buffer->AllocateElements(kSize));
+		EXPECT_EQ(kSize * sizeof(uint32_t), buffer->GetCpuMemorySize());  // NOLINT
+		EXPECT_TRUE(source_->RestoreBuffer(buffer));
+		return buffer;
+	}
+
+// A static buffer with a source releases its shadow once uploaded.
+	TEST_F(BufferShadowTest, StaticBufferReleasesShadow) {
+		ShadowedVertexBuffer* buffer = CreateBuffer(Buffer::STATIC_USAGE, true);
+		EXPECT_EQ(1, source()->restores());
+		EXPECT_EQ(1, buffer->uploads());
+		EXPECT_EQ(0U, buffer->GetCpuMemorySize());
+
+		for(uint32_t i = 0; i < kSize; ++i) {
+			EXPECT_EQ(i, buffer->device()[i]);
+		}
+	}
+
+// Locking a released buffer sets its shadow again from the source, once, and
+// keeps it from then on.
+	TEST_F(BufferShadowTest, LockRestoresReleasedShadowOnce) {
+		ShadowedVertexBuffer* buffer = CreateBuffer(Buffer::STATIC_USAGE, true);
+		uint32_t* data = NULL;
+		ASSERT_TRUE(buffer->LockAs(Buffer::READ_ONLY, &data));
+		ASSERT_TRUE(data != NULL);
+
+		for(uint32_t i = 0; i < kSize; ++i) {
+			EXPECT_EQ(i, data[i]);
+		}
+
+		ASSERT_TRUE(buffer->Unlock());
+		EXPECT_EQ(2, source()->restores());
+		EXPECT_EQ(kSize * sizeof(uint32_t), buffer->GetCpuMemorySize());  // NOLINT
+
+		// Written to again, the buffer keeps its shadow and its new data.
+		ASSERT_TRUE(buffer->LockAs(Buffer::WRITE_ONLY, &data));
+		data[0] = 1000;
+		ASSERT_TRUE(buffer->Unlock());
+		EXPECT_EQ(2, source()->restores());
+		EXPECT_EQ(kSize * sizeof(uint32_t), buffer->GetCpuMemorySize());  // NOLINT
+		EXPECT_EQ(1000U, buffer->device()[0]);
+
+		// A kept shadow is uploaded again as it is after a context loss.
+		ASSERT_TRUE(buffer->RestoreContext());
+		EXPECT_EQ(2, source()->restores());
+		EXPECT_EQ(1000U, buffer->device()[0]);
+		EXPECT_EQ(1U, buffer->device()[1]);
+	}
+
+// A released buffer whose source fails stays released, rather than keeping a
+// shadow the source never set.
+	TEST_F(BufferShadowTest, FailedRestoreLeavesShadowReleased) {
+		ShadowedVertexBuffer* buffer = CreateBuffer(Buffer::STATIC_USAGE, true);
+		source()->set_fail(true);
+		uint32_t* data = NULL;
+		EXPECT_FALSE(buffer->LockAs(Buffer::READ_ONLY, &data));
+		EXPECT_EQ(0U, buffer->GetCpuMemorySize());
+		EXPECT_FALSE(buffer->RestoreContext());
+		EXPECT_EQ(0U, buffer->GetCpuMemorySize());
+		EXPECT_EQ(1, buffer->uploads());
+		// Once the source works again, so does the buffer.
+		source()->set_fail(false);
+		ASSERT_TRUE(buffer->LockAs(Buffer::READ_ONLY, &data));
+		EXPECT_EQ(kSize - 1, data[kSize - 1]);
+		ASSERT_TRUE(buffer->Unlock());
+		EXPECT_EQ(2, source()->restores());
+	}
+
+// After a context loss, a released buffer is set again from its source, and
+// releases its shadow again.
+	TEST_F(BufferShadowTest, ContextRestoreUsesSource) {
+		ShadowedVertexBuffer* buffer = CreateBuffer(Buffer::STATIC_USAGE, true);
+		ASSERT_TRUE(buffer->RestoreContext());
+		EXPECT_EQ(2, source()->restores());
+		EXPECT_EQ(2, buffer->uploads());
+		EXPECT_EQ(0U, buffer->GetCpuMemorySize());
+
+		for(uint32_t i = 0; i < kSize; ++i) {
+			EXPECT_EQ(i, buffer->device()[i]);
+		}
+
+		ASSERT_TRUE(buffer->RestoreContext());
+		EXPECT_EQ(3, source()->restores());
+	}
+
+// Dynamic buffers, and static ones without a source, keep their shadow and
+// never need their source.
+	TEST_F(BufferShadowTest, OthersKeepShadow) {
+		ShadowedVertexBuffer* dynamic = CreateBuffer(Buffer::DYNAMIC_USAGE, true);
+		ShadowedVertexBuffer* no_source = CreateBuffer(Buffer::STATIC_USAGE, false);
+		EXPECT_EQ(kSize * sizeof(uint32_t), dynamic->GetCpuMemorySize());  // NOLINT
+		EXPECT_EQ(kSize * sizeof(uint32_t), no_source->GetCpuMemorySize());  // NOLINT
+		uint32_t* data = NULL;
+		ASSERT_TRUE(dynamic->LockAs(Buffer::READ_ONLY, &data));
+		ASSERT_TRUE(dynamic->Unlock());
+		ASSERT_TRUE(dynamic->RestoreContext());
+		ASSERT_TRUE(no_source->RestoreContext());
+		// Only the calls made by CreateBuffer.
+		EXPECT_EQ(2, source()->restores());
+		EXPECT_EQ(kSize - 1, no_source->device()[kSize - 1]);
+	}
+
+}  // namespace o3d
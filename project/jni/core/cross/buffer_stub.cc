@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "core/cross/buffer_stub.h"
+
+namespace o3d {
+
+	// Vertex Buffers ------------------------------------------------------------
+
+	VertexBufferStub::VertexBufferStub(ServiceLocator* service_locator)
+		: VertexBuffer(service_locator),
+		  size_(0) {
+	}
+
+	VertexBufferStub::~VertexBufferStub() {
+		ConcreteFree();
+	}
+
+	size_t VertexBufferStub::GetCpuMemorySize() const {
+		return data_.get() ? size_ : 0;
+	}
+
+	bool VertexBufferStub::ConcreteAllocate(size_t size_in_bytes) {
+		ConcreteFree();
+		data_.reset(new char[size_in_bytes]);
+		size_ = size_in_bytes;
+		return true;
+	}
+
+	void VertexBufferStub::ConcreteFree() {
+		data_.reset();
+		size_ = 0;
+	}
+
+	bool VertexBufferStub::ConcreteLock(AccessMode access_mode,
+	                                    void** buffer_data) {
+		if(!data_.get()) {
+			return false;
+		}
+
+		*buffer_data = data_.get();
+		return true;
+	}
+
+	bool VertexBufferStub::ConcreteUnlock() {
+		return data_.get() != NULL;
+	}
+
+	// Index Buffers -------------------------------------------------------------
+
+	IndexBufferStub::IndexBufferStub(ServiceLocator* service_locator)
+		: IndexBuffer(service_locator),
+		  size_(0) {
+	}
+
+	IndexBufferStub::~IndexBufferStub() {
+		ConcreteFree();
+	}
+
+	size_t IndexBufferStub::GetCpuMemorySize() const {
+		return data_.get() ? size_ : 0;
+	}
+
+	bool IndexBufferStub::ConcreteAllocate(size_t size_in_bytes) {
+		ConcreteFree();
+		data_.reset(new char[size_in_bytes]);
+		size_ = size_in_bytes;
+		return true;
+	}
+
+	void IndexBufferStub::ConcreteFree() {
+		data_.reset();
+		size_ = 0;
+	}
+
+	bool IndexBufferStub::ConcreteLock(AccessMode access_mode,
+	                                   void** buffer_data) {
+		if(!data_.get()) {
+			return false;
+		}
+
+		*buffer_data = data_.get();
+		return true;
+	}
+
+	bool IndexBufferStub::ConcreteUnlock() {
+		return data_.get() != NULL;
+	}
+
+}  // namespace o3d
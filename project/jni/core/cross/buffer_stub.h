@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "base/cross/scoped_ptr.h"
+#include "core/cross/buffer.h"
+
+namespace o3d {
+
+	// A VertexBuffer kept in system memory, for the stub renderer.
+	class VertexBufferStub : public VertexBuffer {
+	public:
+		explicit VertexBufferStub(ServiceLocator* service_locator);
+		~VertexBufferStub();
+
+		// Overridden from Buffer.
+		virtual size_t GetCpuMemorySize() const;
+
+	protected:
+		// Overridden from Buffer.
+		virtual bool ConcreteAllocate(size_t size_in_bytes);
+
+		// Overridden from Buffer.
+		virtual void ConcreteFree();
+
+		// Overridden from Buffer.
+		virtual bool ConcreteLock(AccessMode access_mode, void** buffer_data);
+
+		// Overridden from Buffer.
+		virtual bool ConcreteUnlock();
+
+	private:
+		::o3d::base::scoped_array<char> data_;
+		size_t size_;
+
+		O3D_DISALLOW_COPY_AND_ASSIGN(VertexBufferStub);
+	};
+
+	// An IndexBuffer kept in system memory, for the stub renderer.
+	class IndexBufferStub : public IndexBuffer {
+	public:
+		explicit IndexBufferStub(ServiceLocator* service_locator);
+		~IndexBufferStub();
+
+		// Overridden from Buffer.
+		virtual size_t GetCpuMemorySize() const;
+
+	protected:
+		// Overridden from Buffer.
+		virtual bool ConcreteAllocate(size_t size_in_bytes);
+
+		// Overridden from Buffer.
+		virtual void ConcreteFree();
+
+		// Overridden from Buffer.
+		virtual bool ConcreteLock(AccessMode access_mode, void** buffer_data);
+
+		// Overridden from Buffer.
+		virtual bool ConcreteUnlock();
+
+	private:
+		::o3d::base::scoped_array<char> data_;
+		size_t size_;
+
+		O3D_DISALLOW_COPY_AND_ASSIGN(IndexBufferStub);
+	};
+
+}  // namespace o3d
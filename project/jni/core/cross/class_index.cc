@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/cross/class_index.h"
+#include <algorithm>
+
+namespace o3d {
+
+	namespace {
+
+		typedef std::pair<std::map<Id, ObjectBase*>::const_iterator,
+		        std::map<Id, ObjectBase*>::const_iterator> ObjectRange;
+
+		// Orders ranges by their first id, the lowest first in a heap.
+		bool FirstIdGreater(const ObjectRange& lhs, const ObjectRange& rhs) {
+			return lhs.first->first > rhs.first->first;
+		}
+
+	}  // anonymous namespace
+
+	void ClassIndex::Add(ObjectBase* object, const ObjectBase::Class* object_class) {
+		O3D_ASSERT(object_class->index_) << "Indexing an unregistered class";
+		unsigned index = object_class->index_ - 1;
+
+		if(index >= objects_by_class_.size()) {
+			objects_by_class_.resize(index + 1);
+		}
+
+		objects_by_class_[index].insert(std::make_pair(object->id(), object));
+	}
+
+	void ClassIndex::Remove(ObjectBase* object,
+	                        const ObjectBase::Class* object_class) {
+		unsigned index = object_class->index_ - 1;
+
+		if(!object_class->index_ || index >= objects_by_class_.size()) {
+			return;
+		}
+
+		objects_by_class_[index].erase(object->id());
+	}
+
+	void ClassIndex::GetObjects(const ObjectBase::Class* base,
+	                            ObjectBaseArray* objects) const {
+		const ObjectBase::ClassTree* tree = ObjectBase::GetClassTree();
+
+		// The classes of the objects added are registered, and so are their
+		// ancestors.
+		if(!tree || !tree->Contains(base)) {
+			return;
+		}
+
+		// The classes deriving from |base| are those in its interval.
+		std::vector<ObjectRange> ranges;
+		unsigned end = tree->end(base);
+
+		for(unsigned begin = tree->begin(base); begin < end; ++begin) {
+			unsigned index = tree->at(begin)->index_ - 1;
+
+			if(index < objects_by_class_.size() &&
+			        !objects_by_class_[index].empty()) {
+				ranges.push_back(ObjectRange(objects_by_class_[index].begin(),
+				                             objects_by_class_[index].end()));
+			}
+		}
+
+		// Each class is sorted by id already, so merge them.
+		std::make_heap(ranges.begin(), ranges.end(), FirstIdGreater);
+
+		while(!ranges.empty()) {
+			std::pop_heap(ranges.begin(), ranges.end(), FirstIdGreater);
+			ObjectRange& range = ranges.back();
+			objects->push_back(range.first->second);
+
+			if(++range.first == range.second) {
+				ranges.pop_back();
+			}
+			else {
+				std::push_heap(ranges.begin(), ranges.end(), FirstIdGreater);
+			}
+		}
+	}
+
+}  // namespace o3d
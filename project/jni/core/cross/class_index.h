@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include "core/cross/object_base.h"
+
+namespace o3d {
+
+	// Groups objects by their exact class, so that finding all the objects
+	// deriving from a class only visits the classes deriving from it and their
+	// objects. It does not hold references to the objects.
+	class ClassIndex {
+	public:
+		ClassIndex() {}
+
+		// Adds an object, indexed under |object_class|, which has to be its
+		// final class and registered with ObjectBase::RegisterClass().
+		void Add(ObjectBase* object, const ObjectBase::Class* object_class);
+
+		// Removes an object added under |object_class|.
+		void Remove(ObjectBase* object, const ObjectBase::Class* object_class);
+
+		// Appends all the objects deriving from |base| to |objects|, by
+		// increasing id.
+		void GetObjects(const ObjectBase::Class* base, ObjectBaseArray* objects) const;
+
+		// Returns all the objects of type T, by increasing id.
+		template<typename T>
+		std::vector<T*> GetByClass() const {
+			ObjectBaseArray objects;
+			GetObjects(T::GetApparentClass(), &objects);
+			std::vector<T*> results;
+			results.reserve(objects.size());
+
+			for(size_t ii = 0; ii < objects.size(); ++ii) {
+				results.push_back(static_cast<T*>(objects[ii]));
+			}
+
+			return results;
+		}
+
+	private:
+		typedef std::map<Id, ObjectBase*> ObjectMap;
+
+		// The objects of each class, by ObjectBase::Class::index_ - 1, which
+		// never changes once the class is registered.
+		std::vector<ObjectMap> objects_by_class_;
+
+		O3D_DISALLOW_COPY_AND_ASSIGN(ClassIndex);
+	};
+
+}  // namespace o3d
@@ -195,6 +195,9 @@ namespace o3d {
 		        << "attempt to register duplicate class";
 		object_creator_class_map_.insert(std::make_pair(object_class,
 		                                 function));
+		// Number the class for ObjectBase::ClassIsA() up front, rather than
+		// the first time it is tested.
+		ObjectBase::RegisterClass(object_class);
 	}
 
 	void ClassManager::RemoveClass(const ObjectBase::Class* object_class) {
@@ -49,8 +49,10 @@
 #include "core/cross/bitmap.h"
 #include "core/cross/error.h"
 #include "core/cross/evaluation_counter.h"
+#include "core/cross/frame_profiler.h"
 #include "core/cross/id_manager.h"
 #include "core/cross/profiler.h"
+#include "core/cross/worker_pool.h"
 #include "utils/cross/dataurl.h"
 
 using std::map;
@@ -79,18 +81,29 @@ namespace o3d {
 		  last_tick_time_(0),
 		  root_(NULL),
 		  rendergraph_root_(NULL),
-		  id_(IdManager::CreateId()) {
+		  present_pending_(false),
+		  id_(IdManager::CreateId()),
+		  pick_buffer_valid_(false),
+		  pick_buffer_pending_(false),
+		  pick_buffer_change_count_(0) {
 	}
 
 // Frees up all the resources allocated by the Client factory methods but
 // does not destroy the "renderer_" object.
 	Client::~Client() {
+		pipeline_pool_.reset();
 		root_.Reset();
 		rendergraph_root_.Reset();
+		render_graph_schedule_.Invalidate();
+		InvalidatePickBuffer();
+		pick_texture_.Reset();
+		pick_surface_.Reset();
+		pick_depth_surface_.Reset();
 		object_manager_->DestroyAllPacks();
 
 		// Unmap the client from the renderer on exit.
 		if(renderer_.IsAvailable()) {
+			renderer_->pickable_registry()->Clear();
 			renderer_->UninitCommon();
 		}
 	}
@@ -159,7 +172,7 @@ namespace o3d {
 		profiler_->ProfileStart("Tick callback");
 		tick_callback_manager_.Run(tick_event_);
 		profiler_->ProfileStop("Tick callback");
-		evaluation_counter_->InvalidateAllParameters();
+		evaluation_counter_->StartNewEvaluation();
 		counter_manager_.AdvanceCounters(1.0f, seconds_elapsed);
 		bool message_check_ok = true;
 		bool has_new_texture = false;
@@ -200,14 +213,67 @@ namespace o3d {
 		}
 	}
 
+	class Client::PrepareFrameTask : public Closure {
+	public:
+		PrepareFrameTask(RenderGraphSchedule* schedule,
+		                 RenderNode* root,
+		                 RenderContext* render_context)
+			: schedule_(schedule),
+			  root_(root),
+			  render_context_(render_context) {
+		}
+
+		virtual void Run() {
+			schedule_->Prepare(root_, render_context_);
+		}
+
+	private:
+		RenderGraphSchedule* schedule_;
+		RenderNode* root_;
+		RenderContext* render_context_;
+	};
+
+	void Client::set_pipelined(bool pipelined) {
+		if(pipelined == this->pipelined()) {
+			return;
+		}
+
+		if(pipelined) {
+			pipeline_pool_.reset(new WorkerPool(1));
+			return;
+		}
+
+		pipeline_pool_.reset();
+		PresentPendingFrame();
+	}
+
+	void Client::PresentPendingFrame() {
+		if(present_pending_) {
+			present_pending_ = false;
+
+			if(renderer_.IsAvailable() && !renderer_->rendering()) {
+				renderer_->Present();
+			}
+		}
+	}
+
 	void Client::RenderClientInner(bool present, bool send_callback) {
-		ElapsedTimeTimer timer;
-		render_tree_called_ = false;
-		total_time_to_render_ = 0.0f;
+		O3D_PROFILE_ZONE("Client::RenderClientInner");
 
 		if(!renderer_.IsAvailable())
 			return;
 
+		// Offscreen surfaces are set within a StartRendering of their own, so
+		// there is no time outside of rendering to prepare the frame in.
+		if(pipelined() && !renderer_->rendering()) {
+			RenderClientPipelined(present, send_callback);
+			return;
+		}
+
+		ElapsedTimeTimer timer;
+		render_tree_called_ = false;
+		total_time_to_render_ = 0.0f;
+
 		if(renderer_->StartRendering()) {
 			counter_manager_.AdvanceRenderFrameCounters(1.0f);
 			profiler_->ProfileStart("Render callback");
@@ -240,28 +306,97 @@ namespace o3d {
 				renderer_->set_need_to_render(false);
 			}
 
-			// Call post render callback.
-			profiler_->ProfileStart("Post-render callback");
-			post_render_callback_manager_.Run(render_event_);
-			profiler_->ProfileStop("Post-render callback");
-			// Update Render stats.
-			render_event_.set_elapsed_time(
-			    render_elapsed_time_timer_.GetElapsedTimeAndReset());
-			render_event_.set_render_time(total_time_to_render_);
-			render_event_.set_transforms_culled(renderer_->transforms_culled());
-			render_event_.set_transforms_processed(renderer_->transforms_processed());
-			render_event_.set_draw_elements_culled(renderer_->draw_elements_culled());
-			render_event_.set_draw_elements_processed(
-			    renderer_->draw_elements_processed());
-			render_event_.set_draw_elements_rendered(
-			    renderer_->draw_elements_rendered());
-			render_event_.set_primitives_rendered(renderer_->primitives_rendered());
-			render_event_.set_active_time(
-			    timer.GetElapsedTimeAndReset() + last_tick_time_);
-			last_tick_time_ = 0.0f;
+			FinishRenderClient(&timer);
+		}
+	}
+
+	void Client::RenderClientPipelined(bool present, bool send_callback) {
+		ElapsedTimeTimer timer;
+		render_tree_called_ = false;
+		total_time_to_render_ = 0.0f;
+		counter_manager_.AdvanceRenderFrameCounters(1.0f);
+		// The scene is edited for this frame here, before the worker reads it.
+		profiler_->ProfileStart("Render callback");
+
+		if(send_callback)
+			render_callback_manager_.Run(render_event_);
+
+		profiler_->ProfileStop("Render callback");
+		RenderNode* rendergraph_root = render_graph_root();
+		bool has_graph = rendergraph_root && !rendergraph_root->children().empty();
+		RenderContext render_context(renderer_.Get());
+		// What the worker counts belongs to this frame.
+		renderer_->StartFrameAhead();
+
+		if(has_graph) {
+			pipeline_pool_->Post(new PrepareFrameTask(&render_graph_schedule_,
+			                                          rendergraph_root,
+			                                          &render_context));
+		}
+
+		// Presenting waits for the GPU to finish the previous frame, which is
+		// the time the worker has to prepare this one.
+		if(present_pending_) {
+			present_pending_ = false;
+			renderer_->Present();
+		}
+
+		// Submission evaluates the same params as the worker, so it can't start
+		// before the worker is done. See set_pipelined.
+		{
+			O3D_PROFILE_ZONE("Client::WaitForPreparedFrame");
+			pipeline_pool_->Wait();
+		}
+
+		if(renderer_->StartRendering()) {
+			if(has_graph) {
+				RenderTree(rendergraph_root);
+			}
+			else {
+				renderer_->Clear(Float4(0.4f, 0.3f, 0.3f, 1.0f),
+				                 true, 1.0f, true, 0, true);
+			}
+
+			renderer_->FinishRendering();
+
+			if(present) {
+				// On demand, this frame may be the last one for a while.
+				if(render_mode_ == RENDERMODE_ON_DEMAND) {
+					renderer_->Present();
+				}
+				else {
+					present_pending_ = true;
+				}
+
+				renderer_->set_need_to_render(false);
+			}
+
+			FinishRenderClient(&timer);
 		}
 	}
 
+	void Client::FinishRenderClient(ElapsedTimeTimer* timer) {
+		// Call post render callback.
+		profiler_->ProfileStart("Post-render callback");
+		post_render_callback_manager_.Run(render_event_);
+		profiler_->ProfileStop("Post-render callback");
+		// Update Render stats.
+		render_event_.set_elapsed_time(
+		    render_elapsed_time_timer_.GetElapsedTimeAndReset());
+		render_event_.set_render_time(total_time_to_render_);
+		render_event_.set_transforms_culled(renderer_->transforms_culled());
+		render_event_.set_transforms_processed(renderer_->transforms_processed());
+		render_event_.set_draw_elements_culled(renderer_->draw_elements_culled());
+		render_event_.set_draw_elements_processed(
+		    renderer_->draw_elements_processed());
+		render_event_.set_draw_elements_rendered(
+		    renderer_->draw_elements_rendered());
+		render_event_.set_primitives_rendered(renderer_->primitives_rendered());
+		render_event_.set_active_time(
+		    timer->GetElapsedTimeAndReset() + last_tick_time_);
+		last_tick_time_ = 0.0f;
+	}
+
 	void Client::RenderClient(bool send_callback) {
 		if(!renderer_.IsAvailable())
 			return;
@@ -324,12 +459,14 @@ namespace o3d {
 
 		if(!renderer_->StartRendering()) return 0;
 
+		// Picking gives new ids to the pickable objects.
+		InvalidatePickBuffer();
 		ParamObject* result = 0;
 
 		if(renderer_->BeginDraw()) {
 			RenderContext render_context(renderer_.Get());
 			renderer_->StartPicking(window_x, window_y);
-			render_graph_root()->RenderTree(&render_context);
+			render_graph_schedule_.Render(render_graph_root(), &render_context);
 			draw_list_manager_.Reset();
 			result = renderer_->FinishPicking();
 			renderer_->EndDraw();
@@ -345,6 +482,135 @@ namespace o3d {
 		return result;
 	}
 
+	bool Client::UpdatePickBuffer(bool asynchronous) {
+		InvalidatePickBuffer();
+
+		if(!render_graph_root() || !renderer_.IsAvailable()) return false;
+
+		const int width = renderer_->width();
+		const int height = renderer_->height();
+
+		if(width <= 0 || height <= 0) return false;
+
+		if(pick_texture_.IsNull() ||
+		        pick_texture_->width() != width ||
+		        pick_texture_->height() != height) {
+			pick_texture_ = renderer_->CreateTexture2D(width, height, Texture::ARGB8, 1, true);
+
+			if(pick_texture_.IsNull()) return false;
+
+			pick_surface_ = pick_texture_->GetRenderSurface(0);
+			pick_depth_surface_ = renderer_->CreateDepthStencilSurface(width, height);
+
+			if(pick_surface_.IsNull() || pick_depth_surface_.IsNull()) {
+				pick_texture_.Reset();
+				return false;
+			}
+		}
+
+		if(!renderer_->StartRendering()) return false;
+
+		// The pick surfaces stand for the back buffer, for the render graph to
+		// go back to after rendering to its own surfaces.
+		renderer_->SetRenderSurfaces(pick_surface_, pick_depth_surface_, true);
+
+		if(renderer_->BeginDraw()) {
+			RenderContext render_context(renderer_.Get());
+			renderer_->StartPickBuffer();
+			render_graph_schedule_.Render(render_graph_root(), &render_context);
+			draw_list_manager_.Reset();
+			renderer_->FinishPickBuffer();
+			renderer_->EndDraw();
+			pick_buffer_valid_ = true;
+			pick_buffer_change_count_ = evaluation_counter_->change_count();
+
+			if(asynchronous) {
+				pick_buffer_pending_ = true;
+			}
+			else {
+				renderer_->ReadPickBuffer(&pick_buffer_);
+			}
+		}
+
+		renderer_->SetRenderSurfaces(NULL, NULL, false);
+		renderer_->FinishRendering();
+		return pick_buffer_valid_;
+	}
+
+	void Client::InvalidatePickBuffer() {
+		pick_buffer_valid_ = false;
+		pick_buffer_pending_ = false;
+		pick_buffer_.Clear();
+	}
+
+	bool Client::IsPickBufferValid() const {
+		return pick_buffer_valid_ &&
+		       pick_buffer_change_count_ == evaluation_counter_->change_count() &&
+		       renderer_.IsAvailable() &&
+		       !pick_texture_.IsNull() &&
+		       pick_texture_->width() == renderer_->width() &&
+		       pick_texture_->height() == renderer_->height();
+	}
+
+	bool Client::PreparePickBuffer() {
+		if(!IsPickBufferValid() && !UpdatePickBuffer(false)) return false;
+
+		if(pick_buffer_pending_) {
+			pick_buffer_pending_ = false;
+
+			if(!renderer_->StartRendering()) {
+				InvalidatePickBuffer();
+				return false;
+			}
+
+			renderer_->SetRenderSurfaces(pick_surface_, pick_depth_surface_, true);
+			renderer_->ReadPickBuffer(&pick_buffer_);
+			renderer_->SetRenderSurfaces(NULL, NULL, false);
+			renderer_->FinishRendering();
+		}
+
+		return !pick_buffer_.empty();
+	}
+
+	ParamObject* Client::PickFromBuffer(int window_x, int window_y) {
+		if(!PreparePickBuffer()) return 0;
+
+		return renderer_->pickable_registry()->Lookup(
+		           pick_buffer_.GetId(window_x, window_y));
+	}
+
+	void Client::PickFromBuffer(const std::vector<std::pair<int, int> >& points,
+	                            std::vector<ParamObject*>* results) {
+		results->assign(points.size(), NULL);
+
+		if(!PreparePickBuffer()) return;
+
+		const PickableRegistry* registry = renderer_->pickable_registry();
+
+		for(size_t ii = 0; ii < points.size(); ++ii) {
+			(*results)[ii] = registry->Lookup(
+			                     pick_buffer_.GetId(points[ii].first, points[ii].second));
+		}
+	}
+
+	void Client::PickFromBuffer(int window_x,
+	                            int window_y,
+	                            int width,
+	                            int height,
+	                            std::vector<ParamObject*>* results) {
+		results->clear();
+
+		if(!PreparePickBuffer()) return;
+
+		const PickableRegistry* registry = renderer_->pickable_registry();
+		std::vector<PickBuffer::Id> ids;
+		pick_buffer_.GetIdsInRect(window_x, window_y, width, height, &ids);
+
+		for(size_t ii = 0; ii < ids.size(); ++ii) {
+			results->push_back(registry->Lookup(ids[ii]));
+		}
+	}
+
 // Executes draw calls for all visible shapes in a subtree
 	void Client::RenderTree(RenderNode* tree_root) {
 		if(!renderer_.IsAvailable())
@@ -368,7 +634,7 @@ namespace o3d {
 			RenderContext render_context(renderer_.Get());
 
 			if(tree_root) {
-				tree_root->RenderTree(&render_context);
+				render_graph_schedule_.Render(tree_root, &render_context);
 			}
 
 			draw_list_manager_.Reset();
@@ -434,6 +700,10 @@ namespace o3d {
 
 	void Client::set_render_mode(RenderMode render_mode) {
 		render_mode_ = render_mode;
+
+		if(render_mode_ == RENDERMODE_ON_DEMAND) {
+			PresentPendingFrame();
+		}
 	}
 
 	void Client::SetPostRenderCallback(RenderCallback* post_render_callback) {
@@ -53,7 +53,9 @@
 #include "core/cross/semantic_manager.h"
 #include "core/cross/transformation_context.h"
 #include "core/cross/picking_context.h"
+#include "core/cross/pick_buffer.h"
 #include "core/cross/render_node.h"
+#include "core/cross/render_graph_schedule.h"
 #include "core/cross/callback.h"
 #include "core/cross/event.h"
 #include "core/cross/event_callback.h"
@@ -61,6 +63,7 @@
 #include "core/cross/lost_resource_callback.h"
 #include "core/cross/render_event.h"
 #include "core/cross/render_surface.h"
+#include "core/cross/texture.h"
 #include "core/cross/tick_event.h"
 #include "core/cross/timer.h"
 #include "core/cross/timingtable.h"
@@ -70,6 +73,7 @@ namespace o3d {
 	class Profiler;
 	class State;
 	class Pack;
+	class WorkerPool;
 
 // The Client class is the main point of entry to O3D.  It defines methods
 // for creating and deleting packs and internal use only methods for creating
@@ -259,9 +263,65 @@ namespace o3d {
 		//       go.
 		void RenderClient(bool send_callback);
 
+		// Turns pipelined rendering on or off. When it is on, RenderClient
+		// traverses the transform graph and sorts the draw lists of the frame on
+		// a worker thread while the rendering thread presents the previous
+		// frame. In RENDERMODE_CONTINUOUS each frame is therefore presented by
+		// the following RenderClient, one frame later. In RENDERMODE_ON_DEMAND
+		// no other frame may follow, so each frame is presented by the
+		// RenderClient that renders it, and nothing overlaps. The render
+		// callback is the point where the scene is edited for the frame: it
+		// runs before the worker starts, outside of rendering, and must not
+		// call RenderTree. The worker is done by the time RenderClient returns,
+		// so the scene can also be edited between RenderClient calls. Turning
+		// it off, or switching to RENDERMODE_ON_DEMAND, presents the pending
+		// frame.
+		//
+		// Only presentation overlaps with the preparation of the next frame:
+		// submitting a frame evaluates params and reads the draw lists on the
+		// rendering thread, after the worker is done with them, since neither
+		// param evaluation nor the param caches are safe to use from two
+		// threads.
+		void set_pipelined(bool pipelined);
+
+		bool pipelined() const {
+			return pipeline_pool_.get() != NULL;
+		}
+
+		// The order the render graph renders in, for inspection.
+		RenderGraphSchedule* render_graph_schedule() {
+			return &render_graph_schedule_;
+		}
+
 		// Picking
 		ParamObject* Pick(int window_x, int window_y);
 
+		// ID buffer picking. UpdatePickBuffer renders the ids of the pickable
+		// objects over the whole view, once, into an offscreen buffer. The
+		// PickFromBuffer functions then answer any number of queries from it,
+		// updating it first if needed, until the view is resized, a Param is
+		// set or bound, the transform graph changes, or InvalidatePickBuffer
+		// is called. With |asynchronous|, the ids are read back at the first
+		// query rather than right away, which gives the GPU time to finish
+		// the pass.
+		bool UpdatePickBuffer(bool asynchronous);
+		void InvalidatePickBuffer();
+		bool IsPickBufferValid() const;
+
+		// Returns the object at the window coordinates, or NULL.
+		ParamObject* PickFromBuffer(int window_x, int window_y);
+
+		// Sets |results| to the object at each point, NULL where there is none.
+		void PickFromBuffer(const std::vector<std::pair<int, int> >& points,
+		                    std::vector<ParamObject*>* results);
+
+		// Sets |results| to the distinct objects seen in the rectangle.
+		void PickFromBuffer(int window_x,
+		                    int window_y,
+		                    int width,
+		                    int height,
+		                    std::vector<ParamObject*>* results);
+
 
 		// Sets the texture to use when a Texture or Sampler is missing while
 		// rendering. If you set it to NULL you'll get an error if you try to render
@@ -436,12 +496,30 @@ namespace o3d {
 		    RenderDepthStencilSurface::Ref depth_surface);
 
 	private:
+		class PrepareFrameTask;
+
 		// Renders the client.
 		void RenderClientInner(bool present, bool send_callback);
 
+		// Renders the client with the render graph prepared on the pipeline
+		// thread while the previous frame is presented.
+		void RenderClientPipelined(bool present, bool send_callback);
+
+		// Presents the frame rendered with pipelining that is still to be, if
+		// any.
+		void PresentPendingFrame();
+
+		// Runs the post render callback and updates the render event after a
+		// frame was rendered.
+		void FinishRenderClient(ElapsedTimeTimer* timer);
+
 		// Gets a screenshot.
 		std::string GetScreenshotAsDataURL();
 
+		// Updates the pick buffer if it isn't valid, and reads it back if an
+		// asynchronous update left it on the GPU. Returns false if it has no ids.
+		bool PreparePickBuffer();
+
 		ServiceLocator* service_locator_;
 		ServiceDependency<ObjectManager> object_manager_;
 		ErrorStatus error_status_;
@@ -499,6 +577,15 @@ namespace o3d {
 		// Global Render Graph root for Client.
 		RenderNode::Ref rendergraph_root_;
 
+		// Flattened render graph, compiled again when the graph changes.
+		RenderGraphSchedule render_graph_schedule_;
+
+		// The thread preparing the frames when rendering is pipelined.
+		base::scoped_ptr<WorkerPool> pipeline_pool_;
+
+		// A frame was rendered with pipelining and is still to be presented.
+		bool present_pending_;
+
 		ParamObject::Ref sas_param_object_;
 
 		// The id of the client.
@@ -509,6 +596,17 @@ namespace o3d {
 		RenderSurface::Ref offscreen_render_surface_;
 		RenderDepthStencilSurface::Ref offscreen_depth_render_surface_;
 
+		// The ID buffer, rendered into |pick_texture_|.
+		PickBuffer pick_buffer_;
+		Texture2D::Ref pick_texture_;
+		RenderSurface::Ref pick_surface_;
+		RenderDepthStencilSurface::Ref pick_depth_surface_;
+		bool pick_buffer_valid_;
+		// The ids are still to be read back.
+		bool pick_buffer_pending_;
+		// The change count of the scene the pick buffer was rendered from.
+		int pick_buffer_change_count_;
+
 		O3D_DISALLOW_COPY_AND_ASSIGN(Client);
 	};  // Client
 
@@ -36,6 +36,8 @@
 #include "tests/common/win/testing_common.h"
 #include "core/cross/pack.h"
 #include "core/cross/buffer.h"
+#include "core/cross/renderer.h"
+#include "core/cross/tree_traversal.h"
 
 namespace o3d {
 
@@ -194,6 +196,79 @@ namespace o3d {
 		EXPECT_TRUE(object_manager_->GetById<Effect>(id2) == e2);
 	}
 
+// Picking ---------------------------------------------------------------------
+
+// Tests that the pick buffer is rendered again once the scene changes, and
+// only then.
+	TEST_F(ClientBasic, PickBufferFollowsSceneChanges) {
+		g_renderer->Resize(16, 16);
+		Transform* transform = pack()->Create<Transform>();
+		transform->SetParent(client()->root());
+		ASSERT_TRUE(client()->UpdatePickBuffer(false));
+		EXPECT_TRUE(client()->IsPickBufferValid());
+		// Neither ticking nor rendering changes what would be picked.
+		client()->Tick();
+		client()->RenderClient(false);
+		EXPECT_TRUE(client()->IsPickBufferValid());
+
+		// Moving an object does.
+		transform->set_local_matrix(
+		    Matrix4::translation(Vector3(1.0f, 0.0f, 0.0f)));
+		EXPECT_FALSE(client()->IsPickBufferValid());
+		// The next pick renders the buffer again.
+		client()->PickFromBuffer(8, 8);
+		EXPECT_TRUE(client()->IsPickBufferValid());
+
+		// So does changing the transform graph.
+		Transform* child = pack()->Create<Transform>();
+		child->SetParent(transform);
+		EXPECT_FALSE(client()->IsPickBufferValid());
+		client()->PickFromBuffer(8, 8);
+		EXPECT_TRUE(client()->IsPickBufferValid());
+		transform->SetParent(NULL);
+	}
+
+// Tests when frames rendered with pipelining are presented, and that the
+// transform graph is still traversed.
+	TEST_F(ClientBasic, PipelinedRendering) {
+		Transform* transform = pack()->Create<Transform>();
+		transform->SetParent(client()->root());
+		TreeTraversal* tree_traversal = pack()->Create<TreeTraversal>();
+		tree_traversal->set_transform(client()->root());
+		tree_traversal->SetParent(client()->render_graph_root());
+		client()->set_pipelined(true);
+		ASSERT_TRUE(client()->pipelined());
+		int presented = g_renderer->present_count();
+
+		// Continuously, each frame is presented by the next one.
+		client()->RenderClient(false);
+		EXPECT_EQ(presented, g_renderer->present_count());
+		EXPECT_LT(0, g_renderer->transforms_processed());
+		client()->RenderClient(false);
+		EXPECT_EQ(presented + 1, g_renderer->present_count());
+
+		// The frame left is presented when switching to on demand, and frames
+		// on demand are presented right away.
+		client()->set_render_mode(Client::RENDERMODE_ON_DEMAND);
+		EXPECT_EQ(presented + 2, g_renderer->present_count());
+		client()->Render();
+		client()->RenderClient(false);
+		EXPECT_EQ(presented + 3, g_renderer->present_count());
+		EXPECT_FALSE(g_renderer->need_to_render());
+
+		// Turning pipelining off presents the frame left.
+		client()->set_render_mode(Client::RENDERMODE_CONTINUOUS);
+		client()->RenderClient(false);
+		EXPECT_EQ(presented + 3, g_renderer->present_count());
+		client()->set_pipelined(false);
+		EXPECT_FALSE(client()->pipelined());
+		EXPECT_EQ(presented + 4, g_renderer->present_count());
+		client()->RenderClient(false);
+		EXPECT_EQ(presented + 5, g_renderer->present_count());
+		tree_traversal->SetParent(NULL);
+		transform->SetParent(NULL);
+	}
+
 // Scenegraph tree -------------------------------------------------------------
 
 // Scenegraph tree test fixture.  Creates a Client object and
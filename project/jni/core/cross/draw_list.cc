@@ -40,7 +40,9 @@
 #include "core/cross/material.h"
 #include "core/cross/element.h"
 #include "core/cross/draw_element.h"
+#include "core/cross/frame_profiler.h"
 #include "core/cross/render_context.h"
+#include "core/cross/transform.h"
 
 namespace o3d {
 
@@ -55,7 +57,8 @@ namespace o3d {
 			: element_(NULL),
 			  draw_element_(NULL),
 			  material_(NULL),
-			  override_(NULL) {
+			  override_(NULL),
+			  instance_(NULL) {
 		}
 
 		void Set(const Matrix4& world,
@@ -65,7 +68,8 @@ namespace o3d {
 		         Material* material,
 		         ParamObject* override,
 		         ParamObject* pickable,
-		         ParamCache* param_cache) {
+		         ParamCache* param_cache,
+		         Transform* instance) {
 			world_ = world;
 			world_view_projection_ = world_view_projection;
 			draw_element_ = draw_element;
@@ -74,6 +78,7 @@ namespace o3d {
 			override_ = override;
 			pickable_ = pickable;
 			param_cache_ = param_cache;
+			instance_ = instance;
 			priority_ = element->priority();
 			effect_ = material->effect();
 			state_ = material->state();
@@ -94,6 +99,9 @@ namespace o3d {
 		inline State* state() const {
 			return state_;
 		}
+		inline Transform* instance() const {
+			return instance_;
+		}
 		void ComputeZValue(TransformationContext* transformation_context) {
 			if(element_->ParamsUsedByZSortHaveInputConnetions()) {
 				transformation_context->set_world(world_);
@@ -126,6 +134,7 @@ namespace o3d {
 		ParamObject* override_;
 		ParamObject* pickable_;
 		ParamCache* param_cache_;
+		Transform* instance_;
 		float priority_;  // pulled out for sorting
 		float z_value_;  // pulled out for sorting
 		Effect* effect_;  // pulled out for sorting
@@ -142,6 +151,8 @@ namespace o3d {
 		  projection_(Matrix4::identity()),
 		  top_draw_element_info_(0),
 		  global_index_(0),
+		  sorted_(false),
+		  sort_method_(BY_PERFORMANCE),
 		  weak_pointer_manager_(this) {
 		DrawListManager* draw_list_manager =
 		    service_locator->GetService<DrawListManager>();
@@ -174,6 +185,7 @@ namespace o3d {
 		view_ = view;
 		projection_ = projection;
 		top_draw_element_info_ = 0;
+		sorted_ = false;
 	}
 
 	void DrawList::AddDrawElement(DrawElement* draw_element,
@@ -182,7 +194,8 @@ namespace o3d {
 	                              ParamObject* override,
 	                              ParamCache* param_cache,
 	                              const Matrix4& world,
-	                              const Matrix4& world_view_projection) {
+	                              const Matrix4& world_view_projection,
+	                              Transform* instance) {
 		// DrawElementInfos only get created once and then reused forever. Then never
 		// get freed until the DrawList gets destroyed. This saves lots of
 		// allocations/deallocation that would otherwise happen every frame.
@@ -198,6 +211,7 @@ namespace o3d {
 			draw_element_infos_.push_back(new DrawElementInfo());
 		}
 
+		sorted_ = false;
 		DrawElementInfo* pass_element =
 		    draw_element_infos_[top_draw_element_info_++];
 		pass_element->Set(world,
@@ -207,7 +221,8 @@ namespace o3d {
 		                  material,
 		                  override,
 		                  picking_context_->pickable(),
-		                  param_cache);
+		                  param_cache,
+		                  instance);
 	}
 
 	inline static bool CompareByPriority(const DrawElementInfo* lhs,
@@ -228,11 +243,19 @@ namespace o3d {
 			return effectDif < 0;
 		}
 
-		return (lhs->state() - rhs->state()) < 0;
+		if(lhs->state() != rhs->state()) {
+			return (lhs->state() - rhs->state()) < 0;
+		}
+
+		// Keeps the elements of an instance together, so that its state is
+		// applied once.
+		return lhs->instance() < rhs->instance();
 	}
 
 	void DrawList::Render(RenderContext* render_context,
 	                      SortMethod sort_method) {
+		O3D_PROFILE_ZONE("DrawList::Render");
+
 		if(top_draw_element_info_ > 0) {
 			// Set the view and projection to what they where when these draw elements
 			// were put on this draw list.
@@ -242,37 +265,75 @@ namespace o3d {
 			    transformation_context_->projection() *
 			    transformation_context_->view());
 
-			switch(sort_method) {
-			case BY_Z_ORDER: {
-					// Compute a Z value for each entry
-					for(unsigned ii = 0; ii < top_draw_element_info_; ++ii) {
-						draw_element_infos_[ii]->ComputeZValue(transformation_context_);
-					}
-
-					std::stable_sort(draw_element_infos_.begin(),
-					                 draw_element_infos_.begin() + top_draw_element_info_,
-					                 CompareByZValue);
-					break;
-				}
-			case BY_PRIORITY:
-				std::sort(draw_element_infos_.begin(),
-				          draw_element_infos_.begin() + top_draw_element_info_,
-				          CompareByPriority);
-				break;
-			default:  // BY_PERFORMANCE
-				std::sort(draw_element_infos_.begin(),
-				          draw_element_infos_.begin() + top_draw_element_info_,
-				          CompareByPerformance);
-				break;
+			if(!sorted_ || sort_method != sort_method_) {
+				SortElements(render_context, sort_method);
 			}
 
 			// TODO: Since the ViewProjection never changes for this entire
 			//    list we could optmize by storing it in the client and changing
 			//    the SAS stuff to use that one.
+			Transform* instance = NULL;
+
 			for(unsigned ii = 0; ii < top_draw_element_info_; ++ii) {
-				draw_element_infos_[ii]->Render(render_context, transformation_context_);
+				DrawElementInfo* draw_element_info = draw_element_infos_[ii];
+
+				// The prototype still has the state of the last instance walked.
+				if(draw_element_info->instance() &&
+				        draw_element_info->instance() != instance) {
+					instance = draw_element_info->instance();
+					instance->ApplyInstanceState();
+				}
+
+				draw_element_info->Render(render_context, transformation_context_);
+			}
+		}
+	}
+
+	void DrawList::Sort(RenderContext* render_context, SortMethod sort_method) {
+		if(sorted_ || top_draw_element_info_ == 0) {
+			return;
+		}
+
+		transformation_context_->set_view(view_);
+		transformation_context_->set_projection(projection_);
+		transformation_context_->set_view_projection(
+		    transformation_context_->projection() *
+		    transformation_context_->view());
+		SortElements(render_context, sort_method);
+	}
+
+	void DrawList::SortElements(RenderContext* render_context,
+	                            SortMethod sort_method) {
+		uint64_t sort_start = FrameProfiler::GetTimeNs();
+
+		switch(sort_method) {
+		case BY_Z_ORDER: {
+				// Compute a Z value for each entry
+				for(unsigned ii = 0; ii < top_draw_element_info_; ++ii) {
+					draw_element_infos_[ii]->ComputeZValue(transformation_context_);
+				}
+
+				std::stable_sort(draw_element_infos_.begin(),
+				                 draw_element_infos_.begin() + top_draw_element_info_,
+				                 CompareByZValue);
+				break;
 			}
+		case BY_PRIORITY:
+			std::sort(draw_element_infos_.begin(),
+			          draw_element_infos_.begin() + top_draw_element_info_,
+			          CompareByPriority);
+			break;
+		default:  // BY_PERFORMANCE
+			std::sort(draw_element_infos_.begin(),
+			          draw_element_infos_.begin() + top_draw_element_info_,
+			          CompareByPerformance);
+			break;
 		}
+
+		sorted_ = true;
+		sort_method_ = sort_method;
+		render_context->renderer()->render_stats()->AddTimeSince(
+		    RenderStats::SORT_TIME, sort_start);
 	}
 
 	ObjectBase::Ref ParamDrawList::Create(ServiceLocator* service_locator) {
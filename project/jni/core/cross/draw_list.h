@@ -50,6 +50,7 @@ namespace o3d {
 	class ParamObject;
 	class ParamCache;
 	class RenderContext;
+	class Transform;
 
 // A DrawList is a list of things to render. It is filled out by a TreeTraversal
 // and is rendered by a DrawPass. A single DrawList can be filled out / added to
@@ -82,17 +83,32 @@ namespace o3d {
 		//   world: World Matrix to render this DrawElement.
 		//   world_view_projection: World View Projection Matrix to render this
 		//       DrawElement.
+		//   instance: Transform whose prototype this DrawElement is drawn for,
+		//       or NULL.
 		void AddDrawElement(DrawElement* draw_element,
 		                    Element* element,
 		                    Material* material,
 		                    ParamObject* override,
 		                    ParamCache* param_cache,
 		                    const Matrix4& world,
-		                    const Matrix4& world_view_projection);
+		                    const Matrix4& world_view_projection,
+		                    Transform* instance);
 
-		// Render the elements of this DrawList.
+		// Render the elements of this DrawList. The state of each instance is
+		// applied again to its prototype before the elements drawn for it,
+		// since the Params they use are only evaluated now.
 		void Render(RenderContext* render_context, SortMethod sort_method);
 
+		// Sorts the elements of this DrawList ahead of Render, unless they were
+		// already sorted since the last Reset or AddDrawElement. Render then
+		// doesn't sort them again if it is called with the same method.
+		void Sort(RenderContext* render_context, SortMethod sort_method);
+
+		// Whether nothing was added since the last Reset.
+		bool empty() const {
+			return top_draw_element_info_ == 0;
+		}
+
 		// Return the global index for this DrawList.
 		unsigned int global_index() {
 			return global_index_;
@@ -106,6 +122,9 @@ namespace o3d {
 	private:
 		explicit DrawList(ServiceLocator* service_locator);
 
+		// Sorts the elements with the transformation context set up for them.
+		void SortElements(RenderContext* render_context, SortMethod sort_method);
+
 		friend class IClassManager;
 		static ObjectBase::Ref Create(ServiceLocator* service_locator);
 
@@ -130,6 +149,10 @@ namespace o3d {
 		// Index of this draw list in the client for quick lookup.
 		unsigned int global_index_;
 
+		// Whether the elements are sorted, and by which method.
+		bool sorted_;
+		SortMethod sort_method_;
+
 		// Manager for weak pointers to us.
 		WeakPointerType::WeakPointerManager weak_pointer_manager_;
 
@@ -37,6 +37,7 @@
 #include "core/cross/draw_list_manager.h"
 #include "core/cross/object_manager.h"
 #include "core/cross/pack.h"
+#include "core/cross/picking_context.h"
 #include "core/cross/service_dependency.h"
 #include "core/cross/transformation_context.h"
 
@@ -58,17 +59,20 @@ namespace o3d {
 		ServiceDependency<ObjectManager> object_manager_;
 		DrawListManager* draw_list_manager_;
 		TransformationContext* transformation_context_;
+		PickingContext* picking_context_;
 		Pack* pack_;
 	};
 
 	void DrawListTest::SetUp() {
 		draw_list_manager_ = new DrawListManager(g_service_locator);
 		transformation_context_ = new TransformationContext(g_service_locator);
+		picking_context_ = new PickingContext(g_service_locator);
 		pack_ = object_manager_->CreatePack();
 	}
 
 	void DrawListTest::TearDown() {
 		pack_->Destroy();
+		delete picking_context_;
 		delete transformation_context_;
 		delete draw_list_manager_;
 	}
@@ -34,6 +34,7 @@
 
 #include "core/cross/draw_pass.h"
 #include "core/cross/draw_list.h"
+#include "core/cross/renderer.h"
 #include "core/cross/transformation_context.h"
 
 namespace o3d {
@@ -54,14 +55,25 @@ namespace o3d {
 	void DrawPass::Render(RenderContext* render_context) {
 		DrawList* drawlist = draw_list();
 
-		if(!drawlist) {
+		// Nothing to draw, nor to count as a pass.
+		if(!drawlist || drawlist->empty()) {
 			return;
 		}
 
+		ScopedRenderStatsPass stats_pass(
+		    render_context->renderer()->render_stats(), id(), name());
 		// Draw the elements of this list.
 		drawlist->Render(render_context, sort_method());
 	}
 
+	void DrawPass::Prepare(RenderContext* render_context) {
+		DrawList* drawlist = draw_list();
+
+		if(drawlist) {
+			drawlist->Sort(render_context, sort_method());
+		}
+	}
+
 	ObjectBase::Ref DrawPass::Create(ServiceLocator* service_locator) {
 		return ObjectBase::Ref(new DrawPass(service_locator));
 	}
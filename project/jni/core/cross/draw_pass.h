@@ -77,6 +77,9 @@ namespace o3d {
 		// Renders this DrawPass.
 		void Render(RenderContext* render_context);
 
+		// Sorts the DrawList, unless it already is.
+		void Prepare(RenderContext* render_context);
+
 	private:
 		explicit DrawPass(ServiceLocator* service_locator);
 
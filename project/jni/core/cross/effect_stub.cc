@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "core/cross/effect_stub.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <vector>
+#include "core/cross/error.h"
+#include "core/cross/param.h"
+#include "core/cross/sampler.h"
+#include "core/cross/semantic_manager.h"
+#include "core/cross/gles2/utils_gles2.h"
+
+namespace o3d {
+
+	namespace {
+
+		const char* kSplitMarker = "// #o3d SplitMarker";
+
+		// The Param class of a GLSL type, or NULL for the types that the GLES2
+		// renderer can't set either.
+		const ObjectBase::Class* GLSLTypeToParamType(const std::string& type) {
+			if(type == "float") {
+				return ParamFloat::GetApparentClass();
+			}
+			else if(type == "vec2") {
+				return ParamFloat2::GetApparentClass();
+			}
+			else if(type == "vec3") {
+				return ParamFloat3::GetApparentClass();
+			}
+			else if(type == "vec4") {
+				return ParamFloat4::GetApparentClass();
+			}
+			else if(type == "int") {
+				return ParamInteger::GetApparentClass();
+			}
+			else if(type == "bool") {
+				return ParamBoolean::GetApparentClass();
+			}
+			else if(type == "mat4") {
+				return ParamMatrix4::GetApparentClass();
+			}
+			else if(type == "sampler2D" || type == "samplerCube") {
+				return ParamSampler::GetApparentClass();
+			}
+
+			return NULL;
+		}
+
+		// Replaces comments with spaces.
+		std::string StripComments(const std::string& source) {
+			std::string stripped(source);
+			std::string::size_type position = 0;
+
+			while((position = stripped.find('/', position)) != std::string::npos &&
+			        position + 1 < stripped.size()) {
+				std::string::size_type end;
+
+				if(stripped[position + 1] == '/') {
+					end = stripped.find('\n', position);
+				}
+				else if(stripped[position + 1] == '*') {
+					end = stripped.find("*/", position + 2);
+					end = end == std::string::npos ? end : end + 2;
+				}
+				else {
+					++position;
+					continue;
+				}
+
+				end = end == std::string::npos ? stripped.size() : end;
+				stripped.replace(position, end - position, end - position, ' ');
+				position = end;
+			}
+
+			return stripped;
+		}
+
+		// Splits a statement into words, with "[", "]" and "," on their own.
+		void Tokenize(const std::string& statement,
+		              std::vector<std::string>* tokens) {
+			std::string token;
+
+			for(std::string::size_type ii = 0; ii <= statement.size(); ++ii) {
+				char c = ii < statement.size() ? statement[ii] : ' ';
+
+				if(c == '[' || c == ']' || c == ',' || isspace(c)) {
+					if(!token.empty()) {
+						tokens->push_back(token);
+						token.clear();
+					}
+
+					if(!isspace(c)) {
+						tokens->push_back(std::string(1, c));
+					}
+				}
+				else {
+					token += c;
+				}
+			}
+		}
+
+		bool IsPrecision(const std::string& token) {
+			return token == "lowp" || token == "mediump" || token == "highp";
+		}
+
+	}  // anonymous namespace
+
+	EffectStub::EffectStub(ServiceLocator* service_locator)
+		: Effect(service_locator),
+		  semantic_manager_(service_locator->GetService<SemanticManager>()) {
+	}
+
+	bool EffectStub::LoadFromFXString(const std::string& effect) {
+		parameters_.clear();
+		streams_.clear();
+		set_source("");
+		std::string::size_type order = effect.find(kMatrixLoadOrderPrefix);
+
+		if(order == std::string::npos) {
+			O3D_ERROR(service_locator()) << "Failed to find \""
+			                             << kMatrixLoadOrderPrefix
+			                             << "\" in Effect";
+			return false;
+		}
+
+		if(effect.find(kSplitMarker) == std::string::npos) {
+			O3D_ERROR(service_locator()) << "Missing '" << kSplitMarker
+			                             << "' in shader: " << effect;
+			return false;
+		}
+
+		order += strlen(kMatrixLoadOrderPrefix);
+		set_matrix_load_order(
+		    effect.compare(order, 11, "ColumnMajor") == 0 ? COLUMN_MAJOR : ROW_MAJOR);
+		// Uniforms are often declared by both shaders, and a program reports
+		// them once, sorted by name.
+		std::map<std::string, EffectParameterInfo> parameters;
+		// Declarations are the statements that start with "uniform" or
+		// "attribute", wherever they are: "{" and "}" end statements too.
+		std::string source(StripComments(effect));
+		std::string::size_type start = 0;
+
+		while(start < source.size()) {
+			std::string::size_type end = source.find_first_of(";{}", start);
+			end = end == std::string::npos ? source.size() : end;
+			std::vector<std::string> tokens;
+			Tokenize(source.substr(start, end - start), &tokens);
+			start = end + 1;
+			bool uniform = !tokens.empty() && tokens[0] == "uniform";
+
+			if(!uniform && (tokens.empty() || tokens[0] != "attribute")) {
+				continue;
+			}
+
+			size_t index = 1;
+
+			while(index < tokens.size() && IsPrecision(tokens[index])) {
+				++index;
+			}
+
+			if(index >= tokens.size()) {
+				continue;
+			}
+
+			const ObjectBase::Class* param_class = GLSLTypeToParamType(tokens[index]);
+
+			// The names, each optionally followed by an array size.
+			for(++index; index < tokens.size(); ++index) {
+				const std::string& name = tokens[index];
+
+				if(name == ",") {
+					continue;
+				}
+
+				int num_elements = 0;
+
+				if(index + 2 < tokens.size() && tokens[index + 1] == "[") {
+					num_elements = atoi(tokens[index + 2].c_str());
+					index += 3;
+				}
+
+				if(!uniform) {
+					Stream::Semantic semantic;
+					int semantic_index;
+
+					if(SemanticNameToSemantic(name, &semantic, &semantic_index)) {
+						streams_.push_back(EffectStreamInfo(semantic, semantic_index));
+					}
+				}
+				else if(param_class) {
+					const ObjectBase::Class* sem_class =
+					    semantic_manager_->LookupSemantic(name);
+					parameters[name] = EffectParameterInfo(
+					                       name,
+					                       param_class,
+					                       num_elements,
+					                       sem_class != NULL ? name : "",
+					                       sem_class);
+				}
+			}
+		}
+
+		std::map<std::string, EffectParameterInfo>::const_iterator it;
+
+		for(it = parameters.begin(); it != parameters.end(); ++it) {
+			parameters_.push_back(it->second);
+		}
+
+		set_source(effect);
+		return true;
+	}
+
+	void EffectStub::GetParameterInfo(EffectParameterInfoArray* info_array) {
+		O3D_ASSERT(info_array);
+		*info_array = parameters_;
+	}
+
+	void EffectStub::GetStreamInfo(EffectStreamInfoArray* info_array) {
+		O3D_ASSERT(info_array);
+		*info_array = streams_;
+	}
+
+}  // namespace o3d
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <string>
+#include "core/cross/effect.h"
+
+namespace o3d {
+
+	class SemanticManager;
+
+	// An Effect of the stub renderer. There is no GLSL compiler to ask, so the
+	// parameters and streams are read from the uniform and attribute
+	// declarations of the source. Unlike a linked program, this also reports
+	// declarations that the shaders don't use.
+	class EffectStub : public Effect {
+	public:
+		explicit EffectStub(ServiceLocator* service_locator);
+
+		// Overridden from Effect.
+		virtual bool LoadFromFXString(const std::string& effect);
+
+		// Overridden from Effect.
+		virtual void GetParameterInfo(EffectParameterInfoArray* info_array);
+
+		// Overridden from Effect.
+		virtual void GetStreamInfo(EffectStreamInfoArray* info_array);
+
+	private:
+		SemanticManager* semantic_manager_;
+		EffectParameterInfoArray parameters_;
+		EffectStreamInfoArray streams_;
+
+		O3D_DISALLOW_COPY_AND_ASSIGN(EffectStub);
+	};
+
+}  // namespace o3d
@@ -54,7 +54,8 @@ namespace o3d {
 
 	Element::Element(ServiceLocator* service_locator)
 		: ParamObject(service_locator),
-		  owner_(NULL) {
+		  owner_(NULL),
+		  bounding_box_dirty_(false) {
 		RegisterParamRef(kMaterialParamName, &material_param_ref_);
 		RegisterParamRef(kBoundingBoxParamName, &bounding_box_param_ref_);
 		RegisterParamRef(kPriorityParamName, &priority_param_ref_);
@@ -63,6 +64,9 @@ namespace o3d {
 	}
 
 	Element::~Element() {
+		if(!bounding_box_buffer_.IsNull()) {
+			bounding_box_buffer_->RemoveBoundingBoxElement(this);
+		}
 	}
 
 	void Element::SetOwner(Shape* new_owner) {
@@ -120,4 +124,39 @@ namespace o3d {
 		draw_element->SetOwner(this);
 		return draw_element;
 	}
+
+	void Element::UpdateBoundingBox() {
+		BoundingBox bounding_box;
+		GetBoundingBox(0, &bounding_box);
+		Point3 min_extent = bounding_box.min_extent();
+		Point3 max_extent = bounding_box.max_extent();
+		set_bounding_box(bounding_box);
+		set_z_sort_point(Float3(
+		                     (min_extent.getX() + max_extent.getX()) / 2.0f,
+		                     (min_extent.getY() + max_extent.getY()) / 2.0f,
+		                     (min_extent.getZ() + max_extent.getZ()) / 2.0f));
+		Buffer* buffer = GetPositionBuffer(0);
+
+		if(buffer != bounding_box_buffer_.Get()) {
+			if(!bounding_box_buffer_.IsNull()) {
+				bounding_box_buffer_->RemoveBoundingBoxElement(this);
+			}
+
+			bounding_box_buffer_ = Buffer::Ref(buffer);
+
+			if(buffer) {
+				buffer->AddBoundingBoxElement(this);
+			}
+		}
+
+		bounding_box_dirty_ = false;
+	}
+
+	void Element::MarkBoundingBoxDirty() {
+		bounding_box_dirty_ = true;
+
+		if(owner_) {
+			owner_->MarkBoundingBoxDirty();
+		}
+	}
 }  // namespace o3d
@@ -38,6 +38,7 @@
 #include <vector>
 #include "core/cross/param_object.h"
 #include "core/cross/bounding_box.h"
+#include "core/cross/buffer.h"
 #include "core/cross/ray_intersection_info.h"
 #include "core/cross/material.h"
 #include "core/cross/draw_element.h"
@@ -156,6 +157,22 @@ namespace o3d {
 		                    ParamObject* param_object,
 		                    ParamCache* param_cache) = 0;
 
+		// Gets the number of levels of detail this Element can be rendered
+		// with, not counting the full detail one.
+		virtual unsigned GetLodCount() const {
+			return 0;
+		}
+
+		// Picks the level of detail to render with, 0 being the full detail.
+		// Parameters:
+		//   screen_size: Projected size of the Element as a fraction of the
+		//       viewport.
+		//   current_lod: Level used for the previous frame, to avoid flipping
+		//       back and forth around a threshold.
+		virtual unsigned SelectLod(float screen_size, unsigned current_lod) const {
+			return 0;
+		}
+
 		// Adds a DrawElement to this Element.
 		// This is an internal function. Use DrawElement::SetOwner.
 		// Parameter:
@@ -222,6 +239,29 @@ namespace o3d {
 		virtual void GetBoundingBox(int position_stream_index,
 		                            BoundingBox* result) const = 0;
 
+		// Gets the buffer holding the specified POSITION stream, or NULL if
+		// there is none.
+		// Parameters:
+		//   position_stream_index: Index of POSITION stream.
+		virtual Buffer* GetPositionBuffer(int position_stream_index) const {
+			return NULL;
+		}
+
+		// Sets the bounding box and z sort point of this Element from the
+		// first POSITION stream, and keeps track of its buffer: the bounding
+		// box gets flagged as dirty each time the buffer is modified.
+		void UpdateBoundingBox();
+
+		// Returns true if the positions changed since the last call to
+		// UpdateBoundingBox().
+		bool bounding_box_dirty() const {
+			return bounding_box_dirty_;
+		}
+
+		// Flags the bounding box of this Element, and those of the transforms
+		// holding its owner, as needing to be recomputed.
+		void MarkBoundingBoxDirty();
+
 	protected:
 		explicit Element(ServiceLocator* service_locator);
 
@@ -238,6 +278,12 @@ namespace o3d {
 		// The Shape we are currently owned by.
 		Shape* owner_;
 
+		// Buffer the bounding box was last computed from.
+		Buffer::Ref bounding_box_buffer_;
+
+		// True if bounding_box_buffer_ was modified since.
+		bool bounding_box_dirty_;
+
 		O3D_DECL_CLASS(Element, ParamObject);
 		O3D_DISALLOW_COPY_AND_ASSIGN(Element);
 	};
@@ -45,11 +45,27 @@ namespace o3d {
 
 		explicit EvaluationCounter(ServiceLocator* service_locator)
 			: service_(service_locator, this),
-			  evaluation_count_(0) {}
+			  evaluation_count_(0),
+			  change_count_(0) {}
 
-		// Marks all parameters as so they will get re-evaluated
+		// Marks all parameters as so they will get re-evaluated, and counts a
+		// change.
 		void InvalidateAllParameters() {
 			++evaluation_count_;
+			++change_count_;
+		}
+
+		// Marks all parameters as so they will get re-evaluated without
+		// counting a change, for the values computed from outside the Params
+		// each tick.
+		void StartNewEvaluation() {
+			++evaluation_count_;
+		}
+
+		// Counts a change that no Param reflects, like a Transform being
+		// re-parented.
+		void CountChange() {
+			++change_count_;
 		}
 
 		// Gets the current global evaluation count.
@@ -57,11 +73,20 @@ namespace o3d {
 			return evaluation_count_;
 		}
 
+		// Gets the number of changes made to the Params or to the transform
+		// graph. What was drawn is still up to date while it stays the same.
+		int change_count() {
+			return change_count_;
+		}
+
 	private:
 		ServiceImplementation<EvaluationCounter> service_;
 
 		// The global evaluation count;
 		int evaluation_count_;
+
+		// The global change count.
+		int change_count_;
 	};
 }  // namespace o3d
 
@@ -34,6 +34,8 @@
 // unit testing and should not be compiled in with the plugin.
 
 #include "core/cross/fake_vertex_source.h"
+
+#include <limits.h>
 #include "core/cross/pointer_utils.h"
 #include "core/cross/buffer.h"
 
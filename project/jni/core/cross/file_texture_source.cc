@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/cross/file_texture_source.h"
+#include "core/cross/bitmap.h"
+#include "core/cross/error.h"
+#include "core/cross/file_resource.h"
+#include "core/cross/texture.h"
+
+namespace o3d {
+
+	FileTextureSource::FileTextureSource(const std::string& path)
+		: path_(path) {
+	}
+
+	bool FileTextureSource::RestoreTexture(Texture* texture) {
+		if(!texture->IsA(Texture2D::GetApparentClass())) {
+			O3D_ERROR(texture->service_locator())
+			        << "Only 2D textures can be restored from " << path_;
+			return false;
+		}
+
+		Texture2D* texture_2d = down_cast<Texture2D*>(texture);
+		BitmapRefArray bitmaps;
+		FileResource resource(path_);
+
+		if(!Bitmap::LoadFromExternalResource(texture->service_locator(), resource,
+		                                     image::UNKNOWN, &bitmaps) ||
+		        bitmaps.size() != 1) {
+			O3D_ERROR(texture->service_locator())
+			        << "Failed to load texture \"" << texture->name()
+			        << "\" from " << path_;
+			return false;
+		}
+
+		Bitmap* bitmap = bitmaps[0].Get();
+
+		// Makes the mips the same way Pack::CreateTextureFromBitmaps did.
+		if(bitmap->num_mipmaps() < static_cast<unsigned int>(texture->levels()) &&
+		        image::CanMakeMips(bitmap->format())) {
+			Bitmap::Ref new_bitmap(new Bitmap(texture->service_locator()));
+			new_bitmap->Allocate(bitmap->format(),
+			                     bitmap->width(),
+			                     bitmap->height(),
+			                     texture->levels(),
+			                     bitmap->semantic());
+			new_bitmap->SetRect(0, 0, 0, bitmap->width(), bitmap->height(),
+			                    bitmap->GetMipData(0), bitmap->GetMipPitch(0));
+			new_bitmap->GenerateMips(0, texture->levels() - 1);
+			bitmaps[0] = new_bitmap;
+			bitmap = new_bitmap.Get();
+		}
+
+		texture_2d->SetFromBitmap(*bitmap);
+		return true;
+	}
+
+}  // namespace o3d
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include "core/cross/texture_base.h"
+
+namespace o3d {
+
+	// Restores a 2D texture by loading its image file again, generating the
+	// mips the file doesn't have.
+	class FileTextureSource : public TextureSource {
+	public:
+		explicit FileTextureSource(const std::string& path);
+
+		// Overridden from TextureSource.
+		virtual bool RestoreTexture(Texture* texture);
+
+		const std::string& path() const {
+			return path_;
+		}
+
+	private:
+		std::string path_;
+
+		O3D_DISALLOW_COPY_AND_ASSIGN(FileTextureSource);
+	};
+
+}  // namespace o3d
@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/cross/frame_profiler.h"
+#include <pthread.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+#include "base/cross/lock.h"
+#include "utils/cross/structured_writer.h"
+
+namespace o3d {
+
+	namespace {
+
+		struct Event {
+			uint64_t time;
+			// Zone id, shifted left once, with the low bit set for the end of
+			// the zone.
+			unsigned zone;
+		};
+
+		// Events of a single thread. Only the thread writes events, and it
+		// publishes them by incrementing |head|; the exporter only moves
+		// |tail|. Buffers are freed when their thread exits, dropping the
+		// events that weren't exported yet.
+		struct ThreadEvents {
+			explicit ThreadEvents(unsigned thread_id)
+				: head(0),
+				  tail(0),
+				  id(thread_id) {
+			}
+
+			Event events[FrameProfiler::kEventsPerThread];
+			volatile unsigned head;
+			unsigned tail;
+			unsigned id;
+			// Begin events of the zones that were still running at the last
+			// export, innermost last. Only used by the exporter.
+			std::vector<Event> open;
+		};
+
+		struct ProfilerState {
+			ProfilerState()
+				: next_thread_id(1),
+				  epoch(0) {
+				pthread_key_create(&thread_events_key, &DeleteThreadEvents);
+			}
+
+			static void DeleteThreadEvents(void* events);
+
+			base::Lock lock;
+			std::vector<const ProfileZone*> zones;
+			std::vector<ThreadEvents*> threads;
+			pthread_key_t thread_events_key;
+			unsigned next_thread_id;
+			uint64_t epoch;
+		};
+
+		// Never destroyed, so that threads can still record during exit.
+		ProfilerState& GetState() {
+			static ProfilerState* state = new ProfilerState;
+			return *state;
+		}
+
+		ThreadEvents* GetThreadEvents() {
+			ProfilerState& state = GetState();
+			ThreadEvents* events = static_cast<ThreadEvents*>(
+			                           pthread_getspecific(state.thread_events_key));
+
+			if(!events) {
+				base::AutoLock lock(state.lock);
+				events = new ThreadEvents(state.next_thread_id++);
+				state.threads.push_back(events);
+				pthread_setspecific(state.thread_events_key, events);
+			}
+
+			return events;
+		}
+
+		void ProfilerState::DeleteThreadEvents(void* events) {
+			ProfilerState& state = GetState();
+			base::AutoLock lock(state.lock);
+			std::vector<ThreadEvents*>::iterator it =
+			    std::find(state.threads.begin(), state.threads.end(), events);
+
+			if(it != state.threads.end()) {
+				state.threads.erase(it);
+			}
+
+			delete static_cast<ThreadEvents*>(events);
+		}
+
+		inline void Record(unsigned zone) {
+			ThreadEvents* events = GetThreadEvents();
+			unsigned head = events->head;
+			Event& event = events->events[head % FrameProfiler::kEventsPerThread];
+			event.time = FrameProfiler::GetTimeNs();
+			event.zone = zone;
+			// Make sure the event is written before it is published.
+			__sync_synchronize();
+			events->head = head + 1;
+		}
+
+		void WriteEvent(StructuredWriter* writer,
+		                const ProfileZone* zone,
+		                unsigned thread_id,
+		                uint64_t begin,
+		                uint64_t end,
+		                uint64_t epoch) {
+			writer->BeginCompacting();
+			writer->OpenObject();
+			writer->WritePropertyName("name");
+			writer->WriteString(zone->name());
+			writer->WritePropertyName("ph");
+			writer->WriteString("X");
+			writer->WritePropertyName("pid");
+			writer->WriteInt(1);
+			writer->WritePropertyName("tid");
+			writer->WriteUnsignedInt(thread_id);
+			// Times are in microseconds. Durations keep the nanoseconds.
+			writer->WritePropertyName("ts");
+			writer->WriteUInt64((begin > epoch ? begin - epoch : 0) / 1000);
+			writer->WritePropertyName("dur");
+			writer->WriteFloat(static_cast<float>(end - begin) / 1000.0f);
+			writer->CloseObject();
+			writer->EndCompacting();
+		}
+
+	}  // anonymous namespace
+
+	volatile bool FrameProfiler::enabled_ = false;
+
+	ProfileZone::ProfileZone(const char* name)
+		: name_(name) {
+		ProfilerState& state = GetState();
+		base::AutoLock lock(state.lock);
+		id_ = state.zones.size();
+		state.zones.push_back(this);
+	}
+
+	void FrameProfiler::SetEnabled(bool enabled) {
+		ProfilerState& state = GetState();
+
+		if(enabled && !enabled_) {
+			base::AutoLock lock(state.lock);
+			state.epoch = GetTimeNs();
+
+			for(size_t ii = 0; ii < state.threads.size(); ++ii) {
+				ThreadEvents* events = state.threads[ii];
+				events->tail = events->head;
+				events->open.clear();
+			}
+		}
+
+		enabled_ = enabled;
+	}
+
+	uint64_t FrameProfiler::GetTimeNs() {
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		return now.tv_sec * 1000000000ULL + now.tv_nsec;
+	}
+
+	void FrameProfiler::BeginZone(const ProfileZone* zone) {
+		Record(zone->id() << 1);
+	}
+
+	void FrameProfiler::EndZone(const ProfileZone* zone) {
+		Record((zone->id() << 1) | 1);
+	}
+
+	void FrameProfiler::WriteTrace(StructuredWriter* writer) {
+		ProfilerState& state = GetState();
+		base::AutoLock lock(state.lock);
+		writer->OpenObject();
+		writer->WritePropertyName("traceEvents");
+		writer->OpenArray();
+
+		for(size_t tt = 0; tt < state.threads.size(); ++tt) {
+			ThreadEvents* events = state.threads[tt];
+			unsigned head = events->head;
+			__sync_synchronize();
+
+			// Events older than the size of the ring have been overwritten,
+			// and the zones they began can't be matched anymore. The slot of
+			// event |head| - kEventsPerThread is the one being written next.
+			if(head - events->tail >= kEventsPerThread) {
+				events->tail = head - kEventsPerThread + 1;
+				events->open.clear();
+			}
+
+			std::vector<Event> copied;
+			copied.reserve(head - events->tail);
+
+			for(unsigned ii = events->tail; ii != head; ++ii) {
+				copied.push_back(events->events[ii % kEventsPerThread]);
+			}
+
+			// The thread may have wrapped around while we were copying, in which
+			// case the oldest events we copied are garbage, up to and including
+			// the one sharing the slot the thread writes next.
+			__sync_synchronize();
+			unsigned overwritten = events->head - kEventsPerThread + 1;
+			unsigned first = 0;
+
+			if(static_cast<int>(overwritten - events->tail) > 0) {
+				first = overwritten - events->tail;
+				events->open.clear();
+			}
+
+			events->tail = head;
+
+			for(unsigned ii = first; ii < copied.size(); ++ii) {
+				const Event& event = copied[ii];
+
+				if(!(event.zone & 1)) {
+					events->open.push_back(event);
+					continue;
+				}
+
+				// Ends without a begin were for zones entered before the profiler
+				// was enabled, or lost to a wrap around.
+				if(events->open.empty() ||
+				        events->open.back().zone != (event.zone & ~1u)) {
+					continue;
+				}
+
+				const Event& begin = events->open.back();
+				WriteEvent(writer, state.zones[begin.zone >> 1], events->id,
+				           begin.time, event.time, state.epoch);
+				events->open.pop_back();
+			}
+		}
+
+		writer->CloseArray();
+		writer->WritePropertyName("displayTimeUnit");
+		writer->WriteString("ns");
+		writer->CloseObject();
+		writer->Close();
+	}
+
+}  // namespace o3d
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "base/cross/config.h"
+
+namespace o3d {
+
+	class StructuredWriter;
+
+	// A named range of code, measured each time it runs while the
+	// FrameProfiler is enabled. Zones are meant to be static, and are
+	// normally declared through O3D_PROFILE_ZONE.
+	class ProfileZone {
+	public:
+		explicit ProfileZone(const char* name);
+
+		const char* name() const {
+			return name_;
+		}
+
+		// Small integer identifying the zone, assigned at construction.
+		unsigned id() const {
+			return id_;
+		}
+
+	private:
+		const char* name_;
+		unsigned id_;
+
+		O3D_DISALLOW_COPY_AND_ASSIGN(ProfileZone);
+	};
+
+	// Records when profile zones are entered and left, on any thread.
+	//
+	// Each thread records into its own ring buffer without taking any lock,
+	// so zones can be left in shipping code: when the profiler is disabled
+	// a zone costs a test of a flag. When a ring buffer is full its oldest
+	// events are overwritten.
+	//
+	// The recorded events are exported in the trace event format of Chrome's
+	// about:tracing, so that nested zones show up as a flame graph per
+	// thread.
+	class FrameProfiler {
+	public:
+		// Number of events each thread can record between two exports.
+		static const unsigned kEventsPerThread = 1 << 14;
+
+		static bool enabled() {
+			return enabled_;
+		}
+
+		// Starts or stops recording. Enabling the profiler discards what was
+		// recorded before.
+		static void SetEnabled(bool enabled);
+
+		// Returns a monotonic time stamp, in nanoseconds.
+		static uint64_t GetTimeNs();
+
+		// Records that the current thread entered or left a zone.
+		static void BeginZone(const ProfileZone* zone);
+		static void EndZone(const ProfileZone* zone);
+
+		// Writes the events recorded since the last call, as a trace event
+		// object with one complete event per zone run. Zones still running
+		// are left for the next call.
+		static void WriteTrace(StructuredWriter* writer);
+
+	private:
+		FrameProfiler();
+
+		static volatile bool enabled_;
+	};
+
+	// Measures a zone from its construction to its destruction.
+	class ScopedProfileZone {
+	public:
+		explicit ScopedProfileZone(const ProfileZone* zone)
+			: zone_(FrameProfiler::enabled() ? zone : NULL) {
+			if(zone_) {
+				FrameProfiler::BeginZone(zone_);
+			}
+		}
+
+		~ScopedProfileZone() {
+			if(zone_) {
+				FrameProfiler::EndZone(zone_);
+			}
+		}
+
+	private:
+		const ProfileZone* zone_;
+
+		O3D_DISALLOW_COPY_AND_ASSIGN(ScopedProfileZone);
+	};
+
+}  // namespace o3d
+
+#define O3D_PROFILE_CONCAT_INNER(a, b) a ## b
+#define O3D_PROFILE_CONCAT(a, b) O3D_PROFILE_CONCAT_INNER(a, b)
+
+// Measures the rest of the enclosing scope as a zone named |name|, which
+// must be a string literal.
+#define O3D_PROFILE_ZONE(name)                                             \
+	static ::o3d::ProfileZone O3D_PROFILE_CONCAT(o3d_profile_zone_, __LINE__)( \
+	        name);                                                               \
+	::o3d::ScopedProfileZone O3D_PROFILE_CONCAT(o3d_profile_scope_, __LINE__)( \
+	        &O3D_PROFILE_CONCAT(o3d_profile_zone_, __LINE__))
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file contains unit tests for the frame profiler.
+
+#include <pthread.h>
+#include <string>
+#include "tests/common/win/testing_common.h"
+#include "core/cross/frame_profiler.h"
+#include "core/cross/worker_pool.h"
+#include "utils/cross/json_writer.h"
+
+namespace o3d {
+
+	namespace {
+
+		void Inner() {
+			O3D_PROFILE_ZONE("FrameProfilerTest inner");
+		}
+
+		void Outer() {
+			O3D_PROFILE_ZONE("FrameProfilerTest outer");
+			Inner();
+			Inner();
+		}
+
+		class OuterTask : public Closure {
+		public:
+			virtual void Run() {
+				Outer();
+			}
+		};
+
+		int CountOccurrences(const std::string& text, const std::string& pattern) {
+			int count = 0;
+
+			for(size_t pos = text.find(pattern);
+			        pos != std::string::npos;
+			        pos = text.find(pattern, pos + 1)) {
+				++count;
+			}
+
+			return count;
+		}
+
+		void* RunOuter(void*) {
+			Outer();
+			return NULL;
+		}
+
+		std::string WriteTrace() {
+			JsonWriter writer(0);
+			FrameProfiler::WriteTrace(&writer);
+			return writer.output();
+		}
+
+	}  // anonymous namespace
+
+	TEST(FrameProfilerTest, TimeIsMonotonic) {
+		uint64_t first = FrameProfiler::GetTimeNs();
+		uint64_t second = FrameProfiler::GetTimeNs();
+		EXPECT_LE(first, second);
+	}
+
+	TEST(FrameProfilerTest, NothingIsRecordedWhenDisabled) {
+		FrameProfiler::SetEnabled(false);
+		WriteTrace();
+		Outer();
+		std::string trace = WriteTrace();
+		EXPECT_EQ(0, CountOccurrences(trace, "FrameProfilerTest"));
+	}
+
+	TEST(FrameProfilerTest, RecordsNestedZones) {
+		FrameProfiler::SetEnabled(true);
+		Outer();
+		FrameProfiler::SetEnabled(false);
+		std::string trace = WriteTrace();
+		EXPECT_EQ(0u, trace.find("{\"traceEvents\":["));
+		EXPECT_EQ(1, CountOccurrences(trace, "\"FrameProfilerTest outer\""));
+		EXPECT_EQ(2, CountOccurrences(trace, "\"FrameProfilerTest inner\""));
+		EXPECT_EQ(3, CountOccurrences(trace, "\"ph\":\"X\""));
+		// Exported events are forgotten.
+		EXPECT_EQ(0, CountOccurrences(WriteTrace(), "FrameProfilerTest"));
+	}
+
+	TEST(FrameProfilerTest, ZonesStillRunningAreWrittenLater) {
+		FrameProfiler::SetEnabled(true);
+		{
+			O3D_PROFILE_ZONE("FrameProfilerTest running");
+			EXPECT_EQ(0, CountOccurrences(WriteTrace(), "FrameProfilerTest"));
+		}
+		FrameProfiler::SetEnabled(false);
+		EXPECT_EQ(1, CountOccurrences(WriteTrace(), "FrameProfilerTest running"));
+	}
+
+	TEST(FrameProfilerTest, RecordsEveryThread) {
+		FrameProfiler::SetEnabled(true);
+		WorkerPool pool(3);
+
+		for(int ii = 0; ii < 30; ++ii) {
+			pool.Post(new OuterTask);
+		}
+
+		pool.Wait();
+		FrameProfiler::SetEnabled(false);
+		std::string trace = WriteTrace();
+		EXPECT_EQ(30, CountOccurrences(trace, "\"FrameProfilerTest outer\""));
+		EXPECT_EQ(60, CountOccurrences(trace, "\"FrameProfilerTest inner\""));
+	}
+
+	TEST(FrameProfilerTest, ExitedThreadsAreForgotten) {
+		FrameProfiler::SetEnabled(true);
+		pthread_t thread;
+		ASSERT_EQ(0, pthread_create(&thread, NULL, &RunOuter, NULL));
+		pthread_join(thread, NULL);
+		FrameProfiler::SetEnabled(false);
+		// The buffer of the thread went away with it.
+		EXPECT_EQ(0, CountOccurrences(WriteTrace(), "FrameProfilerTest"));
+	}
+
+	TEST(FrameProfilerTest, OverwrittenEventsAreDropped) {
+		FrameProfiler::SetEnabled(true);
+
+		for(unsigned ii = 0; ii < FrameProfiler::kEventsPerThread; ++ii) {
+			Outer();
+		}
+
+		FrameProfiler::SetEnabled(false);
+		std::string trace = WriteTrace();
+		int inner = CountOccurrences(trace, "\"FrameProfilerTest inner\"");
+		EXPECT_LT(0, inner);
+		EXPECT_GE(static_cast<int>(FrameProfiler::kEventsPerThread / 2), inner);
+	}
+
+}  // namespace o3d
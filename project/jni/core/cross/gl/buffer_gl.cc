@@ -163,6 +163,9 @@ namespace o3d {
 			return false;
 		}
 
+		renderer_->render_stats()->Add(RenderStats::BUFFER_BYTES_UPLOADED,
+		                               GetSizeInBytes());
+
 		CHECK_GL_ERROR();
 		return true;
 	}
@@ -274,6 +277,9 @@ namespace o3d {
 			return false;
 		}
 
+		renderer_->render_stats()->Add(RenderStats::BUFFER_BYTES_UPLOADED,
+		                               GetSizeInBytes());
+
 		CHECK_GL_ERROR();
 		return true;
 	}
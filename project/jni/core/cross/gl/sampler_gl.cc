@@ -181,6 +181,7 @@ namespace o3d {
 			GLenum texture_unit = cgGLGetTextureEnum(cg_param);
 			::glActiveTextureARB(texture_unit);
 			glBindTexture(target, handle);
+			renderer_->render_stats()->Add(RenderStats::TEXTURE_BINDS, 1);
 			glTexParameteri(target,
 			                GL_TEXTURE_WRAP_S,
 			                GLAddressMode(address_mode_u(), GL_REPEAT));
@@ -48,6 +48,10 @@ namespace o3d {
 
 	namespace {
 
+		// Number of locks and unlocks logged a second, as they happen every
+		// frame for dynamic buffers.
+		const unsigned kLoggedLocksPerSecond = 5;
+
 #if defined(GLES2_BACKEND_DESKTOP_GL)
 		GLenum BufferAccessModeToGLenum(Buffer::AccessMode access_mode) {
 			switch(access_mode) {
@@ -77,8 +81,7 @@ namespace o3d {
 		  renderer_(static_cast<RendererGLES2*>(
 		                service_locator->GetService<Renderer>())),
 #if !defined(GLES2_BACKEND_DESKTOP_GL)
-		  shadow_(NULL),
-		  read_only_(true),
+		  shadow_(this),
 #endif
 		  gl_buffer_(0) {
 		O3D_LOG(INFO) << "VertexBufferGLES2 Construct";
@@ -108,7 +111,7 @@ namespace o3d {
 		                NULL,
 		                GL_STATIC_DRAW);
 #if !defined(GLES2_BACKEND_DESKTOP_GL)
-		shadow_.reset(new char[size_in_bytes]);
+		shadow_.Allocate(size_in_bytes);
 #endif
 		CHECK_GL_ERROR();
 		return true;
@@ -123,7 +126,7 @@ namespace o3d {
 		}
 
 #if !defined(GLES2_BACKEND_DESKTOP_GL)
-		shadow_.reset(NULL);
+		shadow_.Free();
 #endif
 	}
 
@@ -152,8 +155,12 @@ namespace o3d {
 		}
 
 #else
-		*buffer_data = shadow_.get();
-		read_only_ = (access_mode == READ_ONLY);
+		*buffer_data = shadow_.Lock(access_mode);
+
+		if(*buffer_data == NULL) {
+			return false;
+		}
+
 #endif
 		CHECK_GL_ERROR();
 		return true;
@@ -184,27 +191,50 @@ namespace o3d {
 
 #else
 
-		if(!read_only_) {
-			glBufferSubData(GL_ARRAY_BUFFER, 0, GetSizeInBytes(), shadow_.get());
+		if(!shadow_.read_only()) {
+			glBufferSubData(GL_ARRAY_BUFFER, 0, GetSizeInBytes(), shadow_.data());
+			shadow_.Uploaded();
 		}
 
 #endif
+		renderer_->render_stats()->Add(RenderStats::BUFFER_BYTES_UPLOADED,
+		                               GetSizeInBytes());
 		CHECK_GL_ERROR();
 		return true;
 	}
 
 	bool VertexBufferGLES2::OnContextRestored() {
-		if(shadow_.get()) {
+#if !defined(GLES2_BACKEND_DESKTOP_GL)
+
+		if(shadow_.data()) {
 			renderer_->MakeCurrentLazy();
 			glGenBuffersARB(1, &gl_buffer_);
 			glBindBufferARB(GL_ARRAY_BUFFER, gl_buffer_);
 			glBufferData(
-			    GL_ARRAY_BUFFER, GetSizeInBytes(), shadow_.get(), GL_STATIC_DRAW);
+			    GL_ARRAY_BUFFER, GetSizeInBytes(), shadow_.data(), GL_STATIC_DRAW);
+		}
+		else if(num_elements() && source()) {
+			// The shadow was released: the source sets the data again, which
+			// Unlock uploads before releasing the shadow once more.
+			renderer_->MakeCurrentLazy();
+			glGenBuffersARB(1, &gl_buffer_);
+			glBindBufferARB(GL_ARRAY_BUFFER, gl_buffer_);
+			glBufferData(GL_ARRAY_BUFFER, GetSizeInBytes(), NULL, GL_STATIC_DRAW);
+			return shadow_.Restore();
 		}
 
+#endif
 		return true;
 	}
 
+	size_t VertexBufferGLES2::GetCpuMemorySize() const {
+#if !defined(GLES2_BACKEND_DESKTOP_GL)
+		return shadow_.GetCpuMemorySize();
+#else
+		return 0;
+#endif
+	}
+
 // Index Buffers ---------------------------------------------------------------
 
 // Initializes the O3D IndexBuffer object but does not create a OpenGLES2
@@ -215,8 +245,7 @@ namespace o3d {
 		  renderer_(static_cast<RendererGLES2*>(
 		                service_locator->GetService<Renderer>())),
 #if !defined(GLES2_BACKEND_DESKTOP_GL)
-		  shadow_(NULL),
-		  read_only_(true),
+		  shadow_(this),
 #endif
 		  gl_buffer_(0) {
 		O3D_LOG(INFO) << "IndexBufferGLES2 Construct";
@@ -246,7 +275,7 @@ namespace o3d {
 		                NULL,
 		                GL_STATIC_DRAW);
 #if !defined(GLES2_BACKEND_DESKTOP_GL)
-		shadow_.reset(new char[size_in_bytes]);
+		shadow_.Allocate(size_in_bytes);
 #endif
 		CHECK_GL_ERROR();
 		return true;
@@ -261,14 +290,14 @@ namespace o3d {
 		}
 
 #if !defined(GLES2_BACKEND_DESKTOP_GL)
-		shadow_.reset(NULL);
+		shadow_.Free();
 #endif
 	}
 
 // Maps the OpenGLES2 buffer to get the address in memory of the buffer data.
 	bool IndexBufferGLES2::ConcreteLock(Buffer::AccessMode access_mode,
 	                                    void** buffer_data) {
-		O3D_LOG(INFO) << "IndexBufferGLES2 Lock  \"" << name() << "\"";
+		O3D_LOG_RATE_LIMITED(INFO, kLoggedLocksPerSecond) << "IndexBufferGLES2 Lock  \"" << name() << "\"";
 		renderer_->MakeCurrentLazy();
 		glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER, gl_buffer_);
 
@@ -294,8 +323,12 @@ namespace o3d {
 		}
 
 #else
-		*buffer_data = shadow_.get();
-		read_only_ = (access_mode == READ_ONLY);
+		*buffer_data = shadow_.Lock(access_mode);
+
+		if(*buffer_data == NULL) {
+			return false;
+		}
+
 #endif
 		CHECK_GL_ERROR();
 		return true;
@@ -304,7 +337,7 @@ namespace o3d {
 // Calls Unlock on the OpenGLES2 buffer to notify that the contents of the
 // buffer are now ready for use.
 	bool IndexBufferGLES2::ConcreteUnlock() {
-		O3D_LOG(INFO) << "IndexBufferGLES2 Unlock  \"" << name() << "\"";
+		O3D_LOG_RATE_LIMITED(INFO, kLoggedLocksPerSecond) << "IndexBufferGLES2 Unlock  \"" << name() << "\"";
 		renderer_->MakeCurrentLazy();
 
 		if(!num_elements())
@@ -330,26 +363,49 @@ namespace o3d {
 
 #else
 
-		if(!read_only_) {
+		if(!shadow_.read_only()) {
 			glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, GetSizeInBytes(),
-			                shadow_.get());
+			                shadow_.data());
+			shadow_.Uploaded();
 		}
 
 #endif
+		renderer_->render_stats()->Add(RenderStats::BUFFER_BYTES_UPLOADED,
+		                               GetSizeInBytes());
 		CHECK_GL_ERROR();
 		return true;
 	}
 
 	bool IndexBufferGLES2::OnContextRestored() {
-		if(shadow_.get()) {
+#if !defined(GLES2_BACKEND_DESKTOP_GL)
+
+		if(shadow_.data()) {
 			renderer_->MakeCurrentLazy();
 			glGenBuffersARB(1, &gl_buffer_);
 			glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER, gl_buffer_);
 			glBufferData(
-			    GL_ELEMENT_ARRAY_BUFFER, GetSizeInBytes(), shadow_.get(),
+			    GL_ELEMENT_ARRAY_BUFFER, GetSizeInBytes(), shadow_.data(),
 			    GL_STATIC_DRAW);
 		}
+		else if(num_elements() && source()) {
+			// The shadow was released: the source sets the data again, which
+			// Unlock uploads before releasing the shadow once more.
+			renderer_->MakeCurrentLazy();
+			glGenBuffersARB(1, &gl_buffer_);
+			glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER, gl_buffer_);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, GetSizeInBytes(), NULL, GL_STATIC_DRAW);
+			return shadow_.Restore();
+		}
 
+#endif
 		return true;
 	}
+
+	size_t IndexBufferGLES2::GetCpuMemorySize() const {
+#if !defined(GLES2_BACKEND_DESKTOP_GL)
+		return shadow_.GetCpuMemorySize();
+#else
+		return 0;
+#endif
+	}
 }  // namespace o3d
@@ -38,6 +38,7 @@
 
 #include "base/cross/scoped_ptr.h"
 #include "core/cross/buffer.h"
+#include "core/cross/buffer_shadow.h"
 #include "core/cross/gles2/gles2_headers.h"
 
 namespace o3d {
@@ -64,9 +65,13 @@ namespace o3d {
 		// Returns the OpenGLES2 vertex buffer Object handle.
 		GLuint gl_buffer() const { return gl_buffer_; }
 
-		// Handler for a new context.
+		// Handler for a new context. Static buffers that released their shadow
+		// are set again from their source.
 		bool OnContextRestored();
 
+		// Overridden from Buffer.
+		virtual size_t GetCpuMemorySize() const;
+
 	protected:
 		// Creates a OpenGLES2 vertex buffer object of the specified size.
 		virtual bool ConcreteAllocate(size_t size_in_bytes);
@@ -87,9 +92,8 @@ namespace o3d {
 #if !defined(GLES2_BACKEND_DESKTOP_GL)
 		// GLES doesn't support glMapBuffers (only WRITE_ONLY if an extension is
 		// present), or even glGetBufferSubData, so we need to keep a shadow of the
-		// data.
-		::o3d::base::scoped_array<char> shadow_;
-		bool read_only_;
+		// data. Static buffers that have a source release it once uploaded.
+		BufferShadow shadow_;
 #endif
 		GLuint gl_buffer_;
 	};
@@ -106,9 +110,13 @@ namespace o3d {
 		// Returns the OpenGLES2 vertex buffer Object handle.
 		GLuint gl_buffer() const { return gl_buffer_; }
 
-		// Handler for a new context.
+		// Handler for a new context. Static buffers that released their shadow
+		// are set again from their source.
 		bool OnContextRestored();
 
+		// Overridden from Buffer.
+		virtual size_t GetCpuMemorySize() const;
+
 	protected:
 		// Creates a OpenGLES2 index buffer of the specified size.
 		virtual bool ConcreteAllocate(size_t size_in_bytes);
@@ -129,9 +137,8 @@ namespace o3d {
 #if !defined(GLES2_BACKEND_DESKTOP_GL)
 		// GLES doesn't support glMapBuffers (only WRITE_ONLY if an extension is
 		// present), or even glGetBufferSubData, so we need to keep a shadow of the
-		// data.
-		::o3d::base::scoped_array<char> shadow_;
-		bool read_only_;
+		// data. Static buffers that have a source release it once uploaded.
+		BufferShadow shadow_;
 #endif
 		GLuint gl_buffer_;
 	};
@@ -52,6 +52,9 @@ namespace o3d {
 // draw polygons, etc.
 	const int kNumLoggedEvents = 5;
 
+// Number of effect loads logged a second, as importers load one per material.
+	const unsigned kLoggedLoadsPerSecond = 5;
+
 // Convert a GLunum data type into a Param type.
 	static const ObjectBase::Class* GLTypeToParamType(GLenum gl_type) {
 		switch(gl_type) {
@@ -280,7 +283,7 @@ namespace o3d {
 // Initializes the Effect object using the shaders found in an FX formatted
 // string.
 	bool EffectGLES2::LoadFromFXString(const std::string& effect) {
-		O3D_LOG(INFO) << "EffectGLES2 LoadFromFXString";
+		O3D_LOG_RATE_LIMITED(INFO, kLoggedLoadsPerSecond) << "EffectGLES2 LoadFromFXString";
 		renderer_->MakeCurrentLazy();
 		++compile_count_;
 		ClearProgram();
@@ -540,6 +543,7 @@ namespace o3d {
 			i->second->SetEffectParam(renderer_, gl_param);
 		}
 
+		renderer_->render_stats()->Add(RenderStats::UNIFORM_UPLOADS, map.size());
 		renderer_->UpdateDxClippingUniform(
 		    glGetUniformLocation(gl_program_, "dx_clipping"));
 		const bool picking_mode_enabled(renderer_->picking());
@@ -577,6 +581,7 @@ namespace o3d {
 		if(gl_program_) {
 			// Initialise the render states for this pass, this includes the shaders.
 			glUseProgram(gl_program_);
+			renderer_->render_stats()->Add(RenderStats::PROGRAM_BINDS, 1);
 			UpdateShaderUniformsFromEffect(param_cache_gles2);
 		}
 		else {
@@ -100,6 +100,7 @@ namespace o3d {
 			        stream_bank_gl,
 			        material,
 			        override)) {
+				renderer->render_stats()->Add(RenderStats::PARAM_CACHE_REBUILDS, 1);
 				std::string missing_stream;
 
 				if(!stream_bank_gl->CheckForMissingVertexStreams(
@@ -146,10 +147,13 @@ namespace o3d {
 			draw = false;
 		}
 
+		// Level of detail picked by the TreeTraversal for this instance.
+		unsigned lod = indexed() ? std::min(param_cache->lod(), GetLodCount()) : 0;
+		unsigned int number_primitives = lod_number_primitives(lod);
 		unsigned int index_count;
 
 		if(!Primitive::GetIndexCount(primitive_type_,
-		                             number_primitives_,
+		                             number_primitives,
 		                             &index_count)) {
 			O3D_ERROR(service_locator())
 			        << "Unknown Primitive Type in GetIndexCount: "
@@ -160,7 +164,7 @@ namespace o3d {
 
 		if(indexed()) {
 			// Re-bind the index buffer for this shape
-			IndexBufferGLES2* ibuffer = down_cast<IndexBufferGLES2*>(index_buffer());
+			IndexBufferGLES2* ibuffer = down_cast<IndexBufferGLES2*>(lod_index_buffer(lod));
 			unsigned int max_indices = ibuffer->num_elements();
 
 			if(index_count > max_indices) {
@@ -199,31 +203,31 @@ namespace o3d {
 			}
 		case Primitive::LINELIST : {
 				O3D_LOG_FIRST_N(INFO, kNumLoggedEvents)
-				        << "Draw " << number_primitives_ << " GL_LINES";
+				        << "Draw " << number_primitives << " GL_LINES";
 				gl_primitive_type = GL_LINES;
 				break;
 			}
 		case Primitive::LINESTRIP : {
 				O3D_LOG_FIRST_N(INFO, kNumLoggedEvents)
-				        << "Draw " << number_primitives_ << " GL_LINE_STRIP";
+				        << "Draw " << number_primitives << " GL_LINE_STRIP";
 				gl_primitive_type = GL_LINE_STRIP;
 				break;
 			}
 		case Primitive::TRIANGLELIST : {
 				O3D_LOG_FIRST_N(INFO, kNumLoggedEvents)
-				        << "Draw " << number_primitives_ << " GL_TRIANGLES";
+				        << "Draw " << number_primitives << " GL_TRIANGLES";
 				gl_primitive_type = GL_TRIANGLES;
 				break;
 			}
 		case Primitive::TRIANGLESTRIP : {
 				O3D_LOG_FIRST_N(INFO, kNumLoggedEvents)
-				        << "Draw " << number_primitives_ << " GL_TRIANGLE_STRIP";
+				        << "Draw " << number_primitives << " GL_TRIANGLE_STRIP";
 				gl_primitive_type = GL_TRIANGLE_STRIP;
 				break;
 			}
 		case Primitive::TRIANGLEFAN : {
 				O3D_LOG_FIRST_N(INFO, kNumLoggedEvents)
-				        << "Draw " << number_primitives_ << " GL_TRIANGLE_FAN";
+				        << "Draw " << number_primitives << " GL_TRIANGLE_FAN";
 				gl_primitive_type = GL_TRIANGLE_FAN;
 				break;
 			}
@@ -236,19 +240,19 @@ namespace o3d {
 
 		if(draw) {
 			O3D_ASSERT(gl_primitive_type != static_cast<unsigned int>(GL_NONE));
-			renderer->AddPrimitivesRendered(number_primitives_);
+			renderer->AddPrimitivesRendered(number_primitives);
 
 			if(indexed()) {
 #ifdef GLES2_BACKEND_NATIVE_GLES2
 				glDrawElements(gl_primitive_type,
 				               index_count,
 				               GL_UNSIGNED_SHORT,
-				               BufferOffset(start_index() * sizeof(uint16_t)));
+				               BufferOffset(lod_start_index(lod) * sizeof(uint16_t)));
 #else
 				glDrawElements(gl_primitive_type,
 				               index_count,
 				               GL_UNSIGNED_INT,
-				               BufferOffset(start_index() * sizeof(uint32_t)));  // NOLINT
+				               BufferOffset(lod_start_index(lod) * sizeof(uint32_t)));  // NOLINT
 #endif
 			}
 			else {
@@ -1247,9 +1247,11 @@ namespace o3d {
 
 		if(override) is_picking = *override;
 
-		if(is_picking) {
-			int x, y;
-			get_picking_coordinates(x, y);
+		int x, y;
+		get_picking_coordinates(x, y);
+
+		// The whole display is rendered for a pick buffer.
+		if(is_picking && x >= 0) {
 			::glEnable(GL_SCISSOR_TEST);
 			::glScissor(x, display_height() - y, 1, 1);
 		}
@@ -1319,13 +1321,14 @@ namespace o3d {
 	}
 
 	void RendererGLES2::SetCurrentPickable(const ParamObject* pickable) {
-		// use the lower 32 bits of the pointer as a color
-		const unsigned int pointer_as_a_color((uintptr_t) pickable & 0xffffffffu);
+		// use the id of the pickable as a color
+		const PickableRegistry::Id id_as_a_color(
+		    pickable_registry()->Register(pickable));
 		static const float rcpt255(1.f / 255.f);
-		pick_color_[0] = rcpt255 * (float)(pointer_as_a_color       & 0xff);
-		pick_color_[1] = rcpt255 * (float)((pointer_as_a_color >>  8) & 0xff);
-		pick_color_[2] = rcpt255 * (float)((pointer_as_a_color >> 16) & 0xff);
-		pick_color_[3] = rcpt255 * (float)((pointer_as_a_color >> 24) & 0xff);
+		pick_color_[0] = rcpt255 * (float)(id_as_a_color       & 0xff);
+		pick_color_[1] = rcpt255 * (float)((id_as_a_color >>  8) & 0xff);
+		pick_color_[2] = rcpt255 * (float)((id_as_a_color >> 16) & 0xff);
+		pick_color_[3] = rcpt255 * (float)((id_as_a_color >> 24) & 0xff);
 	}
 
 	void RendererGLES2::GetDisplayModes(std::vector<DisplayMode> *modes) {
@@ -1439,6 +1442,7 @@ namespace o3d {
 		O3D_ASSERT(picking());
 		saved_blend_state_ = ::glIsEnabled(GL_BLEND);
 		::glDisable(GL_BLEND);
+		::glDisable(GL_SCISSOR_TEST);
 		::glClearColor(0, 0, 0, 0);
 		::glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 		bool override(true);
@@ -1470,15 +1474,15 @@ namespace o3d {
 #endif
 		int x, y;
 		get_picking_coordinates(x, y);
-		unsigned char pixel_value[4];
-		::glReadPixels(x, display_height() - y, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel_value);
-		const uintptr_t pointer32((pixel_value[3] << 24) | (pixel_value[2] << 16) | (pixel_value[1] << 8) | pixel_value[0]);
-		// FIXME:(jcayzac) dereferencing this newly-constructed pointer
-		// will most likely crash on any 64-bit machine, if not run in
-		// 32-bit mode. Instead, we should probably keep the set of all
-		// pickable somewhere and compare our 32-bit pointer will the lowest
-		// 32 bits of each know pickable.
-		SetPickingResult((ParamObject*)pointer32);
+
+		// A pick buffer is read back by ReadPickBuffer.
+		if(x >= 0) {
+			unsigned char pixel_value[4];
+			::glReadPixels(x, display_height() - y, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel_value);
+			const PickableRegistry::Id id((pixel_value[3] << 24) | (pixel_value[2] << 16) | (pixel_value[1] << 8) | pixel_value[0]);
+			SetPickingResult(pickable_registry()->Lookup(id));
+		}
+
 		bool override(false);
 		SetScissorValues(&override);
 
@@ -1486,6 +1490,24 @@ namespace o3d {
 			::glEnable(GL_BLEND);
 	}
 
+	bool RendererGLES2::ReadPickBuffer(PickBuffer* buffer) {
+		MakeCurrentLazy();
+		const int width = display_width();
+		const int height = display_height();
+
+		if(width <= 0 || height <= 0) {
+			buffer->Clear();
+			return false;
+		}
+
+		std::vector<unsigned char> pixels(width * height * 4);
+		::glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+		CHECK_GL_ERROR();
+		// Render surfaces are rendered top down, see UpdateHelperConstant.
+		buffer->SetFromRGBA(width, height, &pixels[0], !RenderSurfaceActive());
+		return true;
+	}
+
 	void RendererGLES2::PlatformSpecificPresent() {
 		O3D_LOG_FIRST_N(INFO, 10) << "RendererGLES2 Present";
 		O3D_ASSERT(IsCurrent());
@@ -81,6 +81,8 @@ namespace o3d {
 		// Overridden from Renderer.
 		virtual void SetCurrentPickable(const ParamObject*);
 
+		virtual bool ReadPickBuffer(PickBuffer* buffer);
+
 		// Get a vector of the available fullscreen display modes.
 		// Clears *modes on error.
 		virtual void GetDisplayModes(std::vector<DisplayMode> *modes);
@@ -167,6 +167,8 @@ namespace o3d {
 			texture_object = renderer_->error_texture();
 		}
 
+		// Puts the texture back first if it was evicted.
+		renderer_->texture_residency()->TouchTexture(texture_object);
 		GLint handle = static_cast<GLint>(reinterpret_cast<intptr_t>(
 		                                      texture_object->GetTextureHandle()));
 
@@ -187,6 +189,7 @@ namespace o3d {
 
 				::glActiveTexture(GL_TEXTURE0 + texture_unit_);
 				glBindTexture(target, handle);
+				renderer_->render_stats()->Add(RenderStats::TEXTURE_BINDS, 1);
 				glTexParameteri(target,
 				                GL_TEXTURE_WRAP_S,
 				                GLAddressMode(address_mode_u(), GL_REPEAT));
@@ -195,12 +195,14 @@ namespace o3d {
 		return 0;
 	}
 
-// Updates a GLES2 image from a bitmap, rescaling if necessary.
+// Updates a GLES2 image from a bitmap, rescaling if necessary, and counts the
+// bytes uploaded in |render_stats|.
 	static bool UpdateGLImageFromBitmap(GLenum target,
 	                                    unsigned int level,
 	                                    TextureCUBE::CubeFace face,
 	                                    const Bitmap& bitmap,
-	                                    bool resize_to_pot) {
+	                                    bool resize_to_pot,
+	                                    RenderStats* render_stats) {
 		O3D_ASSERT(bitmap.image_data());
 		unsigned int mip_width = std::max(1U, bitmap.width() >> level);
 		unsigned int mip_height = std::max(1U, bitmap.height() >> level);
@@ -245,6 +247,7 @@ namespace o3d {
 #endif
 		}
 
+		render_stats->Add(RenderStats::TEXTURE_BYTES_UPLOADED, mip_size);
 		return glGetError() == GL_NO_ERROR;
 	}
 
@@ -315,6 +318,20 @@ namespace o3d {
 		return true;
 	}
 
+// Computes the number of bytes used by the GLES2 images of a texture face.
+	static size_t ComputeGLImagesSize(Texture::Format format,
+	                                  int levels,
+	                                  unsigned int width,
+	                                  unsigned int height,
+	                                  bool resize_to_pot) {
+		if(resize_to_pot) {
+			width = image::ComputePOTSize(width);
+			height = image::ComputePOTSize(height);
+		}
+
+		return image::ComputeMipChainSize(width, height, format, levels);
+	}
+
 	static void SetDefaultTextureParameters(GLenum target) {
 		glTexParameteri(target,
 		                GL_TEXTURE_MIN_FILTER,
@@ -349,9 +366,13 @@ namespace o3d {
 		gl_texture_(texture),
 		backing_bitmap_(Bitmap::Ref(new Bitmap(service_locator))),
 		has_levels_(0),
-		locked_levels_(0) {
+		locked_levels_(0),
+		evicted_(false),
+		gpu_memory_size_(ComputeGLImagesSize(format, levels, width, height,
+		                                     resize_to_pot)) {
 		O3D_LOG(INFO) << "Texture2DGLES2 Construct from GLint";
 		O3D_ASSERT(format != Texture::UNKNOWN_FORMAT);
+		renderer_->texture_residency()->AddTexture(this);
 	}
 
 // Creates a new texture object from scratch.
@@ -438,11 +459,13 @@ namespace o3d {
 		renderer_->MakeCurrentLazy();
 		glBindTexture(GL_TEXTURE_2D, gl_texture_);
 		UpdateGLImageFromBitmap(GL_TEXTURE_2D, level, TextureCUBE::FACE_POSITIVE_X,
-		                        *backing_bitmap_.Get(), resize_to_pot_);
+		                        *backing_bitmap_.Get(), resize_to_pot_,
+		                        renderer_->render_stats());
 	}
 
 	Texture2DGLES2::~Texture2DGLES2() {
 		O3D_LOG(INFO) << "Texture2DGLES2 Destruct";
+		renderer_->texture_residency()->RemoveTexture(this);
 
 		if(gl_texture_) {
 			renderer_->MakeCurrentLazy();
@@ -495,9 +518,13 @@ namespace o3d {
 			return;
 		}
 
+		if(!renderer_->texture_residency()->keep_backing_bitmaps()) {
+			ReleaseCpuCopy();
+		}
+
 #ifdef O3D_GLES2_MUST_SHADOW_TEXTURES
 
-		if(!compressed) {
+		if(!compressed && backing_bitmap_->image_data()) {
 			// TODO(gman): must shadow compressed textures as well.
 #else
 		if(resize_to_pot_) {
@@ -548,6 +575,10 @@ namespace o3d {
 				    image::ComputeMipChainSize(src_width, src_height, format(), 1),
 				    src_data);
 			}
+
+			renderer_->render_stats()->Add(
+			    RenderStats::TEXTURE_BYTES_UPLOADED,
+			    image::ComputeBufferSize(src_width, src_height, format()));
 		}
 	}
 
@@ -621,6 +652,10 @@ namespace o3d {
 			backing_bitmap_->FreeData();
 #endif
 			has_levels_ = 0;
+
+			if(!renderer_->texture_residency()->keep_backing_bitmaps()) {
+				ReleaseCpuCopy();
+			}
 		}
 
 		CHECK_GL_ERROR();
@@ -662,30 +697,162 @@ namespace o3d {
 		renderer_->MakeCurrentLazy();
 		glGenTextures(1, &gl_texture_);
 		glBindTexture(GL_TEXTURE_2D, gl_texture_);
+		// The lost context took the evicted levels with it too.
+		evicted_ = false;
+		return CreateFullGLTexture();
+	}
+
+	bool Texture2DGLES2::CreateFullGLTexture() {
 		GLenum gl_internal_format = 0;
 		GLenum gl_data_type = 0;
 		GLenum gl_format = GLFormatFromO3DFormat(format(),
 		                   &gl_internal_format,
 		                   &gl_data_type);
-		bool resize_to_pot = !renderer_->supports_npot() &&
-		                     !image::IsPOT(width(), height());
+#if defined(GLES2_BACKEND_DESKTOP_GL)
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels() - 1);
+#endif
 
 		if(!CreateGLImages(GL_TEXTURE_2D, gl_internal_format, gl_format,
 		                   gl_data_type, TextureCUBE::FACE_POSITIVE_X,
-		                   format(), levels(), width(), height(), resize_to_pot)) {
+		                   format(), levels(), width(), height(), resize_to_pot_)) {
 			O3D_LOG(ERROR) << "Failed to create texture images.";
 			glDeleteTextures(1, &gl_texture_);
+			gl_texture_ = 0;
 			return false;
 		}
 
-		for(int level = 0; level < levels(); ++level) {
-			UpdateBackedMipLevel(level);
+		SetDefaultTextureParameters(GL_TEXTURE_2D);
+		gpu_memory_size_ = ComputeGLImagesSize(format(), levels(), width(),
+		                                       height(), resize_to_pot_);
+
+		if(backing_bitmap_->image_data()) {
+			for(int level = 0; level < levels(); ++level) {
+				UpdateBackedMipLevel(level);
+			}
+		}
+		else if(source()) {
+			return source()->RestoreTexture(this);
+		}
+
+		// Otherwise the texture is left blank, like render surfaces which are
+		// drawn again.
+		return true;
+	}
+
+	size_t Texture2DGLES2::GetCpuMemorySize() const {
+		if(!backing_bitmap_->image_data()) {
+			return 0;
+		}
+
+		return backing_bitmap_->GetMipChainSize(backing_bitmap_->num_mipmaps());
+	}
+
+	bool Texture2DGLES2::Evict() {
+		if(evicted_ || render_surfaces_enabled() || locked_levels_ != 0) {
+			return false;
+		}
+
+		bool has_data = backing_bitmap_->image_data() != NULL;
+
+		if(!has_data && !source()) {
+			// It couldn't be restored.
+			return false;
+		}
+
+		// Finds the first level small enough to be kept, if the backing bitmap
+		// can provide it as is.
+		int first_level = levels();
+
+		if(has_data && !resize_to_pot_ && !IsCompressed()) {
+			for(first_level = 0; first_level < levels(); ++first_level) {
+				if(image::ComputeMipDimension(first_level, width()) <=
+				        kEvictedTextureSize &&
+				        image::ComputeMipDimension(first_level, height()) <=
+				        kEvictedTextureSize) {
+					break;
+				}
+			}
+		}
+
+		renderer_->MakeCurrentLazy();
+		glDeleteTextures(1, &gl_texture_);
+		glGenTextures(1, &gl_texture_);
+		glBindTexture(GL_TEXTURE_2D, gl_texture_);
+
+		if(first_level < levels()) {
+			int kept_levels = levels() - first_level;
+			unsigned int kept_width = image::ComputeMipDimension(first_level, width());
+			unsigned int kept_height =
+			    image::ComputeMipDimension(first_level, height());
+			GLenum gl_internal_format = 0;
+			GLenum gl_data_type = 0;
+			GLenum gl_format = GLFormatFromO3DFormat(format(),
+			                   &gl_internal_format,
+			                   &gl_data_type);
+#if defined(GLES2_BACKEND_DESKTOP_GL)
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, kept_levels - 1);
+#endif
+
+			for(int level = 0; level < kept_levels; ++level) {
+				glTexImage2D(GL_TEXTURE_2D, level, gl_internal_format,
+				             image::ComputeMipDimension(level, kept_width),
+				             image::ComputeMipDimension(level, kept_height),
+				             0, gl_format, gl_data_type,
+				             backing_bitmap_->GetMipData(first_level + level));
+			}
+
+			gpu_memory_size_ = ComputeGLImagesSize(format(), kept_levels,
+			                                       kept_width, kept_height, false);
+		}
+		else {
+			static const uint8_t kPlaceholder[] = { 128, 128, 128, 255 };
+#if defined(GLES2_BACKEND_DESKTOP_GL)
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+#endif
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA,
+			             GL_UNSIGNED_BYTE, kPlaceholder);
+			gpu_memory_size_ = sizeof(kPlaceholder);
 		}
 
 		SetDefaultTextureParameters(GL_TEXTURE_2D);
+		evicted_ = true;
+		CHECK_GL_ERROR();
 		return true;
 	}
 
+	bool Texture2DGLES2::Restore() {
+		if(!evicted_) {
+			return true;
+		}
+
+		// Restoring can happen while samplers are being bound, so the texture
+		// bound to the active unit is put back afterwards.
+		renderer_->MakeCurrentLazy();
+		GLint previous_texture = 0;
+		glGetIntegerv(GL_TEXTURE_BINDING_2D, &previous_texture);
+		GLuint evicted_texture = gl_texture_;
+		glDeleteTextures(1, &gl_texture_);
+		glGenTextures(1, &gl_texture_);
+		glBindTexture(GL_TEXTURE_2D, gl_texture_);
+		evicted_ = false;
+		bool result = CreateFullGLTexture();
+		glBindTexture(GL_TEXTURE_2D,
+		              static_cast<GLuint>(previous_texture) == evicted_texture ?
+		              gl_texture_ : previous_texture);
+		CHECK_GL_ERROR();
+		return result;
+	}
+
+	void Texture2DGLES2::ReleaseCpuCopy() {
+		if(!backing_bitmap_->image_data() || !source() || resize_to_pot_ ||
+		        locked_levels_ != 0) {
+			return;
+		}
+
+		backing_bitmap_->FreeData();
+		has_levels_ = 0;
+	}
+
 // TextureCUBEGLES2 ------------------------------------------------------------
 
 // Creates a texture from a pre-existing GLES2 texture object.
@@ -712,10 +879,13 @@ namespace o3d {
 			has_levels_[ii] = 0;
 			locked_levels_[ii] = 0;
 		}
+
+		renderer_->texture_residency()->AddTexture(this);
 	}
 
 	TextureCUBEGLES2::~TextureCUBEGLES2() {
 		O3D_LOG(INFO) << "TextureCUBEGLES2 Destruct";
+		renderer_->texture_residency()->RemoveTexture(this);
 
 		if(gl_texture_) {
 			renderer_->MakeCurrentLazy();
@@ -826,7 +996,8 @@ namespace o3d {
 		glBindTexture(GL_TEXTURE_2D, gl_texture_);
 		UpdateGLImageFromBitmap(kCubemapFaceList[face], level, face,
 		                        *backing_bitmap,
-		                        resize_to_pot_);
+		                        resize_to_pot_,
+		                        renderer_->render_stats());
 	}
 
 	RenderSurface::Ref TextureCUBEGLES2::PlatformSpecificGetRenderSurface(
@@ -956,6 +1127,10 @@ namespace o3d {
 				    image::ComputeMipChainSize(src_width, src_height, format(), 1),
 				    src_data);
 			}
+
+			renderer_->render_stats()->Add(
+			    RenderStats::TEXTURE_BYTES_UPLOADED,
+			    image::ComputeBufferSize(src_width, src_height, format()));
 		}
 	}
 
@@ -1091,4 +1266,23 @@ namespace o3d {
 		return g_gl_abgr32f_swizzle_indices;
 	}
 
+	size_t TextureCUBEGLES2::GetGpuMemorySize() const {
+		return NUMBER_OF_FACES *
+		       ComputeGLImagesSize(format(), levels(), edge_length(), edge_length(),
+		                           resize_to_pot_);
+	}
+
+	size_t TextureCUBEGLES2::GetCpuMemorySize() const {
+		size_t total = 0;
+
+		for(int face = 0; face < static_cast<int>(NUMBER_OF_FACES); ++face) {
+			if(backing_bitmaps_[face]->image_data()) {
+				total += backing_bitmaps_[face]->GetMipChainSize(
+				             backing_bitmaps_[face]->num_mipmaps());
+			}
+		}
+
+		return total;
+	}
+
 }  // namespace o3d
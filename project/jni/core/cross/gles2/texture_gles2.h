@@ -87,6 +87,35 @@ namespace o3d {
 		// RGBA to the internal format used by the rendering API.
 		virtual const RGBASwizzleIndices& GetABGR32FSwizzleIndices();
 
+		// Overridden from Texture.
+		virtual size_t GetGpuMemorySize() const {
+			return gpu_memory_size_;
+		}
+
+		// Overridden from Texture.
+		virtual size_t GetCpuMemorySize() const;
+
+		// Overridden from Texture. Keeps the levels no larger than
+		// kEvictedTextureSize if the backing bitmap has them, or a placeholder
+		// otherwise.
+		virtual bool Evict();
+
+		// Overridden from Texture.
+		virtual bool evicted() const {
+			return evicted_;
+		}
+
+		// Overridden from Texture.
+		virtual bool Restore();
+
+		// Overridden from Texture. Only textures that have a source and don't
+		// need to be resized to a power of two can release their backing
+		// bitmap.
+		virtual void ReleaseCpuCopy();
+
+		// Largest dimension of the levels an evicted texture keeps.
+		static const unsigned int kEvictedTextureSize = 32;
+
 	protected:
 		// Overridden from Texture2D
 		virtual bool PlatformSpecificLock(
@@ -115,6 +144,11 @@ namespace o3d {
 		// it if resize_to_pot_ is set.
 		void UpdateBackedMipLevel(unsigned int level);
 
+		// Creates all the levels of gl_texture_, which must be bound, and sets
+		// their data from the backing bitmap, or from the source if there is no
+		// backing bitmap.
+		bool CreateFullGLTexture();
+
 		// Returns true if the backing bitmap has the data for the level.
 		bool HasLevel(unsigned int level) const {
 			O3D_ASSERT(static_cast<int>(level) < levels());
@@ -140,6 +174,12 @@ namespace o3d {
 
 		// Bitfield that indicates which levels are currently locked.
 		unsigned int locked_levels_;
+
+		// Whether gl_texture_ only has the smallest levels or a placeholder.
+		bool evicted_;
+
+		// Number of bytes used by the levels of gl_texture_.
+		size_t gpu_memory_size_;
 	};
 
 
@@ -183,6 +223,12 @@ namespace o3d {
 		// RGBA to the internal format used by the rendering API.
 		virtual const RGBASwizzleIndices& GetABGR32FSwizzleIndices();
 
+		// Overridden from Texture.
+		virtual size_t GetGpuMemorySize() const;
+
+		// Overridden from Texture.
+		virtual size_t GetCpuMemorySize() const;
+
 	protected:
 		// Overridden from TextureCUBE
 		virtual bool PlatformSpecificLock(
@@ -33,7 +33,6 @@
 #include "core/cross/stream.h"
 #include "core/cross/types.h"
 #include "core/cross/gles2/utils_gles2.h"
-#include "core/cross/gles2/gles2_headers.h"
 
 // Required OpenGLES2 extensions:
 // GL_ARB_vertex_buffer_object
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/cross/lod_generator.h"
+#include <algorithm>
+#include <vector>
+#include "core/cross/mesh_simplifier.h"
+#include "core/cross/pack.h"
+#include "core/cross/primitive.h"
+
+namespace o3d {
+
+	namespace {
+
+		// Largest geometric error allowed on screen, as a fraction of the
+		// viewport; about 2 pixels on a 1000 pixels wide screen.
+		const float kMaxScreenError = 0.002f;
+
+		// A level has to drop at least this fraction of the triangles of the
+		// previous one to be kept.
+		const float kMinReduction = 0.2f;
+
+		// Primitives with fewer triangles are not worth simplifying.
+		const unsigned kMinTriangles = 32;
+
+	}  // anonymous namespace
+
+	unsigned GenerateLods(Pack* pack, Primitive* primitive, unsigned max_levels) {
+		if(max_levels == 0 || primitive->number_primitives() < kMinTriangles) {
+			return 0;
+		}
+
+		std::vector<float> positions;
+		std::vector<uint32_t> indices;
+
+		if(!primitive->GetTriangleList(0, &positions, &indices)) {
+			return 0;
+		}
+
+		BoundingBox box;
+		primitive->GetBoundingBox(0, &box);
+		float diagonal = box.valid() ?
+		                 Vectormath::Aos::length(box.max_extent() - box.min_extent()) : 0.0f;
+		MeshSimplifier simplifier(&positions[0], 3, positions.size() / 3,
+		                          &indices[0], indices.size());
+		unsigned num_triangles = simplifier.num_triangles();
+		float screen_size = 1.0f;
+		unsigned levels = 0;
+
+		while(levels < max_levels && num_triangles >= kMinTriangles) {
+			simplifier.Simplify(num_triangles / 2);
+
+			if(simplifier.num_triangles() >
+			        num_triangles * (1.0f - kMinReduction)) {
+				break;
+			}
+
+			num_triangles = simplifier.num_triangles();
+			float error = simplifier.error();
+
+			if(error > 0.0f) {
+				screen_size = std::min(screen_size,
+				                       kMaxScreenError * diagonal / error);
+			}
+
+			std::vector<uint32_t> lod_indices;
+			simplifier.GetIndices(&lod_indices);
+			IndexBuffer* index_buffer = pack->Create<IndexBuffer>();
+			index_buffer->set_name(primitive->index_buffer()->name());
+
+			if(!index_buffer->AllocateElements(lod_indices.size())) {
+				pack->RemoveObject(index_buffer);
+				break;
+			}
+
+			index_buffer->index_field()->SetFromUInt32s(&lod_indices[0], 1, 0,
+			        lod_indices.size());
+			primitive->AddLod(index_buffer, num_triangles, screen_size);
+			++levels;
+		}
+
+		return levels;
+	}
+
+}  // namespace o3d
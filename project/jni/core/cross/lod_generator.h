@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+namespace o3d {
+
+	class Pack;
+	class Primitive;
+
+	// Builds up to |max_levels| levels of detail for an indexed triangle list
+	// |primitive| with the MeshSimplifier, each one with about half the
+	// triangles of the previous one, and adds them to the primitive. The new
+	// index buffers are created in |pack|; the vertex buffers are shared.
+	//
+	// Each level gets the screen size below which its geometric error stays
+	// under a couple of pixels. Levels that don't remove enough triangles to
+	// be worth switching to are not generated.
+	//
+	// Returns the number of levels added.
+	unsigned GenerateLods(Pack* pack, Primitive* primitive, unsigned max_levels);
+
+}  // namespace o3d
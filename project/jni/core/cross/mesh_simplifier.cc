@@ -0,0 +1,314 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/cross/mesh_simplifier.h"
+#include <algorithm>
+#include <functional>
+#include <math.h>
+#include <utility>
+
+namespace o3d {
+
+	struct MeshSimplifier::Collapse {
+		double cost;
+		unsigned from;
+		unsigned to;
+		unsigned from_stamp;
+		unsigned to_stamp;
+
+		// Orders the heap so that the cheapest collapse comes first.
+		bool operator>(const Collapse& other) const {
+			return cost > other.cost;
+		}
+	};
+
+	namespace {
+
+		inline void Cross(const float* a, const float* b, const float* c,
+		                  double* n) {
+			double u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+			double v[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+			n[0] = u[1] * v[2] - u[2] * v[1];
+			n[1] = u[2] * v[0] - u[0] * v[2];
+			n[2] = u[0] * v[1] - u[1] * v[0];
+		}
+
+	}  // anonymous namespace
+
+	MeshSimplifier::MeshSimplifier(const float* positions,
+	                               unsigned stride,
+	                               unsigned num_vertices,
+	                               const unsigned* indices,
+	                               unsigned num_indices)
+		: positions_(positions),
+		  stride_(stride),
+		  triangles_(indices, indices + num_indices - num_indices % 3),
+		  removed_triangles_(num_indices / 3, false),
+		  vertex_triangles_(num_vertices),
+		  quadrics_(num_vertices),
+		  locked_(num_vertices, false),
+		  stamps_(num_vertices, 0),
+		  num_triangles_(0),
+		  max_cost_(0.0) {
+		Quadric zero = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+		std::fill(quadrics_.begin(), quadrics_.end(), zero);
+		std::vector<std::pair<unsigned, unsigned> > edges;
+		edges.reserve(triangles_.size());
+
+		for(unsigned t = 0; t < removed_triangles_.size(); ++t) {
+			const unsigned* v = &triangles_[t * 3];
+
+			if(v[0] >= num_vertices || v[1] >= num_vertices || v[2] >= num_vertices ||
+			        v[0] == v[1] || v[1] == v[2] || v[2] == v[0]) {
+				removed_triangles_[t] = true;
+				continue;
+			}
+
+			++num_triangles_;
+			// Accumulate the plane of the triangle into its vertices' quadrics.
+			double n[3];
+			Cross(position(v[0]), position(v[1]), position(v[2]), n);
+			double length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+			if(length > 0.0) {
+				n[0] /= length;
+				n[1] /= length;
+				n[2] /= length;
+				const float* p = position(v[0]);
+				double d = -(n[0] * p[0] + n[1] * p[1] + n[2] * p[2]);
+				Quadric q = {
+					n[0]* n[0], n[0]* n[1], n[0]* n[2], n[0]* d,
+					n[1]* n[1], n[1]* n[2], n[1]* d,
+					n[2]* n[2], n[2]* d,
+					d* d
+				};
+
+				for(int i = 0; i < 3; ++i) {
+					Quadric& Q = quadrics_[v[i]];
+					Q.a2 += q.a2;
+					Q.ab += q.ab;
+					Q.ac += q.ac;
+					Q.ad += q.ad;
+					Q.b2 += q.b2;
+					Q.bc += q.bc;
+					Q.bd += q.bd;
+					Q.c2 += q.c2;
+					Q.cd += q.cd;
+					Q.d2 += q.d2;
+				}
+			}
+
+			for(int i = 0; i < 3; ++i) {
+				vertex_triangles_[v[i]].push_back(t);
+				unsigned a = v[i];
+				unsigned b = v[(i + 1) % 3];
+				edges.push_back(std::make_pair(std::min(a, b), std::max(a, b)));
+			}
+		}
+
+		// Edges used by a single triangle are on a boundary, edges used by more
+		// than two are non-manifold. Either way, their vertices stay in place.
+		std::sort(edges.begin(), edges.end());
+
+		for(size_t i = 0; i < edges.size();) {
+			size_t j = i + 1;
+
+			while(j < edges.size() && edges[j] == edges[i]) ++j;
+
+			if(j - i != 2) {
+				locked_[edges[i].first] = true;
+				locked_[edges[i].second] = true;
+			}
+
+			i = j;
+		}
+	}
+
+	float MeshSimplifier::error() const {
+		return static_cast<float>(sqrt(max_cost_));
+	}
+
+	void MeshSimplifier::GetIndices(std::vector<unsigned>* indices) const {
+		indices->reserve(indices->size() + num_triangles_ * 3);
+
+		for(unsigned t = 0; t < removed_triangles_.size(); ++t) {
+			if(!removed_triangles_[t]) {
+				indices->insert(indices->end(),
+				                triangles_.begin() + t * 3,
+				                triangles_.begin() + t * 3 + 3);
+			}
+		}
+	}
+
+	double MeshSimplifier::Cost(unsigned from, unsigned to) const {
+		const Quadric& q0 = quadrics_[from];
+		const Quadric& q1 = quadrics_[to];
+		const float* p = position(to);
+		double x = p[0], y = p[1], z = p[2];
+		double cost =
+		    (q0.a2 + q1.a2) * x * x + 2 * (q0.ab + q1.ab) * x * y +
+		    2 * (q0.ac + q1.ac) * x * z + 2 * (q0.ad + q1.ad) * x +
+		    (q0.b2 + q1.b2) * y * y + 2 * (q0.bc + q1.bc) * y * z +
+		    2 * (q0.bd + q1.bd) * y +
+		    (q0.c2 + q1.c2) * z * z + 2 * (q0.cd + q1.cd) * z +
+		    (q0.d2 + q1.d2);
+		return cost > 0.0 ? cost : 0.0;
+	}
+
+	void MeshSimplifier::PushCollapses(unsigned vertex,
+	                                   std::vector<Collapse>* heap) const {
+		const std::vector<unsigned>& triangles = vertex_triangles_[vertex];
+
+		for(size_t i = 0; i < triangles.size(); ++i) {
+			unsigned t = triangles[i];
+
+			if(removed_triangles_[t]) continue;
+
+			for(int j = 0; j < 3; ++j) {
+				unsigned other = triangles_[t * 3 + j];
+
+				if(other == vertex) continue;
+
+				for(int k = 0; k < 2; ++k) {
+					unsigned from = k ? other : vertex;
+					unsigned to = k ? vertex : other;
+
+					if(locked_[from]) continue;
+
+					Collapse collapse = {
+						Cost(from, to), from, to, stamps_[from], stamps_[to]
+					};
+					heap->push_back(collapse);
+					std::push_heap(heap->begin(), heap->end(),
+					               std::greater<Collapse>());
+				}
+			}
+		}
+	}
+
+	bool MeshSimplifier::Flips(unsigned from, unsigned to) const {
+		const std::vector<unsigned>& triangles = vertex_triangles_[from];
+		bool adjacent = false;
+
+		for(size_t i = 0; i < triangles.size(); ++i) {
+			unsigned t = triangles[i];
+
+			if(removed_triangles_[t]) continue;
+
+			const unsigned* v = &triangles_[t * 3];
+
+			if(v[0] == to || v[1] == to || v[2] == to) {
+				adjacent = true;
+				continue;
+			}
+
+			const float* p[3];
+			const float* q[3];
+
+			for(int j = 0; j < 3; ++j) {
+				p[j] = position(v[j]);
+				q[j] = position(v[j] == from ? to : v[j]);
+			}
+
+			double before[3], after[3];
+			Cross(p[0], p[1], p[2], before);
+			Cross(q[0], q[1], q[2], after);
+
+			if(before[0] * after[0] + before[1] * after[1] + before[2] * after[2] <= 0.0)
+				return true;
+		}
+
+		return !adjacent;
+	}
+
+	void MeshSimplifier::DoCollapse(unsigned from, unsigned to) {
+		std::vector<unsigned>& triangles = vertex_triangles_[from];
+		std::vector<unsigned>& to_triangles = vertex_triangles_[to];
+
+		for(size_t i = 0; i < triangles.size(); ++i) {
+			unsigned t = triangles[i];
+
+			if(removed_triangles_[t]) continue;
+
+			unsigned* v = &triangles_[t * 3];
+
+			if(v[0] == to || v[1] == to || v[2] == to) {
+				removed_triangles_[t] = true;
+				--num_triangles_;
+				continue;
+			}
+
+			for(int j = 0; j < 3; ++j) {
+				if(v[j] == from) v[j] = to;
+			}
+
+			to_triangles.push_back(t);
+		}
+
+		std::vector<unsigned>().swap(triangles);
+		// Drop the triangles that just went away.
+		size_t live = 0;
+
+		for(size_t i = 0; i < to_triangles.size(); ++i) {
+			if(!removed_triangles_[to_triangles[i]]) {
+				to_triangles[live++] = to_triangles[i];
+			}
+		}
+
+		to_triangles.resize(live);
+		Quadric& q0 = quadrics_[from];
+		Quadric& q1 = quadrics_[to];
+		q1.a2 += q0.a2;
+		q1.ab += q0.ab;
+		q1.ac += q0.ac;
+		q1.ad += q0.ad;
+		q1.b2 += q0.b2;
+		q1.bc += q0.bc;
+		q1.bd += q0.bd;
+		q1.c2 += q0.c2;
+		q1.cd += q0.cd;
+		q1.d2 += q0.d2;
+		++stamps_[from];
+		++stamps_[to];
+	}
+
+	void MeshSimplifier::Simplify(unsigned target_triangles) {
+		std::vector<Collapse> heap;
+
+		for(unsigned v = 0; v < vertex_triangles_.size(); ++v) {
+			PushCollapses(v, &heap);
+		}
+
+		while(num_triangles_ > target_triangles && !heap.empty()) {
+			std::pop_heap(heap.begin(), heap.end(), std::greater<Collapse>());
+			Collapse collapse = heap.back();
+			heap.pop_back();
+
+			// Either end changed since this collapse was evaluated.
+			if(collapse.from_stamp != stamps_[collapse.from] ||
+			        collapse.to_stamp != stamps_[collapse.to])
+				continue;
+
+			if(Flips(collapse.from, collapse.to))
+				continue;
+
+			DoCollapse(collapse.from, collapse.to);
+			max_cost_ = std::max(max_cost_, collapse.cost);
+			PushCollapses(collapse.to, &heap);
+		}
+	}
+
+}  // namespace o3d
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <vector>
+#include "base/cross/config.h"
+
+namespace o3d {
+
+	// Simplifies an indexed triangle list using the quadric error metric of
+	// Garland and Heckbert, restricted to half-edge collapses: a vertex is
+	// always merged into one of its neighbours, never moved. The simplified
+	// index lists therefore reference the original vertices and can share
+	// their vertex buffers.
+	//
+	// Vertices on a boundary never move, which keeps the borders of open
+	// meshes and the seams created by split texture coordinates or normals
+	// free of cracks.
+	//
+	// Simplify() can be called repeatedly with decreasing targets to build
+	// successive levels of detail, each one starting from the previous one.
+	class MeshSimplifier {
+	public:
+		// |positions| holds |num_vertices| 3-component positions, |stride|
+		// floats apart. Only the topology is copied; |positions| must outlive
+		// the simplifier.
+		MeshSimplifier(const float* positions,
+		               unsigned stride,
+		               unsigned num_vertices,
+		               const unsigned* indices,
+		               unsigned num_indices);
+
+		// Collapses edges, cheapest first, until no more than
+		// |target_triangles| triangles remain or no collapse is possible.
+		void Simplify(unsigned target_triangles);
+
+		// Number of triangles left.
+		unsigned num_triangles() const {
+			return num_triangles_;
+		}
+
+		// Largest geometric error introduced so far, in the units of the
+		// positions.
+		float error() const;
+
+		// Appends the remaining triangles to |indices|.
+		void GetIndices(std::vector<unsigned>* indices) const;
+
+	private:
+		struct Quadric {
+			double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2;
+		};
+		struct Collapse;
+
+		const float* position(unsigned vertex) const {
+			return positions_ + vertex * stride_;
+		}
+
+		double Cost(unsigned from, unsigned to) const;
+		void PushCollapses(unsigned vertex, std::vector<Collapse>* heap) const;
+		bool Flips(unsigned from, unsigned to) const;
+		void DoCollapse(unsigned from, unsigned to);
+
+		const float* positions_;
+		unsigned stride_;
+		std::vector<unsigned> triangles_;
+		std::vector<bool> removed_triangles_;
+		std::vector<std::vector<unsigned> > vertex_triangles_;
+		std::vector<Quadric> quadrics_;
+		std::vector<bool> locked_;
+		std::vector<unsigned> stamps_;
+		unsigned num_triangles_;
+		double max_cost_;
+
+		O3D_DISALLOW_COPY_AND_ASSIGN(MeshSimplifier);
+	};
+
+}  // namespace o3d
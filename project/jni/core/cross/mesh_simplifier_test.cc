@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file contains unit tests for the mesh simplifier.
+
+#include <math.h>
+#include <set>
+#include <vector>
+#include "tests/common/win/testing_common.h"
+#include "core/cross/mesh_simplifier.h"
+
+namespace o3d {
+
+	namespace {
+
+		// A flat |size| x |size| quad grid in the XY plane, with a bump of
+		// |height| in its center.
+		void MakeGrid(unsigned size, float height,
+		              std::vector<float>* positions,
+		              std::vector<unsigned>* indices) {
+			for(unsigned y = 0; y <= size; ++y) {
+				for(unsigned x = 0; x <= size; ++x) {
+					positions->push_back(static_cast<float>(x));
+					positions->push_back(static_cast<float>(y));
+					positions->push_back(x == size / 2 && y == size / 2 ? height : 0.0f);
+				}
+			}
+
+			for(unsigned y = 0; y < size; ++y) {
+				for(unsigned x = 0; x < size; ++x) {
+					unsigned i = y * (size + 1) + x;
+					indices->push_back(i);
+					indices->push_back(i + 1);
+					indices->push_back(i + size + 1);
+					indices->push_back(i + 1);
+					indices->push_back(i + size + 2);
+					indices->push_back(i + size + 1);
+				}
+			}
+		}
+
+		// Returns true if every triangle still faces +Z.
+		bool AllFacingUp(const std::vector<float>& positions,
+		                 const std::vector<unsigned>& indices) {
+			for(size_t i = 0; i < indices.size(); i += 3) {
+				const float* a = &positions[indices[i] * 3];
+				const float* b = &positions[indices[i + 1] * 3];
+				const float* c = &positions[indices[i + 2] * 3];
+				float z = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+
+				if(z <= 0.0f) return false;
+			}
+
+			return true;
+		}
+
+	}  // anonymous namespace
+
+	TEST(MeshSimplifierTest, FlatGrid) {
+		std::vector<float> positions;
+		std::vector<unsigned> indices;
+		MakeGrid(8, 0.0f, &positions, &indices);
+		MeshSimplifier simplifier(&positions[0], 3, positions.size() / 3,
+		                          &indices[0], indices.size());
+		EXPECT_EQ(128u, simplifier.num_triangles());
+		simplifier.Simplify(0);
+		// Only the 32 boundary vertices are left, which needs 30 triangles.
+		EXPECT_EQ(30u, simplifier.num_triangles());
+		EXPECT_FLOAT_EQ(0.0f, simplifier.error());
+		std::vector<unsigned> simplified;
+		simplifier.GetIndices(&simplified);
+		EXPECT_EQ(90u, simplified.size());
+		EXPECT_TRUE(AllFacingUp(positions, simplified));
+	}
+
+	TEST(MeshSimplifierTest, SuccessiveLevels) {
+		std::vector<float> positions;
+		std::vector<unsigned> indices;
+		MakeGrid(16, 4.0f, &positions, &indices);
+		MeshSimplifier simplifier(&positions[0], 3, positions.size() / 3,
+		                          &indices[0], indices.size());
+		simplifier.Simplify(256);
+		EXPECT_EQ(256u, simplifier.num_triangles());
+		float first_error = simplifier.error();
+		simplifier.Simplify(128);
+		EXPECT_EQ(128u, simplifier.num_triangles());
+		EXPECT_LE(first_error, simplifier.error());
+		std::vector<unsigned> simplified;
+		simplifier.GetIndices(&simplified);
+		EXPECT_TRUE(AllFacingUp(positions, simplified));
+		// The bump is the most expensive vertex to remove, so it is still there.
+		std::set<unsigned> used(simplified.begin(), simplified.end());
+		EXPECT_EQ(1u, used.count(8 * 17 + 8));
+	}
+
+	TEST(MeshSimplifierTest, DegenerateTriangles) {
+		float positions[] = {
+			0.0f, 0.0f, 0.0f,
+			1.0f, 0.0f, 0.0f,
+			0.0f, 1.0f, 0.0f,
+		};
+		unsigned indices[] = { 0, 1, 2, 0, 0, 1, 0, 1, 7 };
+		MeshSimplifier simplifier(positions, 3, 3, indices, 9);
+		EXPECT_EQ(1u, simplifier.num_triangles());
+		simplifier.Simplify(0);
+		EXPECT_EQ(1u, simplifier.num_triangles());
+		std::vector<unsigned> simplified;
+		simplifier.GetIndices(&simplified);
+		ASSERT_EQ(3u, simplified.size());
+		EXPECT_EQ(0u, simplified[0]);
+	}
+
+}  // namespace o3d
@@ -33,9 +33,11 @@
 // This file contains the definition of the ObjectBase class.
 
 #include "core/cross/object_base.h"
+#include <map>
 #include "core/cross/service_locator.h"
 #include "core/cross/object_manager.h"
 #include "core/cross/id_manager.h"
+#include "base/cross/lock.h"
 
 namespace o3d {
 
@@ -43,6 +45,51 @@ namespace o3d {
 		O3D_STRING_CONSTANT("ObjectBase"), NULL
 	};
 
+	const ObjectBase::ClassTree* volatile ObjectBase::class_tree_ = NULL;
+
+	namespace {
+
+		// All the classes registered so far.
+		struct ClassRegistry {
+			typedef std::vector<const ObjectBase::Class*> ClassArray;
+			typedef std::map<std::string, const ObjectBase::Class*> ClassNameMap;
+			typedef std::map<const ObjectBase::Class*, ClassArray> ChildrenMap;
+
+			base::Lock lock;
+			ClassArray classes;
+			ClassNameMap classes_by_name;
+			// Every tree published, as readers may still hold the earlier
+			// ones. There is one per registration adding classes, and classes
+			// are few.
+			std::vector<ObjectBase::ClassTree*> trees;
+		};
+
+		// Function static so that classes can be registered from static
+		// initializers.
+		ClassRegistry& GetClassRegistry() {
+			static ClassRegistry registry;
+			return registry;
+		}
+
+		void NumberClasses(const ObjectBase::Class* class_type,
+		                   const ClassRegistry::ChildrenMap& children,
+		                   ObjectBase::ClassTree* tree) {
+			unsigned index = class_type->index_ - 1;
+			tree->begins_[index] = static_cast<unsigned>(tree->preorder_.size());
+			tree->preorder_.push_back(class_type);
+			ClassRegistry::ChildrenMap::const_iterator iter(children.find(class_type));
+
+			if(iter != children.end()) {
+				for(size_t ii = 0; ii < iter->second.size(); ++ii) {
+					NumberClasses(iter->second[ii], children, tree);
+				}
+			}
+
+			tree->ends_[index] = static_cast<unsigned>(tree->preorder_.size());
+		}
+
+	}  // anonymous namespace
+
 	const char* ObjectBase::Class::unqualified_name() const {
 		if(strncmp(
 		            name_,
@@ -56,7 +103,8 @@ namespace o3d {
 
 	ObjectBase::ObjectBase(ServiceLocator* service_locator)
 		: id_(IdManager::CreateId()),
-		  service_locator_(service_locator) {
+		  service_locator_(service_locator),
+		  indexed_class_(NULL) {
 		// Upon object construction, register this object with the object manager
 		// to allow for central lookup.
 		ObjectManager* object_manager = service_locator_->GetService<ObjectManager>();
@@ -75,24 +123,87 @@ namespace o3d {
 		}
 	}
 
-	bool ObjectBase::ClassIsA(const Class* derived, const Class* base) {
-		// find base in the hierarchy of derived
-		for(; derived; derived = derived->parent()) {
-			if(derived == base) return true;
+	void ObjectBase::RegisterClass(const Class* class_type) {
+		ClassRegistry& registry = GetClassRegistry();
+		base::AutoLock lock(registry.lock);
+		bool added = false;
+
+		for(; class_type && !class_type->index_;
+		        class_type = class_type->parent()) {
+			// Readers ignore the new index until the tree having it is published.
+			registry.classes.push_back(class_type);
+			class_type->index_ = static_cast<unsigned>(registry.classes.size());
+			registry.classes_by_name.insert(std::make_pair(
+			                                    std::string(class_type->name()), class_type));
+			added = true;
+		}
+
+		if(!added) {
+			return;
+		}
+
+		// New classes are rare, so the whole tree is simply numbered again.
+		ClassRegistry::ChildrenMap children;
+		ClassRegistry::ClassArray roots;
+
+		for(size_t ii = 0; ii < registry.classes.size(); ++ii) {
+			const Class* registered = registry.classes[ii];
+
+			if(registered->parent()) {
+				children[registered->parent()].push_back(registered);
+			}
+			else {
+				roots.push_back(registered);
+			}
+		}
+
+		ClassTree* tree = new ClassTree;
+		tree->begins_.resize(registry.classes.size());
+		tree->ends_.resize(registry.classes.size());
+		tree->preorder_.reserve(registry.classes.size());
+
+		for(size_t ii = 0; ii < roots.size(); ++ii) {
+			NumberClasses(roots[ii], children, tree);
 		}
 
-		return false;
+		registry.trees.push_back(tree);
+		// Finish writing the tree before publishing it.
+		__sync_synchronize();
+		class_tree_ = tree;
+	}
+
+	const ObjectBase::Class* ObjectBase::GetRegisteredClassByName(
+	    const std::string& class_name) {
+		ClassRegistry& registry = GetClassRegistry();
+		base::AutoLock lock(registry.lock);
+		const ClassRegistry::ClassNameMap& classes_by_name =
+		    registry.classes_by_name;
+		ClassRegistry::ClassNameMap::const_iterator iter(
+		    classes_by_name.find(class_name));
+		return iter == classes_by_name.end() ? NULL : iter->second;
 	}
 
 	bool ObjectBase::ClassIsAClassName(const Class* derived, const std::string& name) {
-		// find base in the hierarchy of derived
-		for(; derived; derived = derived->parent()) {
-			if(name.compare(derived->name()) == 0) {
-				return true;
+		if(!derived) {
+			return false;
+		}
+
+		const ClassTree* tree = GetClassTree();
+
+		if(!tree || !tree->Contains(derived)) {
+			for(; derived; derived = derived->parent()) {
+				if(name == derived->name()) {
+					return true;
+				}
 			}
+
+			return false;
 		}
 
-		return false;
+		// The ancestors of a registered class are registered, so an unknown
+		// name can't be one of them.
+		const Class* base = GetRegisteredClassByName(name);
+		return base && ClassIsA(derived, base);
 	}
 
 }  // namespace o3d
@@ -40,6 +40,7 @@
 
 #include "core/cross/types.h"
 #include "core/cross/smart_ptr.h"
+#include "core/cross/slab_allocator.h"
 
 #define O3D_NAMESPACE "o3d"
 #define O3D_NAMESPACE_SEPARATOR "."
@@ -164,11 +165,57 @@ namespace o3d {
 			const char* name_;
 			// The base class descriptor.
 			const Class* parent_;
+			// Position of the class in the registered classes plus one, assigned
+			// once by RegisterClass(); 0 means the class hasn't been registered
+			// yet.
+			mutable unsigned index_;
+		};
+
+		// Preorder numbering of the tree of all the registered classes: a class
+		// derives from another if its begin is inside the interval of the
+		// other. A published tree is never modified, RegisterClass() publishes
+		// a new one instead, so that it can be read from any thread while
+		// classes are registered.
+		struct ClassTree {
+		public:
+			// Whether |class_type| was registered when the tree was published.
+			bool Contains(const Class* class_type) const {
+				return class_type->index_ && class_type->index_ <= preorder_.size();
+			}
+
+			// Preorder interval [begin, end) of a class of the tree.
+			unsigned begin(const Class* class_type) const {
+				return begins_[class_type->index_ - 1];
+			}
+
+			unsigned end(const Class* class_type) const {
+				return ends_[class_type->index_ - 1];
+			}
+
+			// The class whose interval begins at |begin|.
+			const Class* at(unsigned begin) const {
+				return preorder_[begin];
+			}
+
+		public:
+			std::vector<unsigned> begins_;
+			std::vector<unsigned> ends_;
+			std::vector<const Class*> preorder_;
 		};
 
 		explicit ObjectBase(ServiceLocator* service_locator);
 		virtual ~ObjectBase();
 
+		// Objects are allocated from slabs: there are many of them and they
+		// are usually created and destroyed together with their pack.
+		static void* operator new(size_t size) {
+			return SlabAllocator::Allocate(size);
+		}
+
+		static void operator delete(void* object, size_t size) {
+			SlabAllocator::Free(object, size);
+		}
+
 		// Return the owning client for this object.
 		ServiceLocator* service_locator() const {
 			return service_locator_;
@@ -185,12 +232,57 @@ namespace o3d {
 		}
 
 		// Returns whether a class derives from a base class.
-		static bool ClassIsA(const Class* derived, const Class* base);
+		static bool ClassIsA(const Class* derived, const Class* base) {
+			if(!derived || !base) {
+				return false;
+			}
+
+			const ClassTree* tree = GetClassTree();
+
+			// The ancestors of a class the tree doesn't have yet are walked
+			// instead.
+			if(!tree || !tree->Contains(derived)) {
+				for(; derived; derived = derived->parent()) {
+					if(derived == base) {
+						return true;
+					}
+				}
+
+				return false;
+			}
+
+			// Registering a class registers its ancestors, so a base the tree
+			// doesn't have can't be one of them.
+			if(!tree->Contains(base)) {
+				return false;
+			}
+
+			unsigned begin = tree->begin(derived);
+			return tree->begin(base) <= begin && begin < tree->end(base);
+		}
 
 		// Returns whether a class derives from a base class by class name
 		static bool ClassIsAClassName(const Class* derived,
 		                              const std::string& class_name);
 
+		// Adds a class and its ancestors to the class tree used by ClassIsA().
+		// The IClassManager registers the classes it can create, and packs and
+		// the ObjectManager those of the objects they index. ClassIsA() itself
+		// never registers, so it can be called from any thread, even while a
+		// class is registered.
+		static void RegisterClass(const Class* class_type);
+
+		// Returns the last published class tree, or NULL if no class was
+		// registered yet. It stays valid for the life of the process.
+		static const ClassTree* GetClassTree() {
+			// The classes of the tree are read through the pointer, which
+			// orders them after its publication on every CPU we run on.
+			return class_tree_;
+		}
+
+		// Returns the registered class with the given name, or NULL.
+		static const Class* GetRegisteredClassByName(const std::string& class_name);
+
 		// Returns the class descriptor for this instance.
 		virtual const Class* GetClass() const {
 			return GetApparentClass();
@@ -214,7 +306,7 @@ namespace o3d {
 		}
 
 		// A dynamic_cast for types derived from ObjectBase. Like dynamic_cast it will
-		// return NULL if the cast fails. Also like dynamic_cast it's slow! Note:
+		// return NULL if the cast fails. Note:
 		// Unlike dynamic_cast you don't specify a pointer as the type so
 		//
 		// Derived* d = ObjectBase::rtti_dynamic_cast<Derived>(base);  // correct
@@ -226,9 +318,15 @@ namespace o3d {
 		}
 
 	private:
+		// The ObjectManager indexes objects by class once they are fully
+		// constructed, and remembers here the class they were indexed under.
+		friend class ObjectManager;
+
 		Id id_;
 		ServiceLocator* service_locator_;
+		const Class* indexed_class_;
 		static Class class_;
+		static const ClassTree* volatile class_tree_;
 	};
 
 	inline Id GetObjectId(const ObjectBase* object) {
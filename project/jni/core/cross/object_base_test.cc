@@ -80,4 +80,75 @@ namespace o3d {
 		                 "ObjectBase"));
 	}
 
+	namespace {
+
+		ObjectBase::Class test_base_class = {
+			"TestBase", ObjectBase::GetApparentClass()
+		};
+		ObjectBase::Class test_left_class = { "TestLeft", &test_base_class };
+		ObjectBase::Class test_right_class = { "TestRight", &test_base_class };
+		ObjectBase::Class test_leaf_class = { "TestLeaf", &test_left_class };
+		ObjectBase::Class test_late_class = { "TestLate", &test_right_class };
+
+	}  // anonymous namespace
+
+	TEST_F(ObjectBaseTest, ClassIsA) {
+		// Testing unregistered classes doesn't register them.
+		EXPECT_TRUE(ObjectBase::ClassIsA(&test_leaf_class, &test_base_class));
+		EXPECT_FALSE(ObjectBase::ClassIsA(&test_leaf_class, &test_right_class));
+		EXPECT_FALSE(ObjectBase::ClassIsA(&test_base_class, &test_leaf_class));
+		EXPECT_EQ(0u, test_leaf_class.index_);
+		EXPECT_EQ(0u, test_base_class.index_);
+		// Registered in no particular order.
+		ObjectBase::RegisterClass(&test_leaf_class);
+		ObjectBase::RegisterClass(&test_base_class);
+		ObjectBase::RegisterClass(&test_right_class);
+		EXPECT_NE(0u, test_base_class.index_);
+		EXPECT_TRUE(ObjectBase::ClassIsA(&test_leaf_class, &test_base_class));
+		EXPECT_TRUE(ObjectBase::ClassIsA(&test_right_class, &test_base_class));
+		EXPECT_TRUE(ObjectBase::ClassIsA(&test_leaf_class, &test_leaf_class));
+		EXPECT_TRUE(ObjectBase::ClassIsA(&test_leaf_class,
+		                                 ObjectBase::GetApparentClass()));
+		EXPECT_FALSE(ObjectBase::ClassIsA(&test_base_class, &test_leaf_class));
+		EXPECT_FALSE(ObjectBase::ClassIsA(&test_right_class, &test_left_class));
+		EXPECT_FALSE(ObjectBase::ClassIsA(&test_leaf_class, &test_right_class));
+		EXPECT_FALSE(ObjectBase::ClassIsA(NULL, &test_base_class));
+		EXPECT_TRUE(ObjectBase::ClassIsA(Pack::GetApparentClass(),
+		                                 NamedObject::GetApparentClass()));
+	}
+
+	// Registering a class publishes a new tree, and leaves the one other
+	// threads may be reading as it was.
+	TEST_F(ObjectBaseTest, RegisterClassPublishesNewTree) {
+		ObjectBase::RegisterClass(&test_right_class);
+		const ObjectBase::ClassTree* before = ObjectBase::GetClassTree();
+		ASSERT_TRUE(before != NULL);
+		ASSERT_TRUE(before->Contains(&test_right_class));
+		unsigned begin = before->begin(&test_right_class);
+		unsigned end = before->end(&test_right_class);
+		EXPECT_EQ(0u, test_late_class.index_);
+		ObjectBase::RegisterClass(&test_late_class);
+		const ObjectBase::ClassTree* after = ObjectBase::GetClassTree();
+		EXPECT_NE(before, after);
+		EXPECT_FALSE(before->Contains(&test_late_class));
+		EXPECT_EQ(begin, before->begin(&test_right_class));
+		EXPECT_EQ(end, before->end(&test_right_class));
+		EXPECT_EQ(end - begin + 1,
+		          after->end(&test_right_class) - after->begin(&test_right_class));
+		EXPECT_TRUE(ObjectBase::ClassIsA(&test_late_class, &test_right_class));
+		EXPECT_FALSE(ObjectBase::ClassIsA(&test_late_class, &test_left_class));
+		// Registering it again changes nothing.
+		ObjectBase::RegisterClass(&test_late_class);
+		EXPECT_EQ(after, ObjectBase::GetClassTree());
+	}
+
+	TEST_F(ObjectBaseTest, ClassIsAClassName) {
+		EXPECT_TRUE(ObjectBase::ClassIsAClassName(&test_leaf_class, "TestLeft"));
+		EXPECT_TRUE(ObjectBase::ClassIsAClassName(&test_leaf_class,
+		                                          "o3d.ObjectBase"));
+		EXPECT_FALSE(ObjectBase::ClassIsAClassName(&test_right_class, "TestLeft"));
+		EXPECT_FALSE(ObjectBase::ClassIsAClassName(&test_leaf_class, "Unknown"));
+		EXPECT_TRUE(pack_->IsAClassName("o3d.Pack"));
+	}
+
 }  // namespace o3d
@@ -55,15 +55,12 @@ namespace o3d {
 	    const std::string& name,
 	    const std::string& class_type_name) const {
 		ObjectBaseArray objects;
-		ObjectMap::const_iterator end(object_map_.end());
+		ObjectBaseArray candidates(GetObjectsByClassName(class_type_name));
 
-		for(ObjectMap::const_iterator iter(object_map_.begin());
-		        iter != end;
-		        ++iter) {
-			if(iter->second->IsAClassName(class_type_name) &&
-			        iter->second->IsA(NamedObjectBase::GetApparentClass()) &&
-			        down_cast<NamedObjectBase*>(iter->second)->name().compare(name) == 0) {
-				objects.push_back(iter->second);
+		for(size_t ii = 0; ii < candidates.size(); ++ii) {
+			if(candidates[ii]->IsA(NamedObjectBase::GetApparentClass()) &&
+			        down_cast<NamedObjectBase*>(candidates[ii])->name().compare(name) == 0) {
+				objects.push_back(candidates[ii]);
 			}
 		}
 
@@ -73,17 +70,33 @@ namespace o3d {
 	std::vector<ObjectBase*> ObjectManager::GetObjectsByClassName(
 	    const std::string& class_type_name) const {
 		ObjectBaseArray objects;
-		ObjectMap::const_iterator end(object_map_.end());
+		IndexNewObjects();
+		// Every indexed object has its class registered.
+		const ObjectBase::Class* class_type =
+		    ObjectBase::GetRegisteredClassByName(class_type_name);
+
+		if(class_type) {
+			class_index_.GetObjects(class_type, &objects);
+		}
+
+		return objects;
+	}
 
-		for(ObjectMap::const_iterator iter(object_map_.begin());
+	void ObjectManager::IndexNewObjects() const {
+		std::tr1::unordered_set<ObjectBase*>::const_iterator end(
+		    unindexed_objects_.end());
+
+		for(std::tr1::unordered_set<ObjectBase*>::const_iterator iter(
+		            unindexed_objects_.begin());
 		        iter != end;
 		        ++iter) {
-			if(iter->second->IsAClassName(class_type_name)) {
-				objects.push_back(iter->second);
-			}
+			ObjectBase* object = *iter;
+			object->indexed_class_ = object->GetClass();
+			ObjectBase::RegisterClass(object->indexed_class_);
+			class_index_.Add(object, object->indexed_class_);
 		}
 
-		return objects;
+		unindexed_objects_.clear();
 	}
 
 	ObjectBase* ObjectManager::GetObjectBaseById(
@@ -107,6 +120,7 @@ namespace o3d {
 		O3D_ASSERT(object_map_.find(object->id()) == object_map_.end())
 		        << "attempt to register duplicate id in client";
 		object_map_.insert(std::make_pair(object->id(), object));
+		unindexed_objects_.insert(object);
 	}
 
 	void ObjectManager::UnregisterObject(ObjectBase* object) {
@@ -117,6 +131,14 @@ namespace o3d {
 		if(object_find != object_map_.end()) {
 			object_map_.erase(object_find);
 		}
+
+		if(object->indexed_class_) {
+			class_index_.Remove(object, object->indexed_class_);
+			object->indexed_class_ = NULL;
+		}
+		else {
+			unindexed_objects_.erase(object);
+		}
 	}
 
 	bool ObjectManager::DestroyPack(Pack* pack) {
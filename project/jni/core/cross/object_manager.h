@@ -35,7 +35,9 @@
 
 #include <map>
 #include <vector>
+#include <tr1/unordered_set>
 
+#include "core/cross/class_index.h"
 #include "core/cross/object_base.h"
 #include "core/cross/named_object.h"
 #include "core/cross/service_implementation.h"
@@ -109,22 +111,19 @@ namespace o3d {
 
 			if(ObjectBase::ClassIsA(T::GetApparentClass(),
 			                        NamedObject::GetApparentClass())) {
-				ObjectMap::const_iterator end(object_map_.end());
-
-				for(ObjectMap::const_iterator iter(object_map_.begin());
-				        iter != end;
-				        ++iter) {
-					if(iter->second->IsA(T::GetApparentClass())) {
-						if(static_cast<NamedObject*>(
-						            iter->second)->name().compare(name) == 0) {
-							objects.push_back(static_cast<T*>(iter->second));
-						}
+				std::vector<T*> candidates(GetByClass<T>());
+
+				for(size_t ii = 0; ii < candidates.size(); ++ii) {
+					if(static_cast<NamedObject*>(
+					            candidates[ii])->name().compare(name) == 0) {
+						objects.push_back(candidates[ii]);
 					}
 				}
 			}
 
 			return objects;
 		}
+
 		// Searches the Client for objects of a particular name and type.
 		// This function is for Javascript.
 		// Parameters:
@@ -150,18 +149,8 @@ namespace o3d {
 		//   Array of Pointers to the requested class.
 		template<typename T>
 		std::vector<T*> GetByClass() const {
-			std::vector<T*> objects;
-			ObjectMap::const_iterator end(object_map_.end());
-
-			for(ObjectMap::const_iterator iter(object_map_.begin());
-			        iter != end;
-			        ++iter) {
-				if(iter->second->IsA(T::GetApparentClass())) {
-					objects.push_back(static_cast<T*>(iter->second));
-				}
-			}
-
-			return objects;
+			IndexNewObjects();
+			return class_index_.GetByClass<T>();
 		}
 
 		void RegisterObject(ObjectBase* object);
@@ -198,12 +187,22 @@ namespace o3d {
 		// Dictionary of Objects indexed by their unique ID
 		typedef std::map<Id, ObjectBase*> ObjectMap;
 
+		// Adds the objects registered since the last class query to
+		// class_index_. Objects register themselves from the ObjectBase
+		// constructor, before their final class is known, so they can only be
+		// indexed afterwards.
+		void IndexNewObjects() const;
+
 		ServiceLocator* service_locator_;
 		ServiceImplementation<ObjectManager> service_;
 
 		// Map of objects to Ids
 		ObjectMap object_map_;
 
+		// Objects by class, and the objects not indexed yet.
+		mutable ClassIndex class_index_;
+		mutable std::tr1::unordered_set<ObjectBase*> unindexed_objects_;
+
 		// Array required to maintain references to the currently live pack objects.
 		PackRefArray pack_array_;
 
@@ -0,0 +1,398 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/cross/occlusion_buffer.h"
+#include <algorithm>
+#include <math.h>
+#include "core/cross/worker_pool.h"
+
+namespace o3d {
+
+	namespace {
+
+		// Depth of an empty pixel.
+		const float kFarDepth = 1.0f;
+
+		// The hierarchy level used to test a box is the finest one where the
+		// box spans at most this many texels in each direction.
+		const unsigned kMaxTestTexels = 4;
+
+		// Rows per band when rasterizing on several threads.
+		const unsigned kMinRowsPerBand = 8;
+
+		inline float Min3(float a, float b, float c) {
+			return std::min(a, std::min(b, c));
+		}
+
+		inline float Max3(float a, float b, float c) {
+			return std::max(a, std::max(b, c));
+		}
+
+		// Point of segment |a|-|b| where clip space z is 0.
+		inline Vector4 ClipNear(const Vector4& a, const Vector4& b) {
+			float t = a.getZ() / (a.getZ() - b.getZ());
+			return a + (b - a) * t;
+		}
+
+	}  // anonymous namespace
+
+	class OcclusionBuffer::RasterizeTask : public Closure {
+	public:
+		RasterizeTask(OcclusionBuffer* buffer, unsigned row_begin, unsigned row_end)
+			: buffer_(buffer),
+			  row_begin_(row_begin),
+			  row_end_(row_end) {
+		}
+
+		virtual void Run() {
+			buffer_->RasterizeRows(row_begin_, row_end_);
+		}
+
+	private:
+		OcclusionBuffer* buffer_;
+		unsigned row_begin_;
+		unsigned row_end_;
+	};
+
+	OcclusionBuffer::OcclusionBuffer()
+		: width_(0),
+		  height_(0) {
+	}
+
+	void OcclusionBuffer::Clear(unsigned width, unsigned height) {
+		triangles_.clear();
+
+		if(width == width_ && height == height_ && !levels_.empty()) {
+			return;
+		}
+
+		width_ = std::max(width, 1u);
+		height_ = std::max(height, 1u);
+		levels_.clear();
+		level_widths_.clear();
+		level_heights_.clear();
+		unsigned level_width = width_;
+		unsigned level_height = height_;
+
+		for(;;) {
+			level_widths_.push_back(level_width);
+			level_heights_.push_back(level_height);
+			levels_.push_back(std::vector<float>(level_width * level_height,
+			                                     kFarDepth));
+
+			if(level_width == 1 && level_height == 1) {
+				break;
+			}
+
+			level_width = (level_width + 1) / 2;
+			level_height = (level_height + 1) / 2;
+		}
+	}
+
+	void OcclusionBuffer::AddOccluder(const Matrix4& world_view_projection,
+	                                  const float* positions,
+	                                  unsigned num_vertices,
+	                                  const uint32_t* indices,
+	                                  unsigned num_indices) {
+		std::vector<Vector4> vertices(num_vertices);
+
+		for(unsigned ii = 0; ii < num_vertices; ++ii) {
+			const float* p = positions + ii * 3;
+			vertices[ii] = world_view_projection * Point3(p[0], p[1], p[2]);
+		}
+
+		for(unsigned ii = 0; ii + 2 < num_indices; ii += 3) {
+			uint32_t i0 = indices[ii];
+			uint32_t i1 = indices[ii + 1];
+			uint32_t i2 = indices[ii + 2];
+
+			if(i0 >= num_vertices || i1 >= num_vertices || i2 >= num_vertices) {
+				continue;
+			}
+
+			AddClippedTriangle(vertices[i0], vertices[i1], vertices[i2]);
+		}
+	}
+
+	void OcclusionBuffer::AddClippedTriangle(const Vector4& a,
+	                                         const Vector4& b,
+	                                         const Vector4& c) {
+		// Trivially reject triangles entirely outside one of the other planes.
+		if((a.getX() < -a.getW() && b.getX() < -b.getW() && c.getX() < -c.getW()) ||
+		        (a.getX() > a.getW() && b.getX() > b.getW() && c.getX() > c.getW()) ||
+		        (a.getY() < -a.getW() && b.getY() < -b.getW() && c.getY() < -c.getW()) ||
+		        (a.getY() > a.getW() && b.getY() > b.getW() && c.getY() > c.getW()) ||
+		        (a.getZ() > a.getW() && b.getZ() > b.getW() && c.getZ() > c.getW())) {
+			return;
+		}
+
+		const Vector4* v[3] = { &a, &b, &c };
+		int num_inside = 0;
+		int inside = 0;
+
+		for(int ii = 0; ii < 3; ++ii) {
+			if(v[ii]->getZ() >= 0.0f) {
+				++num_inside;
+				inside |= 1 << ii;
+			}
+		}
+
+		switch(num_inside) {
+		case 3:
+			AddTriangle(a, b, c);
+			break;
+		case 2: {
+				// Rotate so that the vertex behind the near plane comes first,
+				// keeping the winding.
+				int out = inside == 6 ? 0 : inside == 5 ? 1 : 2;
+				const Vector4& p0 = *v[out];
+				const Vector4& p1 = *v[(out + 1) % 3];
+				const Vector4& p2 = *v[(out + 2) % 3];
+				Vector4 q1 = ClipNear(p0, p1);
+				Vector4 q2 = ClipNear(p0, p2);
+				AddTriangle(q1, p1, p2);
+				AddTriangle(q1, p2, q2);
+				break;
+			}
+		case 1: {
+				int in = inside == 1 ? 0 : inside == 2 ? 1 : 2;
+				const Vector4& p0 = *v[in];
+				const Vector4& p1 = *v[(in + 1) % 3];
+				const Vector4& p2 = *v[(in + 2) % 3];
+				AddTriangle(p0, ClipNear(p0, p1), ClipNear(p0, p2));
+				break;
+			}
+		default:
+			break;
+		}
+	}
+
+	void OcclusionBuffer::AddTriangle(const Vector4& a,
+	                                  const Vector4& b,
+	                                  const Vector4& c) {
+		const Vector4* v[3] = { &a, &b, &c };
+		Triangle triangle;
+
+		for(int ii = 0; ii < 3; ++ii) {
+			float w = v[ii]->getW();
+
+			// Only happens with unusual projections; such occluders are
+			// skipped rather than risk hiding visible things.
+			if(w <= 0.0f) {
+				return;
+			}
+
+			triangle.x[ii] = (v[ii]->getX() / w * 0.5f + 0.5f) * width_;
+			triangle.y[ii] = (v[ii]->getY() / w * 0.5f + 0.5f) * height_;
+			triangle.z[ii] = std::min(v[ii]->getZ() / w, kFarDepth);
+		}
+
+		triangles_.push_back(triangle);
+	}
+
+	void OcclusionBuffer::Rasterize(WorkerPool* pool) {
+		std::fill(levels_[0].begin(), levels_[0].end(), kFarDepth);
+		unsigned num_bands = pool ? std::min(pool->num_threads() * 2,
+		                                     height_ / kMinRowsPerBand) : 0;
+
+		if(num_bands > 1) {
+			for(unsigned ii = 0; ii < num_bands; ++ii) {
+				pool->Post(new RasterizeTask(this,
+				                             height_ * ii / num_bands,
+				                             height_ * (ii + 1) / num_bands));
+			}
+
+			pool->Wait();
+		}
+		else {
+			RasterizeRows(0, height_);
+		}
+
+		BuildHierarchy();
+	}
+
+	void OcclusionBuffer::RasterizeRows(unsigned row_begin, unsigned row_end) {
+		std::vector<float>& depths = levels_[0];
+
+		for(size_t tt = 0; tt < triangles_.size(); ++tt) {
+			const Triangle& t = triangles_[tt];
+			float x0 = t.x[0], y0 = t.y[0], z0 = t.z[0];
+			float x1 = t.x[1], y1 = t.y[1], z1 = t.z[1];
+			float x2 = t.x[2], y2 = t.y[2], z2 = t.z[2];
+			float area = (x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0);
+
+			if(fabsf(area) < 1e-6f) {
+				continue;
+			}
+
+			// Occluders are drawn two-sided; make the winding positive.
+			if(area < 0.0f) {
+				std::swap(x1, x2);
+				std::swap(y1, y2);
+				std::swap(z1, z2);
+				area = -area;
+			}
+
+			float min_y = std::max(Min3(y0, y1, y2), static_cast<float>(row_begin));
+			float max_y = std::min(Max3(y0, y1, y2), static_cast<float>(row_end));
+			float min_x = std::max(Min3(x0, x1, x2), 0.0f);
+			float max_x = std::min(Max3(x0, x1, x2), static_cast<float>(width_));
+
+			if(min_x >= max_x || min_y >= max_y) {
+				continue;
+			}
+
+			int row_first = static_cast<int>(min_y);
+			int row_last = std::min(static_cast<int>(ceilf(max_y)),
+			                        static_cast<int>(row_end));
+			int column_first = static_cast<int>(min_x);
+			int column_last = std::min(static_cast<int>(ceilf(max_x)),
+			                           static_cast<int>(width_));
+			// Edge functions e(x, y) = a * x + b * y + c, positive inside. Pixels
+			// on a shared edge get written twice, which is harmless and keeps
+			// meshes free of cracks.
+			float a[3] = { y0 - y1, y1 - y2, y2 - y0 };
+			float b[3] = { x1 - x0, x2 - x1, x0 - x2 };
+			float c[3] = {
+				x0 * y1 - x1 * y0,
+				x1 * y2 - x2 * y1,
+				x2 * y0 - x0 * y2,
+			};
+			// Depth plane, and the most it grows across half a pixel.
+			float dzdx = ((z1 - z0) * (y2 - y0) - (z2 - z0) * (y1 - y0)) / area;
+			float dzdy = ((z2 - z0) * (x1 - x0) - (z1 - z0) * (x2 - x0)) / area;
+			float z_margin = 0.5f * (fabsf(dzdx) + fabsf(dzdy));
+			float z_max = Max3(z0, z1, z2);
+
+			for(int row = row_first; row < row_last; ++row) {
+				float py = row + 0.5f;
+				float px = column_first + 0.5f;
+				float e0 = a[0] * px + b[0] * py + c[0];
+				float e1 = a[1] * px + b[1] * py + c[1];
+				float e2 = a[2] * px + b[2] * py + c[2];
+				float z = z0 + dzdx * (px - x0) + dzdy * (py - y0) + z_margin;
+				float* depth = &depths[row * width_ + column_first];
+
+				for(int column = column_first; column < column_last; ++column) {
+					if(e0 >= 0.0f && e1 >= 0.0f && e2 >= 0.0f) {
+						float pixel_z = std::min(z, z_max);
+
+						if(pixel_z < *depth) {
+							*depth = pixel_z;
+						}
+					}
+
+					e0 += a[0];
+					e1 += a[1];
+					e2 += a[2];
+					z += dzdx;
+					++depth;
+				}
+			}
+		}
+	}
+
+	void OcclusionBuffer::BuildHierarchy() {
+		for(size_t level = 1; level < levels_.size(); ++level) {
+			const std::vector<float>& fine = levels_[level - 1];
+			std::vector<float>& coarse = levels_[level];
+			unsigned fine_width = level_widths_[level - 1];
+			unsigned fine_height = level_heights_[level - 1];
+			unsigned coarse_width = level_widths_[level];
+			unsigned coarse_height = level_heights_[level];
+
+			for(unsigned y = 0; y < coarse_height; ++y) {
+				unsigned y0 = y * 2;
+				unsigned y1 = std::min(y0 + 1, fine_height - 1);
+
+				for(unsigned x = 0; x < coarse_width; ++x) {
+					unsigned x0 = x * 2;
+					unsigned x1 = std::min(x0 + 1, fine_width - 1);
+					coarse[y * coarse_width + x] = std::max(
+					    std::max(fine[y0 * fine_width + x0], fine[y0 * fine_width + x1]),
+					    std::max(fine[y1 * fine_width + x0], fine[y1 * fine_width + x1]));
+				}
+			}
+		}
+	}
+
+	bool OcclusionBuffer::IsVisible(const Point3& box_min,
+	                                const Point3& box_max,
+	                                const Matrix4& world_view_projection) const {
+		if(levels_.empty()) {
+			return true;
+		}
+
+		float min_x = 1.0f, min_y = 1.0f, max_x = -1.0f, max_y = -1.0f;
+		float min_z = kFarDepth;
+
+		for(int ii = 0; ii < 8; ++ii) {
+			Vector4 point = world_view_projection * Point3(
+			                    (ii & 1) ? box_max.getX() : box_min.getX(),
+			                    (ii & 2) ? box_max.getY() : box_min.getY(),
+			                    (ii & 4) ? box_max.getZ() : box_min.getZ());
+
+			// Boxes crossing the near plane are close enough to be drawn.
+			if(point.getW() <= 0.0f || point.getZ() < 0.0f) {
+				return true;
+			}
+
+			float x = point.getX() / point.getW();
+			float y = point.getY() / point.getW();
+			min_x = std::min(min_x, x);
+			max_x = std::max(max_x, x);
+			min_y = std::min(min_y, y);
+			max_y = std::max(max_y, y);
+			min_z = std::min(min_z, point.getZ() / point.getW());
+		}
+
+		float fx0 = (min_x * 0.5f + 0.5f) * width_;
+		float fx1 = (max_x * 0.5f + 0.5f) * width_;
+		float fy0 = (min_y * 0.5f + 0.5f) * height_;
+		float fy1 = (max_y * 0.5f + 0.5f) * height_;
+
+		// Off screen: left to frustum culling.
+		if(fx1 < 0.0f || fy1 < 0.0f || fx0 >= width_ || fy0 >= height_) {
+			return true;
+		}
+
+		unsigned x0 = static_cast<unsigned>(std::max(fx0, 0.0f));
+		unsigned y0 = static_cast<unsigned>(std::max(fy0, 0.0f));
+		unsigned x1 = std::min(static_cast<unsigned>(fx1), width_ - 1);
+		unsigned y1 = std::min(static_cast<unsigned>(fy1), height_ - 1);
+		size_t level = 0;
+
+		while(level + 1 < levels_.size() &&
+		        ((x1 >> level) - (x0 >> level) >= kMaxTestTexels ||
+		         (y1 >> level) - (y0 >> level) >= kMaxTestTexels)) {
+			++level;
+		}
+
+		const std::vector<float>& depths = levels_[level];
+		unsigned level_width = level_widths_[level];
+
+		for(unsigned y = y0 >> level; y <= (y1 >> level); ++y) {
+			for(unsigned x = x0 >> level; x <= (x1 >> level); ++x) {
+				if(min_z <= depths[y * level_width + x]) {
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+}  // namespace o3d
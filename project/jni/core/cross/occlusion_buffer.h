@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <vector>
+#include "core/cross/types.h"
+
+namespace o3d {
+
+	class WorkerPool;
+
+	// A low resolution depth buffer rasterized on the CPU from a few occluder
+	// meshes, used to find out whether a bounding box is hidden behind them.
+	//
+	// A pixel gets the depth of the occluders covering its center, taking
+	// the farthest depth they have inside the pixel, and boxes are tested
+	// against the farthest depth of all the pixels they overlap. Only gaps
+	// between occluders thinner than a pixel can be missed.
+	//
+	// Depths are normalized device depths, from 0 on the near plane to 1 on
+	// the far plane, as produced by O3D projection matrices.
+	class OcclusionBuffer {
+	public:
+		OcclusionBuffer();
+
+		// Forgets all the occluders and sets the size of the buffer, in pixels.
+		void Clear(unsigned width, unsigned height);
+
+		// Transforms an indexed triangle list by |world_view_projection| and
+		// queues it for rasterization. |positions| holds |num_vertices| packed
+		// 3-component positions. Out of range indices are ignored.
+		void AddOccluder(const Matrix4& world_view_projection,
+		                 const float* positions,
+		                 unsigned num_vertices,
+		                 const uint32_t* indices,
+		                 unsigned num_indices);
+
+		// Rasterizes the queued occluders and builds the depth hierarchy. If
+		// |pool| is not NULL, horizontal bands of the buffer are rasterized on
+		// its threads.
+		void Rasterize(WorkerPool* pool);
+
+		// Returns false if the box, transformed by |world_view_projection|, is
+		// entirely behind the rasterized occluders.
+		bool IsVisible(const Point3& box_min,
+		               const Point3& box_max,
+		               const Matrix4& world_view_projection) const;
+
+		unsigned width() const {
+			return width_;
+		}
+
+		unsigned height() const {
+			return height_;
+		}
+
+		// Number of triangles queued since the last Clear().
+		unsigned num_triangles() const {
+			return static_cast<unsigned>(triangles_.size());
+		}
+
+		// Depth of a pixel after Rasterize(). Row 0 is at the bottom.
+		float depth(unsigned x, unsigned y) const {
+			return levels_[0][y * width_ + x];
+		}
+
+	private:
+		// A triangle in pixel coordinates and normalized device depth.
+		struct Triangle {
+			float x[3];
+			float y[3];
+			float z[3];
+		};
+
+		class RasterizeTask;
+
+		// Clips a clip space triangle against the near plane and queues what
+		// is left.
+		void AddClippedTriangle(const Vector4& a, const Vector4& b, const Vector4& c);
+
+		// Queues a triangle with all its vertices in front of the near plane.
+		void AddTriangle(const Vector4& a, const Vector4& b, const Vector4& c);
+
+		// Rasterizes all the triangles into rows |row_begin| to |row_end| of the
+		// finest level.
+		void RasterizeRows(unsigned row_begin, unsigned row_end);
+
+		// Fills the coarser levels, each texel holding the farthest depth of
+		// the 4 texels under it.
+		void BuildHierarchy();
+
+		unsigned width_;
+		unsigned height_;
+		std::vector<Triangle> triangles_;
+		std::vector<std::vector<float> > levels_;
+		std::vector<unsigned> level_widths_;
+		std::vector<unsigned> level_heights_;
+	};
+
+}  // namespace o3d
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file contains unit tests for the software occlusion buffer.
+
+#include "tests/common/win/testing_common.h"
+#include "core/cross/occlusion_buffer.h"
+#include "core/cross/worker_pool.h"
+
+namespace o3d {
+
+	class OcclusionBufferTest : public testing::Test {
+	protected:
+		virtual void SetUp() {
+			// A camera at the origin looking down -Z, with a 90 degrees field of
+			// view and the same [0, 1] depth range as O3D's projections.
+			float near_plane = 1.0f;
+			float far_plane = 100.0f;
+			float range = near_plane - far_plane;
+			view_projection_ = Matrix4(
+			                       Vector4(1.0f, 0.0f, 0.0f, 0.0f),
+			                       Vector4(0.0f, 1.0f, 0.0f, 0.0f),
+			                       Vector4(0.0f, 0.0f, far_plane / range, -1.0f),
+			                       Vector4(0.0f, 0.0f, near_plane * far_plane / range, 0.0f));
+		}
+
+		// Adds a square wall facing the camera, |size| units wide, centered on
+		// the view axis at distance |distance|.
+		void AddWall(OcclusionBuffer* buffer, float size, float distance) {
+			float h = size * 0.5f;
+			float positions[] = {
+				-h, -h, -distance,
+				h, -h, -distance,
+				h, h, -distance,
+				-h, h, -distance,
+			};
+			uint32_t indices[] = { 0, 1, 2, 0, 2, 3 };
+			buffer->AddOccluder(view_projection_, positions, 4, indices, 6);
+		}
+
+		bool IsBoxVisible(const OcclusionBuffer& buffer,
+		                  float x, float y, float distance, float size) {
+			float h = size * 0.5f;
+			return buffer.IsVisible(Point3(x - h, y - h, -distance - h),
+			                        Point3(x + h, y + h, -distance + h),
+			                        view_projection_);
+		}
+
+		Matrix4 view_projection_;
+	};
+
+	TEST_F(OcclusionBufferTest, EmptyBufferHidesNothing) {
+		OcclusionBuffer buffer;
+		buffer.Clear(64, 32);
+		buffer.Rasterize(NULL);
+		EXPECT_FLOAT_EQ(1.0f, buffer.depth(10, 10));
+		EXPECT_TRUE(IsBoxVisible(buffer, 0.0f, 0.0f, 50.0f, 1.0f));
+	}
+
+	TEST_F(OcclusionBufferTest, WallHidesWhatIsBehind) {
+		OcclusionBuffer buffer;
+		buffer.Clear(64, 64);
+		AddWall(&buffer, 4.0f, 5.0f);
+		EXPECT_EQ(2u, buffer.num_triangles());
+		buffer.Rasterize(NULL);
+		EXPECT_GT(1.0f, buffer.depth(32, 32));
+		// Behind the wall.
+		EXPECT_FALSE(IsBoxVisible(buffer, 0.0f, 0.0f, 20.0f, 2.0f));
+		// In front of it.
+		EXPECT_TRUE(IsBoxVisible(buffer, 0.0f, 0.0f, 3.0f, 1.0f));
+		// Sticking out of the side of the view it covers.
+		EXPECT_TRUE(IsBoxVisible(buffer, 15.0f, 0.0f, 20.0f, 2.0f));
+		// Intersecting it.
+		EXPECT_TRUE(IsBoxVisible(buffer, 0.0f, 0.0f, 5.0f, 1.0f));
+	}
+
+	TEST_F(OcclusionBufferTest, PixelCenters) {
+		OcclusionBuffer buffer;
+		buffer.Clear(64, 64);
+		// The wall spans half the view: from pixel 16 to 48.
+		AddWall(&buffer, 5.0f, 5.0f);
+		buffer.Rasterize(NULL);
+		EXPECT_GT(1.0f, buffer.depth(16, 32));
+		EXPECT_GT(1.0f, buffer.depth(47, 32));
+		EXPECT_FLOAT_EQ(1.0f, buffer.depth(15, 32));
+		EXPECT_FLOAT_EQ(1.0f, buffer.depth(48, 32));
+	}
+
+	TEST_F(OcclusionBufferTest, NearPlaneClipping) {
+		OcclusionBuffer buffer;
+		buffer.Clear(64, 64);
+		// A floor going from behind the camera to far away.
+		float positions[] = {
+			-50.0f, -1.0f, 10.0f,
+			50.0f, -1.0f, 10.0f,
+			50.0f, -1.0f, -90.0f,
+			-50.0f, -1.0f, -90.0f,
+		};
+		uint32_t indices[] = { 0, 1, 2, 0, 2, 3 };
+		buffer.AddOccluder(view_projection_, positions, 4, indices, 6);
+		EXPECT_LT(2u, buffer.num_triangles());
+		buffer.Rasterize(NULL);
+		// Something under the floor is hidden, something above is not.
+		EXPECT_FALSE(IsBoxVisible(buffer, 0.0f, -5.0f, 20.0f, 1.0f));
+		EXPECT_TRUE(IsBoxVisible(buffer, 0.0f, 2.0f, 20.0f, 1.0f));
+	}
+
+	TEST_F(OcclusionBufferTest, ThreadsGiveTheSameResult) {
+		OcclusionBuffer serial;
+		serial.Clear(128, 64);
+		AddWall(&serial, 7.0f, 10.0f);
+		AddWall(&serial, 3.0f, 4.0f);
+		serial.Rasterize(NULL);
+		OcclusionBuffer threaded;
+		threaded.Clear(128, 64);
+		AddWall(&threaded, 7.0f, 10.0f);
+		AddWall(&threaded, 3.0f, 4.0f);
+		WorkerPool pool(3);
+		threaded.Rasterize(&pool);
+
+		for(unsigned y = 0; y < 64; ++y) {
+			for(unsigned x = 0; x < 128; ++x) {
+				ASSERT_EQ(serial.depth(x, y), threaded.depth(x, y));
+			}
+		}
+	}
+
+}  // namespace o3d
@@ -450,21 +450,21 @@ namespace o3d {
 		return object.Get();
 	}
 
+	ObjectBase* Pack::GetObjectById(Id id) {
+		return GetObjectBaseById(id, ObjectBase::GetApparentClass());
+	}
+
 	ObjectBaseArray Pack::GetObjects(const std::string& name,
 	                                 const std::string& class_type_name) const {
 		ObjectBaseArray objects;
-		ObjectSet::const_iterator end(owned_objects_.end());
-
-		for(ObjectSet::const_iterator iter(owned_objects_.begin());
-		        iter != end;
-		        ++iter) {
-			ObjectBase* object = iter->Get();
-
-			if(object->IsAClassName(class_type_name)) {
-				if(object->IsA(NamedObjectBase::GetApparentClass())) {
-					if(name.compare(down_cast<NamedObjectBase*>(object)->name()) == 0) {
-						objects.push_back(object);
-					}
+		ObjectBaseArray candidates(GetObjectsByClassName(class_type_name));
+
+		for(size_t ii = 0; ii < candidates.size(); ++ii) {
+			ObjectBase* object = candidates[ii];
+
+			if(object->IsA(NamedObjectBase::GetApparentClass())) {
+				if(name.compare(down_cast<NamedObjectBase*>(object)->name()) == 0) {
+					objects.push_back(object);
 				}
 			}
 		}
@@ -475,14 +475,12 @@ namespace o3d {
 	ObjectBaseArray Pack::GetObjectsByClassName(
 	    const std::string& class_type_name) const {
 		ObjectBaseArray objects;
-		ObjectSet::const_iterator end(owned_objects_.end());
+		// Every indexed object has its class registered.
+		const ObjectBase::Class* class_type =
+		    ObjectBase::GetRegisteredClassByName(class_type_name);
 
-		for(ObjectSet::const_iterator iter(owned_objects_.begin());
-		        iter != end;
-		        ++iter) {
-			if(iter->Get()->IsAClassName(class_type_name)) {
-				objects.push_back(iter->Get());
-			}
+		if(class_type) {
+			class_index_.GetObjects(class_type, &objects);
 		}
 
 		return objects;
@@ -493,6 +491,8 @@ namespace o3d {
 		O3D_ASSERT(owned_objects_.find(temp) == owned_objects_.end())
 		        << "attempt to register duplicate object in pack.";
 		owned_objects_.insert(temp);
+		ObjectBase::RegisterClass(object->GetClass());
+		class_index_.Add(object, object->GetClass());
 	}
 
 	bool Pack::UnregisterObject(ObjectBase* object) {
@@ -501,6 +501,7 @@ namespace o3d {
 		if(find == owned_objects_.end())
 			return false;
 
+		class_index_.Remove(object, object->GetClass());
 		owned_objects_.erase(find);
 		return true;
 	}
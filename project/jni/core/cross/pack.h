@@ -39,6 +39,7 @@
 #include <vector>
 #include <set>
 
+#include "core/cross/class_index.h"
 #include "core/cross/named_object.h"
 #include "core/cross/smart_ptr.h"
 #include "core/cross/transform.h"
@@ -61,6 +62,10 @@ namespace o3d {
 	class RenderDepthStencilSurface;
 	class MemoryReadStream;
 
+	namespace extra {
+		class ResourceCache;
+	}
+
 // Type definitions ------------------------
 
 // Array of object id's
@@ -319,18 +324,7 @@ namespace o3d {
 		//   Array of Pointers to the requested class.
 		template<typename T>
 		std::vector<T*> GetByClass() const {
-			std::vector<T*> objects;
-			ObjectSet::const_iterator end(owned_objects_.end());
-
-			for(ObjectSet::const_iterator iter(owned_objects_.begin());
-			        iter != end;
-			        ++iter) {
-				if(iter->Get()->IsA(T::GetApparentClass())) {
-					objects.push_back(down_cast<T*>(iter->Get()));
-				}
-			}
-
-			return objects;
+			return class_index_.GetByClass<T>();
 		}
 
 		// Get an object by name typesafe. This function is for C++
@@ -346,16 +340,12 @@ namespace o3d {
 
 			if(ObjectBase::ClassIsA(T::GetApparentClass(),
 			                        NamedObject::GetApparentClass())) {
-				ObjectSet::const_iterator end(owned_objects_.end());
-
-				for(ObjectSet::const_iterator iter(owned_objects_.begin());
-				        iter != end;
-				        ++iter) {
-					if(iter->Get()->IsA(T::GetApparentClass())) {
-						if(down_cast<NamedObject*>(
-						            iter->Get())->name().compare(name) == 0) {
-							objects.push_back(down_cast<T*>(iter->Get()));
-						}
+				std::vector<T*> candidates(GetByClass<T>());
+
+				for(size_t ii = 0; ii < candidates.size(); ++ii) {
+					if(down_cast<NamedObject*>(
+					            candidates[ii])->name().compare(name) == 0) {
+						objects.push_back(candidates[ii]);
 					}
 				}
 			}
@@ -395,6 +385,9 @@ namespace o3d {
 		// the texture, so Texture is befriended to Pack for access to the
 		// RegisterObject routine below.
 		friend class Texture;
+		// The textures shared by ResourceCache are registered with every pack
+		// that loads them.
+		friend class extra::ResourceCache;
 
 		explicit Pack(ServiceLocator* service_locator);
 
@@ -435,6 +428,9 @@ namespace o3d {
 		// or exceed that of the pack.
 		ObjectSet owned_objects_;
 
+		// The same objects, by class.
+		ClassIndex class_index_;
+
 		Transform::Ref root_;
 
 		O3D_DECL_CLASS(Pack, NamedObject);
@@ -36,6 +36,7 @@
 #include "core/cross/object_manager.h"
 #include "core/cross/error_status.h"
 #include "core/cross/service_dependency.h"
+#include "core/cross/shape.h"
 #include "core/cross/transform.h"
 #include "tests/common/win/testing_common.h"
 
@@ -147,6 +148,35 @@ namespace o3d {
 		EXPECT_TRUE(pack->Destroy());
 	}
 
+// Validate that class queries follow object creation and removal, and return
+// derived classes in id order.
+	TEST_F(PackTest, GetByClass) {
+		Pack* pack = object_manager()->CreatePack();
+		ASSERT_TRUE(pack != NULL);
+		Transform* transform1 = pack->Create<Transform>();
+		Shape* shape = pack->Create<Shape>();
+		Transform* transform2 = pack->Create<Transform>();
+		std::vector<Transform*> transforms(pack->GetByClass<Transform>());
+		ASSERT_EQ(2u, transforms.size());
+		EXPECT_TRUE(transforms[0] == transform1);
+		EXPECT_TRUE(transforms[1] == transform2);
+		std::vector<ParamObject*> param_objects(pack->GetByClass<ParamObject>());
+		ASSERT_EQ(3u, param_objects.size());
+		EXPECT_TRUE(param_objects[1] == shape);
+		EXPECT_EQ(3u, pack->GetObjectsByClassName(
+		              ParamObject::GetApparentClass()->name()).size());
+		EXPECT_TRUE(pack->GetObjectsByClassName("o3d.NotAClass").empty());
+		EXPECT_EQ(object_manager()->GetByClass<Transform>().size(),
+		          object_manager()->GetObjectsByClassName(
+		              Transform::GetApparentClass()->name()).size());
+		pack->RemoveObject(transform1);
+		transforms = pack->GetByClass<Transform>();
+		ASSERT_EQ(1u, transforms.size());
+		EXPECT_TRUE(transforms[0] == transform2);
+		EXPECT_EQ(1u, pack->GetByClass<Shape>().size());
+		EXPECT_TRUE(pack->Destroy());
+	}
+
 	TEST_F(PackTest, CreateRawDataFromDataURL) {
 		Pack* pack = object_manager()->CreatePack();
 		RawData* raw_data = pack->CreateRawDataFromDataURL("data:;base64,YWJj");
@@ -142,6 +142,10 @@ namespace o3d {
 		//       be cleared.
 		void GetOutputs(ParamVector* params) const;
 
+		// Invalidates all the params that depend on this param, for when its
+		// value was changed behind set_value's back.
+		void InvalidateAllOutputs() const;
+
 		// Directly binds two Param elements such that the this parameter gets its
 		// value from the source parameter.  The source parameters
 		// must be a compatible type to this param or NULL to unbind. Note: The
@@ -280,9 +284,6 @@ namespace o3d {
 		// don't have to define client in this file.
 		void InvalidateAllParameters();
 
-		// Invalidates all the params that depend on this param
-		void InvalidateAllOutputs() const;
-
 		// Invalidates all the params that we depend. (also Invalidates ourself)
 		void InvalidateAllInputs();
 
@@ -300,6 +301,10 @@ namespace o3d {
 		//   old_source: The Param that used to be bound.
 		virtual void OnAfterUnbindInput(Param* old_source) { }
 
+		// Called after the value of an unbound Param is set through set_value.
+		// You can override this in a derived class.
+		virtual void OnAfterSetValue() { }
+
 	private:
 		// Adds ALL the params that affect this Param to the ParamVector.
 		// Parameters:
@@ -393,6 +398,7 @@ namespace o3d {
 				// }
 				InvalidateAllParameters();
 				set_dynamic_value(value);
+				OnAfterSetValue();
 			}
 			else {
 				ReportDynamicSetError();
@@ -498,6 +504,7 @@ namespace o3d {
 				// }
 				InvalidateAllParameters();
 				set_dynamic_value(value);
+				OnAfterSetValue();
 			}
 			else {
 				ReportDynamicSetError();
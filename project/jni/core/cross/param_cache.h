@@ -37,6 +37,7 @@
 
 #include <vector>
 #include "core/cross/param_object.h"
+#include "core/cross/slab_allocator.h"
 #include "core/cross/stream_bank.h"
 
 namespace o3d {
@@ -51,9 +52,19 @@ namespace o3d {
 // to O3D param cached map to make rendering faster.
 	class ParamCache {
 	public:
-		ParamCache() : rebuild_cache_(true) {}
+		ParamCache() : rebuild_cache_(true), lod_(0) {}
 		virtual ~ParamCache() {}
 
+		// There is one cache per DrawElement and Element, so they come from
+		// slabs like the objects themselves.
+		static void* operator new(size_t size) {
+			return SlabAllocator::Allocate(size);
+		}
+
+		static void operator delete(void* cache, size_t size) {
+			SlabAllocator::Free(cache, size);
+		}
+
 		// Clears any internal Param to Shader Parameter cache.
 		void ClearParamCache();
 
@@ -73,6 +84,16 @@ namespace o3d {
 		                         Element* element,
 		                         Material* material,
 		                         ParamObject* override) = 0;
+		// Level of detail the element using this cache was last drawn with.
+		// Caches are handed out in the same order every frame, so this is
+		// what the TreeTraversal uses to remember the level of each instance.
+		unsigned lod() const {
+			return lod_;
+		}
+		void set_lod(unsigned lod) {
+			lod_ = lod;
+		}
+
 	protected:
 		// Validates platform specific information about the effect.
 		// Returns:
@@ -83,6 +104,8 @@ namespace o3d {
 		// If true we need to rebuild the cache of Params to Shader Parameters.
 		bool rebuild_cache_;
 
+		unsigned lod_;
+
 		// A class to track the change of an object and its parameters.
 		template <typename T, typename TPOINTER>
 		class ChangeTracker {
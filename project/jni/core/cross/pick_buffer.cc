@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/cross/pick_buffer.h"
+#include <algorithm>
+#include <set>
+
+namespace o3d {
+
+	PickBuffer::PickBuffer()
+		: width_(0),
+		  height_(0) {
+	}
+
+	void PickBuffer::SetFromRGBA(int width,
+	                             int height,
+	                             const unsigned char* pixels,
+	                             bool bottom_up) {
+		width_ = width;
+		height_ = height;
+		ids_.resize(width * height);
+
+		for(int yy = 0; yy < height; ++yy) {
+			const unsigned char* row =
+			    pixels + (bottom_up ? height - 1 - yy : yy) * width * 4;
+			Id* ids = &ids_[yy * width];
+
+			for(int xx = 0; xx < width; ++xx, row += 4) {
+				ids[xx] = row[0] | (row[1] << 8) | (row[2] << 16) |
+				          (static_cast<Id>(row[3]) << 24);
+			}
+		}
+	}
+
+	void PickBuffer::Clear() {
+		width_ = 0;
+		height_ = 0;
+		ids_.clear();
+	}
+
+	PickBuffer::Id PickBuffer::GetId(int x, int y) const {
+		if(x < 0 || y < 0 || x >= width_ || y >= height_) {
+			return PickableRegistry::kNoPickable;
+		}
+
+		return ids_[y * width_ + x];
+	}
+
+	void PickBuffer::GetIdsInRect(int x,
+	                              int y,
+	                              int width,
+	                              int height,
+	                              std::vector<Id>* ids) const {
+		int left = std::max(x, 0);
+		int top = std::max(y, 0);
+		int right = std::min(x + width, width_);
+		int bottom = std::min(y + height, height_);
+		std::set<Id> seen;
+		Id last = PickableRegistry::kNoPickable;
+
+		for(int yy = top; yy < bottom; ++yy) {
+			const Id* row = &ids_[yy * width_];
+
+			for(int xx = left; xx < right; ++xx) {
+				Id id = row[xx];
+
+				// Neighbouring pixels mostly have the same id.
+				if(id == last || id == PickableRegistry::kNoPickable) {
+					continue;
+				}
+
+				last = id;
+
+				if(seen.insert(id).second) {
+					ids->push_back(id);
+				}
+			}
+		}
+	}
+
+}  // namespace o3d
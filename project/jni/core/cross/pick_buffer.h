@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <vector>
+#include "core/cross/pickable_registry.h"
+
+namespace o3d {
+
+	// The ids of the pickable objects rendered at each pixel of the display,
+	// read back from an ID buffer pass. It answers any number of point and
+	// rectangle queries without rendering again.
+	class PickBuffer {
+	public:
+		typedef PickableRegistry::Id Id;
+
+		PickBuffer();
+
+		// Decodes |width| x |height| RGBA pixels, as written by the picking
+		// shaders, with the id's low byte in red. Rows go from the bottom of the
+		// display up if |bottom_up|, as glReadPixels reads the back buffer.
+		void SetFromRGBA(int width,
+		                 int height,
+		                 const unsigned char* pixels,
+		                 bool bottom_up);
+
+		void Clear();
+
+		bool empty() const {
+			return ids_.empty();
+		}
+
+		int width() const {
+			return width_;
+		}
+
+		int height() const {
+			return height_;
+		}
+
+		// Returns the id at the window coordinates (x, y), or kNoPickable out of
+		// the buffer.
+		Id GetId(int x, int y) const;
+
+		// Appends to |ids| the distinct ids of the rectangle, clipped to the
+		// buffer, in the order they first appear from the top left. Leaves out
+		// kNoPickable.
+		void GetIdsInRect(int x,
+		                  int y,
+		                  int width,
+		                  int height,
+		                  std::vector<Id>* ids) const;
+
+	private:
+		int width_;
+		int height_;
+		// Rows from the top of the display.
+		std::vector<Id> ids_;
+	};
+
+}  // namespace o3d
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file contains the tests of PickBuffer.
+
+#include "tests/common/win/testing_common.h"
+#include "core/cross/pick_buffer.h"
+
+namespace o3d {
+
+	namespace {
+
+		// Sets the RGBA pixel at |index| to the encoding of |id|.
+		void SetPixel(unsigned char* pixels, int index, PickBuffer::Id id) {
+			pixels[index * 4 + 0] = id & 0xff;
+			pixels[index * 4 + 1] = (id >> 8) & 0xff;
+			pixels[index * 4 + 2] = (id >> 16) & 0xff;
+			pixels[index * 4 + 3] = (id >> 24) & 0xff;
+		}
+
+	}  // anonymous namespace
+
+	TEST(PickBufferTest, DecodesIds) {
+		// 2 x 2, top row first.
+		unsigned char pixels[16] = { 0 };
+		SetPixel(pixels, 1, 0x01020304);
+		SetPixel(pixels, 2, 7);
+		PickBuffer buffer;
+		EXPECT_TRUE(buffer.empty());
+		buffer.SetFromRGBA(2, 2, pixels, false);
+		EXPECT_FALSE(buffer.empty());
+		EXPECT_EQ(2, buffer.width());
+		EXPECT_EQ(2, buffer.height());
+		EXPECT_EQ(0u, buffer.GetId(0, 0));
+		EXPECT_EQ(0x01020304u, buffer.GetId(1, 0));
+		EXPECT_EQ(7u, buffer.GetId(0, 1));
+		EXPECT_EQ(0u, buffer.GetId(2, 0));
+		EXPECT_EQ(0u, buffer.GetId(0, -1));
+		buffer.Clear();
+		EXPECT_TRUE(buffer.empty());
+		EXPECT_EQ(0u, buffer.GetId(1, 0));
+	}
+
+	TEST(PickBufferTest, FlipsBottomUpRows) {
+		unsigned char pixels[8] = { 0 };
+		// The first row read is the bottom one.
+		SetPixel(pixels, 0, 5);
+		PickBuffer buffer;
+		buffer.SetFromRGBA(1, 2, pixels, true);
+		EXPECT_EQ(0u, buffer.GetId(0, 0));
+		EXPECT_EQ(5u, buffer.GetId(0, 1));
+	}
+
+	TEST(PickBufferTest, GetIdsInRect) {
+		// 3 x 3:
+		//   1 1 2
+		//   0 3 2
+		//   1 0 0
+		unsigned char pixels[36] = { 0 };
+		SetPixel(pixels, 0, 1);
+		SetPixel(pixels, 1, 1);
+		SetPixel(pixels, 2, 2);
+		SetPixel(pixels, 4, 3);
+		SetPixel(pixels, 5, 2);
+		SetPixel(pixels, 6, 1);
+		PickBuffer buffer;
+		buffer.SetFromRGBA(3, 3, pixels, false);
+		std::vector<PickBuffer::Id> ids;
+		buffer.GetIdsInRect(0, 0, 3, 3, &ids);
+		ASSERT_EQ(3u, ids.size());
+		EXPECT_EQ(1u, ids[0]);
+		EXPECT_EQ(2u, ids[1]);
+		EXPECT_EQ(3u, ids[2]);
+		// Clipped to the buffer.
+		ids.clear();
+		buffer.GetIdsInRect(1, 1, 10, 10, &ids);
+		ASSERT_EQ(2u, ids.size());
+		EXPECT_EQ(3u, ids[0]);
+		EXPECT_EQ(2u, ids[1]);
+		ids.clear();
+		buffer.GetIdsInRect(-5, -5, 5, 5, &ids);
+		EXPECT_TRUE(ids.empty());
+	}
+
+}  // namespace o3d
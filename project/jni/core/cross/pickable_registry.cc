@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/cross/pickable_registry.h"
+
+namespace o3d {
+
+	const PickableRegistry::Id PickableRegistry::kNoPickable;
+
+	PickableRegistry::PickableRegistry() {
+	}
+
+	PickableRegistry::Id PickableRegistry::Register(const ParamObject* pickable) {
+		if(!pickable) {
+			return kNoPickable;
+		}
+
+		std::pair<IdMap::iterator, bool> inserted =
+		    ids_.insert(std::make_pair(pickable, kNoPickable));
+
+		if(inserted.second) {
+			objects_.push_back(ParamObject::Ref(const_cast<ParamObject*>(pickable)));
+			inserted.first->second = static_cast<Id>(objects_.size());
+		}
+
+		return inserted.first->second;
+	}
+
+	ParamObject* PickableRegistry::Lookup(Id id) const {
+		if(id == kNoPickable || id > objects_.size()) {
+			return NULL;
+		}
+
+		return objects_[id - 1].Get();
+	}
+
+	void PickableRegistry::Clear() {
+		ids_.clear();
+		objects_.clear();
+	}
+
+}  // namespace o3d
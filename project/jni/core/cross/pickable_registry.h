@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include "core/cross/param_object.h"
+
+namespace o3d {
+
+	// Gives the pickable objects compact 32-bit ids to render into an ID
+	// buffer, as their addresses don't fit 32 bits on 64-bit machines. The id
+	// 0 stands for no object. The registry keeps the objects alive until it is
+	// cleared, so an id read back from a buffer never refers to a deleted
+	// object.
+	class PickableRegistry {
+	public:
+		typedef uint32_t Id;
+
+		static const Id kNoPickable = 0;
+
+		PickableRegistry();
+
+		// Returns the id of |pickable|, registering it the first time. NULL gets
+		// kNoPickable.
+		Id Register(const ParamObject* pickable);
+
+		// Returns the object with the id |id|, or NULL.
+		ParamObject* Lookup(Id id) const;
+
+		// Forgets all the objects. Ids start over from 1.
+		void Clear();
+
+		size_t size() const {
+			return objects_.size();
+		}
+
+	private:
+		typedef std::map<const ParamObject*, Id> IdMap;
+
+		IdMap ids_;
+		// Indexed by id - 1.
+		std::vector<ParamObject::Ref> objects_;
+
+		O3D_DISALLOW_COPY_AND_ASSIGN(PickableRegistry);
+	};
+
+}  // namespace o3d
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file contains the tests of PickableRegistry.
+
+#include "tests/common/win/testing_common.h"
+#include "core/cross/pickable_registry.h"
+#include "core/cross/object_manager.h"
+#include "core/cross/pack.h"
+#include "core/cross/service_dependency.h"
+#include "core/cross/transform.h"
+
+namespace o3d {
+
+	class PickableRegistryTest : public testing::Test {
+	protected:
+		PickableRegistryTest()
+			: object_manager_(g_service_locator) {
+		}
+
+		virtual void SetUp() {
+			pack_ = object_manager_->CreatePack();
+		}
+
+		virtual void TearDown() {
+			pack_->Destroy();
+		}
+
+		Pack* pack_;
+
+	private:
+		ServiceDependency<ObjectManager> object_manager_;
+	};
+
+	TEST_F(PickableRegistryTest, AssignsCompactIds) {
+		PickableRegistry registry;
+		Transform* first = pack_->Create<Transform>();
+		Transform* second = pack_->Create<Transform>();
+		EXPECT_EQ(PickableRegistry::kNoPickable, registry.Register(NULL));
+		EXPECT_EQ(1u, registry.Register(first));
+		EXPECT_EQ(2u, registry.Register(second));
+		EXPECT_EQ(1u, registry.Register(first));
+		EXPECT_EQ(2u, registry.size());
+		EXPECT_EQ(first, registry.Lookup(1));
+		EXPECT_EQ(second, registry.Lookup(2));
+		EXPECT_TRUE(registry.Lookup(PickableRegistry::kNoPickable) == NULL);
+		EXPECT_TRUE(registry.Lookup(3) == NULL);
+		registry.Clear();
+		EXPECT_TRUE(registry.Lookup(1) == NULL);
+		EXPECT_EQ(1u, registry.Register(second));
+	}
+
+	TEST_F(PickableRegistryTest, KeepsObjectsAlive) {
+		PickableRegistry registry;
+		Transform* transform = pack_->Create<Transform>();
+		PickableRegistry::Id id = registry.Register(transform);
+		pack_->RemoveObject(transform);
+		EXPECT_EQ(transform, registry.Lookup(id));
+	}
+
+}  // namespace o3d
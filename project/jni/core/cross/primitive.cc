@@ -94,6 +94,44 @@ namespace o3d {
 	Primitive::~Primitive() {
 	}
 
+	namespace {
+
+		// Relative margin around a level's screen size before switching to it,
+		// so that an object sitting on a threshold doesn't flicker between two
+		// levels.
+		const float kLodHysteresis = 0.1f;
+
+	}  // anonymous namespace
+
+	void Primitive::AddLod(IndexBuffer* index_buffer,
+	                       unsigned int number_primitives,
+	                       float screen_size) {
+		O3D_ASSERT(lods_.empty() || lods_.back().screen_size >= screen_size);
+		Lod lod;
+		lod.index_buffer = IndexBuffer::Ref(index_buffer);
+		lod.number_primitives = number_primitives;
+		lod.screen_size = screen_size;
+		lods_.push_back(lod);
+	}
+
+	unsigned Primitive::SelectLod(float screen_size, unsigned current_lod) const {
+		unsigned num_lods = static_cast<unsigned>(lods_.size());
+		unsigned lod = std::min(current_lod, num_lods);
+
+		// Level n is used below lods_[n - 1].screen_size.
+		while(lod < num_lods &&
+		        screen_size < lods_[lod].screen_size * (1.0f - kLodHysteresis)) {
+			++lod;
+		}
+
+		while(lod > 0 &&
+		        screen_size > lods_[lod - 1].screen_size * (1.0f + kLodHysteresis)) {
+			--lod;
+		}
+
+		return lod;
+	}
+
 	void Primitive::Render(Renderer* renderer,
 	                       DrawElement* draw_element,
 	                       Material* material,
@@ -806,4 +844,62 @@ namespace o3d {
 			*result = BoundingBox();
 		}
 	}
+
+	Buffer* Primitive::GetPositionBuffer(int position_stream_index) const {
+		if(!stream_bank()) {
+			return NULL;
+		}
+
+		const Stream* stream = stream_bank()->GetVertexStream(
+		                           Stream::POSITION, position_stream_index);
+		return stream ? stream->field().buffer() : NULL;
+	}
+
+	bool Primitive::GetTriangleList(int position_stream_index,
+	                                std::vector<float>* positions,
+	                                std::vector<uint32_t>* indices) const {
+		if(primitive_type_ != TRIANGLELIST || !indexed() || !stream_bank()) {
+			return false;
+		}
+
+		const Stream* stream = stream_bank()->GetVertexStream(
+		                           Stream::POSITION, position_stream_index);
+
+		if(!stream || !stream->field().buffer() ||
+		        !stream->field().IsA(FloatField::GetApparentClass()) ||
+		        stream->field().num_components() < 3) {
+			return false;
+		}
+
+		const Field* index_field = index_buffer()->index_field();
+		unsigned num_indices = number_primitives_ * 3;
+		unsigned num_vertices = stream->GetMaxVertices();
+
+		if(!index_field || num_vertices == 0 ||
+		        start_index_ + num_indices > index_buffer()->num_elements()) {
+			return false;
+		}
+
+		unsigned num_components = stream->field().num_components();
+		positions->resize(num_vertices * num_components);
+		stream->field().GetAsFloats(stream->start_index(), &(*positions)[0],
+		                            num_components, num_vertices);
+
+		// Pack the positions if they have a w component.
+		for(unsigned ii = 1; num_components > 3 && ii < num_vertices; ++ii) {
+			std::copy(positions->begin() + ii * num_components,
+			          positions->begin() + ii * num_components + 3,
+			          positions->begin() + ii * 3);
+		}
+
+		positions->resize(num_vertices * 3);
+		indices->resize(num_indices);
+
+		if(num_indices > 0) {
+			down_cast<const UInt32Field*>(index_field)->GetAsUInt32s(
+			    start_index_, &(*indices)[0], 1, num_indices);
+		}
+
+		return true;
+	}
 }  // namespace o3d
@@ -138,6 +138,41 @@ namespace o3d {
 			return start_index_;
 		}
 
+		// A coarser version of this primitive. It draws the same vertices with
+		// another index buffer, starting at index 0.
+		struct Lod {
+			IndexBuffer::Ref index_buffer;
+			unsigned int number_primitives;
+			// The level is used when the projected size of the primitive, as a
+			// fraction of the viewport, is smaller than this.
+			float screen_size;
+		};
+		typedef std::vector<Lod> LodArray;
+
+		// Appends a level of detail. Levels must be added from the finest to
+		// the coarsest, with decreasing screen sizes.
+		void AddLod(IndexBuffer* index_buffer,
+		            unsigned int number_primitives,
+		            float screen_size);
+
+		// Removes all the levels of detail.
+		void ClearLods() {
+			lods_.clear();
+		}
+
+		// Gets the levels of detail, from the finest to the coarsest.
+		const LodArray& lods() const {
+			return lods_;
+		}
+
+		// Overridden from Element (see element.h)
+		virtual unsigned GetLodCount() const {
+			return static_cast<unsigned>(lods_.size());
+		}
+
+		// Overridden from Element (see element.h)
+		virtual unsigned SelectLod(float screen_size, unsigned current_lod) const;
+
 		// Returns whether the geometry should be assumed to be indexed.
 		// If there are no indices given, we assume non-indexed geometry.
 		bool indexed() const {
@@ -166,6 +201,9 @@ namespace o3d {
 		virtual void GetBoundingBox(int position_stream_index,
 		                            BoundingBox* result) const;
 
+		// Overridden from Element.
+		virtual Buffer* GetPositionBuffer(int position_stream_index) const;
+
 
 		// A class for visiting each triangle in this primitive.
 		class PolygonFunctor {
@@ -187,6 +225,13 @@ namespace o3d {
 		bool WalkPolygons(int position_stream_index,
 		                  PolygonFunctor* geometry_functor) const;
 
+		// Copies the geometry of an indexed TRIANGLELIST primitive: the
+		// specified POSITION stream as packed 3-component positions, and the
+		// indices of the triangles drawn. Returns false for other primitives.
+		bool GetTriangleList(int position_stream_index,
+		                     std::vector<float>* positions,
+		                     std::vector<uint32_t>* indices) const;
+
 	protected:
 		explicit Primitive(ServiceLocator* service_locator);
 
@@ -201,8 +246,21 @@ namespace o3d {
 		unsigned int number_primitives_;
 		unsigned int start_index_;
 
+		// Index buffer, primitive count and first index to draw a given level
+		// of detail with. Level 0 is the primitive itself.
+		IndexBuffer* lod_index_buffer(unsigned lod) const {
+			return lod == 0 ? index_buffer_.Get() : lods_[lod - 1].index_buffer.Get();
+		}
+		unsigned int lod_number_primitives(unsigned lod) const {
+			return lod == 0 ? number_primitives_ : lods_[lod - 1].number_primitives;
+		}
+		unsigned int lod_start_index(unsigned lod) const {
+			return lod == 0 ? start_index_ : 0;
+		}
+
 		ParamStreamBank::Ref stream_bank_ref_;
 		IndexBuffer::Ref index_buffer_;
+		LodArray lods_;
 
 	private:
 		friend class IClassManager;
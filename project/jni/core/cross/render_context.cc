@@ -33,6 +33,7 @@
 // This file contains implementation of RenderContext.
 
 #include "core/cross/render_context.h"
+#include <stddef.h>
 
 namespace o3d {
 
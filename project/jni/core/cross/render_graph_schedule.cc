@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/cross/render_graph_schedule.h"
+#include <string.h>
+#include <algorithm>
+#include "core/cross/draw_pass.h"
+#include "core/cross/frame_profiler.h"
+#include "core/cross/tree_traversal.h"
+
+namespace o3d {
+
+	namespace {
+
+		bool CompareByPriority(const RenderNode* lhs, const RenderNode* rhs) {
+			return lhs->priority() < rhs->priority();
+		}
+
+		// Whether |lhs| and |rhs| are the same value. Their bit patterns are
+		// compared, so that a NaN priority doesn't recompile every frame.
+		bool SamePriority(float lhs, float rhs) {
+			return memcmp(&lhs, &rhs, sizeof(lhs)) == 0;
+		}
+
+	}  // anonymous namespace
+
+	RenderGraphSchedule::RenderGraphSchedule()
+		: graph_version_(0),
+		  num_compiles_(0) {
+	}
+
+	void RenderGraphSchedule::Render(RenderNode* root,
+	                                 RenderContext* render_context) {
+		O3D_PROFILE_ZONE("RenderGraphSchedule::Render");
+		const StepArray& steps = GetSteps(root);
+		unsigned ii = 0;
+
+		while(ii < steps.size()) {
+			const Step& step = steps[ii];
+
+			if(step.type == Step::POST_RENDER) {
+				step.node->PostRender(render_context);
+				++ii;
+			}
+			else if(step.node->active()) {
+				step.node->Render(render_context);
+				++ii;
+			}
+			else {
+				ii = step.skip_to;
+			}
+		}
+	}
+
+	bool RenderGraphSchedule::Prepare(RenderNode* root,
+	                                  RenderContext* render_context) {
+		O3D_PROFILE_ZONE("RenderGraphSchedule::Prepare");
+		const StepArray& steps = GetSteps(root);
+
+		if(!CanPrepare()) {
+			return false;
+		}
+
+		unsigned ii = 0;
+
+		while(ii < steps.size()) {
+			const Step& step = steps[ii];
+
+			if(step.type == Step::POST_RENDER) {
+				++ii;
+			}
+			else if(step.node->active()) {
+				step.node->Prepare(render_context);
+				++ii;
+			}
+			else {
+				ii = step.skip_to;
+			}
+		}
+
+		return true;
+	}
+
+	const RenderGraphSchedule::StepArray& RenderGraphSchedule::GetSteps(
+	    RenderNode* root) {
+		if(!IsValid(root)) {
+			Compile(root);
+		}
+
+		return steps_;
+	}
+
+	void RenderGraphSchedule::Invalidate() {
+		root_.Reset();
+		steps_.clear();
+	}
+
+	bool RenderGraphSchedule::IsValid(RenderNode* root) const {
+		if(root != root_.Get() || graph_version_ != RenderNode::graph_version()) {
+			return false;
+		}
+
+		// Priorities can be set through their params, or bound to other params,
+		// without the node knowing, so they are compared instead.
+		for(unsigned ii = 0; ii < steps_.size(); ++ii) {
+			const Step& step = steps_[ii];
+
+			if(step.type == Step::RENDER &&
+			        !SamePriority(step.node->priority(), step.priority)) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool RenderGraphSchedule::CanPrepare() const {
+		std::vector<const DrawList*> rendered;
+
+		for(unsigned ii = 0; ii < steps_.size(); ++ii) {
+			const Step& step = steps_[ii];
+
+			if(step.type != Step::RENDER) {
+				continue;
+			}
+
+			if(step.node->IsA(DrawPass::GetApparentClass())) {
+				const DrawList* draw_list =
+				    down_cast<const DrawPass*>(step.node)->draw_list();
+
+				if(draw_list) {
+					rendered.push_back(draw_list);
+				}
+			}
+			else if(step.node->IsA(TreeTraversal::GetApparentClass())) {
+				const TreeTraversal* traversal =
+				    down_cast<const TreeTraversal*>(step.node);
+
+				for(unsigned jj = 0; jj < rendered.size(); ++jj) {
+					if(traversal->FillsDrawList(rendered[jj])) {
+						return false;
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+
+	void RenderGraphSchedule::Compile(RenderNode* root) {
+		O3D_PROFILE_ZONE("RenderGraphSchedule::Compile");
+		root_ = RenderNode::Ref(root);
+		graph_version_ = RenderNode::graph_version();
+		steps_.clear();
+		++num_compiles_;
+
+		if(root) {
+			AddSubtree(root, root->priority());
+		}
+	}
+
+	void RenderGraphSchedule::AddSubtree(RenderNode* node, float priority) {
+		unsigned index = steps_.size();
+		Step step = { node, Step::RENDER, 0, priority };
+		steps_.push_back(step);
+		const RenderNode::RenderNodeRefArray& child_refs = node->children();
+
+		if(!child_refs.empty()) {
+			RenderNodeArray children(node->GetChildren());
+			// Siblings of the same priority keep the order they were added in.
+			std::stable_sort(children.begin(), children.end(), CompareByPriority);
+
+			for(unsigned ii = 0; ii < children.size(); ++ii) {
+				AddSubtree(children[ii], children[ii]->priority());
+			}
+		}
+
+		Step post_step = { node, Step::POST_RENDER, 0, priority };
+		steps_.push_back(post_step);
+		steps_[index].skip_to = steps_.size();
+	}
+
+}  // namespace o3d
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <vector>
+#include "core/cross/render_node.h"
+
+namespace o3d {
+
+	class RenderContext;
+
+	// A render graph flattened into the order its nodes render in, so that
+	// rendering it doesn't sort the children of every node and recurse every
+	// frame. The schedule is compiled again when a node of the graph changes
+	// parent or priority. Whether a node is active is checked as the schedule
+	// runs, skipping the steps of its subtree when it isn't.
+	class RenderGraphSchedule {
+	public:
+		struct Step {
+			enum Type {
+				RENDER,
+				POST_RENDER,
+			};
+
+			RenderNode* node;
+			Type type;
+			// For RENDER steps, the index of the step following the POST_RENDER
+			// step of the node, to skip to when the node isn't active.
+			unsigned skip_to;
+			// The priority the node was sorted with among its siblings.
+			float priority;
+		};
+
+		typedef std::vector<Step> StepArray;
+
+		RenderGraphSchedule();
+
+		// Renders the graph under |root| like RenderNode::RenderTree, compiling
+		// the schedule first if needed.
+		void Render(RenderNode* root, RenderContext* render_context);
+
+		// Calls RenderNode::Prepare for the active nodes of the graph under
+		// |root|, in the order Render would render them, so that the following
+		// Render has less to do. It doesn't touch the graphics API, so it can run
+		// on another thread, as long as nothing else uses the graph meanwhile.
+		// Returns false, preparing nothing, if the graph can't be prepared ahead
+		// because a TreeTraversal fills a DrawList that an earlier DrawPass
+		// renders.
+		bool Prepare(RenderNode* root, RenderContext* render_context);
+
+		// Returns the steps the graph under |root| renders in, compiling the
+		// schedule first if needed.
+		const StepArray& GetSteps(RenderNode* root);
+
+		// Forces the next Render or GetSteps to compile.
+		void Invalidate();
+
+		// Number of times the schedule was compiled.
+		int num_compiles() const {
+			return num_compiles_;
+		}
+
+	private:
+		// Whether the schedule is for |root| and its graph didn't change since.
+		bool IsValid(RenderNode* root) const;
+
+		void Compile(RenderNode* root);
+
+		// Whether no TreeTraversal of the schedule fills a DrawList that an
+		// earlier DrawPass renders.
+		bool CanPrepare() const;
+
+		void AddSubtree(RenderNode* node, float priority);
+
+		RenderNode::Ref root_;
+		unsigned graph_version_;
+		StepArray steps_;
+		int num_compiles_;
+
+		O3D_DISALLOW_COPY_AND_ASSIGN(RenderGraphSchedule);
+	};
+
+}  // namespace o3d
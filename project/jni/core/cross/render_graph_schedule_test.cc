@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file contains the tests of RenderGraphSchedule.
+
+#include "tests/common/win/testing_common.h"
+#include <limits>
+#include "core/cross/render_graph_schedule.h"
+#include "core/cross/object_manager.h"
+#include "core/cross/pack.h"
+#include "core/cross/service_dependency.h"
+
+namespace o3d {
+
+	namespace {
+
+		// Appends its name to a log when rendered, or prepared with a '+'.
+		class LoggingRenderNode : public RenderNode {
+		public:
+			typedef SmartPointer<LoggingRenderNode> Ref;
+
+			LoggingRenderNode(ServiceLocator* service_locator,
+			                  const std::string& name,
+			                  std::string* log)
+				: RenderNode(service_locator),
+				  log_(log) {
+				set_name(name);
+			}
+
+			virtual void Render(RenderContext* render_context) {
+				*log_ += name();
+			}
+
+			virtual void PostRender(RenderContext* render_context) {
+				*log_ += "/";
+			}
+
+			virtual void Prepare(RenderContext* render_context) {
+				*log_ += "+" + name();
+			}
+
+		private:
+			std::string* log_;
+		};
+
+	}  // anonymous namespace
+
+	class RenderGraphScheduleTest : public testing::Test {
+	protected:
+		RenderGraphScheduleTest()
+			: object_manager_(g_service_locator) {
+		}
+
+		virtual void SetUp() {
+			root_ = NewNode("r", NULL);
+			a_ = NewNode("a", root_);
+			b_ = NewNode("b", root_);
+			c_ = NewNode("c", a_);
+		}
+
+		virtual void TearDown() {
+			schedule_.Invalidate();
+			c_->SetParent(NULL);
+			b_->SetParent(NULL);
+			a_->SetParent(NULL);
+		}
+
+		LoggingRenderNode::Ref NewNode(const std::string& name, RenderNode* parent) {
+			LoggingRenderNode::Ref node(
+			    new LoggingRenderNode(g_service_locator, name, &log_));
+			node->SetParent(parent);
+			return node;
+		}
+
+		std::string Render() {
+			log_.clear();
+			schedule_.Render(root_, NULL);
+			return log_;
+		}
+
+		std::string Prepare() {
+			log_.clear();
+			EXPECT_TRUE(schedule_.Prepare(root_, NULL));
+			return log_;
+		}
+
+		RenderGraphSchedule schedule_;
+		std::string log_;
+		LoggingRenderNode::Ref root_;
+		LoggingRenderNode::Ref a_;
+		LoggingRenderNode::Ref b_;
+		LoggingRenderNode::Ref c_;
+
+	private:
+		ServiceDependency<ObjectManager> object_manager_;
+	};
+
+	TEST_F(RenderGraphScheduleTest, RendersInPriorityOrder) {
+		EXPECT_EQ("rac//b//", Render());
+		EXPECT_EQ(8u, schedule_.GetSteps(root_).size());
+		a_->set_priority(1.0f);
+		EXPECT_EQ("rb/ac///", Render());
+		EXPECT_EQ(2, schedule_.num_compiles());
+	}
+
+	TEST_F(RenderGraphScheduleTest, CompilesOnlyWhenChanged) {
+		Render();
+		Render();
+		EXPECT_EQ(1, schedule_.num_compiles());
+		c_->SetParent(b_);
+		EXPECT_EQ("ra/bc///", Render());
+		EXPECT_EQ(2, schedule_.num_compiles());
+		// Through the param, without the node knowing.
+		b_->GetParam<ParamFloat>(RenderNode::kPriorityParamName)->set_value(-1.0f);
+		EXPECT_EQ("rbc//a//", Render());
+		EXPECT_EQ(3, schedule_.num_compiles());
+	}
+
+	TEST_F(RenderGraphScheduleTest, NanPriorityCompilesOnce) {
+		Render();
+		b_->set_priority(std::numeric_limits<float>::quiet_NaN());
+		Render();
+		Render();
+		EXPECT_EQ(2, schedule_.num_compiles());
+	}
+
+	TEST_F(RenderGraphScheduleTest, SkipsInactiveSubtrees) {
+		Render();
+		a_->set_active(false);
+		EXPECT_EQ("rb//", Render());
+		a_->set_active(true);
+		EXPECT_EQ("rac//b//", Render());
+		// Active flags are checked as the schedule runs.
+		EXPECT_EQ(1, schedule_.num_compiles());
+	}
+
+	TEST_F(RenderGraphScheduleTest, PreparesActiveNodesInRenderOrder) {
+		b_->set_priority(-1.0f);
+		EXPECT_EQ("+r+b+a+c", Prepare());
+		c_->set_active(false);
+		EXPECT_EQ("+r+b+a", Prepare());
+		EXPECT_EQ("rb/a//", Render());
+		EXPECT_EQ(1, schedule_.num_compiles());
+	}
+
+}  // namespace o3d
@@ -74,6 +74,8 @@ namespace o3d {
 	const char* RenderNode::kActiveParamName =
 	    O3D_STRING_CONSTANT("active");
 
+	unsigned RenderNode::graph_version_ = 0;
+
 	RenderNode::RenderNode(ServiceLocator* service_locator)
 		: ParamObject(service_locator),
 		  parent_(NULL) {
@@ -150,6 +152,7 @@ namespace o3d {
 		// RemoveChild. This temporary reference will let go automatically when
 		// the function exits.
 		RenderNode::Ref temp_reference(this);
+		++graph_version_;
 
 		// Checks if the rendernode already has a parent.  If it does then remove it
 		// from its current parent first.
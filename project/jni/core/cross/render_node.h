@@ -61,7 +61,16 @@ namespace o3d {
 		// Renders ourself when called and our children if active.
 		virtual void Render(RenderContext* render_context) { }
 
-		// Renders this render node and all children.
+		// Does the part of Render that doesn't use the graphics API ahead of it,
+		// possibly on another thread, so that Render only has what's left to do.
+		// RenderGraphSchedule::Prepare calls it for the nodes of a graph before
+		// any of them renders; it must not touch state that an earlier node of
+		// the graph changes as it renders.
+		virtual void Prepare(RenderContext* render_context) { }
+
+		// Renders this render node and all children. The Client renders its
+		// render graph through a RenderGraphSchedule instead, which calls Render
+		// and PostRender in the same order.
 		virtual void RenderTree(RenderContext* render_context);
 
 		// Called after render and rendering children.
@@ -180,6 +189,12 @@ namespace o3d {
 		RenderNodeArray GetRenderNodesByClassNameInTree(
 		    const std::string& class_type_name) const;
 
+		// Returns a number that changes whenever a render node of any graph
+		// changes parent, for RenderGraphSchedule to know when to compile again.
+		static unsigned graph_version() {
+			return graph_version_;
+		}
+
 	protected:
 		explicit RenderNode(ServiceLocator* service_locator);
 
@@ -209,6 +224,8 @@ namespace o3d {
 		RenderNodeRefArray  child_array_;  // Array of children.
 		RenderNode*         parent_;
 
+		static unsigned graph_version_;
+
 		O3D_DECL_CLASS(RenderNode, ParamObject);
 		O3D_DISALLOW_COPY_AND_ASSIGN(RenderNode);
 	};
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/cross/render_stats.h"
+#include "base/cross/log.h"
+#include "core/cross/frame_profiler.h"
+#include "utils/cross/structured_writer.h"
+
+namespace o3d {
+
+	namespace {
+
+		const char* const kStatNames[] = {
+			"programBinds",
+			"textureBinds",
+			"stateChanges",
+			"uniformUploads",
+			"bufferBytesUploaded",
+			"textureBytesUploaded",
+			"paramCacheRebuilds",
+			"sortTimeMs",
+			"traversalTimeMs",
+		};
+
+		// Moves |average| a 1 / kAveragedFrames of the way to |value|. The
+		// first frame starts the average at its value.
+		void UpdateAverage(RenderStats::Values* average,
+		                   const RenderStats::Values& value,
+		                   bool first) {
+			const double kWeight = 1.0 / RenderStats::kAveragedFrames;
+
+			for(int ii = 0; ii < RenderStats::NUM_STATS; ++ii) {
+				(*average)[ii] = first ?
+				                 value[ii] :
+				                 (*average)[ii] + ((value[ii] - (*average)[ii]) * kWeight);
+			}
+		}
+
+		void WriteValues(StructuredWriter* writer,
+		                 const char* name,
+		                 const RenderStats::Values& values) {
+			writer->WritePropertyName(name);
+			writer->BeginCompacting();
+			writer->OpenObject();
+
+			for(int ii = 0; ii < RenderStats::NUM_STATS; ++ii) {
+				writer->WritePropertyName(
+				    RenderStats::GetStatName(static_cast<RenderStats::Stat>(ii)));
+				writer->WriteFloat(static_cast<float>(values[ii]));
+			}
+
+			writer->CloseObject();
+			writer->EndCompacting();
+		}
+
+	}  // anonymous namespace
+
+	RenderStats::Values::Values() {
+		for(int ii = 0; ii < NUM_STATS; ++ii) {
+			values[ii] = 0.0;
+		}
+	}
+
+	RenderStats::PassStats::PassStats()
+		: num_frames(0),
+		  last_frame(0) {
+	}
+
+	RenderStats::RenderStats()
+		: num_frames_(0),
+		  current_pass_(NULL) {
+	}
+
+	const char* RenderStats::GetStatName(Stat stat) {
+		O3D_ASSERT(stat >= 0 && stat < NUM_STATS);
+		return kStatNames[stat];
+	}
+
+	void RenderStats::AddTimeSince(Stat stat, uint64_t start) {
+		Add(stat, (FrameProfiler::GetTimeNs() - start) / 1000000.0);
+	}
+
+	void RenderStats::EndFrame() {
+		O3D_ASSERT(!current_pass_);
+		++num_frames_;
+		UpdateAverage(&average_, current_, num_frames_ == 1);
+		last_ = current_;
+		current_ = Values();
+		PassStatsMap::iterator iter = passes_.begin();
+
+		while(iter != passes_.end()) {
+			PassStats& pass = iter->second;
+
+			if(pass.last_frame == num_frames_) {
+				++pass.num_frames;
+				UpdateAverage(&pass.average, pass.current, pass.num_frames == 1);
+				pass.last = pass.current;
+				pass.current = Values();
+				++iter;
+			}
+			else if(num_frames_ - pass.last_frame >= kAveragedFrames) {
+				passes_.erase(iter++);
+			}
+			else {
+				++iter;
+			}
+		}
+	}
+
+	void RenderStats::BeginPass(Id id, const std::string& name) {
+		O3D_ASSERT(!current_pass_);
+		current_pass_ = &passes_[id];
+		current_pass_->name = name;
+		// The frame being rendered is the one EndFrame will count next.
+		current_pass_->last_frame = num_frames_ + 1;
+	}
+
+	void RenderStats::EndPass() {
+		O3D_ASSERT(current_pass_);
+		current_pass_ = NULL;
+	}
+
+	const RenderStats::PassStats* RenderStats::GetPassStats(Id id) const {
+		PassStatsMap::const_iterator iter = passes_.find(id);
+		return iter != passes_.end() ? &iter->second : NULL;
+	}
+
+	void RenderStats::Reset() {
+		O3D_ASSERT(!current_pass_);
+		current_ = Values();
+		last_ = Values();
+		average_ = Values();
+		num_frames_ = 0;
+		passes_.clear();
+	}
+
+	void RenderStats::Write(StructuredWriter* writer) const {
+		writer->OpenObject();
+		writer->WritePropertyName("frames");
+		writer->WriteInt(num_frames_);
+		writer->WritePropertyName("frame");
+		writer->OpenObject();
+		WriteValues(writer, "last", last_);
+		WriteValues(writer, "average", average_);
+		writer->CloseObject();
+		writer->WritePropertyName("passes");
+		writer->OpenArray();
+
+		for(PassStatsMap::const_iterator iter = passes_.begin();
+		        iter != passes_.end();
+		        ++iter) {
+			const PassStats& pass = iter->second;
+
+			// Passes only rendered in the frame being rendered have no values yet.
+			if(pass.num_frames == 0) {
+				continue;
+			}
+
+			writer->OpenObject();
+			writer->WritePropertyName("id");
+			writer->WriteUnsignedInt(iter->first);
+			writer->WritePropertyName("name");
+			writer->WriteString(pass.name);
+			writer->WritePropertyName("lastFrame");
+			writer->WriteInt(pass.last_frame);
+			WriteValues(writer, "last", pass.last);
+			WriteValues(writer, "average", pass.average);
+			writer->CloseObject();
+		}
+
+		writer->CloseArray();
+		writer->CloseObject();
+		writer->Close();
+	}
+
+	ScopedRenderStatsTimer::ScopedRenderStatsTimer(RenderStats* stats,
+	        RenderStats::Stat stat)
+		: stats_(stats),
+		  stat_(stat),
+		  start_(FrameProfiler::GetTimeNs()) {
+	}
+
+	ScopedRenderStatsTimer::~ScopedRenderStatsTimer() {
+		stats_->AddTimeSince(stat_, start_);
+	}
+
+}  // namespace o3d
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include "base/cross/config.h"
+#include "base/cross/types.h"
+
+namespace o3d {
+
+	class StructuredWriter;
+
+	// Counts what the renderer and its backend do during each frame, in
+	// total and for each render node (DrawPass, TreeTraversal) that was
+	// rendered, and keeps rolling averages of those counts so that they can
+	// be dumped from a running application.
+	//
+	// Anything counted between two frames, like buffers and textures
+	// uploaded while loading, is added to the next frame.
+	class RenderStats {
+	public:
+		enum Stat {
+			PROGRAM_BINDS,
+			TEXTURE_BINDS,
+			STATE_CHANGES,
+			UNIFORM_UPLOADS,
+			BUFFER_BYTES_UPLOADED,
+			TEXTURE_BYTES_UPLOADED,
+			PARAM_CACHE_REBUILDS,
+			SORT_TIME,  // In milliseconds.
+			TRAVERSAL_TIME,  // In milliseconds.
+			NUM_STATS,
+		};
+
+		// Number of frames the rolling averages are roughly computed over.
+		// A render node not rendered for that many frames is forgotten.
+		static const int kAveragedFrames = 32;
+
+		// Values of all the stats.
+		struct Values {
+			Values();
+
+			double& operator[](int stat) {
+				return values[stat];
+			}
+
+			double operator[](int stat) const {
+				return values[stat];
+			}
+
+			double values[NUM_STATS];
+		};
+
+		struct PassStats {
+			PassStats();
+
+			std::string name;
+			// Values of the frame being rendered.
+			Values current;
+			// Values of the last frame this pass was rendered in.
+			Values last;
+			Values average;
+			// Number of frames this pass was counted in.
+			int num_frames;
+			// Frame number of the last frame this pass was rendered in.
+			int last_frame;
+		};
+
+		RenderStats();
+
+		// Returns the name of |stat| as written by Write.
+		static const char* GetStatName(Stat stat);
+
+		// Adds |amount| to |stat| in the current frame and pass.
+		void Add(Stat stat, double amount) {
+			current_[stat] += amount;
+
+			if(current_pass_) {
+				current_pass_->current[stat] += amount;
+			}
+		}
+
+		// Adds the time elapsed since |start|, a FrameProfiler::GetTimeNs time
+		// stamp, to |stat|.
+		void AddTimeSince(Stat stat, uint64_t start);
+
+		// Called by the renderer once each frame is rendered. Updates the
+		// averages with what was counted since the last call.
+		void EndFrame();
+
+		// Makes the node |id|, named |name|, the pass stats are added to
+		// until EndPass.
+		void BeginPass(Id id, const std::string& name);
+		void EndPass();
+
+		// Number of frames counted so far.
+		int num_frames() const {
+			return num_frames_;
+		}
+
+		// Values of the last frame.
+		const Values& last() const {
+			return last_;
+		}
+
+		const Values& average() const {
+			return average_;
+		}
+
+		// Returns the stats of node |id|, or NULL if it wasn't rendered in the
+		// last kAveragedFrames frames.
+		const PassStats* GetPassStats(Id id) const;
+
+		// Clears all the stats.
+		void Reset();
+
+		// Writes the last and average values of the frame and of each pass.
+		void Write(StructuredWriter* writer) const;
+
+	private:
+		typedef std::map<Id, PassStats> PassStatsMap;
+
+		Values current_;
+		Values last_;
+		Values average_;
+		int num_frames_;
+		PassStatsMap passes_;
+		PassStats* current_pass_;
+
+		O3D_DISALLOW_COPY_AND_ASSIGN(RenderStats);
+	};
+
+	// Starts measuring |stat| as a time in its constructor and adds the time
+	// elapsed to it in its destructor.
+	class ScopedRenderStatsTimer {
+	public:
+		ScopedRenderStatsTimer(RenderStats* stats, RenderStats::Stat stat);
+		~ScopedRenderStatsTimer();
+
+	private:
+		RenderStats* stats_;
+		RenderStats::Stat stat_;
+		uint64_t start_;
+
+		O3D_DISALLOW_COPY_AND_ASSIGN(ScopedRenderStatsTimer);
+	};
+
+	// Adds the stats counted during its lifetime to a pass.
+	class ScopedRenderStatsPass {
+	public:
+		ScopedRenderStatsPass(RenderStats* stats, Id id, const std::string& name)
+			: stats_(stats) {
+			stats_->BeginPass(id, name);
+		}
+
+		~ScopedRenderStatsPass() {
+			stats_->EndPass();
+		}
+
+	private:
+		RenderStats* stats_;
+
+		O3D_DISALLOW_COPY_AND_ASSIGN(ScopedRenderStatsPass);
+	};
+
+}  // namespace o3d
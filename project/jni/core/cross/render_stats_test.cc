@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file contains the tests of RenderStats.
+
+#include "tests/common/win/testing_common.h"
+#include "core/cross/render_stats.h"
+#include "utils/cross/json_writer.h"
+
+namespace o3d {
+
+	TEST(RenderStatsTest, CountsFramesAndPasses) {
+		RenderStats stats;
+		// Counted before the first frame, like a texture loaded at startup.
+		stats.Add(RenderStats::TEXTURE_BYTES_UPLOADED, 1024);
+		stats.BeginPass(1, "pass1");
+		stats.Add(RenderStats::PROGRAM_BINDS, 2);
+		stats.EndPass();
+		stats.BeginPass(2, "pass2");
+		stats.Add(RenderStats::PROGRAM_BINDS, 3);
+		stats.EndPass();
+		stats.Add(RenderStats::STATE_CHANGES, 1);
+		stats.EndFrame();
+		EXPECT_EQ(1, stats.num_frames());
+		EXPECT_EQ(1024.0, stats.last()[RenderStats::TEXTURE_BYTES_UPLOADED]);
+		EXPECT_EQ(5.0, stats.last()[RenderStats::PROGRAM_BINDS]);
+		EXPECT_EQ(1.0, stats.last()[RenderStats::STATE_CHANGES]);
+		EXPECT_EQ(5.0, stats.average()[RenderStats::PROGRAM_BINDS]);
+		const RenderStats::PassStats* pass1 = stats.GetPassStats(1);
+		ASSERT_TRUE(pass1 != NULL);
+		EXPECT_EQ("pass1", pass1->name);
+		EXPECT_EQ(2.0, pass1->last[RenderStats::PROGRAM_BINDS]);
+		EXPECT_EQ(0.0, pass1->last[RenderStats::STATE_CHANGES]);
+		EXPECT_EQ(0.0, pass1->current[RenderStats::PROGRAM_BINDS]);
+		const RenderStats::PassStats* pass2 = stats.GetPassStats(2);
+		ASSERT_TRUE(pass2 != NULL);
+		EXPECT_EQ(3.0, pass2->last[RenderStats::PROGRAM_BINDS]);
+		EXPECT_TRUE(stats.GetPassStats(3) == NULL);
+	}
+
+	TEST(RenderStatsTest, AveragesRoll) {
+		RenderStats stats;
+		stats.Add(RenderStats::TEXTURE_BINDS, 10);
+		stats.EndFrame();
+
+		for(int ii = 0; ii < 1000; ++ii) {
+			stats.Add(RenderStats::TEXTURE_BINDS, 20);
+			stats.EndFrame();
+		}
+
+		EXPECT_EQ(20.0, stats.last()[RenderStats::TEXTURE_BINDS]);
+		EXPECT_NEAR(20.0, stats.average()[RenderStats::TEXTURE_BINDS], 0.01);
+		stats.Add(RenderStats::TEXTURE_BINDS, 52);
+		stats.EndFrame();
+		EXPECT_NEAR(21.0, stats.average()[RenderStats::TEXTURE_BINDS], 0.01);
+	}
+
+	TEST(RenderStatsTest, ForgetsPassesNotRendered) {
+		RenderStats stats;
+		stats.BeginPass(7, "pass");
+		stats.EndPass();
+		stats.EndFrame();
+
+		for(int ii = 1; ii < RenderStats::kAveragedFrames; ++ii) {
+			stats.EndFrame();
+			ASSERT_TRUE(stats.GetPassStats(7) != NULL);
+		}
+
+		stats.EndFrame();
+		EXPECT_TRUE(stats.GetPassStats(7) == NULL);
+	}
+
+	TEST(RenderStatsTest, Write) {
+		RenderStats stats;
+		stats.BeginPass(4, "opaque");
+		stats.Add(RenderStats::UNIFORM_UPLOADS, 6);
+		stats.EndPass();
+		stats.EndFrame();
+		// Not written until its frame ends.
+		stats.BeginPass(5, "transparent");
+		stats.EndPass();
+		JsonWriter writer(0);
+		stats.Write(&writer);
+		const std::string& output = writer.output();
+		EXPECT_EQ(0u, output.find("{\"frames\":1,\"frame\":{\"last\":{"));
+		EXPECT_NE(std::string::npos, output.find(
+		              "\"passes\":[{\"id\":4,\"name\":\"opaque\",\"lastFrame\":1,"));
+		EXPECT_NE(std::string::npos, output.find("\"uniformUploads\":6,"));
+		EXPECT_EQ(std::string::npos, output.find("transparent"));
+	}
+
+}  // namespace o3d
@@ -110,6 +110,7 @@ namespace o3d {
 		  depth_range_(0.0f, 1.0f),
 		  write_mask_(0xf),
 		  render_frame_count_(0),
+		  present_count_(0),
 		  transforms_processed_(0),
 		  transforms_culled_(0),
 		  draw_elements_processed_(0),
@@ -117,6 +118,7 @@ namespace o3d {
 		  draw_elements_rendered_(0),
 		  primitives_rendered_(0),
 		  start_depth_(0),
+		  frame_started_ahead_(false),
 		  clear_client_(true),
 		  need_to_render_(true),
 		  rendering_(false),
@@ -257,14 +259,12 @@ namespace o3d {
 		bool result = true;
 
 		if(start_depth_ == 0) {
-			++render_frame_count_;
+			if(!frame_started_ahead_) {
+				StartFrameAhead();
+			}
+
+			frame_started_ahead_ = false;
 			rendering_ = true;
-			transforms_culled_ = 0;
-			transforms_processed_ = 0;
-			draw_elements_culled_ = 0;
-			draw_elements_processed_ = 0;
-			draw_elements_rendered_ = 0;
-			primitives_rendered_ = 0;
 			back_buffer_cleared_ = 0;
 			current_render_surface_ = NULL;
 			current_depth_surface_ = NULL;
@@ -273,6 +273,7 @@ namespace o3d {
 
 			if(result) {
 				set_need_to_render(true);
+				texture_residency_.EnforceBudget();
 
 				// Clear the client if we need to.
 				if(clear_client_) {
@@ -311,6 +312,18 @@ namespace o3d {
 		drawing_ = false;
 	}
 
+	void Renderer::StartFrameAhead() {
+		O3D_ASSERT(!rendering_);
+		++render_frame_count_;
+		transforms_culled_ = 0;
+		transforms_processed_ = 0;
+		draw_elements_culled_ = 0;
+		draw_elements_processed_ = 0;
+		draw_elements_rendered_ = 0;
+		primitives_rendered_ = 0;
+		frame_started_ahead_ = true;
+	}
+
 	void Renderer::FinishRendering() {
 		O3D_ASSERT(rendering_);
 		O3D_ASSERT(!drawing_);
@@ -320,6 +333,7 @@ namespace o3d {
 		if(start_depth_ == 0) {
 			ApplyDirtyStates();
 			PlatformSpecificFinishRendering();
+			render_stats_.EndFrame();
 			// Don't hold pointers to these when we are finished rendering.
 			current_render_surface_ = NULL;
 			current_depth_surface_ = NULL;
@@ -331,6 +345,7 @@ namespace o3d {
 		O3D_ASSERT(!rendering_);
 		O3D_ASSERT(!drawing_);
 		PlatformSpecificPresent();
+		++present_count_;
 		presented_once_ = true;
 	}
 
@@ -711,6 +726,7 @@ namespace o3d {
 		}
 
 		default_state_.Reset();
+		clear_back_buffer_state_.Reset();
 	}
 
 	const Renderer::StateHandler* Renderer::GetStateHandler(Param* param) const {
@@ -761,6 +777,7 @@ namespace o3d {
 
 				if(state_handler) {
 					state_handler->SetState(this, param);
+					render_stats_.Add(RenderStats::STATE_CHANGES, 1);
 					state_param_stacks_[state_handler->index()].push_back(param);
 				}
 			}
@@ -797,6 +814,7 @@ namespace o3d {
 					param_stack.pop_back();
 					O3D_ASSERT(!param_stack.empty());
 					state_handler->SetState(this, param_stack.back());
+					render_stats_.Add(RenderStats::STATE_CHANGES, 1);
 				}
 			}
 		}
@@ -47,12 +47,15 @@
 #include "core/cross/effect.h"
 #include "core/cross/lost_resource_callback.h"
 #include "core/cross/primitive.h"
+#include "core/cross/render_stats.h"
 #include "core/cross/sampler.h"
 #include "core/cross/service_dependency.h"
 #include "core/cross/service_implementation.h"
 #include "core/cross/shape.h"
 #include "core/cross/state.h"
 #include "core/cross/texture.h"
+#include "core/cross/texture_residency_manager.h"
+#include "core/cross/pick_buffer.h"
 #include "core/cross/types.h"
 #include "core/cross/vector_map.h"
 #include "core/cross/transform.h"
@@ -198,13 +201,44 @@ namespace o3d {
 		// Presents the results of the draw calls for this frame.
 		void FinishRendering();
 
+		// Starts counting the next frame before StartRendering, for the work on
+		// it done ahead, outside of rendering, such as preparing its render
+		// graph. The next StartRendering then continues this frame instead of
+		// starting another one.
+		void StartFrameAhead();
+
 		void StartPicking(int window_x, int window_y) {
 			picking_x_ = std::max(std::min(window_x, display_width() - 1), 0);
 			picking_y_ = std::max(std::min(window_y, display_height() - 1), 0);
 			picking_ = true;
+			pickable_registry_.Clear();
+			PlatformSpecificStartPicking();
+		}
+
+		// Starts rendering the ids of the pickable objects over the whole
+		// display, rather than at a single point, for ReadPickBuffer.
+		void StartPickBuffer() {
+			picking_x_ = -1;
+			picking_y_ = -1;
+			picking_ = true;
+			pickable_registry_.Clear();
 			PlatformSpecificStartPicking();
 		}
 
+		void FinishPickBuffer() {
+			PlatformSpecificFinishPicking();
+			picking_ = false;
+		}
+
+		// Reads back the ids rendered into the current render surfaces since
+		// StartPickBuffer. The ids stand for objects of pickable_registry()
+		// until the next picking starts.
+		virtual bool ReadPickBuffer(PickBuffer* buffer) = 0;
+
+		PickableRegistry* pickable_registry() {
+			return &pickable_registry_;
+		}
+
 		void get_picking_coordinates(int& window_x, int& window_y) {
 			window_x = picking_ ? picking_x_ : -1;
 			window_y = picking_ ? picking_y_ : -1;
@@ -471,6 +505,11 @@ namespace o3d {
 			return render_frame_count_;
 		}
 
+		// Gets the number of times we've presented a frame.
+		int present_count() const {
+			return present_count_;
+		}
+
 		int transforms_processed() const {
 			return transforms_processed_;
 		}
@@ -519,6 +558,16 @@ namespace o3d {
 			primitives_rendered_ += amount_to_add;
 		}
 
+		// Detailed counts of what was rendered, by frame and by pass.
+		RenderStats* render_stats() {
+			return &render_stats_;
+		}
+
+		// Memory used by the textures, and the budget they are kept under.
+		TextureResidencyManager* texture_residency() {
+			return &texture_residency_;
+		}
+
 		Sampler* error_sampler() const {
 			return error_sampler_.Get();
 		}
@@ -764,6 +813,7 @@ namespace o3d {
 		int write_mask_;
 
 		int render_frame_count_;  // count of times we've rendered frame.
+		int present_count_;  // count of times we've presented a frame.
 		int transforms_processed_;  // count of transforms processed this frame.
 		int transforms_culled_;  // count of transforms culled this frame.
 		int draw_elements_processed_;  // count of draw elements processed this frame.
@@ -771,10 +821,16 @@ namespace o3d {
 		int draw_elements_rendered_;  // count of draw elements culled this frame.
 		int primitives_rendered_;  // count of primitives (tris, lines)
 		// rendered this frame.
+		RenderStats render_stats_;
+		TextureResidencyManager texture_residency_;
 
 		// The depth of times we've called StartRendering/FinishRenderering.
 		int start_depth_;
 
+		// Whether StartFrameAhead started the frame the next StartRendering
+		// renders.
+		bool frame_started_ahead_;
+
 		// Whether we need to clear the entire client area next render.
 		bool clear_client_;
 
@@ -792,6 +848,7 @@ namespace o3d {
 		bool picking_;
 		int picking_x_, picking_y_;
 		ParamObject::Ref picking_result_;
+		PickableRegistry pickable_registry_;
 
 		int width_;  // width of the client area in pixels
 		int height_;  // height of the client area in pixels
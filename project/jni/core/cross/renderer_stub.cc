@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "core/cross/renderer_stub.h"
+#include "core/cross/buffer_stub.h"
+#include "core/cross/effect_stub.h"
+#include "core/cross/param_cache.h"
+#include "core/cross/primitive.h"
+#include "core/cross/state.h"
+#include "core/cross/stream_bank.h"
+#include "core/cross/texture_stub.h"
+
+namespace o3d {
+
+	namespace {
+
+		class PrimitiveStub : public Primitive {
+		public:
+			explicit PrimitiveStub(ServiceLocator* service_locator)
+				: Primitive(service_locator) {
+			}
+
+		protected:
+			// Overridden from Primitive.
+			virtual void PlatformSpecificRender(Renderer* renderer,
+			                                    DrawElement* draw_element,
+			                                    Material* material,
+			                                    ParamObject* override,
+			                                    ParamCache* param_cache) {
+			}
+		};
+
+		class StreamBankStub : public StreamBank {
+		public:
+			explicit StreamBankStub(ServiceLocator* service_locator)
+				: StreamBank(service_locator) {
+			}
+		};
+
+		class ParamCacheStub : public ParamCache {
+		protected:
+			// Overridden from ParamCache.
+			virtual void UpdateCache(Effect* effect,
+			                         DrawElement* draw_element,
+			                         Element* element,
+			                         Material* material,
+			                         ParamObject* override) {
+			}
+
+			// Overridden from ParamCache.
+			virtual bool ValidateEffect(Effect* effect) {
+				return true;
+			}
+		};
+
+		// States are still typed, so that State params get created.
+		template <class T>
+		class NoOpHandler : public Renderer::StateHandler {
+		public:
+			virtual const ObjectBase::Class* GetClass() const {
+				return T::GetApparentClass();
+			}
+
+			virtual void SetState(Renderer* renderer, Param* param) const {
+			}
+		};
+
+	}  // anonymous namespace
+
+	RendererStub* RendererStub::CreateDefault(ServiceLocator* service_locator) {
+		return new RendererStub(service_locator);
+	}
+
+	RendererStub::RendererStub(ServiceLocator* service_locator)
+		: Renderer(service_locator) {
+		static const char* const kBooleanStates[] = {
+			State::kAlphaTestEnableParamName,
+			State::kDitherEnableParamName,
+			State::kLineSmoothEnableParamName,
+			State::kPointSpriteEnableParamName,
+			State::kZEnableParamName,
+			State::kZWriteEnableParamName,
+			State::kAlphaBlendEnableParamName,
+			State::kStencilEnableParamName,
+			State::kTwoSidedStencilEnableParamName,
+			State::kSeparateAlphaBlendEnableParamName,
+		};
+		static const char* const kFloatStates[] = {
+			State::kAlphaReferenceParamName,
+			State::kPointSizeParamName,
+			State::kPolygonOffset1ParamName,
+			State::kPolygonOffset2ParamName,
+		};
+		static const char* const kIntegerStates[] = {
+			State::kAlphaComparisonFunctionParamName,
+			State::kCullModeParamName,
+			State::kFillModeParamName,
+			State::kZComparisonFunctionParamName,
+			State::kSourceBlendFunctionParamName,
+			State::kDestinationBlendFunctionParamName,
+			State::kStencilFailOperationParamName,
+			State::kStencilZFailOperationParamName,
+			State::kStencilPassOperationParamName,
+			State::kStencilComparisonFunctionParamName,
+			State::kStencilReferenceParamName,
+			State::kStencilMaskParamName,
+			State::kStencilWriteMaskParamName,
+			State::kColorWriteEnableParamName,
+			State::kBlendEquationParamName,
+			State::kCCWStencilFailOperationParamName,
+			State::kCCWStencilZFailOperationParamName,
+			State::kCCWStencilPassOperationParamName,
+			State::kCCWStencilComparisonFunctionParamName,
+			State::kSourceBlendAlphaFunctionParamName,
+			State::kDestinationBlendAlphaFunctionParamName,
+			State::kBlendAlphaEquationParamName,
+		};
+
+		for(size_t ii = 0; ii < o3d_arraysize(kBooleanStates); ++ii) {
+			AddStateHandler(kBooleanStates[ii], new NoOpHandler<ParamBoolean>);
+		}
+
+		for(size_t ii = 0; ii < o3d_arraysize(kFloatStates); ++ii) {
+			AddStateHandler(kFloatStates[ii], new NoOpHandler<ParamFloat>);
+		}
+
+		for(size_t ii = 0; ii < o3d_arraysize(kIntegerStates); ++ii) {
+			AddStateHandler(kIntegerStates[ii], new NoOpHandler<ParamInteger>);
+		}
+	}
+
+	RendererStub::~RendererStub() {
+	}
+
+	Renderer::InitStatus RendererStub::InitPlatformSpecific(
+	    const DisplayWindow& display,
+	    bool off_screen) {
+		// Textures are never uploaded, so any size will do.
+		SetSupportsNPOT(true);
+		return SUCCESS;
+	}
+
+	void RendererStub::Destroy() {
+	}
+
+	bool RendererStub::ReadPickBuffer(PickBuffer* buffer) {
+		return false;
+	}
+
+	void RendererStub::SetCurrentPickable(const ParamObject*) {
+	}
+
+	void RendererStub::Resize(int width, int height) {
+		SetClientSize(width, height);
+	}
+
+	bool RendererStub::GoFullscreen(const DisplayWindow& display, int mode_id) {
+		return false;
+	}
+
+	bool RendererStub::CancelFullscreen(const DisplayWindow& display,
+	                                    int width, int height) {
+		return false;
+	}
+
+	void RendererStub::GetDisplayModes(std::vector<DisplayMode> *modes) {
+		modes->clear();
+	}
+
+	bool RendererStub::GetDisplayMode(int id, DisplayMode* mode) {
+		return false;
+	}
+
+	StreamBank::Ref RendererStub::CreateStreamBank() {
+		return StreamBank::Ref(new StreamBankStub(service_locator()));
+	}
+
+	Primitive::Ref RendererStub::CreatePrimitive() {
+		return Primitive::Ref(new PrimitiveStub(service_locator()));
+	}
+
+	DrawElement::Ref RendererStub::CreateDrawElement() {
+		return DrawElement::Ref(new DrawElement(service_locator()));
+	}
+
+	VertexBuffer::Ref RendererStub::CreateVertexBuffer() {
+		return VertexBuffer::Ref(new VertexBufferStub(service_locator()));
+	}
+
+	IndexBuffer::Ref RendererStub::CreateIndexBuffer() {
+		return IndexBuffer::Ref(new IndexBufferStub(service_locator()));
+	}
+
+	Effect::Ref RendererStub::CreateEffect() {
+		return Effect::Ref(new EffectStub(service_locator()));
+	}
+
+	Sampler::Ref RendererStub::CreateSampler() {
+		return Sampler::Ref(new Sampler(service_locator()));
+	}
+
+	RenderDepthStencilSurface::Ref RendererStub::CreateDepthStencilSurface(
+	    int width,
+	    int height) {
+		return RenderDepthStencilSurface::Ref(
+		           new RenderDepthStencilSurface(service_locator(), width, height));
+	}
+
+	const int* RendererStub::GetRGBAUByteNSwizzleTable() {
+		static int swizzle_table[] = { 0, 1, 2, 3, };
+		return swizzle_table;
+	}
+
+	void RendererStub::SetBackBufferPlatformSpecific() {
+	}
+
+	void RendererStub::SetRenderSurfacesPlatformSpecific(
+	    const RenderSurface* surface,
+	    const RenderDepthStencilSurface* depth_surface) {
+	}
+
+	ParamCache* RendererStub::CreatePlatformSpecificParamCache() {
+		return new ParamCacheStub();
+	}
+
+	Texture2D::Ref RendererStub::CreatePlatformSpecificTexture2D(
+	    int width,
+	    int height,
+	    Texture::Format format,
+	    int levels,
+	    bool enable_render_surfaces) {
+		return Texture2D::Ref(new Texture2DStub(service_locator(), width, height,
+		                                        format, levels,
+		                                        enable_render_surfaces));
+	}
+
+	TextureCUBE::Ref RendererStub::CreatePlatformSpecificTextureCUBE(
+	    int edge_length,
+	    Texture::Format format,
+	    int levels,
+	    bool enable_render_surfaces) {
+		return TextureCUBE::Ref(new TextureCUBEStub(service_locator(), edge_length,
+		                                            format, levels,
+		                                            enable_render_surfaces));
+	}
+
+	bool RendererStub::PlatformSpecificBeginDraw() {
+		return true;
+	}
+
+	void RendererStub::PlatformSpecificEndDraw() {
+	}
+
+	bool RendererStub::PlatformSpecificStartRendering() {
+		return true;
+	}
+
+	void RendererStub::PlatformSpecificFinishRendering() {
+	}
+
+	void RendererStub::PlatformSpecificStartPicking() {
+	}
+
+	void RendererStub::PlatformSpecificFinishPicking() {
+	}
+
+	void RendererStub::PlatformSpecificPresent() {
+	}
+
+	void RendererStub::PlatformSpecificClear(const Float4& color,
+	                                         bool color_flag,
+	                                         float depth,
+	                                         bool depth_flag,
+	                                         int stencil,
+	                                         bool stencil_flag) {
+	}
+
+	void RendererStub::ApplyDirtyStates() {
+	}
+
+	void RendererStub::SetViewportInPixels(int left,
+	                                       int top,
+	                                       int width,
+	                                       int height,
+	                                       float min_z,
+	                                       float max_z) {
+	}
+
+}  // namespace o3d
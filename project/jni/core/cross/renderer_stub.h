@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <vector>
+#include "core/cross/renderer.h"
+
+namespace o3d {
+
+	// A Renderer that doesn't draw, for tools that import, prepare and save
+	// scenes on a host without a GPU. Buffers keep their data in system
+	// memory, effects read their parameters from the GLSL declarations, and
+	// rendering, picking and presenting do nothing.
+	//
+	// It is created with CreateDefault() rather than CreateDefaultRenderer(),
+	// which belongs to the renderer the library is built with.
+	class RendererStub : public Renderer {
+	public:
+		// Creates a stub renderer.
+		static RendererStub* CreateDefault(ServiceLocator* service_locator);
+		virtual ~RendererStub();
+
+		// Overridden from Renderer.
+		virtual InitStatus InitPlatformSpecific(const DisplayWindow& display,
+		                                        bool off_screen);
+
+		// Overridden from Renderer.
+		virtual void Destroy();
+
+		// Overridden from Renderer.
+		virtual bool ReadPickBuffer(PickBuffer* buffer);
+
+		// Overridden from Renderer.
+		virtual void SetCurrentPickable(const ParamObject*);
+
+		// Overridden from Renderer.
+		virtual void Resize(int width, int height);
+
+		// Overridden from Renderer.
+		virtual bool GoFullscreen(const DisplayWindow& display, int mode_id);
+
+		// Overridden from Renderer.
+		virtual bool CancelFullscreen(const DisplayWindow& display,
+		                              int width, int height);
+
+		// Overridden from Renderer.
+		virtual bool fullscreen() const {
+			return false;
+		}
+
+		// Overridden from Renderer.
+		virtual void GetDisplayModes(std::vector<DisplayMode> *modes);
+
+		// Overridden from Renderer.
+		virtual bool GetDisplayMode(int id, DisplayMode* mode);
+
+		// Overridden from Renderer.
+		virtual StreamBank::Ref CreateStreamBank();
+
+		// Overridden from Renderer.
+		virtual Primitive::Ref CreatePrimitive();
+
+		// Overridden from Renderer.
+		virtual DrawElement::Ref CreateDrawElement();
+
+		// Overridden from Renderer.
+		virtual VertexBuffer::Ref CreateVertexBuffer();
+
+		// Overridden from Renderer.
+		virtual IndexBuffer::Ref CreateIndexBuffer();
+
+		// Overridden from Renderer.
+		virtual Effect::Ref CreateEffect();
+
+		// Overridden from Renderer.
+		virtual Sampler::Ref CreateSampler();
+
+		// Overridden from Renderer.
+		virtual RenderDepthStencilSurface::Ref CreateDepthStencilSurface(
+		    int width,
+		    int height);
+
+		// Overridden from Renderer.
+		virtual const int* GetRGBAUByteNSwizzleTable();
+
+	protected:
+		explicit RendererStub(ServiceLocator* service_locator);
+
+		// Overridden from Renderer.
+		virtual void SetBackBufferPlatformSpecific();
+
+		// Overridden from Renderer.
+		virtual void SetRenderSurfacesPlatformSpecific(
+		    const RenderSurface* surface,
+		    const RenderDepthStencilSurface* depth_surface);
+
+		// Overridden from Renderer.
+		virtual ParamCache* CreatePlatformSpecificParamCache();
+
+		// Overridden from Renderer.
+		virtual Texture2D::Ref CreatePlatformSpecificTexture2D(
+		    int width,
+		    int height,
+		    Texture::Format format,
+		    int levels,
+		    bool enable_render_surfaces);
+
+		// Overridden from Renderer.
+		virtual TextureCUBE::Ref CreatePlatformSpecificTextureCUBE(
+		    int edge_length,
+		    Texture::Format format,
+		    int levels,
+		    bool enable_render_surfaces);
+
+		// Overridden from Renderer.
+		virtual bool PlatformSpecificBeginDraw();
+
+		// Overridden from Renderer.
+		virtual void PlatformSpecificEndDraw();
+
+		// Overridden from Renderer.
+		virtual bool PlatformSpecificStartRendering();
+
+		// Overridden from Renderer.
+		virtual void PlatformSpecificFinishRendering();
+
+		// Overridden from Renderer.
+		virtual void PlatformSpecificStartPicking();
+
+		// Overridden from Renderer.
+		virtual void PlatformSpecificFinishPicking();
+
+		// Overridden from Renderer.
+		virtual void PlatformSpecificPresent();
+
+		// Overridden from Renderer.
+		virtual void PlatformSpecificClear(const Float4& color,
+		                                   bool color_flag,
+		                                   float depth,
+		                                   bool depth_flag,
+		                                   int stencil,
+		                                   bool stencil_flag);
+
+		// Overridden from Renderer.
+		virtual void ApplyDirtyStates();
+
+		// Overridden from Renderer.
+		virtual void SetViewportInPixels(int left,
+		                                 int top,
+		                                 int width,
+		                                 int height,
+		                                 float min_z,
+		                                 float max_z);
+
+	private:
+		O3D_DISALLOW_COPY_AND_ASSIGN(RendererStub);
+	};
+
+}  // namespace o3d
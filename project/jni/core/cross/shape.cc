@@ -35,6 +35,7 @@
 #include "core/cross/shape.h"
 #include "core/cross/param_object.h"
 #include "core/cross/render_node.h"
+#include "core/cross/transform.h"
 
 namespace o3d {
 
@@ -51,6 +52,7 @@ namespace o3d {
 // Adds a element do this shape.
 	void Shape::AddElement(Element* element) {
 		elements_.push_back(Element::Ref(element));
+		MarkBoundingBoxDirty();
 	}
 
 // Removes a element from this Shape.
@@ -61,6 +63,7 @@ namespace o3d {
 
 		if(iter != elements_.end()) {
 			elements_.erase(iter);
+			MarkBoundingBoxDirty();
 			return true;
 		}
 
@@ -83,6 +86,28 @@ namespace o3d {
 		for(unsigned int i = 0; i != elements.size(); ++i) {
 			elements_[i] = Element::Ref(elements[i]);
 		}
+
+		MarkBoundingBoxDirty();
+	}
+
+	void Shape::AddTransform(Transform* transform) {
+		transforms_.push_back(transform);
+	}
+
+	void Shape::RemoveTransform(Transform* transform) {
+		std::vector<Transform*>::iterator iter = std::find(transforms_.begin(),
+		        transforms_.end(),
+		        transform);
+
+		if(iter != transforms_.end()) {
+			transforms_.erase(iter);
+		}
+	}
+
+	void Shape::MarkBoundingBoxDirty() {
+		for(unsigned tt = 0; tt < transforms_.size(); ++tt) {
+			transforms_[tt]->MarkBoundingBoxDirty();
+		}
 	}
 
 	namespace {
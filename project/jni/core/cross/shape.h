@@ -42,6 +42,7 @@
 namespace o3d {
 
 	class Pack;
+	class Transform;
 
 // TODO: A Shape is something made of Primitives. What would a HeightMap
 // be made of? It seems like Shape should be based on something like class
@@ -97,6 +98,23 @@ namespace o3d {
 		//   true if successful, false if element was not owned by this shape.
 		bool RemoveElement(Element* element);
 
+		// Records that a Transform holds this shape. This is an internal
+		// function and should not be called directly. Use Transform::AddShape.
+		// Parameters:
+		//   transform: Transform the shape was added to.
+		void AddTransform(Transform* transform);
+
+		// Records that a Transform no longer holds this shape. This is an
+		// internal function and should not be called directly. Use
+		// Transform::RemoveShape.
+		// Parameters:
+		//   transform: Transform the shape was removed from.
+		void RemoveTransform(Transform* transform);
+
+		// Flags the bounding boxes of the transforms holding this shape as
+		// needing to be recomputed.
+		void MarkBoundingBoxDirty();
+
 	private:
 		explicit Shape(ServiceLocator* service_locator);
 
@@ -106,6 +124,9 @@ namespace o3d {
 		// The elements of this Shape.
 		ElementRefArray elements_;
 
+		// The transforms this shape was added to, once per time it was added.
+		std::vector<Transform*> transforms_;
+
 		O3D_DECL_CLASS(Shape, ParamObject)
 		O3D_DISALLOW_COPY_AND_ASSIGN(Shape);
 	};  // Shape
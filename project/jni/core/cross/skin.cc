@@ -34,6 +34,7 @@
 
 #include "core/cross/skin.h"
 #include "core/cross/error.h"
+#include "core/cross/frame_profiler.h"
 #include "core/cross/pointer_utils.h"
 #include "import/cross/memory_stream.h"
 #include "import/cross/raw_data.h"
@@ -453,6 +454,7 @@ namespace o3d {
 	}
 
 	void SkinEval::UpdateOutputs() {
+		O3D_PROFILE_ZONE("SkinEval::UpdateOutputs");
 		// Get our matrices.
 		ParamArray* param_array = matrices();
 
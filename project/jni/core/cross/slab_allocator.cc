@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/cross/slab_allocator.h"
+#include <new>
+#include <stdlib.h>
+#include "base/cross/lock.h"
+#include "base/cross/log.h"
+
+namespace o3d {
+
+	namespace {
+
+		const size_t kAlignment = 16;
+		const size_t kNumSizeClasses = SlabAllocator::kMaxBlockSize / kAlignment;
+
+		struct FreeBlock {
+			FreeBlock* next;
+		};
+
+		// Slabs are aligned on their size, so that the slab of a block is
+		// found by masking its address. The header sits at the start of the
+		// slab, followed by the blocks.
+		struct Slab {
+			Slab* previous;
+			Slab* next;
+			FreeBlock* free_blocks;
+			// Start of the blocks never allocated yet.
+			char* unused;
+			size_t size_class;
+			size_t num_allocated;
+		};
+
+		const size_t kHeaderSize = (sizeof(Slab) + kAlignment - 1) & ~(kAlignment - 1);
+
+		struct SizeClass {
+			// Slabs with at least one free block.
+			Slab* available;
+			// A completely free slab kept around, so that allocating and freeing
+			// a single object doesn't map and unmap a slab each time.
+			Slab* spare;
+		};
+
+		struct SlabHeap {
+			SlabHeap()
+				: num_slabs(0),
+				  bytes_in_use(0) {
+				for(size_t ii = 0; ii < kNumSizeClasses; ++ii) {
+					size_classes[ii].available = NULL;
+					size_classes[ii].spare = NULL;
+				}
+			}
+
+			base::Lock lock;
+			SizeClass size_classes[kNumSizeClasses];
+			size_t num_slabs;
+			size_t bytes_in_use;
+		};
+
+		// Function static so that it is constructed before the first object,
+		// and never destroyed so that objects can be released during exit.
+		SlabHeap& GetHeap() {
+			static SlabHeap* heap = new SlabHeap;
+			return *heap;
+		}
+
+		inline size_t GetSizeClass(size_t size) {
+			return size == 0 ? 0 : (size - 1) / kAlignment;
+		}
+
+		inline size_t GetBlockSize(size_t size_class) {
+			return (size_class + 1) * kAlignment;
+		}
+
+		inline Slab* GetSlab(void* block) {
+			return reinterpret_cast<Slab*>(
+			           reinterpret_cast<uintptr_t>(block) & ~(SlabAllocator::kSlabSize - 1));
+		}
+
+		inline char* GetSlabEnd(Slab* slab) {
+			return reinterpret_cast<char*>(slab) + SlabAllocator::kSlabSize;
+		}
+
+		void Unlink(SizeClass* size_class, Slab* slab) {
+			if(slab->previous) {
+				slab->previous->next = slab->next;
+			}
+			else {
+				size_class->available = slab->next;
+			}
+
+			if(slab->next) {
+				slab->next->previous = slab->previous;
+			}
+
+			slab->previous = NULL;
+			slab->next = NULL;
+		}
+
+		void PushFront(SizeClass* size_class, Slab* slab) {
+			slab->previous = NULL;
+			slab->next = size_class->available;
+
+			if(slab->next) {
+				slab->next->previous = slab;
+			}
+
+			size_class->available = slab;
+		}
+
+		Slab* NewSlab(SlabHeap* heap, size_t size_class) {
+			void* memory = NULL;
+
+			if(posix_memalign(&memory, SlabAllocator::kSlabSize,
+			                  SlabAllocator::kSlabSize) != 0) {
+				return NULL;
+			}
+
+			Slab* slab = static_cast<Slab*>(memory);
+			slab->previous = NULL;
+			slab->next = NULL;
+			slab->free_blocks = NULL;
+			slab->unused = static_cast<char*>(memory) + kHeaderSize;
+			slab->size_class = size_class;
+			slab->num_allocated = 0;
+			++heap->num_slabs;
+			return slab;
+		}
+
+	}  // anonymous namespace
+
+	void* SlabAllocator::Allocate(size_t size) {
+		if(size > kMaxBlockSize) {
+			return ::operator new(size);
+		}
+
+		SlabHeap& heap = GetHeap();
+		size_t size_class_index = GetSizeClass(size);
+		size_t block_size = GetBlockSize(size_class_index);
+		SizeClass* size_class = &heap.size_classes[size_class_index];
+		base::AutoLock lock(heap.lock);
+		Slab* slab = size_class->available;
+
+		if(!slab) {
+			if(size_class->spare) {
+				slab = size_class->spare;
+				size_class->spare = NULL;
+			}
+			else {
+				slab = NewSlab(&heap, size_class_index);
+
+				if(!slab) {
+					throw std::bad_alloc();
+				}
+			}
+
+			PushFront(size_class, slab);
+		}
+
+		void* block;
+
+		if(slab->free_blocks) {
+			block = slab->free_blocks;
+			slab->free_blocks = slab->free_blocks->next;
+		}
+		else {
+			block = slab->unused;
+			slab->unused += block_size;
+		}
+
+		++slab->num_allocated;
+		heap.bytes_in_use += block_size;
+
+		// Full slabs leave the list until one of their blocks is freed.
+		if(!slab->free_blocks && slab->unused + block_size > GetSlabEnd(slab)) {
+			Unlink(size_class, slab);
+		}
+
+		return block;
+	}
+
+	void SlabAllocator::Free(void* block, size_t size) {
+		if(!block) {
+			return;
+		}
+
+		if(size > kMaxBlockSize) {
+			::operator delete(block);
+			return;
+		}
+
+		SlabHeap& heap = GetHeap();
+		Slab* slab = GetSlab(block);
+		O3D_ASSERT(slab->size_class == GetSizeClass(size));
+		size_t block_size = GetBlockSize(slab->size_class);
+		SizeClass* size_class = &heap.size_classes[slab->size_class];
+		base::AutoLock lock(heap.lock);
+		bool was_full = !slab->free_blocks &&
+		                slab->unused + block_size > GetSlabEnd(slab);
+		FreeBlock* free_block = static_cast<FreeBlock*>(block);
+		free_block->next = slab->free_blocks;
+		slab->free_blocks = free_block;
+		--slab->num_allocated;
+		heap.bytes_in_use -= block_size;
+
+		if(was_full) {
+			PushFront(size_class, slab);
+		}
+
+		if(slab->num_allocated == 0) {
+			// Release the slab as a whole, keeping one per size class around.
+			Unlink(size_class, slab);
+			slab->free_blocks = NULL;
+			slab->unused = reinterpret_cast<char*>(slab) + kHeaderSize;
+
+			if(size_class->spare) {
+				free(slab);
+				--heap.num_slabs;
+			}
+			else {
+				size_class->spare = slab;
+			}
+		}
+	}
+
+	size_t SlabAllocator::GetNumSlabs() {
+		SlabHeap& heap = GetHeap();
+		base::AutoLock lock(heap.lock);
+		return heap.num_slabs;
+	}
+
+	size_t SlabAllocator::GetBytesInUse() {
+		SlabHeap& heap = GetHeap();
+		base::AutoLock lock(heap.lock);
+		return heap.bytes_in_use;
+	}
+
+}  // namespace o3d
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include "base/cross/config.h"
+
+namespace o3d {
+
+	// Allocates small objects from 64KB slabs, each slab holding blocks of
+	// a single size class. Scene graph objects are allocated and released
+	// by the thousand when packs are loaded and destroyed; slabs make this
+	// cheaper than going through malloc for each of them, keep objects of
+	// the same size together, and give memory back to the system a whole
+	// slab at a time once all its objects are gone.
+	//
+	// Blocks bigger than kMaxBlockSize come from the global operator new.
+	class SlabAllocator {
+	public:
+		static const size_t kSlabSize = 64 * 1024;
+		static const size_t kMaxBlockSize = 1024;
+
+		// Allocates |size| bytes, aligned for any type. Throws std::bad_alloc
+		// like operator new.
+		static void* Allocate(size_t size);
+
+		// Releases a block returned by Allocate(|size|).
+		static void Free(void* block, size_t size);
+
+		// Number of slabs currently allocated.
+		static size_t GetNumSlabs();
+
+		// Number of bytes handed out in slabs and not freed.
+		static size_t GetBytesInUse();
+
+	private:
+		SlabAllocator();
+	};
+
+}  // namespace o3d
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file contains unit tests for the slab allocator.
+
+#include <set>
+#include <vector>
+#include "tests/common/win/testing_common.h"
+#include "core/cross/slab_allocator.h"
+
+namespace o3d {
+
+	TEST(SlabAllocatorTest, BlocksAreAlignedAndDistinct) {
+		size_t bytes_in_use = SlabAllocator::GetBytesInUse();
+		std::vector<void*> blocks;
+		std::set<void*> distinct;
+
+		for(size_t size = 1; size <= SlabAllocator::kMaxBlockSize; size += 7) {
+			void* block = SlabAllocator::Allocate(size);
+			EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(block) % 16);
+			memset(block, 0xcd, size);
+			blocks.push_back(block);
+			distinct.insert(block);
+		}
+
+		EXPECT_EQ(blocks.size(), distinct.size());
+		EXPECT_LT(bytes_in_use, SlabAllocator::GetBytesInUse());
+
+		for(size_t ii = 0; ii < blocks.size(); ++ii) {
+			SlabAllocator::Free(blocks[ii], 1 + ii * 7);
+		}
+
+		EXPECT_EQ(bytes_in_use, SlabAllocator::GetBytesInUse());
+	}
+
+	TEST(SlabAllocatorTest, FreedBlocksAreReused) {
+		void* first = SlabAllocator::Allocate(40);
+		void* second = SlabAllocator::Allocate(40);
+		SlabAllocator::Free(first, 40);
+		void* third = SlabAllocator::Allocate(48);
+		EXPECT_EQ(first, third);
+		SlabAllocator::Free(second, 40);
+		SlabAllocator::Free(third, 48);
+	}
+
+	TEST(SlabAllocatorTest, EmptySlabsAreReleased) {
+		size_t num_slabs = SlabAllocator::GetNumSlabs();
+		std::vector<void*> blocks;
+
+		// Enough blocks for several slabs.
+		for(int ii = 0; ii < 4000; ++ii) {
+			blocks.push_back(SlabAllocator::Allocate(100));
+		}
+
+		EXPECT_LT(num_slabs + 4, SlabAllocator::GetNumSlabs());
+
+		for(size_t ii = 0; ii < blocks.size(); ++ii) {
+			SlabAllocator::Free(blocks[ii], 100);
+		}
+
+		// One spare slab may be kept for the size class.
+		EXPECT_GE(num_slabs + 1, SlabAllocator::GetNumSlabs());
+	}
+
+	TEST(SlabAllocatorTest, LargeBlocks) {
+		size_t bytes_in_use = SlabAllocator::GetBytesInUse();
+		void* block = SlabAllocator::Allocate(SlabAllocator::kMaxBlockSize + 1);
+		EXPECT_TRUE(block != NULL);
+		EXPECT_EQ(bytes_in_use, SlabAllocator::GetBytesInUse());
+		SlabAllocator::Free(block, SlabAllocator::kMaxBlockSize + 1);
+	}
+
+}  // namespace o3d
@@ -33,6 +33,7 @@
 // This file contains the definition of StreamBank.
 
 #include "core/cross/stream_bank.h"
+#include <limits.h>
 #include "core/cross/renderer.h"
 #include "core/cross/error.h"
 #include "core/cross/vertex_source.h"
@@ -44,6 +44,21 @@ namespace o3d {
 	class Pack;
 	class Renderer;
 	class RenderSurface;
+	class Texture;
+
+// Provides the data of a texture again, for textures that don't keep a copy
+// of it in memory, after they were evicted by the TextureResidencyManager or
+// after the graphics context was lost.
+	class TextureSource : public RefCounted {
+	public:
+		typedef SmartPointer<TextureSource> Ref;
+
+		virtual ~TextureSource() {}
+
+		// Sets the data of all the levels of |texture|. Returns false on
+		// failure.
+		virtual bool RestoreTexture(Texture* texture) = 0;
+	};
 
 // The Texture class is a base class for image data used in texture
 // mapping.  It is an abstract class.  Concrete implementations should
@@ -135,6 +150,48 @@ namespace o3d {
 			return weak_pointer_manager_.GetWeakPointer();
 		}
 
+		// Where the data of the texture can be loaded from again, or NULL.
+		TextureSource* source() const {
+			return source_.Get();
+		}
+
+		void set_source(TextureSource* source) {
+			source_ = TextureSource::Ref(source);
+		}
+
+		// Number of bytes the texture uses in graphics memory.
+		virtual size_t GetGpuMemorySize() const {
+			return 0;
+		}
+
+		// Number of bytes used by the copy of the texture kept in main memory.
+		virtual size_t GetCpuMemorySize() const {
+			return 0;
+		}
+
+		// Replaces the texture in graphics memory by its smallest levels or by
+		// a placeholder, until Restore is called. Returns false if the
+		// texture can't be evicted, for instance because there is no way to
+		// restore it.
+		virtual bool Evict() {
+			return false;
+		}
+
+		// Whether the texture was evicted and not restored yet.
+		virtual bool evicted() const {
+			return false;
+		}
+
+		// Puts back an evicted texture. Returns false on failure.
+		virtual bool Restore() {
+			return true;
+		}
+
+		// Releases the copy of the texture kept in main memory, if the texture
+		// can do without it.
+		virtual void ReleaseCpuCopy() {
+		}
+
 	protected:
 		void set_levels(int levels) {
 			levels_param_->set_read_only_value(levels);
@@ -159,6 +216,8 @@ namespace o3d {
 
 		bool render_surfaces_enabled_;
 
+		TextureSource::Ref source_;
+
 		O3D_DECL_CLASS(Texture, ParamObject);
 		O3D_DISALLOW_COPY_AND_ASSIGN(Texture);
 	};
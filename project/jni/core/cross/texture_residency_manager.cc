@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/cross/texture_residency_manager.h"
+#include "base/cross/log.h"
+#include "core/cross/texture_base.h"
+
+namespace o3d {
+
+	TextureResidencyManager::TextureResidencyManager()
+		: budget_(0),
+		  keep_backing_bitmaps_(true),
+		  frame_(0),
+		  num_evictions_(0),
+		  num_restores_(0) {
+	}
+
+	void TextureResidencyManager::set_keep_backing_bitmaps(
+	    bool keep_backing_bitmaps) {
+		keep_backing_bitmaps_ = keep_backing_bitmaps;
+
+		if(!keep_backing_bitmaps_) {
+			for(EntryList::iterator iter = entries_.begin();
+			        iter != entries_.end();
+			        ++iter) {
+				iter->texture->ReleaseCpuCopy();
+			}
+		}
+	}
+
+	void TextureResidencyManager::AddTexture(Texture* texture) {
+		O3D_ASSERT(entry_map_.find(texture) == entry_map_.end());
+		Entry entry = { texture, frame_ };
+		entry_map_[texture] = entries_.insert(entries_.end(), entry);
+	}
+
+	void TextureResidencyManager::RemoveTexture(Texture* texture) {
+		EntryMap::iterator iter = entry_map_.find(texture);
+
+		if(iter != entry_map_.end()) {
+			entries_.erase(iter->second);
+			entry_map_.erase(iter);
+		}
+	}
+
+	void TextureResidencyManager::TouchTexture(Texture* texture) {
+		EntryMap::iterator iter = entry_map_.find(texture);
+
+		if(iter == entry_map_.end()) {
+			return;
+		}
+
+		if(texture->evicted()) {
+			if(texture->Restore()) {
+				++num_restores_;
+			}
+			else {
+				O3D_LOG(ERROR) << "Failed to restore evicted texture "
+				               << texture->name();
+			}
+		}
+
+		if(!keep_backing_bitmaps_) {
+			// In case it got a new copy or a source since it was last bound.
+			texture->ReleaseCpuCopy();
+		}
+
+		iter->second->last_frame = frame_;
+		entries_.splice(entries_.end(), entries_, iter->second);
+	}
+
+	void TextureResidencyManager::EnforceBudget() {
+		++frame_;
+
+		if(budget_ == 0) {
+			return;
+		}
+
+		size_t gpu_bytes = GetGpuBytes();
+
+		for(EntryList::iterator iter = entries_.begin();
+		        iter != entries_.end() && gpu_bytes > budget_;
+		        ++iter) {
+			if(iter->last_frame >= frame_ - 1) {
+				// Everything after was bound in the last frame too.
+				break;
+			}
+
+			Texture* texture = iter->texture;
+
+			if(texture->evicted()) {
+				continue;
+			}
+
+			size_t size = texture->GetGpuMemorySize();
+
+			if(texture->Evict()) {
+				++num_evictions_;
+				gpu_bytes -= size - texture->GetGpuMemorySize();
+			}
+		}
+	}
+
+	size_t TextureResidencyManager::GetGpuBytes() const {
+		size_t total = 0;
+
+		for(EntryList::const_iterator iter = entries_.begin();
+		        iter != entries_.end();
+		        ++iter) {
+			total += iter->texture->GetGpuMemorySize();
+		}
+
+		return total;
+	}
+
+	size_t TextureResidencyManager::GetCpuBytes() const {
+		size_t total = 0;
+
+		for(EntryList::const_iterator iter = entries_.begin();
+		        iter != entries_.end();
+		        ++iter) {
+			total += iter->texture->GetCpuMemorySize();
+		}
+
+		return total;
+	}
+
+}  // namespace o3d
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <list>
+#include <map>
+#include "base/cross/config.h"
+
+namespace o3d {
+
+	class Texture;
+
+	// Keeps track of the memory used by the textures of a renderer, in main
+	// memory and in graphics memory, and keeps the graphics memory under a
+	// budget by evicting the textures that were bound least recently. An
+	// evicted texture keeps only its smallest levels, or a placeholder, and
+	// gets its data back from its backing bitmap or its TextureSource the next
+	// time it is bound.
+	//
+	// Textures add themselves when created and remove themselves when
+	// destroyed. Textures that can't be evicted, like render targets, are
+	// only counted.
+	class TextureResidencyManager {
+	public:
+		TextureResidencyManager();
+
+		// Number of bytes of graphics memory the textures should fit in. 0,
+		// the default, means there is no budget.
+		size_t budget() const {
+			return budget_;
+		}
+
+		void set_budget(size_t budget) {
+			budget_ = budget;
+		}
+
+		// Whether textures keep a copy of their data in main memory. When
+		// false, textures that have a TextureSource to get their data back
+		// from release their copy, and have to be read again from the source
+		// when restored, including after the graphics context was lost.
+		bool keep_backing_bitmaps() const {
+			return keep_backing_bitmaps_;
+		}
+
+		void set_keep_backing_bitmaps(bool keep_backing_bitmaps);
+
+		void AddTexture(Texture* texture);
+		void RemoveTexture(Texture* texture);
+
+		// Called when |texture| is about to be bound. Restores it if it was
+		// evicted, and releases its copy in main memory if backing bitmaps
+		// aren't kept.
+		void TouchTexture(Texture* texture);
+
+		// Evicts textures until they fit in the budget. Textures bound in the
+		// last frame are never evicted. Called by the renderer at the start
+		// of each frame.
+		void EnforceBudget();
+
+		// Number of bytes used by all the textures in graphics memory.
+		size_t GetGpuBytes() const;
+
+		// Number of bytes used by all the textures in main memory.
+		size_t GetCpuBytes() const;
+
+		// Number of textures evicted and restored since the manager was
+		// created.
+		int num_evictions() const {
+			return num_evictions_;
+		}
+
+		int num_restores() const {
+			return num_restores_;
+		}
+
+	private:
+		struct Entry {
+			Texture* texture;
+			// Frame the texture was last bound in.
+			int last_frame;
+		};
+
+		// Least recently bound first.
+		typedef std::list<Entry> EntryList;
+		typedef std::map<Texture*, EntryList::iterator> EntryMap;
+
+		EntryList entries_;
+		EntryMap entry_map_;
+		size_t budget_;
+		bool keep_backing_bitmaps_;
+		// Number of the frame being rendered.
+		int frame_;
+		int num_evictions_;
+		int num_restores_;
+
+		O3D_DISALLOW_COPY_AND_ASSIGN(TextureResidencyManager);
+	};
+
+}  // namespace o3d
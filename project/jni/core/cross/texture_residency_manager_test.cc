@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file contains the tests of TextureResidencyManager.
+
+#include "tests/common/win/testing_common.h"
+#include "core/cross/texture_residency_manager.h"
+#include "core/cross/texture_base.h"
+#include "core/cross/object_manager.h"
+
+namespace o3d {
+
+	namespace {
+
+		Texture::RGBASwizzleIndices swizzle;
+
+		// Texture using |size| bytes, or none once evicted.
+		class MockTexture : public Texture {
+		public:
+			typedef SmartPointer<MockTexture> Ref;
+
+			MockTexture(ServiceLocator* service_locator, size_t size)
+				: Texture(service_locator, Texture::ARGB8, 1, false),
+				  size_(size),
+				  evicted_(false),
+				  released_(false) {
+			}
+
+			virtual const RGBASwizzleIndices& GetABGR32FSwizzleIndices() {
+				return swizzle;
+			}
+
+			virtual void* GetTextureHandle() const {
+				return NULL;
+			}
+
+			virtual void SetFromBitmap(const Bitmap& bitmap) {
+			}
+
+			virtual void GenerateMips(int source_level, int num_levels) {
+			}
+
+			virtual size_t GetGpuMemorySize() const {
+				return evicted_ ? 0 : size_;
+			}
+
+			virtual size_t GetCpuMemorySize() const {
+				return released_ ? 0 : size_;
+			}
+
+			virtual bool Evict() {
+				evicted_ = true;
+				return true;
+			}
+
+			virtual bool evicted() const {
+				return evicted_;
+			}
+
+			virtual bool Restore() {
+				evicted_ = false;
+				return true;
+			}
+
+			virtual void ReleaseCpuCopy() {
+				released_ = true;
+			}
+
+		private:
+			size_t size_;
+			bool evicted_;
+			bool released_;
+
+			O3D_DISALLOW_COPY_AND_ASSIGN(MockTexture);
+		};
+
+	}  // anonymous namespace
+
+	class TextureResidencyManagerTest : public testing::Test {
+	protected:
+		TextureResidencyManagerTest()
+			: object_manager_(g_service_locator) {
+		}
+
+		virtual void SetUp() {
+			for(int ii = 0; ii < 3; ++ii) {
+				textures_[ii] = MockTexture::Ref(
+				                    new MockTexture(g_service_locator, 60));
+				manager_.AddTexture(textures_[ii]);
+			}
+		}
+
+		virtual void TearDown() {
+			for(int ii = 0; ii < 3; ++ii) {
+				manager_.RemoveTexture(textures_[ii]);
+			}
+		}
+
+		TextureResidencyManager manager_;
+		MockTexture::Ref textures_[3];
+
+	private:
+		ServiceDependency<ObjectManager> object_manager_;
+	};
+
+	TEST_F(TextureResidencyManagerTest, CountsBytes) {
+		EXPECT_EQ(180u, manager_.GetGpuBytes());
+		EXPECT_EQ(180u, manager_.GetCpuBytes());
+		manager_.set_keep_backing_bitmaps(false);
+		EXPECT_EQ(0u, manager_.GetCpuBytes());
+		manager_.RemoveTexture(textures_[0]);
+		EXPECT_EQ(120u, manager_.GetGpuBytes());
+	}
+
+	TEST_F(TextureResidencyManagerTest, NoBudget) {
+		manager_.EnforceBudget();
+		manager_.EnforceBudget();
+		manager_.EnforceBudget();
+		EXPECT_EQ(0, manager_.num_evictions());
+		EXPECT_EQ(180u, manager_.GetGpuBytes());
+	}
+
+	TEST_F(TextureResidencyManagerTest, EvictsLeastRecentlyBound) {
+		manager_.set_budget(100);
+		manager_.EnforceBudget();
+		manager_.TouchTexture(textures_[0]);
+		manager_.EnforceBudget();
+		manager_.EnforceBudget();
+		// Texture 0 was bound after the others.
+		EXPECT_EQ(2, manager_.num_evictions());
+		EXPECT_FALSE(textures_[0]->evicted());
+		EXPECT_TRUE(textures_[1]->evicted());
+		EXPECT_TRUE(textures_[2]->evicted());
+		EXPECT_EQ(60u, manager_.GetGpuBytes());
+		manager_.TouchTexture(textures_[2]);
+		EXPECT_FALSE(textures_[2]->evicted());
+		EXPECT_EQ(1, manager_.num_restores());
+	}
+
+	TEST_F(TextureResidencyManagerTest, KeepsTexturesBoundInLastFrame) {
+		manager_.set_budget(100);
+		manager_.EnforceBudget();
+
+		for(int ii = 0; ii < 3; ++ii) {
+			manager_.TouchTexture(textures_[ii]);
+		}
+
+		manager_.EnforceBudget();
+		EXPECT_EQ(0, manager_.num_evictions());
+		EXPECT_EQ(180u, manager_.GetGpuBytes());
+	}
+
+}  // namespace o3d
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "core/cross/texture_stub.h"
+#include "core/cross/error.h"
+#include "core/cross/image_utils.h"
+
+namespace o3d {
+
+	namespace {
+
+		Texture::RGBASwizzleIndices g_stub_abgr32f_swizzle_indices = {0, 1, 2, 3};
+
+		// Checks that a SetRect fits in the level.
+		bool CheckRect(Texture* texture, int level, unsigned mip_width,
+		               unsigned mip_height, unsigned dst_left, unsigned dst_top,
+		               unsigned width, unsigned height) {
+			if(level >= texture->levels() || level < 0) {
+				O3D_ERROR(texture->service_locator())
+				        << "Trying to SetRect on non-existent level " << level
+				        << " on Texture \"" << texture->name() << "\"";
+				return false;
+			}
+
+			if(dst_left + width > mip_width || dst_top + height > mip_height) {
+				O3D_ERROR(texture->service_locator())
+				        << "SetRect(" << level << ", " << dst_left << ", " << dst_top
+				        << ", " << width << ", " << height
+				        << ") out of range for texture \"" << texture->name() << "\"";
+				return false;
+			}
+
+			return true;
+		}
+
+		// Gives |buffer| the size of the level and returns it, with its pitch.
+		void* LockScratch(std::vector<uint8_t>* buffer, Texture::Format format,
+		                  unsigned mip_width, unsigned mip_height, int* pitch) {
+			buffer->resize(image::ComputeBufferSize(mip_width, mip_height, format));
+			*pitch = image::ComputePitch(format, mip_width);
+			return buffer->empty() ? NULL : &(*buffer)[0];
+		}
+
+	}  // anonymous namespace
+
+	// Texture2DStub -------------------------------------------------------------
+
+	Texture2DStub::Texture2DStub(ServiceLocator* service_locator,
+	                             int width,
+	                             int height,
+	                             Format format,
+	                             int levels,
+	                             bool enable_render_surfaces)
+		: Texture2D(service_locator, width, height, format, levels,
+		            enable_render_surfaces),
+		  scratch_(levels) {
+	}
+
+	void Texture2DStub::SetRect(int level,
+	                            unsigned dst_left,
+	                            unsigned dst_top,
+	                            unsigned width,
+	                            unsigned height,
+	                            const void* src_data,
+	                            int src_pitch) {
+		CheckRect(this, level,
+		          image::ComputeMipDimension(level, this->width()),
+		          image::ComputeMipDimension(level, this->height()),
+		          dst_left, dst_top, width, height);
+	}
+
+	const Texture::RGBASwizzleIndices& Texture2DStub::GetABGR32FSwizzleIndices() {
+		return g_stub_abgr32f_swizzle_indices;
+	}
+
+	bool Texture2DStub::PlatformSpecificLock(int level, void** texture_data,
+	                                         int* pitch, AccessMode mode) {
+		*texture_data = LockScratch(&scratch_[level], format(),
+		                            image::ComputeMipDimension(level, width()),
+		                            image::ComputeMipDimension(level, height()),
+		                            pitch);
+		return *texture_data != NULL;
+	}
+
+	bool Texture2DStub::PlatformSpecificUnlock(int level) {
+		std::vector<uint8_t>().swap(scratch_[level]);
+		return true;
+	}
+
+	RenderSurface::Ref Texture2DStub::PlatformSpecificGetRenderSurface(
+	    int mip_level) {
+		if(!render_surfaces_enabled() || mip_level >= levels() || mip_level < 0) {
+			return RenderSurface::Ref(NULL);
+		}
+
+		return RenderSurface::Ref(new RenderSurfaceStub(
+		                              service_locator(),
+		                              image::ComputeMipDimension(mip_level, width()),
+		                              image::ComputeMipDimension(mip_level, height()),
+		                              this));
+	}
+
+	// TextureCUBEStub -----------------------------------------------------------
+
+	TextureCUBEStub::TextureCUBEStub(ServiceLocator* service_locator,
+	                                 int edge_length,
+	                                 Format format,
+	                                 int levels,
+	                                 bool enable_render_surfaces)
+		: TextureCUBE(service_locator, edge_length, format, levels,
+		              enable_render_surfaces),
+		  scratch_(NUMBER_OF_FACES * levels) {
+	}
+
+	void TextureCUBEStub::SetRect(CubeFace face,
+	                              int level,
+	                              unsigned dst_left,
+	                              unsigned dst_top,
+	                              unsigned width,
+	                              unsigned height,
+	                              const void* src_data,
+	                              int src_pitch) {
+		unsigned mip_length = image::ComputeMipDimension(level, edge_length());
+		CheckRect(this, level, mip_length, mip_length,
+		          dst_left, dst_top, width, height);
+	}
+
+	const Texture::RGBASwizzleIndices&
+	TextureCUBEStub::GetABGR32FSwizzleIndices() {
+		return g_stub_abgr32f_swizzle_indices;
+	}
+
+	bool TextureCUBEStub::PlatformSpecificLock(CubeFace face, int level,
+	                                           void** texture_data, int* pitch,
+	                                           AccessMode mode) {
+		unsigned mip_length = image::ComputeMipDimension(level, edge_length());
+		*texture_data = LockScratch(&scratch_[face * levels() + level], format(),
+		                            mip_length, mip_length, pitch);
+		return *texture_data != NULL;
+	}
+
+	bool TextureCUBEStub::PlatformSpecificUnlock(CubeFace face, int level) {
+		std::vector<uint8_t>().swap(scratch_[face * levels() + level]);
+		return true;
+	}
+
+	RenderSurface::Ref TextureCUBEStub::PlatformSpecificGetRenderSurface(
+	    CubeFace face,
+	    int level) {
+		if(!render_surfaces_enabled() || level >= levels() || level < 0) {
+			return RenderSurface::Ref(NULL);
+		}
+
+		unsigned mip_length = image::ComputeMipDimension(level, edge_length());
+		return RenderSurface::Ref(new RenderSurfaceStub(
+		                              service_locator(), mip_length, mip_length,
+		                              this));
+	}
+
+}  // namespace o3d
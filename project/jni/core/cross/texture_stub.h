@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <vector>
+#include "core/cross/render_surface.h"
+#include "core/cross/texture.h"
+
+namespace o3d {
+
+	// Textures of the stub renderer don't keep their pixels: SetRect only
+	// checks its arguments, and Lock hands out a level-sized scratch buffer
+	// that Unlock drops.
+	class Texture2DStub : public Texture2D {
+	public:
+		Texture2DStub(ServiceLocator* service_locator,
+		              int width,
+		              int height,
+		              Format format,
+		              int levels,
+		              bool enable_render_surfaces);
+
+		// Overridden from Texture2D.
+		virtual void SetRect(int level,
+		                     unsigned dst_left,
+		                     unsigned dst_top,
+		                     unsigned width,
+		                     unsigned height,
+		                     const void* src_data,
+		                     int src_pitch);
+
+		// Overridden from Texture.
+		virtual void* GetTextureHandle() const {
+			return NULL;
+		}
+
+		// Overridden from Texture.
+		virtual const RGBASwizzleIndices& GetABGR32FSwizzleIndices();
+
+	protected:
+		// Overridden from Texture2D.
+		virtual bool PlatformSpecificLock(int level, void** texture_data,
+		                                  int* pitch, AccessMode mode);
+
+		// Overridden from Texture2D.
+		virtual bool PlatformSpecificUnlock(int level);
+
+		// Overridden from Texture2D.
+		virtual RenderSurface::Ref PlatformSpecificGetRenderSurface(int mip_level);
+
+	private:
+		std::vector<std::vector<uint8_t> > scratch_;
+
+		O3D_DISALLOW_COPY_AND_ASSIGN(Texture2DStub);
+	};
+
+	class TextureCUBEStub : public TextureCUBE {
+	public:
+		TextureCUBEStub(ServiceLocator* service_locator,
+		                int edge_length,
+		                Format format,
+		                int levels,
+		                bool enable_render_surfaces);
+
+		// Overridden from TextureCUBE.
+		virtual void SetRect(CubeFace face,
+		                     int level,
+		                     unsigned dst_left,
+		                     unsigned dst_top,
+		                     unsigned width,
+		                     unsigned height,
+		                     const void* src_data,
+		                     int src_pitch);
+
+		// Overridden from Texture.
+		virtual void* GetTextureHandle() const {
+			return NULL;
+		}
+
+		// Overridden from Texture.
+		virtual const RGBASwizzleIndices& GetABGR32FSwizzleIndices();
+
+	protected:
+		// Overridden from TextureCUBE.
+		virtual bool PlatformSpecificLock(CubeFace face, int level,
+		                                  void** texture_data, int* pitch,
+		                                  AccessMode mode);
+
+		// Overridden from TextureCUBE.
+		virtual bool PlatformSpecificUnlock(CubeFace face, int level);
+
+		// Overridden from TextureCUBE.
+		virtual RenderSurface::Ref PlatformSpecificGetRenderSurface(CubeFace face,
+		                                                            int level);
+
+	private:
+		std::vector<std::vector<uint8_t> > scratch_;
+
+		O3D_DISALLOW_COPY_AND_ASSIGN(TextureCUBEStub);
+	};
+
+	// A RenderSurface that can't be read back.
+	class RenderSurfaceStub : public RenderSurface {
+	public:
+		RenderSurfaceStub(ServiceLocator* service_locator,
+		                  int width,
+		                  int height,
+		                  Texture* texture)
+			: RenderSurface(service_locator, width, height, texture) {
+		}
+
+	protected:
+		// Overridden from RenderSurface.
+		virtual bool PlatformSpecificGetIntoBitmap(Bitmap::Ref bitmap) const {
+			return false;
+		}
+
+	private:
+		O3D_DISALLOW_COPY_AND_ASSIGN(RenderSurfaceStub);
+	};
+
+}  // namespace o3d
@@ -33,6 +33,7 @@
 // This file contains the definition of the Transform class.
 
 #include "core/cross/transform.h"
+#include <map>
 #include "core/cross/renderer.h"
 #include "core/cross/error.h"
 
@@ -93,6 +94,21 @@ namespace o3d {
 
 	}  // end unnamed namespace
 
+	struct Transform::InstanceInfo {
+		explicit InstanceInfo(Transform* prototype)
+			: prototype(prototype) {
+		}
+
+		Transform::Ref prototype;
+
+		typedef std::map<Shape*, Shape::Ref> ShapeMap;
+		ShapeMap shapes;
+
+		typedef std::vector<std::pair<Transform::Ref, ParamMatrix4::Ref> >
+		MatrixArray;
+		MatrixArray matrices;
+	};
+
 	O3D_DEFN_CLASS(Transform, ParamObject);
 	O3D_DEFN_CLASS(ParamTransform, RefParamBase);
 
@@ -110,8 +126,12 @@ namespace o3d {
 	Transform::Transform(ServiceLocator* service_locator)
 		: ParamObject(service_locator),
 		  parent_(NULL),
+		  bounding_box_dirty_(true),
+		  evaluation_counter_(service_locator->GetService<EvaluationCounter>()),
 		  param_cache_manager_(service_locator->GetService<Renderer>()),
 		  weak_pointer_manager_(this) {
+		AddParam(kLocalMatrixParamName,
+		         new LocalMatrixParam(service_locator, this));
 		RegisterParamRef(kLocalMatrixParamName, &local_matrix_param_ref_);
 		SlaveParamMatrix4::RegisterParamRef(kWorldMatrixParamName,
 		                                    &world_matrix_param_ref_,
@@ -132,6 +152,10 @@ namespace o3d {
 		        ++iter) {
 			(*iter)->SetParent(NULL);
 		}
+
+		for(unsigned ss = 0; ss < shape_array_.size(); ++ss) {
+			shape_array_[ss]->RemoveTransform(this);
+		}
 	}
 
 	void Transform::UpdateOutputs() {
@@ -263,6 +287,7 @@ namespace o3d {
 		// First check if the transform already has a parent.  If it does then
 		// remove it from its current parent first.
 		if(parent_ != NULL) {
+			parent_->MarkBoundingBoxDirty();
 			bool removed = parent_->RemoveChild(this);
 			O3D_ASSERT(removed);
 
@@ -285,6 +310,8 @@ namespace o3d {
 		// an orphan in order to avoid any inconsistencies in the scenegraph
 		if(!added)
 			parent_ = NULL;
+		else
+			new_parent->MarkBoundingBoxDirty();
 	}
 
 // Explicitly calculates and returns the world matrix.  The world matrix
@@ -313,6 +340,8 @@ namespace o3d {
 // Adds a shape do this transform.
 	void Transform::AddShape(Shape* shape) {
 		shape_array_.push_back(Shape::Ref(shape));
+		shape->AddTransform(this);
+		MarkBoundingBoxDirty();
 	}
 
 // Removes a shape from this transform.
@@ -322,7 +351,9 @@ namespace o3d {
 		                               Shape::Ref(shape));
 
 		if(iter != shape_array_.end()) {
+			shape->RemoveTransform(this);
 			shape_array_.erase(iter);
+			MarkBoundingBoxDirty();
 			return true;
 		}
 
@@ -340,11 +371,18 @@ namespace o3d {
 	}
 
 	void Transform::SetShapes(const ShapeArray& shapes) {
+		for(unsigned int i = 0; i != shape_array_.size(); ++i) {
+			shape_array_[i]->RemoveTransform(this);
+		}
+
 		shape_array_.resize(shapes.size());
 
 		for(unsigned int i = 0; i != shapes.size(); ++i) {
 			shape_array_[i] = Shape::Ref(shapes[i]);
+			shapes[i]->AddTransform(this);
 		}
+
+		MarkBoundingBoxDirty();
 	}
 
 	void Transform::CreateDrawElements(Pack* pack, Material* material) {
@@ -395,6 +433,74 @@ namespace o3d {
 		}
 	}
 
+	void Transform::set_instance_of(Transform* prototype) {
+		O3D_ASSERT(prototype != this);
+		instance_info_.reset(prototype ? new InstanceInfo(prototype) : NULL);
+		MarkBoundingBoxDirty();
+	}
+
+	Transform* Transform::instance_of() const {
+		return instance_info_.get() ? instance_info_->prototype.Get() : NULL;
+	}
+
+	void Transform::SetInstanceShape(Shape* shape, Shape* instance_shape) {
+		O3D_ASSERT(instance_info_.get());
+		instance_info_->shapes[shape] = Shape::Ref(instance_shape);
+	}
+
+	Shape* Transform::GetInstanceShape(Shape* shape) const {
+		if(!instance_info_.get() || instance_info_->shapes.empty()) {
+			return shape;
+		}
+
+		InstanceInfo::ShapeMap::const_iterator iter =
+		    instance_info_->shapes.find(shape);
+		return iter != instance_info_->shapes.end() ? iter->second.Get() : shape;
+	}
+
+	void Transform::AddInstanceMatrix(Transform* transform, ParamMatrix4* param) {
+		O3D_ASSERT(instance_info_.get());
+		instance_info_->matrices.push_back(
+		    std::make_pair(Transform::Ref(transform), ParamMatrix4::Ref(param)));
+	}
+
+	void Transform::ApplyInstanceState() {
+		O3D_ASSERT(instance_info_.get());
+		Transform* prototype = instance_info_->prototype;
+		const NamedParamRefMap& instance_params = params();
+
+		for(NamedParamRefMap::const_iterator iter = instance_params.begin();
+		        iter != instance_params.end();
+		        ++iter) {
+			Param* param = iter->second;
+
+			if(param == local_matrix_param_ref_ ||
+			        param == world_matrix_param_ref_ ||
+			        param == visible_param_ref_ ||
+			        param == bounding_box_param_ref_ ||
+			        param == cull_param_ref_) {
+				continue;
+			}
+
+			Param* prototype_param = prototype->GetUntypedParam(iter->first);
+
+			if(prototype_param && prototype_param->IsA(param->GetClass()) &&
+			        !prototype_param->input_connection()) {
+				prototype_param->CopyDataFromParam(param);
+				// Only what is computed from the copied Param is stale, the rest
+				// of the scene stays cached.
+				prototype_param->InvalidateAllOutputs();
+			}
+		}
+
+		for(InstanceInfo::MatrixArray::iterator iter =
+		            instance_info_->matrices.begin();
+		        iter != instance_info_->matrices.end();
+		        ++iter) {
+			iter->second->set_dynamic_value(iter->first->GetUpdatedWorldMatrix());
+		}
+	}
+
 	ObjectBase::Ref ParamTransform::Create(ServiceLocator* service_locator) {
 		return ObjectBase::Ref(new ParamTransform(service_locator, false, false));
 	}
@@ -36,12 +36,14 @@
 #define O3D_CORE_CROSS_TRANSFORM_H_
 
 #include <vector>
+#include "base/cross/scoped_ptr.h"
 #include "core/cross/param_object.h"
 #include "core/cross/param.h"
 #include "core/cross/types.h"
 #include "core/cross/shape.h"
 #include "core/cross/param_cache.h"
 #include "core/cross/bounding_box.h"
+#include "core/cross/evaluation_counter.h"
 
 namespace o3d {
 
@@ -151,6 +153,12 @@ namespace o3d {
 			local_matrix_param_ref_->set_value(local_matrix);
 		}
 
+		// Returns true if the local matrix gets its value from another Param,
+		// in which case it can change every frame.
+		inline bool LocalMatrixHasInputConnection() const {
+			return local_matrix_param_ref_->input_connection() != NULL;
+		}
+
 		// Returns the world transform matrix.  The world transformation matrix
 		// gets updated each frame by the client if there's a direct path from the
 		// scenegraph root to the Transform.
@@ -244,6 +252,72 @@ namespace o3d {
 		// Update the world Matrix.
 		void UpdateOutputs();
 
+		// Returns true if the bounding box of this Transform needs to be
+		// recomputed, because something changed in its subtree since the last
+		// time it was.
+		bool bounding_box_dirty() const {
+			return bounding_box_dirty_;
+		}
+
+		// Flags the bounding box of this Transform, and of all its ancestors,
+		// as needing to be recomputed. Setting or binding the localMatrix
+		// Param, or changing the children, the shapes or the elements of the
+		// shapes does it automatically. A localMatrix bound to another Param,
+		// as animated transforms are, can change every frame without notice,
+		// so the box of its parent stays dirty for as long as it is bound.
+		void MarkBoundingBoxDirty() {
+			evaluation_counter_->CountChange();
+
+			for(Transform* transform = this;
+			        transform && !transform->bounding_box_dirty_;
+			        transform = transform->parent_) {
+				transform->bounding_box_dirty_ = true;
+			}
+		}
+
+		// Flags the bounding box of this Transform as up to date. The
+		// ancestors are not changed.
+		void ClearBoundingBoxDirty() {
+			bounding_box_dirty_ = false;
+		}
+
+		// Makes this Transform draw the subtree under |prototype| as if it was
+		// one of its children. The transforms, shapes, materials and animations
+		// of the subtree are shared by all the Transforms drawing it, so that
+		// many instances of a model cost little more than their root. The
+		// prototype must not be in the transform graph itself. Pass NULL to
+		// stop drawing it.
+		//
+		// Params of this Transform that have the same name and type as Params
+		// of |prototype|, other than the standard Transform Params, are copied
+		// to |prototype| each time this instance is walked, and again before
+		// the elements drawn for it are rendered. That is how each instance
+		// gets its own animation time, and how the material Params bound to
+		// the prototype get the values of each instance.
+		void set_instance_of(Transform* prototype);
+
+		// Returns the Transform whose subtree this Transform draws, or NULL.
+		Transform* instance_of() const;
+
+		// Makes this instance draw |instance_shape| where the prototype's
+		// subtree has |shape|, for the few shapes that can't be shared, like
+		// skinned ones.
+		void SetInstanceShape(Shape* shape, Shape* instance_shape);
+
+		// Returns the shape this instance draws in place of |shape|.
+		Shape* GetInstanceShape(Shape* shape) const;
+
+		// Makes |param| take the world matrix |transform| of the prototype's
+		// subtree has, relative to the prototype, each time this instance is
+		// drawn. This is how the bones of a skin particular to an instance
+		// follow the animation time of the instance.
+		void AddInstanceMatrix(Transform* transform, ParamMatrix4* param);
+
+		// Copies the Params of this instance to the prototype and updates the
+		// instance matrices. Called when the prototype is about to be walked
+		// or rendered as this instance.
+		void ApplyInstanceState();
+
 	protected:
 		// Removes a child transform from the child array. Does not change the child
 		// transform's parent.
@@ -268,6 +342,38 @@ namespace o3d {
 	private:
 		typedef SlaveParam<ParamMatrix4, Transform> SlaveParamMatrix4;
 
+		// Local matrix Param which flags the bounding box of the parent as
+		// dirty when it gets bound or unbound.
+		class LocalMatrixParam : public ParamMatrix4 {
+		public:
+			LocalMatrixParam(ServiceLocator* service_locator, Transform* master)
+				: ParamMatrix4(service_locator, false, false),
+				  master_(master) {
+			}
+
+			virtual void OnAfterBindInput() {
+				master_->MarkParentBoundingBoxDirty();
+			}
+
+			virtual void OnAfterUnbindInput(Param* old_source) {
+				master_->MarkParentBoundingBoxDirty();
+			}
+
+			virtual void OnAfterSetValue() {
+				master_->MarkParentBoundingBoxDirty();
+			}
+
+		private:
+			Transform* master_;
+			O3D_DISALLOW_COPY_AND_ASSIGN(LocalMatrixParam);
+		};
+
+		void MarkParentBoundingBoxDirty() {
+			if(parent_) {
+				parent_->MarkBoundingBoxDirty();
+			}
+		}
+
 		explicit Transform(ServiceLocator* service_locator);
 
 		friend class IClassManager;
@@ -293,6 +399,13 @@ namespace o3d {
 		// Culling on or off.
 		ParamBoolean::Ref cull_param_ref_;
 
+		// True if the bounding box needs to be recomputed. If a Transform is
+		// dirty, so are all its ancestors.
+		bool bounding_box_dirty_;
+
+		// Counts the changes to the transform graph.
+		EvaluationCounter* evaluation_counter_;
+
 		// Array of refs to children Transforms for this transform.
 		TransformRefArray child_array_;
 
@@ -302,6 +415,11 @@ namespace o3d {
 		// Caches of Params for rendering.
 		ParamCacheManager param_cache_manager_;
 
+		// What this Transform needs to draw the subtree of another one, or
+		// NULL if it doesn't.
+		struct InstanceInfo;
+		::o3d::base::scoped_ptr<InstanceInfo> instance_info_;
+
 		// Manager for weak pointers to us.
 		WeakPointerType::WeakPointerManager weak_pointer_manager_;
 
@@ -41,6 +41,11 @@
 #include "core/cross/object_manager.h"
 #include "core/cross/pack.h"
 #include "core/cross/service_dependency.h"
+#include "core/cross/evaluation_counter.h"
+#include "core/cross/buffer.h"
+#include "core/cross/matrix4_translation.h"
+#include "core/cross/stream_bank.h"
+#include "extra/cross/bounding_boxes_extra.h"
 #include "tests/common/win/testing_common.h"
 
 namespace o3d {
@@ -410,6 +415,147 @@ namespace o3d {
 		EXPECT_EQ(shape2, shape_array[0]);
 	}
 
+// Tests that changes in a subtree flag the bounding boxes of the ancestors.
+	TEST_F(TransformBasic, MarkBoundingBoxDirty) {
+		Transform* t3 = pack()->Create<Transform>();
+		Shape* shape = pack()->Create<Shape>();
+		transform2_->SetParent(transform_);
+		t3->SetParent(transform2_);
+		EXPECT_TRUE(transform_->bounding_box_dirty());
+		EXPECT_TRUE(t3->bounding_box_dirty());
+		transform_->ClearBoundingBoxDirty();
+		transform2_->ClearBoundingBoxDirty();
+		t3->ClearBoundingBoxDirty();
+		// Moving a transform changes the box of its parent, not its own.
+		t3->set_local_matrix(Matrix4::translation(Vector3(1.0f, 2.0f, 3.0f)));
+		EXPECT_TRUE(transform_->bounding_box_dirty());
+		EXPECT_TRUE(transform2_->bounding_box_dirty());
+		EXPECT_FALSE(t3->bounding_box_dirty());
+		transform_->ClearBoundingBoxDirty();
+		transform2_->ClearBoundingBoxDirty();
+		// So does setting its localMatrix Param directly.
+		t3->GetParam<ParamMatrix4>(Transform::kLocalMatrixParamName)->set_value(
+		    Matrix4::translation(Vector3(3.0f, 2.0f, 1.0f)));
+		EXPECT_TRUE(transform_->bounding_box_dirty());
+		EXPECT_TRUE(transform2_->bounding_box_dirty());
+		EXPECT_FALSE(t3->bounding_box_dirty());
+		transform_->ClearBoundingBoxDirty();
+		transform2_->ClearBoundingBoxDirty();
+		t3->AddShape(shape);
+		EXPECT_TRUE(transform_->bounding_box_dirty());
+		EXPECT_TRUE(t3->bounding_box_dirty());
+		transform_->ClearBoundingBoxDirty();
+		transform2_->ClearBoundingBoxDirty();
+		t3->ClearBoundingBoxDirty();
+		Primitive* primitive = pack()->Create<Primitive>();
+		primitive->SetOwner(shape);
+		EXPECT_TRUE(transform_->bounding_box_dirty());
+		EXPECT_TRUE(t3->bounding_box_dirty());
+	}
+
+// Tests that writing to a buffer flags the boxes computed from it, and that
+// refitting recomputes them.
+	TEST_F(TransformBasic, RefitBoundingBoxAfterBufferWrite) {
+		static const float kPositions[] = {
+			0.0f, 0.0f, 0.0f,
+			1.0f, 0.0f, 0.0f,
+			0.0f, 1.0f, 0.0f,
+		};
+		static const float kMovedPositions[] = {
+			0.0f, 0.0f, 0.0f,
+			4.0f, 0.0f, 0.0f,
+			0.0f, 1.0f, -2.0f,
+		};
+		VertexBuffer* buffer = pack()->Create<VertexBuffer>();
+		Field* field = buffer->CreateField(FloatField::GetApparentClass(), 3);
+		ASSERT_TRUE(buffer->AllocateElements(3));
+		field->SetFromFloats(kPositions, 3, 0, 3);
+		StreamBank* stream_bank = pack()->Create<StreamBank>();
+		ASSERT_TRUE(stream_bank->SetVertexStream(Stream::POSITION, 0, field, 0));
+		Primitive* primitive = pack()->Create<Primitive>();
+		primitive->set_stream_bank(stream_bank);
+		primitive->set_primitive_type(Primitive::TRIANGLELIST);
+		primitive->set_number_vertices(3);
+		primitive->set_number_primitives(1);
+		Shape* shape = pack()->Create<Shape>();
+		primitive->SetOwner(shape);
+		transform2_->AddShape(shape);
+		transform2_->SetParent(transform_);
+		transform2_->set_local_matrix(Matrix4::translation(Vector3(10.0f, 0.0f, 0.0f)));
+		primitive->UpdateBoundingBox();
+		extra::updateBoundingBoxes(*transform_);
+		EXPECT_FALSE(primitive->bounding_box_dirty());
+		EXPECT_FALSE(transform_->bounding_box_dirty());
+		EXPECT_FALSE(transform2_->bounding_box_dirty());
+		EXPECT_FLOAT_EQ(11.0f, transform_->bounding_box().max_extent().getX());
+
+		field->SetFromFloats(kMovedPositions, 3, 0, 3);
+		EXPECT_TRUE(primitive->bounding_box_dirty());
+		EXPECT_TRUE(transform2_->bounding_box_dirty());
+		EXPECT_TRUE(transform_->bounding_box_dirty());
+		// Nothing is recomputed until the boxes are refitted.
+		EXPECT_FLOAT_EQ(1.0f, primitive->bounding_box().max_extent().getX());
+
+		extra::refitBoundingBoxes(*transform_);
+		EXPECT_FALSE(primitive->bounding_box_dirty());
+		EXPECT_FALSE(transform2_->bounding_box_dirty());
+		EXPECT_FALSE(transform_->bounding_box_dirty());
+		EXPECT_FLOAT_EQ(4.0f, primitive->bounding_box().max_extent().getX());
+		EXPECT_FLOAT_EQ(-2.0f, transform2_->bounding_box().min_extent().getZ());
+		EXPECT_FLOAT_EQ(14.0f, transform_->bounding_box().max_extent().getX());
+		EXPECT_FLOAT_EQ(-2.0f, transform_->bounding_box().min_extent().getZ());
+	}
+
+// Tests that refitting follows a transform animated through its localMatrix
+// Param.
+	TEST_F(TransformBasic, RefitBoundingBoxOfAnimatedTransform) {
+		static const float kPositions[] = {
+			0.0f, 0.0f, 0.0f,
+			1.0f, 0.0f, 0.0f,
+			0.0f, 1.0f, 0.0f,
+		};
+		VertexBuffer* buffer = pack()->Create<VertexBuffer>();
+		Field* field = buffer->CreateField(FloatField::GetApparentClass(), 3);
+		ASSERT_TRUE(buffer->AllocateElements(3));
+		field->SetFromFloats(kPositions, 3, 0, 3);
+		StreamBank* stream_bank = pack()->Create<StreamBank>();
+		ASSERT_TRUE(stream_bank->SetVertexStream(Stream::POSITION, 0, field, 0));
+		Primitive* primitive = pack()->Create<Primitive>();
+		primitive->set_stream_bank(stream_bank);
+		primitive->set_primitive_type(Primitive::TRIANGLELIST);
+		primitive->set_number_vertices(3);
+		primitive->set_number_primitives(1);
+		Shape* shape = pack()->Create<Shape>();
+		primitive->SetOwner(shape);
+		transform2_->AddShape(shape);
+		transform2_->SetParent(transform_);
+		Matrix4Translation* translation = pack()->Create<Matrix4Translation>();
+		translation->set_translation(Float3(10.0f, 0.0f, 0.0f));
+		ASSERT_TRUE(transform2_->GetParam<ParamMatrix4>(
+		                Transform::kLocalMatrixParamName)->Bind(
+		                translation->GetParam<ParamMatrix4>(
+		                    Matrix4Translation::kOutputMatrixParamName)));
+		primitive->UpdateBoundingBox();
+		extra::updateBoundingBoxes(*transform_);
+		EXPECT_FLOAT_EQ(11.0f, transform_->bounding_box().max_extent().getX());
+		// The parent is refitted each time, since the animation can change the
+		// local matrix without notice.
+		EXPECT_TRUE(transform_->bounding_box_dirty());
+		EXPECT_FALSE(transform2_->bounding_box_dirty());
+
+		translation->set_translation(Float3(0.0f, -5.0f, 0.0f));
+		extra::refitBoundingBoxes(*transform_);
+		EXPECT_FLOAT_EQ(1.0f, transform_->bounding_box().max_extent().getX());
+		EXPECT_FLOAT_EQ(-5.0f, transform_->bounding_box().min_extent().getY());
+
+		// Once unbound, the box of the parent stays as refitted.
+		transform2_->GetParam<ParamMatrix4>(
+		    Transform::kLocalMatrixParamName)->UnbindInput();
+		extra::refitBoundingBoxes(*transform_);
+		EXPECT_FALSE(transform_->bounding_box_dirty());
+		EXPECT_FLOAT_EQ(-5.0f, transform_->bounding_box().min_extent().getY());
+	}
+
 	TEST_F(TransformBasic, CreateGroupDrawElements) {
 		// Setup a basic hierarchy
 		SetupSimpleTree();
@@ -554,4 +700,74 @@ namespace o3d {
 		EXPECT_FALSE(t1_world_matrix->cachable());
 	}
 
+	TEST_F(TransformBasic, InstanceOf) {
+		EXPECT_TRUE(transform_->instance_of() == NULL);
+		transform_->ClearBoundingBoxDirty();
+		transform_->set_instance_of(transform2_);
+		EXPECT_EQ(transform2_, transform_->instance_of());
+		// The instance is as big as its prototype.
+		EXPECT_TRUE(transform_->bounding_box_dirty());
+		transform_->set_instance_of(NULL);
+		EXPECT_TRUE(transform_->instance_of() == NULL);
+	}
+
+	TEST_F(TransformBasic, GetInstanceShape) {
+		Shape* shape = pack()->Create<Shape>();
+		Shape* skinned = pack()->Create<Shape>();
+		Shape* instance_skinned = pack()->Create<Shape>();
+		EXPECT_EQ(shape, transform_->GetInstanceShape(shape));
+		transform_->set_instance_of(transform2_);
+		EXPECT_EQ(skinned, transform_->GetInstanceShape(skinned));
+		transform_->SetInstanceShape(skinned, instance_skinned);
+		EXPECT_EQ(instance_skinned, transform_->GetInstanceShape(skinned));
+		EXPECT_EQ(shape, transform_->GetInstanceShape(shape));
+	}
+
+	TEST_F(TransformBasic, ApplyInstanceState) {
+		// transform2_ is the prototype, with a child whose param follows the
+		// prototype's time.
+		Transform* child = pack()->Create<Transform>();
+		child->SetParent(transform2_);
+		child->set_local_matrix(Matrix4::translation(Vector3(1.0f, 2.0f, 3.0f)));
+		ParamFloat* prototype_time = transform2_->CreateParam<ParamFloat>("time");
+		ParamFloat* child_time = child->CreateParam<ParamFloat>("childTime");
+		ASSERT_TRUE(child_time->Bind(prototype_time));
+		ParamFloat* prototype_bound = transform2_->CreateParam<ParamFloat>("bound");
+		ParamFloat* source = child->CreateParam<ParamFloat>("source");
+		source->set_value(5.0f);
+		ASSERT_TRUE(prototype_bound->Bind(source));
+		transform2_->CreateParam<ParamFloat>("other_type");
+		// The instance.
+		transform_->CreateParam<ParamFloat>("time")->set_value(2.0f);
+		transform_->CreateParam<ParamFloat>("bound")->set_value(7.0f);
+		transform_->CreateParam<ParamInteger>("other_type")->set_value(1);
+		transform_->set_local_matrix(Matrix4::translation(Vector3(4.0f, 0.0f, 0.0f)));
+		transform_->set_instance_of(transform2_);
+		ParamMatrix4* bone = transform_->CreateParam<ParamMatrix4>("bone");
+		transform_->AddInstanceMatrix(child, bone);
+		EXPECT_FLOAT_EQ(0.0f, child_time->value());
+		EvaluationCounter* evaluation_counter =
+		    g_service_locator->GetService<EvaluationCounter>();
+		int evaluation_count = evaluation_counter->evaluation_count();
+		transform_->ApplyInstanceState();
+		// Only the outputs of the copied params were invalidated.
+		EXPECT_EQ(evaluation_count, evaluation_counter->evaluation_count());
+		EXPECT_FLOAT_EQ(2.0f, prototype_time->value());
+		EXPECT_FLOAT_EQ(2.0f, child_time->value());
+		// Bound params, params of another type and the standard params are
+		// left alone.
+		EXPECT_FLOAT_EQ(5.0f, prototype_bound->value());
+		EXPECT_TRUE(MatricesAreSame(Matrix4::identity(),
+		                            transform2_->local_matrix()));
+		EXPECT_TRUE(MatricesAreSame(
+		                Matrix4::translation(Vector3(1.0f, 2.0f, 3.0f)),
+		                bone->value()));
+		// A second instance gets its own time.
+		Transform* other = pack()->Create<Transform>();
+		other->CreateParam<ParamFloat>("time")->set_value(3.0f);
+		other->set_instance_of(transform2_);
+		other->ApplyInstanceState();
+		EXPECT_FLOAT_EQ(3.0f, child_time->value());
+	}
+
 }  // namespace o3d
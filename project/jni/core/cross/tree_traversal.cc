@@ -33,15 +33,75 @@
 // This file contains the definition of TreeTraveral.
 
 #include "core/cross/tree_traversal.h"
+#include <algorithm>
+#include <set>
+#include "core/cross/primitive.h"
 #include "core/cross/shape.h"
 #include "core/cross/draw_list.h"
 #include "core/cross/transformation_context.h"
 #include "core/cross/picking_context.h"
 #include "core/cross/renderer.h"
 #include "core/cross/error.h"
+#include "core/cross/frame_profiler.h"
+#include "core/cross/worker_pool.h"
 
 namespace o3d {
 
+	namespace {
+
+		// Returns the larger of the width and height of |box| projected by
+		// |world_view_projection|, as a fraction of the viewport. A box that
+		// crosses the near plane is treated as covering the whole viewport.
+		float ProjectedSize(const BoundingBox& box,
+		                    const Matrix4& world_view_projection) {
+			if(!box.valid()) {
+				return 1.0f;
+			}
+
+			Point3 box_min = box.min_extent();
+			Point3 box_max = box.max_extent();
+			float min_x = 1.0f, min_y = 1.0f, max_x = -1.0f, max_y = -1.0f;
+
+			for(int i = 0; i < 8; ++i) {
+				Vector4 point = world_view_projection * Vector4(
+				                    (i & 1) ? box_max.getX() : box_min.getX(),
+				                    (i & 2) ? box_max.getY() : box_min.getY(),
+				                    (i & 4) ? box_max.getZ() : box_min.getZ(),
+				                    1.0f);
+
+				if(point.getW() <= 0.0f) {
+					return 1.0f;
+				}
+
+				float x = point.getX() / point.getW();
+				float y = point.getY() / point.getW();
+				min_x = std::min(min_x, x);
+				max_x = std::max(max_x, x);
+				min_y = std::min(min_y, y);
+				max_y = std::max(max_y, y);
+			}
+
+			// Normalized device coordinates span 2 units across the viewport.
+			return std::max(max_x - min_x, max_y - min_y) * 0.5f;
+		}
+
+		// Default size of the occlusion buffers. Occluders are coarse, so a
+		// small buffer is enough and keeps rasterization cheap.
+		const unsigned kOcclusionBufferWidth = 256;
+		const unsigned kOcclusionBufferHeight = 128;
+
+		// Returns true if |box| is known to be hidden behind the occluders in
+		// |occlusion_buffer|, which can be NULL.
+		bool IsOccluded(const OcclusionBuffer* occlusion_buffer,
+		                const BoundingBox& box,
+		                const Matrix4& world_view_projection) {
+			return occlusion_buffer && box.valid() &&
+			       !occlusion_buffer->IsVisible(box.min_extent(), box.max_extent(),
+			                                    world_view_projection);
+		}
+
+	}  // anonymous namespace
+
 // Acts as a stack for pickable objects as they get traversed by
 // the TreeTraversal (used in WalkTransform() and AddInstance()).
 // The PickingContext gets modified only if Renderer::picking()
@@ -54,10 +114,11 @@ namespace o3d {
 		PickableStack(PickingContext* context, ParamObject* candidate, bool really_do_it)
 			: context(context), previous_pickable(context->pickable()) {
 			O3D_ASSERT(candidate);
-			ParamBoolean* p = candidate->GetParam<ParamBoolean>("pickable");
 
-			if(really_do_it && p) {
-				if(p->value()) {
+			if(really_do_it) {
+				ParamBoolean* p = candidate->GetParam<ParamBoolean>("pickable");
+
+				if(p && p->value()) {
 					context->set_pickable(candidate);
 				}
 			}
@@ -80,7 +141,10 @@ namespace o3d {
 		: RenderNode(service_locator),
 		  transformation_context_(service_locator->
 		                          GetService<TransformationContext>()),
-		  picking_context_(service_locator->GetService<PickingContext>()) {
+		  picking_context_(service_locator->GetService<PickingContext>()),
+		  prepared_(false),
+		  occlusion_buffer_width_(kOcclusionBufferWidth),
+		  occlusion_buffer_height_(kOcclusionBufferHeight) {
 		RegisterParamRef(kTransformParamName, &transform_param_);
 	}
 
@@ -95,10 +159,112 @@ namespace o3d {
 	}
 
 	bool TreeTraversal::UnregisterDrawList(DrawList* draw_list) {
+		// Buffers are recreated for the remaining draw contexts on the next
+		// traversal.
+		occlusion_buffers_.clear();
 		return draw_list_draw_context_info_map_.erase(DrawList::Ref(draw_list)) > 0;
 	}
 
+	bool TreeTraversal::FillsDrawList(const DrawList* draw_list) const {
+		for(DrawListDrawContextInfoMap::const_iterator iter(
+		            draw_list_draw_context_info_map_.begin());
+		        iter != draw_list_draw_context_info_map_.end();
+		        ++iter) {
+			if(iter->first.Get() == draw_list) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool TreeTraversal::AddOccluder(Transform* transform, Primitive* primitive) {
+		O3D_ASSERT(transform);
+		O3D_ASSERT(primitive);
+		Occluder occluder;
+
+		if(!primitive->GetTriangleList(0, &occluder.positions, &occluder.indices)) {
+			O3D_ERROR(service_locator())
+			        << "Primitive '" << primitive->name()
+			        << "' is not an indexed triangle list and can't be an occluder";
+			return false;
+		}
+
+		occluder.transform = Transform::Ref(transform);
+		occluders_.push_back(occluder);
+		return true;
+	}
+
+	void TreeTraversal::ClearOccluders() {
+		occluders_.clear();
+		occlusion_buffers_.clear();
+	}
+
+	void TreeTraversal::set_occlusion_threads(unsigned num_threads) {
+		occlusion_pool_.reset(num_threads > 0 ? new WorkerPool(num_threads) : NULL);
+	}
+
+	void TreeTraversal::SetOcclusionBufferSize(unsigned width, unsigned height) {
+		occlusion_buffer_width_ = width;
+		occlusion_buffer_height_ = height;
+	}
+
+	void TreeTraversal::RasterizeOccluders() {
+		std::set<const DrawContext*> rasterized;
+		DrawListDrawContextInfoMap::iterator end(
+		    draw_list_draw_context_info_map_.end());
+
+		for(DrawListDrawContextInfoMap::iterator iter(
+		            draw_list_draw_context_info_map_.begin());
+		        iter != end;
+		        ++iter) {
+			DrawContextInfo& draw_context_info = iter->second;
+			const DrawContext* draw_context = draw_context_info.draw_context();
+			OcclusionBuffer& buffer = occlusion_buffers_[draw_context];
+			draw_context_info.set_occlusion_buffer(&buffer);
+
+			if(!rasterized.insert(draw_context).second) {
+				continue;
+			}
+
+			buffer.Clear(occlusion_buffer_width_, occlusion_buffer_height_);
+
+			for(OccluderArray::const_iterator occluder(occluders_.begin());
+			        occluder != occluders_.end();
+			        ++occluder) {
+				buffer.AddOccluder(
+				    draw_context_info.view_projection() *
+				    occluder->transform->world_matrix(),
+				    &occluder->positions[0],
+				    static_cast<unsigned>(occluder->positions.size() / 3),
+				    &occluder->indices[0],
+				    static_cast<unsigned>(occluder->indices.size()));
+			}
+
+			buffer.Rasterize(occlusion_pool_.get());
+		}
+	}
+
 	void TreeTraversal::Render(RenderContext* render_context) {
+		if(prepared_) {
+			prepared_ = false;
+			return;
+		}
+
+		Traverse(render_context);
+	}
+
+	void TreeTraversal::Prepare(RenderContext* render_context) {
+		Traverse(render_context);
+		prepared_ = true;
+	}
+
+	void TreeTraversal::Traverse(RenderContext* render_context) {
+		O3D_PROFILE_ZONE("TreeTraversal::Traverse");
+		RenderStats* render_stats = render_context->renderer()->render_stats();
+		ScopedRenderStatsPass stats_pass(render_stats, id(), name());
+		ScopedRenderStatsTimer traversal_timer(render_stats,
+		                                       RenderStats::TRAVERSAL_TIME);
 		// Reset the draw context infos array so we can rebuild it.
 		draw_context_infos_by_draw_list_global_index_.clear();
 		// Reset any DrawLists that need resetting and set the pass list flags.
@@ -134,6 +300,7 @@ namespace o3d {
 
 			draw_context_infos_by_draw_list_global_index_[global_index] =
 			    &draw_context_info;
+			draw_context_info.set_occlusion_buffer(NULL);
 		}
 
 		// At this point draw_context_infos_by_draw_list_global_index_ is big enough
@@ -154,11 +321,17 @@ namespace o3d {
 			return;
 		}
 
+		if(!occluders_.empty()) {
+			RasterizeOccluders();
+		}
+
 		// Now walk ourselves and all our children.
 		WalkTransform(render_context,
 		              transform1,
 		              0,
-		              static_cast<int>(draw_list_draw_context_info_map_.size()));
+		              static_cast<int>(draw_list_draw_context_info_map_.size()),
+		              NULL,
+		              NULL);
 	}
 
 	void TreeTraversal::SetStandardParameters(const Matrix4& world,
@@ -175,10 +348,14 @@ namespace o3d {
 	void TreeTraversal::WalkTransform(RenderContext* render_context,
 	                                  Transform* transform,
 	                                  int depth,
-	                                  int num_non_culled_draw_contexts) {
+	                                  int num_non_culled_draw_contexts,
+	                                  const Matrix4* parent_world,
+	                                  Transform* instance) {
 		Renderer* renderer = render_context->renderer();
 		PickableStack pushIfPickable(picking_context_, transform, renderer->picking());
-		Matrix4 world = transform->world_matrix();
+		Matrix4 world = parent_world ?
+		                *parent_world * transform->local_matrix() :
+		                transform->world_matrix();
 		Matrix4 world_view_projection;
 		bool cull_depth_was_set = false;
 		renderer->IncrementTransformsProcessed();
@@ -236,7 +413,10 @@ namespace o3d {
 					//     In other words the user can not supply is own funky
 					//     worldViewProjection for culling using param binds where as he
 					//     can supply one for rendering.
-					if(!transform->bounding_box().InFrustum(world_view_projection)) {
+					if(!transform->bounding_box().InFrustum(world_view_projection) ||
+					        IsOccluded(draw_context_info->occlusion_buffer(),
+					                   transform->bounding_box(),
+					                   world_view_projection)) {
 						renderer->IncrementTransformsCulled();
 						--num_non_culled_draw_contexts;
 						draw_context_info->set_cull_depth(depth);
@@ -253,7 +433,10 @@ namespace o3d {
 				ShapeRefArray::size_type size = shapes.size();
 
 				for(ShapeRefArray::size_type ii = 0; ii < size; ++ii) {
-					AddInstance(render_context, shapes[ii], transform, world);
+					Shape* shape = instance ?
+					               instance->GetInstanceShape(shapes[ii]) :
+					               shapes[ii].Get();
+					AddInstance(render_context, shape, transform, world, instance);
 				}
 			}
 			// Process all the children
@@ -267,10 +450,26 @@ namespace o3d {
 						WalkTransform(render_context,
 						              children[ii],
 						              children_depth,
-						              num_non_culled_draw_contexts);
+						              num_non_culled_draw_contexts,
+						              instance ? &world : NULL,
+						              instance);
 					}
 				}
 			}
+			// Process the prototype this transform is an instance of, with the
+			// state of this instance. Its transforms are shared by all the
+			// instances, so their world matrices are computed from ours.
+			Transform* prototype = transform->instance_of();
+
+			if(prototype && prototype->visible()) {
+				transform->ApplyInstanceState();
+				WalkTransform(render_context,
+				              prototype,
+				              depth + 1,
+				              num_non_culled_draw_contexts,
+				              &world,
+				              transform);
+			}
 		}
 
 		// Reset any cull_depths at our depth
@@ -299,7 +498,8 @@ namespace o3d {
 	void TreeTraversal::AddInstance(RenderContext* render_context,
 	                                Shape* shape,
 	                                Transform* override,
-	                                const Matrix4& world) {
+	                                const Matrix4& world,
+	                                Transform* instance) {
 		Renderer* renderer = render_context->renderer();
 		PickableStack pushIfPickable(picking_context_, shape, renderer->picking());
 		const ElementRefArray& elements = shape->GetElementRefs();
@@ -369,19 +569,30 @@ namespace o3d {
 						//     that no matter what, we only cull to that worldViewProjection.
 						//     In other words the user can not supply is own funky
 						//     worldViewProjection for culling using param binds.
-						if(!element->bounding_box().InFrustum(world_view_projection)) {
+						if(!element->bounding_box().InFrustum(world_view_projection) ||
+						        IsOccluded(draw_context_info->occlusion_buffer(),
+						                   element->bounding_box(),
+						                   world_view_projection)) {
 							renderer->IncrementDrawElementsCulled();
 							continue;
 						}
 					}
 
+					if(element->GetLodCount() > 0) {
+						param_cache->set_lod(element->SelectLod(
+						                         ProjectedSize(element->bounding_box(),
+						                                       world_view_projection),
+						                         param_cache->lod()));
+					}
+
 					draw_list->AddDrawElement(draw_element,
 					                          element,
 					                          material,
 					                          override,
 					                          param_cache,
 					                          world,
-					                          world_view_projection);
+					                          world_view_projection,
+					                          instance);
 				}
 			}
 		}
@@ -37,6 +37,8 @@
 
 #include <map>
 #include <vector>
+#include "base/cross/scoped_ptr.h"
+#include "core/cross/occlusion_buffer.h"
 #include "core/cross/transform.h"
 #include "core/cross/render_node.h"
 #include "core/cross/draw_context.h"
@@ -45,7 +47,9 @@ namespace o3d {
 
 	class TransformationContext;
 	class PickingContext;
+	class Primitive;
 	class Shape;
+	class WorkerPool;
 
 // A TreeTraversal has multiple DrawLists registered with it. Each DrawList has
 // a DrawContext registered with it. At render time the TreeTraversal walks the
@@ -71,6 +75,13 @@ namespace o3d {
 
 		virtual void Render(RenderContext* render_context);
 
+		// Traverses the tree ahead of Render, which then has nothing left to do
+		// for this frame.
+		virtual void Prepare(RenderContext* render_context);
+
+		// Whether this TreeTraversal adds to |draw_list|.
+		bool FillsDrawList(const DrawList* draw_list) const;
+
 		// Registers a DrawList with this TreeTraversal so that when this
 		// TreeTraversal traverses its tree materials that use this DrawList will be
 		// added though possibly culled by the view frustum of the DrawContext.
@@ -91,6 +102,31 @@ namespace o3d {
 		//   true if unregistered. false if this draw_list was not registered.
 		bool UnregisterDrawList(DrawList* draw_list);
 
+		// Registers an occluder. At the start of each traversal, the occluders
+		// are rasterized on the CPU into a low resolution depth buffer for each
+		// DrawContext, and the Transforms and Elements entirely hidden behind
+		// them are culled like those outside the view frustum.
+		// Good occluders are a few large and simple meshes, such as low detail
+		// stand-ins for buildings; they don't need to be drawn. The geometry of
+		// the primitive is copied, while the world matrix of the transform is
+		// read every frame.
+		// Parameters:
+		//   transform: Transform giving the position of the occluder.
+		//   primitive: indexed TRIANGLELIST Primitive giving its shape.
+		// Returns:
+		//   false if the primitive can't be used as an occluder.
+		bool AddOccluder(Transform* transform, Primitive* primitive);
+
+		// Unregisters all the occluders.
+		void ClearOccluders();
+
+		// Sets the number of threads rasterizing the occluders. With 0, the
+		// default, they are rasterized on the rendering thread.
+		void set_occlusion_threads(unsigned num_threads);
+
+		// Sets the size in pixels of the occlusion depth buffers.
+		void SetOcclusionBufferSize(unsigned width, unsigned height);
+
 	private:
 		explicit TreeTraversal(ServiceLocator* service_locator);
 
@@ -100,11 +136,23 @@ namespace o3d {
 		public:
 			// This has to exist so std::map operator[] can work but an uninitialized
 			// DrawContextInfo is never direcly accessed.
-			DrawContextInfo() { }
+			DrawContextInfo()
+				: reset_(false),
+				  cull_depth_(-1),
+				  occlusion_buffer_(NULL),
+				  view_(Matrix4::identity()),
+				  projection_(Matrix4::identity()),
+				  view_projection_(Matrix4::identity()) {
+			}
 
 			DrawContextInfo(DrawContext* draw_context, bool reset)
 				: draw_context_(DrawContext::Ref(draw_context)),
-				  reset_(reset) {
+				  reset_(reset),
+				  cull_depth_(-1),
+				  occlusion_buffer_(NULL),
+				  view_(Matrix4::identity()),
+				  projection_(Matrix4::identity()),
+				  view_projection_(Matrix4::identity()) {
 			}
 
 			DrawContext* draw_context() const {
@@ -143,6 +191,16 @@ namespace o3d {
 				return cull_depth_ >= 0;
 			}
 
+			// Occluders rasterized for this draw context this frame, or NULL
+			// if there are none.
+			const OcclusionBuffer* occlusion_buffer() const {
+				return occlusion_buffer_;
+			}
+
+			void set_occlusion_buffer(const OcclusionBuffer* occlusion_buffer) {
+				occlusion_buffer_ = occlusion_buffer;
+			}
+
 			// Updates the view, projection and viewProjection based on the DrawContext.
 			void UpdateViewProjection();
 
@@ -150,6 +208,7 @@ namespace o3d {
 			DrawContext::Ref draw_context_;
 			bool reset_;
 			int cull_depth_;
+			const OcclusionBuffer* occlusion_buffer_;
 			Matrix4 view_;
 			Matrix4 projection_;
 			Matrix4 view_projection_;
@@ -158,6 +217,9 @@ namespace o3d {
 		friend class IClassManager;
 		static ObjectBase::Ref Create(ServiceLocator* service_locator);
 
+		// Resets the registered DrawLists and fills them from the tree.
+		void Traverse(RenderContext* render_context);
+
 		// Adds an instance of a Shape to the DrawList it's material requests if
 		// we are gathering stuff for that DrawList.
 		// Parameters:
@@ -165,23 +227,35 @@ namespace o3d {
 		//   shape: Shape to add to list.
 		//   override: Transform used to override params and store param cache.
 		//   world_matrix: The worldMatrix for this Shape.
+		//   instance: the instance the Shape is drawn for, or NULL.
 		void AddInstance(RenderContext* render_context,
 		                 Shape* shape,
 		                 Transform* override,
-		                 const Matrix4& world_matrix);
+		                 const Matrix4& world_matrix,
+		                 Transform* instance);
 
 		// Walks a transform, optionally attempts to cull it. If not culled, walks its
 		// children and attempts to add its Shapes to the corresponding registered
-		// DrawLists.
+		// DrawLists. If it is an instance of another transform, walks that one
+		// too.
 		// Parameters:
 		//   render_context: Rendering info.
 		//   transform: Transform to walk.
 		//   depth: depth we've walked so far.
 		//   num_non_culled_draw_contexts: How many contexts we have left to process.
+		//   parent_world: when walking the prototype of an instance, the world
+		//       matrix of the parent of |transform| in that instance, since its
+		//       own world matrix is not the one of the instance. NULL otherwise.
+		//   instance: the instance being walked, or NULL.
 		void WalkTransform(RenderContext* render_context,
 		                   Transform* transform,
 		                   int depth,
-		                   int num_non_culled_draw_contexts);
+		                   int num_non_culled_draw_contexts,
+		                   const Matrix4* parent_world,
+		                   Transform* instance);
+
+		// Rasterizes the occluders for each registered DrawContext.
+		void RasterizeOccluders();
 
 		// Sets the standard parameters on the client so that Param chains might
 		// get valid values.
@@ -210,6 +284,26 @@ namespace o3d {
 		bool standard_params_have_been_set_;  // true if standard params
 		// have been set.
 
+		// Whether Prepare traversed the tree since the last Render.
+		bool prepared_;
+
+		// An occluder with its geometry copied into plain memory.
+		struct Occluder {
+			Transform::Ref transform;
+			std::vector<float> positions;
+			std::vector<uint32_t> indices;
+		};
+		typedef std::vector<Occluder> OccluderArray;
+		OccluderArray occluders_;
+
+		// Occlusion buffers by DrawContext, so that DrawLists sharing a
+		// DrawContext share a buffer.
+		typedef std::map<const DrawContext*, OcclusionBuffer> OcclusionBufferMap;
+		OcclusionBufferMap occlusion_buffers_;
+		unsigned occlusion_buffer_width_;
+		unsigned occlusion_buffer_height_;
+		base::scoped_ptr<WorkerPool> occlusion_pool_;
+
 		O3D_DECL_CLASS(TreeTraversal, RenderNode);
 		O3D_DISALLOW_COPY_AND_ASSIGN(TreeTraversal);
 	};
@@ -32,6 +32,8 @@
 
 // This file implements unit tests for class TreeTraveral.
 
+#include <algorithm>
+#include <vector>
 #include "tests/common/win/testing_common.h"
 #include "core/cross/tree_traversal.h"
 #include "core/cross/object_manager.h"
@@ -39,9 +41,54 @@
 #include "core/cross/service_dependency.h"
 #include "core/cross/transformation_context.h"
 #include "core/cross/draw_list_manager.h"
+#include "core/cross/picking_context.h"
+#include "core/cross/primitive.h"
+#include "core/cross/render_context.h"
+#include "core/cross/semantic_manager.h"
+#include "core/cross/renderer.h"
+#include "core/cross/shape.h"
+#include "core/cross/draw_list.h"
+#include "core/cross/material.h"
 
 namespace o3d {
 
+	namespace {
+
+		// An Element that keeps the value its material has for "tint" each time
+		// it is rendered.
+		class TintRecorder : public Element {
+		public:
+			TintRecorder(ServiceLocator* service_locator,
+			             std::vector<float>* tints)
+				: Element(service_locator),
+				  tints_(tints) {
+			}
+
+			virtual void Render(Renderer* renderer,
+			                    DrawElement* draw_element,
+			                    Material* material,
+			                    ParamObject* param_object,
+			                    ParamCache* param_cache) {
+				tints_->push_back(material->GetParam<ParamFloat>("tint")->value());
+			}
+
+			virtual void IntersectRay(int position_stream_index,
+			                          State::Cull cull,
+			                          const Point3& start,
+			                          const Point3& end,
+			                          RayIntersectionInfo* result) const {
+			}
+
+			virtual void GetBoundingBox(int position_stream_index,
+			                            BoundingBox* result) const {
+			}
+
+		private:
+			std::vector<float>* tints_;
+		};
+
+	}  // anonymous namespace
+
 	class TreeTraversalTest : public testing::Test {
 	protected:
 		TreeTraversalTest()
@@ -52,25 +99,59 @@ namespace o3d {
 
 		Pack* pack() { return pack_; }
 
+		// Creates |count| small shapes in a row along x from -2 to 2, of which
+		// the identity view and projection only see the middle half.
+		Transform* CreateRow(unsigned count, DrawList* draw_list);
+
 	private:
 		ServiceDependency<ObjectManager> object_manager_;
 		TransformationContext* transformation_context_;
 		DrawListManager* draw_list_manager_;
+		PickingContext* picking_context_;
+		SemanticManager* semantic_manager_;
 		Pack* pack_;
 	};
 
 	void TreeTraversalTest::SetUp() {
 		transformation_context_ = new TransformationContext(g_service_locator);
 		draw_list_manager_ = new DrawListManager(g_service_locator);
+		picking_context_ = new PickingContext(g_service_locator);
+		semantic_manager_ = new SemanticManager(g_service_locator);
 		pack_ = object_manager_->CreatePack();
 	}
 
 	void TreeTraversalTest::TearDown() {
 		pack_->Destroy();
+		delete semantic_manager_;
+		delete picking_context_;
 		delete draw_list_manager_;
 		delete transformation_context_;
 	}
 
+	Transform* TreeTraversalTest::CreateRow(unsigned count, DrawList* draw_list) {
+		Material* material = pack()->Create<Material>();
+		material->set_effect(pack()->Create<Effect>());
+		material->set_draw_list(draw_list);
+		Transform* root = pack()->Create<Transform>();
+
+		for(unsigned ii = 0; ii < count; ++ii) {
+			float x = (ii + 0.5f - count * 0.5f) / (count * 0.25f);
+			Primitive* primitive = pack()->Create<Primitive>();
+			primitive->set_material(material);
+			primitive->set_cull(true);
+			primitive->set_bounding_box(BoundingBox(Point3(x - 0.001f, 0.0f, 0.5f),
+			                                        Point3(x + 0.001f, 0.1f, 0.6f)));
+			primitive->CreateDrawElement(pack(), NULL);
+			Shape* shape = pack()->Create<Shape>();
+			primitive->SetOwner(shape);
+			Transform* transform = pack()->Create<Transform>();
+			transform->AddShape(shape);
+			transform->SetParent(root);
+		}
+
+		return root;
+	}
+
 	TEST_F(TreeTraversalTest, Basic) {
 		TreeTraversal* tree_traversal = pack()->Create<TreeTraversal>();
 		// Check that tree_traversal got created.
@@ -93,4 +174,69 @@ namespace o3d {
 		EXPECT_FALSE(tree_traversal->UnregisterDrawList(draw_list3));
 	}
 
+	TEST_F(TreeTraversalTest, CullsOutsideFrustum) {
+		TreeTraversal* tree_traversal = pack()->Create<TreeTraversal>();
+		DrawList* draw_list = pack()->Create<DrawList>();
+		DrawContext* draw_context = pack()->Create<DrawContext>();
+		tree_traversal->RegisterDrawList(draw_list, draw_context, true);
+		Transform* root = CreateRow(1024, draw_list);
+		tree_traversal->set_transform(root);
+		RenderContext render_context(g_renderer);
+		int processed = g_renderer->draw_elements_processed();
+		int culled = g_renderer->draw_elements_culled();
+		tree_traversal->Render(&render_context);
+		EXPECT_EQ(1024, g_renderer->draw_elements_processed() - processed);
+		EXPECT_EQ(512, g_renderer->draw_elements_culled() - culled);
+		EXPECT_FALSE(draw_list->empty());
+		root->SetParent(NULL);
+	}
+
+	// Material params bound to a prototype get the values of each instance
+	// when they are rendered, not those of the last instance walked.
+	TEST_F(TreeTraversalTest, InstanceParamsAtRender) {
+		TreeTraversal* tree_traversal = pack()->Create<TreeTraversal>();
+		DrawList* draw_list = pack()->Create<DrawList>();
+		DrawContext* draw_context = pack()->Create<DrawContext>();
+		tree_traversal->RegisterDrawList(draw_list, draw_context, true);
+		Material* material = pack()->Create<Material>();
+		material->set_effect(pack()->Create<Effect>());
+		material->set_draw_list(draw_list);
+		std::vector<float> tints;
+		Element::Ref element(new TintRecorder(g_service_locator, &tints));
+		element->set_material(material);
+		element->set_cull(false);
+		element->CreateDrawElement(pack(), NULL);
+		Shape* shape = pack()->Create<Shape>();
+		element->SetOwner(shape);
+		Transform* prototype = pack()->Create<Transform>();
+		prototype->AddShape(shape);
+		ASSERT_TRUE(material->CreateParam<ParamFloat>("tint")->Bind(
+		                prototype->CreateParam<ParamFloat>("tint")));
+		Transform* root = pack()->Create<Transform>();
+
+		for(int ii = 1; ii <= 2; ++ii) {
+			Transform* instance = pack()->Create<Transform>();
+			instance->CreateParam<ParamFloat>("tint")->set_value(ii * 1.0f);
+			instance->set_instance_of(prototype);
+			instance->SetParent(root);
+		}
+
+		tree_traversal->set_transform(root);
+		RenderContext render_context(g_renderer);
+		tree_traversal->Render(&render_context);
+		g_renderer->InitCommon();
+		ASSERT_TRUE(g_renderer->StartRendering());
+		ASSERT_TRUE(g_renderer->BeginDraw());
+		draw_list->Render(&render_context, DrawList::BY_PERFORMANCE);
+		g_renderer->EndDraw();
+		g_renderer->FinishRendering();
+		g_renderer->UninitCommon();
+		ASSERT_EQ(2u, tints.size());
+		std::sort(tints.begin(), tints.end());
+		EXPECT_FLOAT_EQ(1.0f, tints[0]);
+		EXPECT_FLOAT_EQ(2.0f, tints[1]);
+		element->SetOwner(NULL);
+		root->SetParent(NULL);
+	}
+
 }  // namespace o3d
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/cross/worker_pool.h"
+#include "base/cross/log.h"
+#include <unistd.h>
+
+namespace o3d {
+
+	WorkerPool::WorkerPool(unsigned num_threads)
+		: task_posted_(lock_),
+		  task_done_(lock_),
+		  pending_(0),
+		  quit_(false) {
+		for(unsigned ii = 0; ii < num_threads; ++ii) {
+			pthread_t thread;
+
+			if(pthread_create(&thread, NULL, &WorkerPool::ThreadMain, this) != 0) {
+				O3D_LOG(WARNING) << "Could only start " << ii << " worker threads out of " << num_threads;
+				break;
+			}
+
+			threads_.push_back(thread);
+		}
+	}
+
+	WorkerPool::~WorkerPool() {
+		Wait();
+		{
+			base::AutoLock lock(lock_);
+			quit_ = true;
+			task_posted_.Broadcast();
+		}
+
+		for(size_t ii = 0; ii < threads_.size(); ++ii) {
+			pthread_join(threads_[ii], NULL);
+		}
+	}
+
+	void WorkerPool::Post(Closure* task) {
+		if(threads_.empty()) {
+			task->Run();
+			delete task;
+			return;
+		}
+
+		base::AutoLock lock(lock_);
+		tasks_.push_back(task);
+		++pending_;
+		task_posted_.Signal();
+	}
+
+	void WorkerPool::Wait() {
+		base::AutoLock lock(lock_);
+
+		while(pending_) {
+			task_done_.Wait();
+		}
+	}
+
+	unsigned WorkerPool::GetNumberOfProcessors() {
+		long count = sysconf(_SC_NPROCESSORS_ONLN);
+		return count > 0 ? static_cast<unsigned>(count) : 1;
+	}
+
+	void* WorkerPool::ThreadMain(void* pool) {
+		static_cast<WorkerPool*>(pool)->Work();
+		return NULL;
+	}
+
+	void WorkerPool::Work() {
+		while(true) {
+			Closure* task = NULL;
+			{
+				base::AutoLock lock(lock_);
+
+				while(tasks_.empty() && !quit_) {
+					task_posted_.Wait();
+				}
+
+				if(tasks_.empty()) return;
+
+				task = tasks_.front();
+				tasks_.pop_front();
+			}
+			task->Run();
+			delete task;
+			{
+				base::AutoLock lock(lock_);
+
+				if(--pending_ == 0) task_done_.Broadcast();
+			}
+		}
+	}
+
+}  // namespace o3d
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <pthread.h>
+#include "base/cross/lock.h"
+#include "core/cross/callback.h"
+
+namespace o3d {
+
+	// A fixed set of threads running Closures posted from any thread.
+	//
+	// Tasks must not create, destroy or modify ObjectBase-derived objects:
+	// the object and id managers are not thread-safe, and neither are the
+	// graphics backends. Use workers to convert data into plain memory and
+	// create the O3D objects afterwards, on the owning thread.
+	class WorkerPool {
+	public:
+		// A pool with no thread runs tasks synchronously in Post().
+		explicit WorkerPool(unsigned num_threads);
+
+		// Waits for pending tasks, then joins the threads.
+		~WorkerPool();
+
+		// Queues a task. The pool takes ownership of it and deletes it
+		// after it has run.
+		void Post(Closure* task);
+
+		// Blocks until every task posted so far has run.
+		void Wait();
+
+		unsigned num_threads() const {
+			return static_cast<unsigned>(threads_.size());
+		}
+
+		// Number of online processors, or 1 if it can't be determined.
+		static unsigned GetNumberOfProcessors();
+
+	private:
+		static void* ThreadMain(void* pool);
+		void Work();
+
+		base::Lock lock_;
+		base::ConditionVariable task_posted_;
+		base::ConditionVariable task_done_;
+		std::deque<Closure*> tasks_;
+		unsigned pending_;
+		bool quit_;
+		std::vector<pthread_t> threads_;
+
+		O3D_DISALLOW_COPY_AND_ASSIGN(WorkerPool);
+	};
+
+}  // namespace o3d
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file contains unit tests for the worker pool.
+
+#include <vector>
+#include "tests/common/win/testing_common.h"
+#include "core/cross/worker_pool.h"
+
+namespace o3d {
+
+	namespace {
+
+		class StoreIndexTask : public Closure {
+		public:
+			StoreIndexTask(std::vector<int>* results, int index)
+				: results_(results), index_(index) {}
+
+			virtual void Run() {
+				(*results_)[index_] = index_;
+			}
+
+		private:
+			std::vector<int>* results_;
+			int index_;
+		};
+
+	}  // anonymous namespace
+
+// Tests that a pool without threads runs tasks synchronously.
+	TEST(WorkerPoolTest, NoThreads) {
+		WorkerPool pool(0);
+		EXPECT_EQ(0U, pool.num_threads());
+		std::vector<int> results(1, -1);
+		pool.Post(new StoreIndexTask(&results, 0));
+		EXPECT_EQ(0, results[0]);
+	}
+
+// Tests that every posted task has run once Wait() returns.
+	TEST(WorkerPoolTest, WaitRunsEverything) {
+		const int kNumTasks = 1000;
+		WorkerPool pool(4);
+		std::vector<int> results(kNumTasks, -1);
+
+		for(int ii = 0; ii < kNumTasks; ++ii) {
+			pool.Post(new StoreIndexTask(&results, ii));
+		}
+
+		pool.Wait();
+
+		for(int ii = 0; ii < kNumTasks; ++ii) {
+			EXPECT_EQ(ii, results[ii]);
+		}
+	}
+
+// Tests that the pool can be reused after a Wait().
+	TEST(WorkerPoolTest, Reuse) {
+		WorkerPool pool(2);
+		std::vector<int> results(2, -1);
+		pool.Post(new StoreIndexTask(&results, 0));
+		pool.Wait();
+		pool.Post(new StoreIndexTask(&results, 1));
+		pool.Wait();
+		EXPECT_EQ(0, results[0]);
+		EXPECT_EQ(1, results[1]);
+	}
+
+}  // namespace o3d
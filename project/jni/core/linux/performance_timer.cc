@@ -38,17 +38,18 @@
 
 #include "core/cross/performance_timer.h"
 
-#include <sys/time.h>
 #include <time.h>
 
 #include "base/cross/log.h"
 
 namespace o3d {
 
+	// Returns a monotonic time in nanoseconds, unaffected by changes of the
+	// wall clock.
 	static uint64_t GetCurrentTime() {
-		struct timeval tv;
-		gettimeofday(&tv, NULL);
-		return tv.tv_sec * 1000000ULL + tv.tv_usec;
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		return now.tv_sec * 1000000000ULL + now.tv_nsec;
 	}
 
 	PerformanceTimer::PerformanceTimer(const char* name)
@@ -66,7 +67,7 @@ namespace o3d {
 	}
 
 	double PerformanceTimer::GetElapsedTime() {
-		return static_cast<double>(accum_time_) / 1.E6;
+		return static_cast<double>(accum_time_) / 1.E9;
 	}
 
 	void PerformanceTimer::Print() {
@@ -35,6 +35,7 @@ LOCAL_SRC_FILES := \
     primitive_picking.cc \
     collision_detection.cc \
     binary.cc \
+    resource_cache.cc \
   )
 
 include $(O3D_BUILD_MODULE)
@@ -29,9 +29,16 @@
 #include <core/cross/class_manager.h>
 #include <core/cross/renderer.h>
 #include <core/cross/texture.h>
+#include <core/cross/bitmap.h>
+#include <core/cross/image_utils.h>
 #include <core/cross/draw_context.h>
 #include <core/cross/sampler.h>
+#include <core/cross/timer.h>
+#include <core/cross/frame_profiler.h>
+#include <core/cross/worker_pool.h>
+#include <base/cross/lock.h>
 #include <extra/cross/binary.h>
+#include <extra/cross/resource_cache.h>
 #include <extra/cross/utils.h>
 
 #include <import/cross/memory_stream.h>
@@ -236,11 +243,275 @@ namespace o3d {
 				return true;
 			}
 
+// Geometry codec. Values are coded as varints, small values taking few bytes,
+// so the geometry is turned into small values first: indices are coded
+// against a cache of the last ones used, and quantized vertices as the
+// difference with the previous vertex.
+			static inline uint32_t zigzag(int32_t value) {
+				return (uint32_t(value) << 1) ^ uint32_t(value >> 31);
+			}
+
+			static inline int32_t unzigzag(uint32_t value) {
+				return int32_t(value >> 1) ^ -int32_t(value & 1);
+			}
+
+			static inline void put_varint(std::string& output, uint32_t value) {
+				while(value >= 0x80) {
+					output += char(value | 0x80);
+					value >>= 7;
+				}
+
+				output += char(value);
+			}
+
+			static inline bool get_varint(const uint8_t*& p, const uint8_t* end, uint32_t& value) {
+				value = 0;
+
+				for(unsigned shift(0); (p < end) && (shift < 32); shift += 7) {
+					const uint8_t byte(*p++);
+					value |= uint32_t(byte & 0x7f) << shift;
+
+					if(!(byte & 0x80)) return true;
+				}
+
+				return false;
+			}
+
+// Last indices used, most recent first. An index found in there is coded
+// as its position, others as the difference with the next index never
+// used, so that both indices shared by neighbouring triangles and new
+// vertices in order take a byte.
+			class IndexCache {
+			public:
+				enum { SIZE = 16 };
+
+				IndexCache()
+					: mSize(0)
+					, mNext(0) { }
+
+				void encode(uint32_t index, std::string& output) {
+					const int position(find(index));
+
+					if(position >= 0)
+						put_varint(output, position);
+					else
+						put_varint(output, SIZE + zigzag(int32_t(index - mNext)));
+
+					push(index, position);
+				}
+
+				bool decode(uint32_t code, uint32_t& index) {
+					int position(-1);
+
+					if(code < SIZE) {
+						if(code >= mSize) return false;
+
+						position = code;
+						index = mEntries[position];
+					}
+					else {
+						index = mNext + unzigzag(code - SIZE);
+					}
+
+					push(index, position);
+					return true;
+				}
+
+			private:
+				int find(uint32_t index) const {
+					for(size_t i(0); i < mSize; ++i)
+						if(mEntries[i] == index) return i;
+
+					return -1;
+				}
+
+				void push(uint32_t index, int position) {
+					if(position < 0) position = (mSize < SIZE) ? mSize++ : SIZE - 1;
+
+					for(; position > 0; --position) mEntries[position] = mEntries[position - 1];
+
+					mEntries[0] = index;
+
+					if(index >= mNext) mNext = index + 1;
+				}
+
+				uint32_t mEntries[SIZE];
+				size_t mSize;
+				uint32_t mNext;
+			};
+
+			static void encode_indices(const uint32_t* indices, size_t count, std::string& output) {
+				IndexCache cache;
+				output.reserve(count);
+
+				for(size_t i(0); i < count; ++i) cache.encode(indices[i], output);
+			}
+
+// Decode indices straight into a locked buffer, stride bytes apart
+			template<typename T>
+			static bool decode_indices(const std::string& input, size_t count, uint8_t* destination, size_t stride) {
+				const uint8_t* p(reinterpret_cast<const uint8_t*>(input.data()));
+				const uint8_t* const end(p + input.size());
+				IndexCache cache;
+
+				for(size_t i(0); i < count; ++i, destination += stride) {
+					uint32_t code, index;
+
+					if(!get_varint(p, end, code) || !cache.decode(code, index)) return false;
+
+					*reinterpret_cast<T*>(destination) = T(index);
+				}
+
+				return p == end;
+			}
+
+// Quantize each component between its extrema, on bits bits
+			static void encode_quantized(const float* values, size_t num_components, size_t count, unsigned bits, binary::Buffer::Field& field) {
+				const uint32_t max_quantum((1U << bits) - 1);
+				std::vector<uint32_t> previous(num_components, 0);
+				std::string& output(*field.mutable_value_encoded());
+				output.reserve(count * num_components * 2);
+
+				for(size_t c(0); c < num_components; ++c) {
+					float lowest(values[c]), highest(values[c]);
+
+					for(size_t i(1); i < count; ++i) {
+						lowest = std::min(lowest, values[i * num_components + c]);
+						highest = std::max(highest, values[i * num_components + c]);
+					}
+
+					field.add_encoding_offset(lowest);
+					field.add_encoding_scale((highest - lowest) / max_quantum);
+				}
+
+				for(size_t i(0); i < count; ++i) {
+					for(size_t c(0); c < num_components; ++c) {
+						const float scale(field.encoding_scale(c));
+						uint32_t quantum(0);
+
+						if(scale > 0.f)
+							quantum = std::min(max_quantum, uint32_t((values[i * num_components + c] - field.encoding_offset(c)) / scale + .5f));
+
+						put_varint(output, zigzag(int32_t(quantum - previous[c])));
+						previous[c] = quantum;
+					}
+				}
+
+				field.set_encoding(binary::Buffer::Field::QUANTIZED);
+				field.set_encoding_bits(bits);
+			}
+
+			static bool decode_quantized(const binary::Buffer::Field& field, size_t count, uint8_t* destination, size_t stride) {
+				const size_t num_components(field.num_components());
+
+				if((size_t(field.encoding_offset_size()) != num_components) || (size_t(field.encoding_scale_size()) != num_components))
+					return false;
+
+				const std::string& input(field.value_encoded());
+				const uint8_t* p(reinterpret_cast<const uint8_t*>(input.data()));
+				const uint8_t* const end(p + input.size());
+				const float* offset(field.encoding_offset().data());
+				const float* scale(field.encoding_scale().data());
+				std::vector<uint32_t> quantum(num_components, 0);
+
+				for(size_t i(0); i < count; ++i, destination += stride) {
+					float* value(reinterpret_cast<float*>(destination));
+
+					for(size_t c(0); c < num_components; ++c) {
+						uint32_t delta;
+
+						if(!get_varint(p, end, delta)) return false;
+
+						quantum[c] += unzigzag(delta);
+						value[c] = offset[c] + scale[c] * quantum[c];
+					}
+				}
+
+				return p == end;
+			}
+
+// Map unit vectors on the octahedron, unfolded on the [-1, 1] square
+			static void encode_octahedral(const float* normals, size_t count, unsigned bits, binary::Buffer::Field& field) {
+				const float max_quantum(float((1U << bits) - 1));
+				int32_t previous[2] = { 0, 0 };
+				std::string& output(*field.mutable_value_encoded());
+				output.reserve(count * 2 * 2);
+
+				for(size_t i(0); i < count; ++i, normals += 3) {
+					const float length(fabsf(normals[0]) + fabsf(normals[1]) + fabsf(normals[2]));
+					float u(0.f), v(0.f);
+
+					if(length > 0.f) {
+						u = normals[0] / length;
+						v = normals[1] / length;
+
+						if(normals[2] < 0.f) {
+							const float folded_u((1.f - fabsf(v)) * (u >= 0.f ? 1.f : -1.f));
+							v = (1.f - fabsf(u)) * (v >= 0.f ? 1.f : -1.f);
+							u = folded_u;
+						}
+					}
+
+					const int32_t quantum[2] = {
+						int32_t((u * .5f + .5f) * max_quantum + .5f),
+						int32_t((v * .5f + .5f) * max_quantum + .5f),
+					};
+
+					for(size_t c(0); c < 2; ++c) {
+						put_varint(output, zigzag(quantum[c] - previous[c]));
+						previous[c] = quantum[c];
+					}
+				}
+
+				field.set_encoding(binary::Buffer::Field::OCTAHEDRAL);
+				field.set_encoding_bits(bits);
+			}
+
+			static bool decode_octahedral(const binary::Buffer::Field& field, size_t count, uint8_t* destination, size_t stride) {
+				if((field.num_components() != 3) || (field.encoding_bits() < 1) || (field.encoding_bits() > 16))
+					return false;
+
+				const std::string& input(field.value_encoded());
+				const uint8_t* p(reinterpret_cast<const uint8_t*>(input.data()));
+				const uint8_t* const end(p + input.size());
+				const float step(2.f / float((1U << field.encoding_bits()) - 1));
+				int32_t quantum[2] = { 0, 0 };
+
+				for(size_t i(0); i < count; ++i, destination += stride) {
+					for(size_t c(0); c < 2; ++c) {
+						uint32_t delta;
+
+						if(!get_varint(p, end, delta)) return false;
+
+						quantum[c] += unzigzag(delta);
+					}
+
+					float x(quantum[0] * step - 1.f), y(quantum[1] * step - 1.f);
+					const float z(1.f - fabsf(x) - fabsf(y));
+
+					if(z < 0.f) {
+						const float unfolded_x((1.f - fabsf(y)) * (x >= 0.f ? 1.f : -1.f));
+						y = (1.f - fabsf(x)) * (y >= 0.f ? 1.f : -1.f);
+						x = unfolded_x;
+					}
+
+					const float length(sqrtf(x * x + y * y + z * z));
+					float* value(reinterpret_cast<float*>(destination));
+					value[0] = x / length;
+					value[1] = y / length;
+					value[2] = z / length;
+				}
+
+				return p == end;
+			}
+
 // Private class responsible for serializing a scenegraph
 			class Publisher {
 			public:
-				Publisher(pb::io::CodedOutputStream& stream)
+				Publisher(pb::io::CodedOutputStream& stream, const SaveOptions& options, SaveReport* report = 0)
 					: mStream(stream)
+					, mOptions(options)
+					, mReport(report)
 					, mServiceLocator(0) { }
 
 				bool operator()(Transform& root) {
@@ -251,6 +522,8 @@ namespace o3d {
 					const bool transform_exported(SendTransform(&root));
 					root.SetParent(parent);
 
+					if(mTexturePack) mTexturePack->Destroy();
+
 					if(!transform_exported) return false;
 
 					binary::AtomHeader atom_header;
@@ -366,6 +639,150 @@ namespace o3d {
 					return true;
 				}
 
+				// Returns the id an object is referred to by: that of the object it
+				// duplicates, if any
+				Id RefId(const ObjectBase* o) const {
+					std::tr1::unordered_map<Id, Id>::const_iterator alias(mAliases.find(o->id()));
+					return (alias != mAliases.end()) ? alias->second : o->id();
+				}
+
+				// Append the values of an object's params to its content. Returns
+				// false if the object can't be deduplicated, because some of its
+				// params would need objects that may refer to it sent before it.
+				bool GetParamsContent(ObjectBase* o, std::string& content) {
+					ParamObject* param_obj;
+
+					if(!(param_obj << * o)) return true;
+
+					const NamedParamRefMap& params(param_obj->params());
+
+					for(NamedParamRefMap::const_iterator it(params.begin()); it != params.end(); ++it) {
+						Param* param(it->second.Get());
+
+						if(IsIgnoredParam(param)) continue;
+
+						if(param->input_connection()) return false;
+
+						RefParamBase* as_ref;
+
+						if(as_ref << * param) {
+							ObjectBase* value(as_ref->value());
+
+							if(value && (mVisitedObjects.find(value->id()) == mVisitedObjects.end()) &&
+							        !is_a<Effect>(*value) && !is_a<Sampler>(*value) && !is_a<Texture>(*value))
+								return false;
+						}
+
+						binary::Param message;
+
+						if(!SetParamValue(param, message)) return false;
+
+						content.append(it->first).append(1, '\0');
+						content.append(param->GetClass()->name()).append(1, '\0');
+						content.append(message.SerializeAsString());
+					}
+
+					return true;
+				}
+
+				// Refer to the params and fields of a duplicate as to those of the
+				// object it duplicates
+				void Alias(ObjectBase* duplicate, ObjectBase* original) {
+					mAliases[duplicate->id()] = original->id();
+					ParamObject* duplicate_params;
+					ParamObject* original_params;
+
+					if((duplicate_params << * duplicate) && (original_params << * original)) {
+						const NamedParamRefMap& params(duplicate_params->params());
+
+						for(NamedParamRefMap::const_iterator it(params.begin()); it != params.end(); ++it) {
+							Param* same(original_params->GetUntypedParam(it->first));
+
+							if(same && (same->GetClass() == it->second->GetClass())) {
+								mAliases[it->second->id()] = same->id();
+								mVisitedObjects[it->second->id()] = ObjectBase::Ref(it->second.Get());
+							}
+						}
+					}
+
+					Buffer* duplicate_buffer;
+					Buffer* original_buffer;
+
+					if((duplicate_buffer << * duplicate) && (original_buffer << * original)) {
+						const FieldRefArray& duplicate_fields(duplicate_buffer->fields());
+						const FieldRefArray& original_fields(original_buffer->fields());
+
+						for(size_t i(0); i < std::min(duplicate_fields.size(), original_fields.size()); ++i)
+							mAliases[duplicate_fields[i]->id()] = original_fields[i]->id();
+					}
+				}
+
+				// Returns true if an object with the same content was sent already,
+				// in which case the object is referred to as that one from now on
+				// and mustn't be sent. The content is the object's message, without
+				// any id of its own.
+				bool Deduplicate(ObjectBase* o, const std::string& message_content) {
+					if(!mOptions.deduplicate) return false;
+
+					std::string content(o->GetClass()->name());
+					content.append(1, '\0').append(message_content);
+
+					if(!GetParamsContent(o, content)) return false;
+
+					std::pair<std::tr1::unordered_map<std::string, Id>::iterator, bool> sent(mContents.insert(std::make_pair(content, o->id())));
+
+					if(sent.second) return false;
+
+					Alias(o, mVisitedObjects[sent.first->second].Get());
+
+					if(mReport) {
+						++mReport->duplicates;
+						mReport->bytes_saved += content.size();
+					}
+
+					return true;
+				}
+
+				// Returns true if this param isn't worth sending
+				bool IsIgnoredParam(Param* param) {
+					// Ignore params that have no output connection,
+					// if…
+					if(param->output_connections().empty()) {
+						// …they're either dynamic or read-only.
+						if(param->dynamic() || param->read_only())
+							return true;
+
+						// …they're ParamVertexBufferStreams, as they're handled
+						// when dealing with SkinEval and StreamBank objects.
+						if(is_a<ParamVertexBufferStream>(*param))
+							return true;
+
+						// …they're ParamDrawLists. We don't want those.
+						if(is_a<ParamDrawList>(*param))
+							return true;
+
+						// …they're ParamEffects and their owner is a standard Collada material,
+						// as we can rebuild these at runtime.
+						if(is_a<ParamEffect>(*param) && is_a<Material>(*param->owner())) {
+							ParamString* colladaLightingTypeParam(param->owner()->GetParam<ParamString>(Collada::kLightingTypeParamName));
+
+							if(colladaLightingTypeParam) {
+								std::string val(colladaLightingTypeParam->value());
+
+								for(size_t i(0); i < val.size(); ++i) val[i] =::tolower(val[i]);
+
+								if(!(val.compare(Collada::kLightingTypePhong) &&
+								        val.compare(Collada::kLightingTypeLambert) &&
+								        val.compare(Collada::kLightingTypeBlinn) &&
+								        val.compare(Collada::kLightingTypeConstant)))
+									return true;
+							}
+						}
+					}
+
+					return false;
+				}
+
 				// Returns true if this object should be ignored
 				bool Ignore(ObjectBase* o) {
 					// Ignore NULL objects
@@ -379,42 +796,8 @@ namespace o3d {
 					mVisitedObjects[o->id()] = ObjectBase::Ref(o);
 					Param* param;
 
-					if(param << * o) {
-						// Ignore params that have no output connection,
-						// if…
-						if(param->output_connections().empty()) {
-							// …they're either dynamic or read-only.
-							if(param->dynamic() || param->read_only())
-								return true;
-
-							// …they're ParamVertexBufferStreams, as they're handled
-							// when dealing with SkinEval and StreamBank objects.
-							if(is_a<ParamVertexBufferStream>(*param))
-								return true;
-
-							// …they're ParamDrawLists. We don't want those.
-							if(is_a<ParamDrawList>(*param))
-								return true;
-
-							// …they're ParamEffects and their owner is a standard Collada material,
-							// as we can rebuild these at runtime.
-							if(is_a<ParamEffect>(*param) && is_a<Material>(*param->owner())) {
-								ParamString* colladaLightingTypeParam(param->owner()->GetParam<ParamString>(Collada::kLightingTypeParamName));
-
-								if(colladaLightingTypeParam) {
-									std::string val(colladaLightingTypeParam->value());
-
-									for(size_t i(0); i < val.size(); ++i) val[i] =::tolower(val[i]);
-
-									if(!(val.compare(Collada::kLightingTypePhong) &&
-									        val.compare(Collada::kLightingTypeLambert) &&
-									        val.compare(Collada::kLightingTypeBlinn) &&
-									        val.compare(Collada::kLightingTypeConstant)))
-										return true;
-								}
-							}
-						}
-					}
+					if((param << * o) && IsIgnoredParam(param))
+						return true;
 
 					return false;
 				}
@@ -431,7 +814,7 @@ namespace o3d {
 						// owned by an object not sent yet!
 						if(!Send(o->owner())) return false;
 
-						message.set_owner_ref(o->owner()->id());
+						message.set_owner_ref(RefId(o->owner()));
 					}
 					else if(array) {
 						if(!SendParamArray(array)) return false;
@@ -443,137 +826,144 @@ namespace o3d {
 					if(o->input_connection()) {
 						if(!SendParam(o->input_connection())) return false;
 
-						message.set_input_connection_ref(o->input_connection()->id());
+						message.set_input_connection_ref(RefId(o->input_connection()));
 					}
-					else do {
-							ParamBoolean* as_boolean;
+					else if(!SetParamValue(o, message)) return false;
 
-							if(as_boolean << * o) {
-								// it's false by default
-								if(as_boolean->value()) message.set_bool_value(true);
+					if(!SendObjectHeader(o)) return false;
 
-								break;
-							}
+					if(!pbx::write(message, mStream)) {
+						O3D_ERROR(mServiceLocator) << "Failed to send object";
+						return false;
+					}
 
-							ParamInteger* as_integer;
+					return true;
+				}
+				// Set the value of a param in its message, sending the object it
+				// refers to first
+				bool SetParamValue(Param* o, binary::Param& message) {
+					do {
+						ParamBoolean* as_boolean;
 
-							if(as_integer << * o) {
-								// it's 0 by default
-								if(as_integer->value()) message.set_integer_value(as_integer->value());
+						if(as_boolean << * o) {
+							// it's false by default
+							if(as_boolean->value()) message.set_bool_value(true);
 
-								break;
-							}
+							break;
+						}
 
-							ParamString* as_string;
+						ParamInteger* as_integer;
 
-							if(as_string << * o) {
-								size_t index;
+						if(as_integer << * o) {
+							// it's 0 by default
+							if(as_integer->value()) message.set_integer_value(as_integer->value());
 
-								if(!GetStringIndex(as_string->value(), index)) return false;
+							break;
+						}
 
-								message.set_indexed_string_value(index);
-								break;
-							}
+						ParamString* as_string;
 
-							ParamFloat* as_float;
+						if(as_string << * o) {
+							size_t index;
 
-							if(as_float << * o) {
-								message.add_float_value(as_float->value());
-								break;
-							}
+							if(!GetStringIndex(as_string->value(), index)) return false;
 
-							ParamFloat2* as_float2;
+							message.set_indexed_string_value(index);
+							break;
+						}
 
-							if(as_float2 << * o) {
-								Float2 value(as_float2->value());
-								message.add_float_value(value[0]);
-								message.add_float_value(value[1]);
-								break;
-							}
+						ParamFloat* as_float;
 
-							ParamFloat3* as_float3;
+						if(as_float << * o) {
+							message.add_float_value(as_float->value());
+							break;
+						}
 
-							if(as_float3 << * o) {
-								Float3 value(as_float3->value());
-								message.add_float_value(value[0]);
-								message.add_float_value(value[1]);
-								message.add_float_value(value[2]);
-								break;
-							}
+						ParamFloat2* as_float2;
 
-							ParamFloat4* as_float4;
+						if(as_float2 << * o) {
+							Float2 value(as_float2->value());
+							message.add_float_value(value[0]);
+							message.add_float_value(value[1]);
+							break;
+						}
 
-							if(as_float4 << * o) {
-								Float4 value(as_float4->value());
-								message.add_float_value(value[0]);
-								message.add_float_value(value[1]);
-								message.add_float_value(value[2]);
-								message.add_float_value(value[3]);
-								break;
-							}
+						ParamFloat3* as_float3;
 
-							ParamMatrix4* as_matrix4;
-
-							if(as_matrix4 << * o) {
-								Matrix4 value(as_matrix4->value());
-
-								if(!matrix4_extra::is_identity(value)) {
-									Quat rotation;
-									Vector3 position;
-									float scale;
-
-									if(matrix4_extra::decompose(value, rotation, position, scale)) {
-										message.add_float_value(rotation[0]);
-										message.add_float_value(rotation[1]);
-										message.add_float_value(rotation[2]);
-										message.add_float_value(rotation[3]);
-										message.add_float_value(position[0]);
-										message.add_float_value(position[1]);
-										message.add_float_value(position[2]);
-										message.add_float_value(scale);
-									}
-									else for(size_t i(0); i < 4; ++i) {
-											message.add_float_value(value[i][0]);
-											message.add_float_value(value[i][1]);
-											message.add_float_value(value[i][2]);
-											message.add_float_value(value[i][3]);
-										}
-								}
+						if(as_float3 << * o) {
+							Float3 value(as_float3->value());
+							message.add_float_value(value[0]);
+							message.add_float_value(value[1]);
+							message.add_float_value(value[2]);
+							break;
+						}
 
-								break;
+						ParamFloat4* as_float4;
+
+						if(as_float4 << * o) {
+							Float4 value(as_float4->value());
+							message.add_float_value(value[0]);
+							message.add_float_value(value[1]);
+							message.add_float_value(value[2]);
+							message.add_float_value(value[3]);
+							break;
+						}
+
+						ParamMatrix4* as_matrix4;
+
+						if(as_matrix4 << * o) {
+							Matrix4 value(as_matrix4->value());
+
+							if(!matrix4_extra::is_identity(value)) {
+								Quat rotation;
+								Vector3 position;
+								float scale;
+
+								if(matrix4_extra::decompose(value, rotation, position, scale)) {
+									message.add_float_value(rotation[0]);
+									message.add_float_value(rotation[1]);
+									message.add_float_value(rotation[2]);
+									message.add_float_value(rotation[3]);
+									message.add_float_value(position[0]);
+									message.add_float_value(position[1]);
+									message.add_float_value(position[2]);
+									message.add_float_value(scale);
+								}
+								else for(size_t i(0); i < 4; ++i) {
+										message.add_float_value(value[i][0]);
+										message.add_float_value(value[i][1]);
+										message.add_float_value(value[i][2]);
+										message.add_float_value(value[i][3]);
+									}
 							}
 
-							// No need to send bounding-boxes data,
-							// as these will be recomputed anyway
-							ParamBoundingBox* as_bbox;
+							break;
+						}
 
-							if(as_bbox << * o) break;
+						// No need to send bounding-boxes data,
+						// as these will be recomputed anyway
+						ParamBoundingBox* as_bbox;
 
-							RefParamBase* as_ref;
+						if(as_bbox << * o) break;
 
-							if(as_ref << * o) {
-								ObjectBase* value(as_ref->value());
+						RefParamBase* as_ref;
 
-								if(value) {
-									if(!Send(value)) return false;
+						if(as_ref << * o) {
+							ObjectBase* value(as_ref->value());
 
-									message.set_object_ref_value(value->id());
-								}
+							if(value) {
+								if(!Send(value)) return false;
 
-								break;
+								message.set_object_ref_value(RefId(value));
 							}
 
-							O3D_ERROR(mServiceLocator) << "Unsupported Param type: " << o->GetClass()->name();
-							return false;
+							break;
 						}
-						while(false);
-
-					if(!SendObjectHeader(o)) return false;
 
-					if(!pbx::write(message, mStream)) {
-						O3D_ERROR(mServiceLocator) << "Failed to send object";
+						O3D_ERROR(mServiceLocator) << "Unsupported Param type: " << o->GetClass()->name();
 						return false;
 					}
+					while(false);
 
 					return true;
 				}
@@ -621,6 +1011,8 @@ namespace o3d {
 						message.set_source_indexed_string(index);
 					}
 
+					if(Deduplicate(o, message.SerializeAsString())) return true;
+
 					if(!SendObjectHeader(o)) {
 						O3D_ERROR(mServiceLocator) << "Failed to send object header";
 						return false;
@@ -660,6 +1052,8 @@ namespace o3d {
 					std::copy(source, source + sizeof(Matrix4)*inverse_bind_pose_matrices.size(),
 					          pb::RepeatedFieldBackInserter(message.mutable_inverse_bind_pose_matrice()));
 
+					if(Deduplicate(o, message.SerializeAsString())) return true;
+
 					if(!SendObjectHeader(o)) {
 						O3D_ERROR(mServiceLocator) << "Failed to send object header";
 						return false;
@@ -712,6 +1106,8 @@ namespace o3d {
 						key.set_output(keys[i]->output());
 					}
 
+					if(Deduplicate(o, message.SerializeAsString())) return true;
+
 					if(!SendObjectHeader(o)) {
 						O3D_ERROR(mServiceLocator) << "Failed to send object header";
 						return false;
@@ -729,6 +1125,36 @@ namespace o3d {
 
 					return true;
 				}
+				// Encode a field of a vertex buffer with the geometry codec, if it holds positions or normals
+				bool EncodeFloats(const Field* o, const float* values, size_t num_elements, binary::Buffer::Field& field) {
+					if(!mOptions.encode_geometry) return false;
+
+					std::tr1::unordered_map<Id, Stream::Semantic>::const_iterator semantic(mFieldSemantics.find(o->id()));
+
+					if(semantic == mFieldSemantics.end()) return false;
+
+					if((semantic->second == Stream::POSITION) && mOptions.position_bits) {
+						encode_quantized(values, o->num_components(), num_elements, std::min(mOptions.position_bits, 24U), field);
+						return true;
+					}
+
+					if((semantic->second == Stream::NORMAL) && mOptions.normal_bits && (o->num_components() == 3)) {
+						encode_octahedral(values, num_elements, std::min(mOptions.normal_bits, 16U), field);
+						return true;
+					}
+
+					return false;
+				}
+
+				// Encode the field of an index buffer with the geometry codec
+				bool EncodeIndices(Buffer* o, const Field* index_field, const uint32_t* indices, binary::Buffer::Field& field) {
+					if(!mOptions.encode_geometry || !is_a<IndexBuffer>(*o) || (index_field->num_components() != 1)) return false;
+
+					encode_indices(indices, o->num_elements(), *field.mutable_value_encoded());
+					field.set_encoding(binary::Buffer::Field::INDICES);
+					return true;
+				}
+
 				bool SendBuffer(Buffer* o, bool* ignored = 0) {
 					CHECK_IGNORE(o);
 					const bool export_data(!is_a<DestinationBuffer>(*o));
@@ -771,6 +1197,9 @@ namespace o3d {
 									const size_t count(o->num_elements() * float_field->num_components());
 									std::vector<float> tmp(count);
 									float_field->GetAsFloats(0, &tmp[0], float_field->num_components(), o->num_elements());
+
+									if(count && EncodeFloats(float_field, &tmp[0], o->num_elements(), field)) break;
+
 									pb::RepeatedField<float>& data(*field.mutable_value_float());
 									data.Reserve(count);
 
@@ -791,6 +1220,9 @@ namespace o3d {
 									const size_t count(o->num_elements() * uint32_field->num_components());
 									std::vector<uint32_t> tmp(count);
 									uint32_field->GetAsUInt32s(0, &tmp[0], uint32_field->num_components(), o->num_elements());
+
+									if(count && EncodeIndices(o, uint32_field, &tmp[0], field)) break;
+
 									pb::RepeatedField<uint32_t>& data(*field.mutable_value_uint());
 									data.Reserve(count);
 
@@ -812,6 +1244,13 @@ namespace o3d {
 									const size_t count(o->num_elements() * uint16_field->num_components());
 									std::vector<uint16_t> tmp(count);
 									uint16_field->GetAsUInt16s(0, &tmp[0], uint16_field->num_components(), o->num_elements());
+
+									if(count) {
+										const std::vector<uint32_t> indices(tmp.begin(), tmp.end());
+
+										if(EncodeIndices(o, uint16_field, &indices[0], field)) break;
+									}
+
 									pb::RepeatedField<uint32_t>& data(*field.mutable_value_uint());
 									data.Reserve(count);
 
@@ -845,6 +1284,17 @@ namespace o3d {
 						while(false);
 					}
 
+					// Buffers without data are written to at runtime, so each needs its own
+					if(export_data) {
+						binary::Buffer content(message);
+
+						// Field ids are required, hence the partial serialization
+						for(size_t i(0); i < (size_t)content.field_size(); ++i)
+							content.mutable_field(i)->clear_id();
+
+						if(Deduplicate(o, content.SerializePartialAsString())) return true;
+					}
+
 					if(!SendObjectHeader(o)) {
 						O3D_ERROR(mServiceLocator) << "Failed to send object header";
 						return false;
@@ -875,6 +1325,12 @@ namespace o3d {
 					        empty_vector
 					    ));
 
+					// Tell the geometry codec what the fields hold, before their buffers get sent
+					for(size_t i(0); i < stream_param_vector.size(); ++i) {
+						const Stream& s(stream_param_vector[i]->stream());
+						mFieldSemantics[s.field().id()] = s.semantic();
+					}
+
 					for(size_t i(0); i < stream_param_vector.size(); ++i) {
 						const Stream& s(stream_param_vector[i]->stream());
 
@@ -884,7 +1340,7 @@ namespace o3d {
 						}
 
 						binary::VertexSource::Stream& stream(*message.add_stream());
-						stream.set_field_ref(s.field().id());
+						stream.set_field_ref(RefId(&s.field()));
 						stream.set_start_index(s.start_index());
 
 						if(!set_semantic(stream, s.semantic())) {
@@ -902,7 +1358,7 @@ namespace o3d {
 								return false;
 							}
 
-							stream.set_bind(dependency->id());
+							stream.set_bind(RefId(dependency));
 						}
 					}
 
@@ -934,7 +1390,22 @@ namespace o3d {
 							return false;
 						}
 
-						message.set_index_buffer_ref(o->index_buffer()->id());
+						message.set_index_buffer_ref(RefId(o->index_buffer()));
+					}
+
+					// Save the levels of detail
+					const Primitive::LodArray& lods(o->lods());
+
+					for(size_t i(0); i < lods.size(); ++i) {
+						if(!SendBuffer(lods[i].index_buffer)) {
+							O3D_ERROR(mServiceLocator) << "Failed to send LOD index buffer";
+							return false;
+						}
+
+						binary::Primitive::Lod& lod(*message.add_lod());
+						lod.set_index_buffer_ref(RefId(lods[i].index_buffer));
+						lod.set_number_primitives(lods[i].number_primitives);
+						lod.set_screen_size(lods[i].screen_size);
 					}
 
 					// Save the stream bank
@@ -944,7 +1415,7 @@ namespace o3d {
 							return false;
 						}
 
-						message.set_stream_bank_ref(o->stream_bank()->id());
+						message.set_stream_bank_ref(RefId(o->stream_bank()));
 					}
 
 					// Save the primitive
@@ -1093,6 +1564,64 @@ namespace o3d {
 
 					return true;
 				}
+				// Decode the image of a texture and make its mips, the way the
+				// loader would, to spare it the work
+				bool EmbedTexture(const std::string& uri, binary::Texture& message) {
+					if(!mTexturePack) {
+						ObjectManager* object_manager(mServiceLocator->GetService<ObjectManager>());
+						mTexturePack = Pack::Ref(object_manager ? object_manager->CreatePack() : 0);
+
+						if(!mTexturePack) return false;
+					}
+
+					ExternalResource::Ref res(mOptions.texture_provider->GetExternalResourceForURI(*mTexturePack, uri));
+
+					if(!res) return false;
+
+					BitmapRefArray bitmaps;
+					MemoryReadStream mrs(res->data(), res->size());
+
+					if(!Bitmap::LoadFromStream(mServiceLocator, &mrs, uri, image::UNKNOWN, &bitmaps)) return false;
+
+					for(size_t i(0); i < bitmaps.size(); ++i) {
+						Bitmap::Ref bitmap(bitmaps[i]);
+						const bool can_make_mips(image::CanMakeMips(bitmap->format()));
+
+						if(mOptions.scale_textures_to_pot && !bitmap->IsPOT() && can_make_mips) {
+							Bitmap::Ref scaled(new Bitmap(mServiceLocator));
+							scaled->Allocate(bitmap->format(), image::ComputePOTSize(bitmap->width()), image::ComputePOTSize(bitmap->height()),
+							                 1, bitmap->semantic());
+
+							if(!image::ScaleUpToPOT(bitmap->width(), bitmap->height(), bitmap->format(), bitmap->GetMipData(0),
+							                        scaled->GetMipData(0), scaled->GetMipPitch(0)))
+								return false;
+
+							bitmap = scaled;
+						}
+
+						const unsigned total_mips(image::ComputeMipMapCount(bitmap->width(), bitmap->height()));
+
+						// Same as Pack::CreateTextureFromBitmaps
+						if(can_make_mips && (bitmap->num_mipmaps() == 1) && (total_mips > 1)) {
+							Bitmap::Ref with_mips(new Bitmap(mServiceLocator));
+							with_mips->Allocate(bitmap->format(), bitmap->width(), bitmap->height(), total_mips, bitmap->semantic());
+							with_mips->SetRect(0, 0, 0, bitmap->width(), bitmap->height(), bitmap->GetMipData(0), bitmap->GetMipPitch(0));
+							with_mips->GenerateMips(0, total_mips - 1);
+							bitmap = with_mips;
+						}
+
+						binary::Texture::Image& image(*message.add_image());
+						image.set_format(bitmap->format());
+						image.set_width(bitmap->width());
+						image.set_height(bitmap->height());
+						image.set_num_mipmaps(bitmap->num_mipmaps());
+						image.set_semantic(bitmap->semantic());
+						image.set_data(bitmap->GetMipData(0), bitmap->GetMipChainSize(bitmap->num_mipmaps()));
+					}
+
+					return true;
+				}
+
 				bool SendTexture(Texture* o, bool* ignored = 0) {
 					CHECK_IGNORE(o);
 					binary::Texture message;
@@ -1115,6 +1644,11 @@ namespace o3d {
 
 					message.set_uri(index);
 
+					if(mOptions.texture_provider && original_uri->value().compare("#error") && !EmbedTexture(original_uri->value(), message)) {
+						O3D_ERROR(mServiceLocator) << "Failed to embed texture at \"" << original_uri->value() << "\"";
+						return false;
+					}
+
 					if(!SendObjectHeader(o)) {
 						O3D_ERROR(mServiceLocator) << "Failed to send object header";
 						return false;
@@ -1156,6 +1690,8 @@ namespace o3d {
 #undef DISPATCH
 					CHECK_IGNORE(o);
 
+					if(is_a<Material>(*o) && Deduplicate(o, std::string())) return true;
+
 					if(!SendObjectHeader(o)) {
 						O3D_ERROR(mServiceLocator) << "Failed to send object header";
 						return false;
@@ -1171,84 +1707,237 @@ namespace o3d {
 			private:
 				string_db_t mStringDB;
 				std::tr1::unordered_map<Id, ObjectBase::Ref> mVisitedObjects;
+				std::tr1::unordered_map<Id, Stream::Semantic> mFieldSemantics;
 				pb::io::CodedOutputStream& mStream;
+				const SaveOptions& mOptions;
+				SaveReport* mReport;
 				ServiceLocator* mServiceLocator;
+				// Objects sent, by content, and objects sent as another one
+				std::tr1::unordered_map<std::string, Id> mContents;
+				std::tr1::unordered_map<Id, Id> mAliases;
+				// Pack the images of the textures to embed get fetched with
+				Pack::Ref mTexturePack;
 			};
 
-			class Load {
-			public:
-				Load(Pack& pack, pb::io::ZeroCopyInputStream& stream, IExternalResourceProvider& erp)
-					: mERP(erp), mPack(pack), mStream(stream), mServiceLocator(pack.service_locator()) { }
-				Transform* operator()() {
-					// Build a map of all the O3D classes
-					IClassManager* class_manager(mPack.service_locator()->GetService<IClassManager>());
-					std::vector<const ObjectBase::Class*> o3d_classes(class_manager->GetAllClasses());
+// Decode an encoded field of a buffer straight into its locked data
+			static bool decode_field(Buffer& o, Field& field, const binary::Buffer::Field& field_desc, uint8_t* destination) {
+				switch(field_desc.encoding()) {
+				case binary::Buffer::Field::INDICES:
+					if(field.num_components() != 1) return false;
 
-					for(size_t i(0); i < o3d_classes.size(); ++i) {
-						mClassMap[o3d_classes[i]->name()] = o3d_classes[i];
-					}
+					if(is_a<UInt32Field>(field))
+						return decode_indices<uint32_t>(field_desc.value_encoded(), o.num_elements(), destination, o.stride());
 
-					std::vector<const ObjectBase::Class*>().swap(o3d_classes);
-					// Receive loop
-					Transform* root(0);
+#ifdef GLES2_BACKEND_NATIVE_GLES2
 
-					while(true) {
-						binary::AtomHeader atom_header;
+					if(is_a<UInt16Field>(field))
+						return decode_indices<uint16_t>(field_desc.value_encoded(), o.num_elements(), destination, o.stride());
 
-						if(!pbx::read(atom_header, mStream)) {
-							O3D_ERROR(mServiceLocator) << "Failed to parse atom header";
+#endif
+					return false;
+				case binary::Buffer::Field::QUANTIZED:
+					return is_a<FloatField>(field) && decode_quantized(field_desc, o.num_elements(), destination, o.stride());
+				case binary::Buffer::Field::OCTAHEDRAL:
+					return is_a<FloatField>(field) && decode_octahedral(field_desc, o.num_elements(), destination, o.stride());
+				default:
+					return false;
+				}
+			}
+
+// Set the data of a buffer, whose fields and elements match the message's
+			static bool set_buffer_data(Buffer& o, const binary::Buffer& message, ServiceLocator* service_locator) {
+				const FieldRefArray& fields(o.fields());
+
+				if((fields.size() != (size_t)message.field_size()) || (o.num_elements() != message.num_elements())) {
+					O3D_ERROR(service_locator) << "Buffer doesn't match its message";
+					return false;
+				}
+
+				BufferLockHelper lock(&o);
+				uint8_t* const data(lock.GetDataAs<uint8_t>(Buffer::WRITE_ONLY));
+
+				for(size_t i(0); i < (size_t)fields.size(); ++i) {
+					const binary::Buffer::Field& field_desc(message.field(i));
+					Field& field = *fields[i];
+
+					// Encoded fields are decoded straight into the buffer
+					if(field_desc.encoding() != binary::Buffer::Field::RAW) {
+						if(!data || !decode_field(o, field, field_desc, data + field.offset())) {
+							O3D_ERROR(service_locator) << "Failed to decode a field";
 							return false;
 						}
 
-						switch(atom_header.atom_type()) {
-						case binary::AtomHeader::END_OF_ARCHIVE_ATOM: {
-								binary::EndOfArchive eoa;
+						continue;
+					}
 
-								if(!pbx::read(eoa, mStream)) {
-									O3D_ERROR(mServiceLocator) << "Failed to parse end of archive";
-									return false;
-								}
+					do {
+						FloatField* float_field;
 
-								ObjectBase::Ref ref(GetObjectRef(eoa.root()));
+						if(float_field << field) {
+							if((size_t)field_desc.value_float_size() != (size_t)field.num_components() * o.num_elements()) {
+								O3D_ERROR(service_locator) << "Field's data size mismatchs";
+								return false;
+							}
 
-								if(!ref) {
-									O3D_ERROR(mServiceLocator) << "Couldn't find root transform. Missing dependency?";
-									return false;
-								}
+							float_field->SetFromFloats(field_desc.value_float().data(), field.num_components(), 0, o.num_elements());
+							break;
+						}
 
-								if(root << * ref) return root;
-								else {
-									O3D_ERROR(mServiceLocator) << "Root ref doesn't reference a Transform object";
-									return false;
-								}
-							}
-							return 0;
-						case binary::AtomHeader::STRING_ATOM:
+						UInt32Field* uint32_field;
 
-							if(!ReceiveString()) {
-								O3D_ERROR(mServiceLocator) << "Failed to deserialize a string";
+						if(uint32_field << field) {
+							if((size_t)field_desc.value_uint_size() != (size_t)field.num_components() * o.num_elements()) {
+								O3D_ERROR(service_locator) << "Field's data size mismatchs";
 								return false;
 							}
 
+							uint32_field->SetFromUInt32s(field_desc.value_uint().data(), field.num_components(), 0, o.num_elements());
 							break;
-						case binary::AtomHeader::OBJECT_ATOM:
+						}
+
+						UByteNField* ubyten_field;
 
-							if(!ReceiveObject()) {
-								O3D_ERROR(mServiceLocator) << "Failed to deserialize an object";
+						if(ubyten_field << field) {
+							const std::string& value_byte(field_desc.value_byte());
+
+							if(value_byte.size() != field.num_components() * o.num_elements()) {
+								O3D_ERROR(service_locator) << "Field's data size mismatchs";
 								return false;
 							}
 
+							ubyten_field->SetFromUByteNs((const uint8_t*) &value_byte[0], field.num_components(), 0, o.num_elements());
 							break;
-						case binary::AtomHeader::ATTACHMENT_ATOM:
+						}
 
-							if(!ReceiveAttachments()) {
-								O3D_ERROR(mServiceLocator) << "Failed to deserialize attachments";
+#ifdef GLES2_BACKEND_NATIVE_GLES2
+						UInt16Field* uint16_field;
+
+						if(uint16_field << field) {
+							if((size_t)field_desc.value_uint_size() != (size_t)field.num_components() * o.num_elements()) {
+								O3D_ERROR(service_locator) << "Field's data size mismatchs";
 								return false;
 							}
 
+							uint16_field->SetFromUInt32s(field_desc.value_uint().data(), field.num_components(), 0, o.num_elements());
 							break;
 						}
+
+#endif
+						O3D_ERROR(service_locator) << "Unknown Field type";
+						return false;
 					}
+					while(false);
+				}
+
+				return true;
+			}
+
+// Sets the data of a static buffer again from its message, kept compressed
+			class ArchiveBufferSource : public BufferSource {
+			public:
+				/** @return A source for the buffer of a message, or NULL if it
+				  *         wouldn't take less memory than the buffer itself.
+				  */
+				static ArchiveBufferSource* Create(const binary::Buffer& message, size_t buffer_size, ServiceLocator* service_locator);
+
+				virtual bool RestoreBuffer(Buffer* buffer);
+
+			private:
+				explicit ArchiveBufferSource(ServiceLocator* service_locator)
+					: mServiceLocator(service_locator)
+					, mCompression(binary::StreamHeader::COMPRESSION_NONE)
+					, mSize(0) { }
+
+				ServiceLocator* mServiceLocator;
+				binary::StreamHeader::Compression mCompression;
+				uint32_t mSize;
+				std::string mData;
+			};
+
+			class Load {
+			public:
+				enum Result {
+					RESULT_MORE,
+					RESULT_DONE,
+					RESULT_FAILED,
+				};
+
+				Load(Pack& pack, pb::io::ZeroCopyInputStream& stream, IExternalResourceProvider& erp, IBinaryLoadListener* listener = 0)
+					: mERP(erp), mListener(listener), mPack(pack), mStream(stream), mServiceLocator(pack.service_locator()), mRoot(0) { }
+
+				// Must be called once before the first call to Next()
+				void Begin() {
+					// Build a map of all the O3D classes
+					IClassManager* class_manager(mPack.service_locator()->GetService<IClassManager>());
+					std::vector<const ObjectBase::Class*> o3d_classes(class_manager->GetAllClasses());
+
+					for(size_t i(0); i < o3d_classes.size(); ++i) {
+						mClassMap[o3d_classes[i]->name()] = o3d_classes[i];
+					}
+				}
+
+				// Receive a single atom
+				Result Next() {
+					binary::AtomHeader atom_header;
+
+					if(!pbx::read(atom_header, mStream)) {
+						O3D_ERROR(mServiceLocator) << "Failed to parse atom header";
+						return RESULT_FAILED;
+					}
+
+					switch(atom_header.atom_type()) {
+					case binary::AtomHeader::END_OF_ARCHIVE_ATOM: {
+							binary::EndOfArchive eoa;
+
+							if(!pbx::read(eoa, mStream)) {
+								O3D_ERROR(mServiceLocator) << "Failed to parse end of archive";
+								return RESULT_FAILED;
+							}
+
+							ObjectBase::Ref ref(GetObjectRef(eoa.root()));
+
+							if(!ref) {
+								O3D_ERROR(mServiceLocator) << "Couldn't find root transform. Missing dependency?";
+								return RESULT_FAILED;
+							}
+
+							if(mRoot << * ref) return RESULT_DONE;
+
+							O3D_ERROR(mServiceLocator) << "Root ref doesn't reference a Transform object";
+							return RESULT_FAILED;
+						}
+					case binary::AtomHeader::STRING_ATOM:
+
+						if(!ReceiveString()) {
+							O3D_ERROR(mServiceLocator) << "Failed to deserialize a string";
+							return RESULT_FAILED;
+						}
+
+						break;
+					case binary::AtomHeader::OBJECT_ATOM:
+
+						if(!ReceiveObject()) {
+							O3D_ERROR(mServiceLocator) << "Failed to deserialize an object";
+							return RESULT_FAILED;
+						}
+
+						break;
+					case binary::AtomHeader::ATTACHMENT_ATOM:
+
+						if(!ReceiveAttachments()) {
+							O3D_ERROR(mServiceLocator) << "Failed to deserialize attachments";
+							return RESULT_FAILED;
+						}
+
+						break;
+					}
+
+					return RESULT_MORE;
+				}
+
+				// The root transform, as soon as it has been received
+				Transform* root() const {
+					return mRoot;
 				}
 
 			private:
@@ -1339,6 +2028,9 @@ namespace o3d {
 
 								if(shape << * attch) {
 									transform->AddShape(shape);
+
+									if(mListener) mListener->OnShapeReady(*transform, *shape);
+
 									continue;
 								}
 
@@ -1346,6 +2038,10 @@ namespace o3d {
 								return false;
 							}
 
+							// Every transform is followed by its attachments, even when
+							// it has no shape, so this is where it becomes complete.
+							if(mListener) mListener->OnTransformReady(*transform);
+
 							return true;
 						}
 					}
@@ -1478,29 +2174,69 @@ namespace o3d {
 						}
 
 						const std::string& uri(mStringDB.db[message.uri()]);
+						// Shared textures keep the name they were created with:
+						// renaming them would rename them in every other pack.
+						bool created(false);
 
 						if(uri.compare("#error") == 0) {
 							Renderer* renderer(mPack.service_locator()->GetService<Renderer>());
 							texture = renderer->error_texture() ? renderer->error_texture() : renderer->fallback_error_texture();
 						}
 						else {
-							ExternalResource::Ref res(mERP.GetExternalResourceForURI(mPack, uri));
+							// Textures already loaded by another scene, from the same
+							// content, are shared rather than decoded again. The URI
+							// alone can't tell: it is relative to the scene's provider.
+							ResourceCache* cache(mServiceLocator->IsAvailable<ResourceCache>() ? mServiceLocator->GetService<ResourceCache>() : 0);
+
+							// Embedded images are what the scene was saved with: they
+							// are used whatever is at the URI, and shared by content.
+							if(message.image_size()) {
+								const ResourceCache::Hash hash(cache ? HashEmbeddedImages(message) : 0);
+								texture = cache ? cache->FindTexture(mPack, hash) : 0;
+
+								if(!texture) {
+									texture = CreateEmbeddedTexture(message, uri);
+
+									if(!texture) {
+										O3D_ERROR(mServiceLocator) << "Failed to rebuild embedded texture at \"" << uri << "\"";
+										return false;
+									}
+
+									created = true;
+
+									if(cache) cache->AddTexture(hash, texture);
+								}
+							}
+
+							if(!texture) {
+								ExternalResource::Ref res(mERP.GetExternalResourceForURI(mPack, uri));
+
+								if(!res) {
+									O3D_ERROR(mServiceLocator) << "Failed to fetch data for texture at \"" << uri << "\"";
+									return false;
+								}
 
-							if(!res) {
-								O3D_ERROR(mServiceLocator) << "Failed to fetch data for texture at \"" << uri << "\"";
-								return false;
-							}
+								if(cache) {
+									texture = cache->GetTexture(mPack, uri, *res, &created);
 
-							BitmapRefArray bitmap_refs;
-							MemoryReadStream mrs(res->data(), res->size());
-							const bool loaded(Bitmap::LoadFromStream(mPack.service_locator(), &mrs, uri, image::UNKNOWN, &bitmap_refs));
+									if(!texture) {
+										return false;
+									}
+								}
+								else {
+									BitmapRefArray bitmap_refs;
+									MemoryReadStream mrs(res->data(), res->size());
+									const bool loaded(Bitmap::LoadFromStream(mPack.service_locator(), &mrs, uri, image::UNKNOWN, &bitmap_refs));
 
-							if(!loaded) {
-								O3D_ERROR(mServiceLocator) << "Failed to load bitmaps for texture at \"" << uri << "\"";
-								return false;
-							}
+									if(!loaded) {
+										O3D_ERROR(mServiceLocator) << "Failed to load bitmaps for texture at \"" << uri << "\"";
+										return false;
+									}
 
-							texture = mPack.CreateTextureFromBitmaps(bitmap_refs, uri, true);
+									texture = mPack.CreateTextureFromBitmaps(bitmap_refs, uri, true);
+									created = true;
+								}
+							}
 
 							if(classname.compare(texture->GetClass()->name())) {
 								O3D_ERROR(mServiceLocator) << "Texture type mismatch when rebuilding texture";
@@ -1508,7 +2244,7 @@ namespace o3d {
 							}
 						}
 
-						if(!name.empty()) texture->set_name(name);
+						if(created && !name.empty()) texture->set_name(name);
 
 						mOldIdToNewObject[object_header.id()] = ObjectBase::Ref(texture);
 					}
@@ -1547,6 +2283,45 @@ namespace o3d {
 					return true;
 				}
 
+				// Upload the bitmaps of a texture as they were embedded
+				static ResourceCache::Hash HashEmbeddedImages(const binary::Texture& message) {
+					ResourceCache::Hash hash(ResourceCache::HashContent(0, 0));
+
+					for(size_t i(0); i < (size_t)message.image_size(); ++i) {
+						const binary::Texture::Image& image(message.image(i));
+						const uint32_t header[] = { image.format(), image.width(), image.height(), image.num_mipmaps(), image.semantic() };
+						hash = ResourceCache::HashContent(header, sizeof(header), hash);
+						hash = ResourceCache::HashContent(image.data().data(), image.data().size(), hash);
+					}
+
+					return hash;
+				}
+
+				Texture* CreateEmbeddedTexture(const binary::Texture& message, const std::string& uri) {
+					BitmapRefArray bitmaps;
+
+					for(size_t i(0); i < (size_t)message.image_size(); ++i) {
+						const binary::Texture::Image& image(message.image(i));
+
+						if((image.format() == Texture::UNKNOWN_FORMAT) || (image.format() > Texture::DXT5) ||
+						        !image.width() || !image.height() || !image::CheckImageDimensions(image.width(), image.height()) ||
+						        !image.num_mipmaps() || (image.num_mipmaps() > image::ComputeMipMapCount(image.width(), image.height())) ||
+						        (image.semantic() > Bitmap::SLICE))
+							return 0;
+
+						Bitmap::Ref bitmap(new Bitmap(mServiceLocator));
+						bitmap->Allocate(static_cast<Texture::Format>(image.format()), image.width(), image.height(), image.num_mipmaps(),
+						                 static_cast<Bitmap::Semantic>(image.semantic()));
+
+						if(image.data().size() != bitmap->GetMipChainSize(image.num_mipmaps())) return 0;
+
+						memcpy(bitmap->GetMipData(0), image.data().data(), image.data().size());
+						bitmaps.push_back(bitmap);
+					}
+
+					return mPack.CreateTextureFromBitmaps(bitmaps, uri, false);
+				}
+
 				bool ParseParam(Param& o, binary::Param& message) {
 					// set input connection
 					if(message.has_input_connection_ref()) {
@@ -1914,6 +2689,7 @@ namespace o3d {
 
 #endif
 						Field* field(0);
+						has_data |= field_desc.has_value_encoded();
 
 						switch(field_type) {
 						case binary::Buffer::Field::FLOAT:
@@ -1955,82 +2731,26 @@ namespace o3d {
 						mOldIdToNewObject[field_desc.id()] = ObjectBase::Ref(field);
 					}
 
-					// Allocate the memory
-					if(!o.AllocateElements(message.num_elements())) {
+					// Allocate the memory. Buffers can't allocate no elements, empty ones
+					// are left unallocated, the way they were saved.
+					if(message.num_elements() && !o.AllocateElements(message.num_elements())) {
 						O3D_ERROR(mServiceLocator) << "Couldn't allocate " << message.num_elements() << " elements for buffer";
 						return false;
 					}
 
-					// 2nd pass recreates the data (it any)
-					if(has_data) {
-						BufferLockHelper lock(&o);
-						lock.GetData(Buffer::WRITE_ONLY);
-
-						for(size_t i(0); i < (size_t)fields.size(); ++i) {
-							const binary::Buffer::Field& field_desc(message.field(i));
-							Field& field = *fields[i];
-
-							do {
-								FloatField* float_field;
-
-								if(float_field << field) {
-									if((size_t)field_desc.value_float_size() != (size_t)field.num_components() * o.num_elements()) {
-										O3D_ERROR(mServiceLocator) << "Field's data size mismatchs";
-										return false;
-									}
-
-									float_field->SetFromFloats(field_desc.value_float().data(), field.num_components(), 0, o.num_elements());
-									break;
-								}
-
-								UInt32Field* uint32_field;
-
-								if(uint32_field << field) {
-									if((size_t)field_desc.value_uint_size() != (size_t)field.num_components() * o.num_elements()) {
-										O3D_ERROR(mServiceLocator) << "Field's data size mismatchs";
-										return false;
-									}
-
-									uint32_field->SetFromUInt32s(field_desc.value_uint().data(), field.num_components(), 0, o.num_elements());
-									break;
-								}
-
-								UByteNField* ubyten_field;
-
-								if(ubyten_field << field) {
-									const std::string& value_byte(field_desc.value_byte());
-
-									if(value_byte.size() != field.num_components() * o.num_elements()) {
-										O3D_ERROR(mServiceLocator) << "Field's data size mismatchs";
-										return false;
-									}
-
-									ubyten_field->SetFromUByteNs((const uint8_t*) &value_byte[0], field.num_components(), 0, o.num_elements());
-									break;
-								}
-
-#ifdef GLES2_BACKEND_NATIVE_GLES2
-								UInt16Field* uint16_field;
-
-								if(uint16_field << field) {
-									if((size_t)field_desc.value_uint_size() != (size_t)field.num_components() * o.num_elements()) {
-										O3D_ERROR(mServiceLocator) << "Field's data size mismatchs";
-										return false;
-									}
-
-									uint16_field->SetFromUInt32s(field_desc.value_uint().data(), field.num_components(), 0, o.num_elements());
-									break;
-								}
+					// Static buffers set from the archive can do without their copy
+					// in main memory, as long as their message takes less
+					if(has_data && o.GetCpuMemorySize()) {
+						ArchiveBufferSource* source(ArchiveBufferSource::Create(message, o.GetSizeInBytes(), mServiceLocator));
 
-#endif
-								O3D_ERROR(mServiceLocator) << "Unknown Field type";
-								return false;
-							}
-							while(false);
+						if(source) {
+							o.set_usage(Buffer::STATIC_USAGE);
+							o.set_source(source);
 						}
 					}
 
-					return true;
+					// 2nd pass recreates the data (it any)
+					return !has_data || set_buffer_data(o, message, mServiceLocator);
 				}
 
 				template<typename T>
@@ -2140,6 +2860,28 @@ namespace o3d {
 						}
 					}
 
+					o.ClearLods();
+
+					for(size_t i(0); i < (size_t)message.lod_size(); ++i) {
+						const binary::Primitive::Lod& lod(message.lod(i));
+						ObjectBase::Ref ref(GetObjectRef(lod.index_buffer_ref()));
+
+						if(!ref) {
+							O3D_ERROR(mServiceLocator) << "Couldn't find primitive's LOD index buffer";
+							return false;
+						}
+
+						IndexBuffer* index_buffer;
+
+						if(index_buffer << * ref) {
+							o.AddLod(index_buffer, lod.number_primitives(), lod.screen_size());
+						}
+						else {
+							O3D_ERROR(mServiceLocator) << "Impostor posed as an IndexBuffer, but we didn't fall for it";
+							return false;
+						}
+					}
+
 					if(message.has_stream_bank_ref()) {
 						ObjectBase::Ref ref(GetObjectRef(message.stream_bank_ref()));
 
@@ -2183,6 +2925,10 @@ namespace o3d {
 						return false;
 					}
 
+					// The root transform is the only one without a parent, and
+					// it is always sent first.
+					if(!message.has_parent_ref() && !mRoot) mRoot = &o;
+
 					if(message.has_parent_ref()) {
 						ObjectBase::Ref ref(GetObjectRef(message.parent_ref()));
 
@@ -2205,76 +2951,602 @@ namespace o3d {
 
 			private:
 				IExternalResourceProvider& mERP;
+				IBinaryLoadListener* mListener;
 				string_db_t mStringDB;
 				std::tr1::unordered_map<std::string, const ObjectBase::Class*> mClassMap;
 				std::tr1::unordered_map<uint32_t, ObjectBase::Ref> mOldIdToNewObject;
 				Pack& mPack;
 				pb::io::ZeroCopyInputStream& mStream;
 				ServiceLocator* mServiceLocator;
+				Transform* mRoot;
+			};
+
+// Compress a block of the stream on its own
+			static bool compress_block(binary::StreamHeader::Compression compression, const uint8_t* data, size_t size, std::string& output) {
+				pb::io::StringOutputStream string_stream(&output);
+				pb::io::ZeroCopyOutputStream* compressed_stream(0);
+				pb::io::GzipOutputStream* gzip_stream(0);
+				pb::io::LzmaOutputStream* lzma_stream(0);
+
+				switch(compression) {
+				case binary::StreamHeader::COMPRESSION_GZIP: {
+						pb::io::GzipOutputStream::Options options;
+						options.compression_level = 9;
+						compressed_stream = gzip_stream = new pb::io::GzipOutputStream(&string_stream, options);
+					}
+					break;
+				case binary::StreamHeader::COMPRESSION_LZMA:
+					compressed_stream = lzma_stream = new pb::io::LzmaOutputStream(&string_stream);
+					break;
+				default:
+					output.assign(reinterpret_cast<const char*>(data), size);
+					return true;
+				}
+
+				bool ok(true);
+
+				while(ok && size) {
+					void* buffer;
+					int buffer_size;
+					ok = compressed_stream->Next(&buffer, &buffer_size);
+
+					if(ok) {
+						const size_t n(std::min(size, size_t(buffer_size)));
+						memcpy(buffer, data, n);
+						compressed_stream->BackUp(buffer_size - n);
+						data += n;
+						size -= n;
+					}
+				}
+
+				if(gzip_stream) ok = gzip_stream->Close() && ok;
+
+				if(lzma_stream) ok = lzma_stream->Flush() && ok;
+
+				delete compressed_stream;
+				return ok;
+			}
+
+// Most memory reserved up front for a decompressed block
+			static const size_t kMaxBlockReserve = 16 * 1024 * 1024;
+
+// Decompress a block of the stream
+			static bool decompress_block(binary::StreamHeader::Compression compression, const std::string& input, uint32_t size, std::string& output) {
+				if(compression == binary::StreamHeader::COMPRESSION_NONE) {
+					output = input;
+					return output.size() == size;
+				}
+
+				pb::io::ArrayInputStream array_stream(input.data(), input.size());
+				pb::io::ZeroCopyInputStream* decompressed_stream(0);
+
+				if(compression == binary::StreamHeader::COMPRESSION_GZIP)
+					decompressed_stream = new pb::io::GzipInputStream(&array_stream);
+				else if(compression == binary::StreamHeader::COMPRESSION_LZMA)
+					decompressed_stream = new pb::io::LzmaInputStream(&array_stream, true);
+				else
+					return false;
+
+				// The size comes from the stream, don't trust it with the allocation.
+				output.reserve(std::min<size_t>(size, kMaxBlockReserve));
+				const void* data;
+				int data_size;
+
+				while((output.size() <= size) && decompressed_stream->Next(&data, &data_size)) {
+					output.append(static_cast<const char*>(data), data_size);
+				}
+
+				delete decompressed_stream;
+				return output.size() == size;
+			}
+
+			ArchiveBufferSource* ArchiveBufferSource::Create(const binary::Buffer& message, size_t buffer_size, ServiceLocator* service_locator) {
+				ArchiveBufferSource* source(new ArchiveBufferSource(service_locator));
+				std::string data;
+
+				if(!message.SerializeToString(&data)) {
+					delete source;
+					return 0;
+				}
+
+				source->mSize = data.size();
+
+				// Encoded geometry is usually compact enough as it is
+				if(data.size() < buffer_size / 2) {
+					source->mData.swap(data);
+				}
+				else if(compress_block(binary::StreamHeader::COMPRESSION_GZIP, reinterpret_cast<const uint8_t*>(data.data()), data.size(), source->mData)) {
+					source->mCompression = binary::StreamHeader::COMPRESSION_GZIP;
+				}
+				else {
+					source->mData.clear();
+				}
+
+				if(source->mData.empty() || (source->mData.size() >= buffer_size)) {
+					delete source;
+					return 0;
+				}
+
+				return source;
+			}
+
+			bool ArchiveBufferSource::RestoreBuffer(Buffer* buffer) {
+				std::string data;
+				binary::Buffer message;
+
+				if(!decompress_block(mCompression, mData, mSize, data) || !message.ParseFromString(data)) {
+					O3D_ERROR(mServiceLocator) << "Failed to restore buffer \"" << buffer->name() << "\"";
+					return false;
+				}
+
+				return set_buffer_data(*buffer, message, mServiceLocator);
+			}
+
+// Compresses blocks of a stream being saved, on a worker thread
+			struct CompressedBlock {
+				std::string data;
+				bool ok;
+			};
+
+			class CompressBlockTask : public Closure {
+			public:
+				CompressBlockTask(binary::StreamHeader::Compression compression, const uint8_t* data, size_t size, CompressedBlock& output)
+					: mCompression(compression)
+					, mData(data)
+					, mSize(size)
+					, mOutput(output) { }
+
+				virtual void Run() {
+					mOutput.ok = compress_block(mCompression, mData, mSize, mOutput.data);
+				}
+
+			private:
+				binary::StreamHeader::Compression mCompression;
+				const uint8_t* mData;
+				size_t mSize;
+				CompressedBlock& mOutput;
+			};
+
+// Reads a stream saved in blocks, which get decompressed by a worker
+// pool, a few blocks ahead of the parser. Compressed blocks are read from
+// the underlying stream only when their turn to be decompressed comes.
+			class BlockInputStream : public pb::io::ZeroCopyInputStream {
+			public:
+				BlockInputStream(const binary::StreamHeader& header, pb::io::ZeroCopyInputStream& source)
+					: mSource(source)
+					, mBlocks(header.blocks_size())
+					, mTotalSize(0)
+					, mCompressedSize(0)
+					, mIndex(0)
+					, mOffset(0)
+					, mByteCount(0)
+					, mPosted(0)
+					, mBlockDone(mLock)
+					, mPool(WorkerPool::GetNumberOfProcessors()) {
+					for(int i(0); i < header.blocks_size(); ++i) {
+						const binary::StreamHeader::Block& block(header.blocks(i));
+						mBlocks[i].compression = block.compression();
+						mBlocks[i].compressed_size = block.compressed_size();
+						mBlocks[i].size = block.size();
+						mBlocks[i].done = false;
+						mBlocks[i].ok = false;
+						mTotalSize += block.size();
+						mCompressedSize += block.compressed_size();
+					}
+				}
+
+				~BlockInputStream() {
+					// Let the pool finish with the blocks before they go away.
+					mPool.Wait();
+				}
+
+				// Check the header against the bytes left in the underlying stream,
+				// if known, and start decompressing the first blocks
+				bool Start(int64_t remaining) {
+					if((remaining >= 0) && (mCompressedSize > uint64_t(remaining))) {
+						O3D_LOG(ERROR) << "Binary stream header lists " << mCompressedSize << " bytes of blocks, but only " << remaining << " are left";
+						return false;
+					}
+
+					PostAhead();
+					return true;
+				}
+
+				// Fraction of the stream the parser consumed, in [0, 1]
+				float progress() const {
+					return mTotalSize ? float(mByteCount) / float(mTotalSize) : 1.f;
+				}
+
+				// implements ZeroCopyInputStream
+				bool Next(const void** data, int* size) {
+					while(mIndex < mBlocks.size()) {
+						Block& block(mBlocks[mIndex]);
+
+						if(!Wait(block)) return false;
+
+						if(mOffset < block.data.size()) {
+							*data = block.data.data() + mOffset;
+							*size = block.data.size() - mOffset;
+							mByteCount += *size;
+							mOffset = block.data.size();
+							return true;
+						}
+
+						std::string().swap(block.data);
+						++mIndex;
+						mOffset = 0;
+						PostAhead();
+					}
+
+					return false;
+				}
+
+				void BackUp(int count) {
+					mOffset -= count;
+					mByteCount -= count;
+				}
+
+				bool Skip(int count) {
+					const void* data;
+					int size;
+
+					while(count > 0) {
+						if(!Next(&data, &size)) return false;
+
+						if(size > count) BackUp(size - count);
+
+						count -= std::min(size, count);
+					}
+
+					return true;
+				}
+
+				pb::int64 ByteCount() const {
+					return mByteCount;
+				}
+
+			private:
+				struct Block {
+					binary::StreamHeader::Compression compression;
+					uint32_t compressed_size;
+					uint32_t size;
+					std::string compressed;
+					std::string data;
+					bool done;
+					bool ok;
+				};
+
+				class DecompressTask : public Closure {
+				public:
+					DecompressTask(BlockInputStream& stream, Block& block)
+						: mStream(stream)
+						, mBlock(block) { }
+
+					virtual void Run() {
+						std::string data;
+						const bool ok(decompress_block(mBlock.compression, mBlock.compressed, mBlock.size, data));
+						base::AutoLock lock(mStream.mLock);
+						mBlock.data.swap(data);
+						std::string().swap(mBlock.compressed);
+						mBlock.ok = ok;
+						mBlock.done = true;
+						mStream.mBlockDone.Broadcast();
+					}
+
+				private:
+					BlockInputStream& mStream;
+					Block& mBlock;
+				};
+
+				// Keep a couple of blocks per thread decompressing ahead of the parser,
+				// so that memory doesn't fill up with blocks.
+				void PostAhead() {
+					const size_t ahead(2 * mPool.num_threads());
+
+					while((mPosted < mBlocks.size()) && (mPosted < mIndex + ahead)) {
+						Block& block(mBlocks[mPosted++]);
+						pb::io::CodedInputStream tmp(&mSource);
+
+						if(!tmp.ReadString(&block.compressed, block.compressed_size)) {
+							// Leave the block failed, Next() reports it when it gets there.
+							base::AutoLock lock(mLock);
+							block.done = true;
+							continue;
+						}
+
+						mPool.Post(new DecompressTask(*this, block));
+					}
+				}
+
+				bool Wait(Block& block) {
+					base::AutoLock lock(mLock);
+
+					while(!block.done) mBlockDone.Wait();
+
+					if(!block.ok) {
+						O3D_LOG(ERROR) << "Failed to decompress block " << mIndex << " of binary stream";
+					}
+
+					return block.ok;
+				}
+
+				pb::io::ZeroCopyInputStream& mSource;
+				std::vector<Block> mBlocks;
+				uint64_t mTotalSize;
+				uint64_t mCompressedSize;
+				size_t mIndex;
+				size_t mOffset;
+				pb::int64 mByteCount;
+				size_t mPosted;
+				base::Lock mLock;
+				base::ConditionVariable mBlockDone;
+				// Last, so that it is destroyed first.
+				WorkerPool mPool;
 			};
 
 		} // anonymous namespace
 
-		Transform* LoadFromBinaryStream(std::istream& stream, Pack& pack, IExternalResourceProvider& erp) {
-			pbx::log_handler lh;
-			Transform* root(0);
+		struct BinaryStreamLoader::Impl {
+			pbx::log_handler                  lh;
+			std::istream&                     stream;
+			int64_t                           stream_size;
+			pb::io::IstreamInputStream        low_level_stream;
+			pb::io::ZeroCopyInputStream*      decompressed_stream;
+			BlockInputStream*                 block_stream;
+			Load*                             load;
+
+			Impl(std::istream& s)
+				: stream(s)
+				, stream_size(0)
+				, low_level_stream(&s)
+				, decompressed_stream(0)
+				, block_stream(0)
+				, load(0) { }
+
+			~Impl() {
+				delete load;
+
+				if(decompressed_stream != &low_level_stream)
+					delete decompressed_stream;
+			}
 
-			if(stream.good()) {
-				stream.seekg(0, std::ios::beg);
-				pb::io::IstreamInputStream low_level_stream(&stream);
-				// Read FourCC
-				bool magic_ok(false);
+			// Read the FourCC and stream header, and set up decompression.
+			bool Open(Pack& pack, IExternalResourceProvider& erp, IBinaryLoadListener* listener) {
+				O3D_PROFILE_ZONE("BinaryStreamLoader::Open");
 
+				// Read FourCC
 				do {
 					pb::io::CodedInputStream tmp(&low_level_stream);
 					uint32_t magic;
 
-					if(!tmp.ReadLittleEndian32(&magic)) break;
+					if(!tmp.ReadLittleEndian32(&magic)) return false;
+
+					if(magic != FOURCC) return false;
+				}
+				while(false);
+
+				binary::StreamHeader header;
+
+				if(!pbx::read(header, low_level_stream)) return false;
+
+				if(header.blocks_size()) {
+					decompressed_stream = block_stream = new BlockInputStream(header, low_level_stream);
+					const int64_t remaining((stream_size > 0) ? stream_size - low_level_stream.ByteCount() : -1);
+
+					if(!block_stream->Start(remaining)) return false;
+				}
+				else switch(header.compression()) {
+				case binary::StreamHeader::COMPRESSION_NONE:
+					decompressed_stream = &low_level_stream;
+					break;
+				case binary::StreamHeader::COMPRESSION_GZIP:
+					decompressed_stream = new pb::io::GzipInputStream(&low_level_stream);
+					break;
+				case binary::StreamHeader::COMPRESSION_LZMA:
+					decompressed_stream = new pb::io::LzmaInputStream(&low_level_stream, true);
+					break;
+				default:
+					O3D_ASSERT(false);
+					return false;
+				}
+
+				load = new Load(pack, *decompressed_stream, erp, listener);
+				load->Begin();
+				return true;
+			}
+		};
+
+		BinaryStreamLoader::BinaryStreamLoader(std::istream& stream, Pack& pack, IExternalResourceProvider& erp, IBinaryLoadListener* listener)
+			: mImpl(0)
+			, mStatus(STATUS_FAILED) {
+			if(!stream.good()) return;
+
+			// Measure the stream so that we can report progress
+			stream.seekg(0, std::ios::end);
+			const int64_t stream_size(stream.tellg());
+			stream.seekg(0, std::ios::beg);
+			mImpl = new Impl(stream);
+			mImpl->stream_size = stream_size;
+
+			if(mImpl->Open(pack, erp, listener)) mStatus = STATUS_LOADING;
+			else stream.setstate(std::ios_base::failbit);
+		}
+
+		BinaryStreamLoader::~BinaryStreamLoader() {
+			delete mImpl;
+		}
+
+		BinaryStreamLoader::Status BinaryStreamLoader::Step(float budget_ms) {
+			if(mStatus != STATUS_LOADING) return mStatus;
+
+			O3D_PROFILE_ZONE("BinaryStreamLoader::Step");
+			ElapsedTimeTimer timer;
+			Load::Result result;
+
+			do {
+				result = mImpl->load->Next();
+			}
+			while((result == Load::RESULT_MORE) &&
+			        ((budget_ms <= 0.f) || (timer.GetElapsedTimeWithoutClearing() * 1000.f < budget_ms)));
+
+			switch(result) {
+			case Load::RESULT_DONE:
+				mStatus = STATUS_DONE;
+				break;
+			case Load::RESULT_FAILED:
+				mStatus = STATUS_FAILED;
+				mImpl->stream.setstate(std::ios_base::failbit);
+				break;
+			default:
+				break;
+			}
+
+			return mStatus;
+		}
+
+		float BinaryStreamLoader::progress() const {
+			if(mStatus == STATUS_DONE) return 1.f;
+
+			if(mImpl && mImpl->block_stream) return mImpl->block_stream->progress();
+
+			if(!mImpl || (mImpl->stream_size <= 0)) return 0.f;
+
+			return std::min(1.f, float(mImpl->low_level_stream.ByteCount()) / float(mImpl->stream_size));
+		}
+
+		Transform* BinaryStreamLoader::root() const {
+			return (mImpl && mImpl->load) ? mImpl->load->root() : 0;
+		}
+
+		Transform* LoadFromBinaryStream(std::istream& stream, Pack& pack, IExternalResourceProvider& erp) {
+			BinaryStreamLoader loader(stream, pack, erp);
+
+			if(loader.Step(0.f) == BinaryStreamLoader::STATUS_DONE)
+				return loader.root();
+
+			stream.setstate(std::ios_base::failbit);
+			return 0;
+		}
+
+		// Serialize a scenegraph, cut in blocks compressed on their own
+		static bool SaveInBlocks(std::ostream& stream, Transform& root, const SaveOptions& options, SaveReport* report) {
+			const size_t block_size(options.block_size);
+			binary::StreamHeader::Compression block_compression(binary::StreamHeader::COMPRESSION_NONE);
+
+			switch(options.compression) {
+			case COMPRESSION_NONE:
+				break;
+			case COMPRESSION_GZIP:
+				block_compression = binary::StreamHeader::COMPRESSION_GZIP;
+				break;
+			case COMPRESSION_LZMA:
+				block_compression = binary::StreamHeader::COMPRESSION_LZMA;
+				break;
+			default:
+				O3D_ASSERT(false);
+			}
+
+			// Serialize our model in memory first, to cut it in blocks
+			std::string model;
+			bool ok(false);
 
-					if(magic != FOURCC) break;
+			do {
+				pb::io::StringOutputStream model_stream(&model);
+				pb::io::CodedOutputStream coded_stream(&model_stream);
+				Publisher publish(coded_stream, options, report);
+				ok = publish(root);
+			}
+			while(false);
+
+			if(ok && stream.good()) {
+				const uint8_t* data(reinterpret_cast<const uint8_t*>(model.data()));
+				const size_t num_blocks((model.size() + block_size - 1) / block_size);
+				std::vector<CompressedBlock> blocks(num_blocks);
+
+				do {
+					WorkerPool pool(WorkerPool::GetNumberOfProcessors());
 
-					magic_ok = true;
+					for(size_t i(0); i < num_blocks; ++i) {
+						const size_t offset(i * block_size);
+						pool.Post(new CompressBlockTask(block_compression, data + offset, std::min(block_size, model.size() - offset), blocks[i]));
+					}
 				}
 				while(false);
 
-				if(magic_ok) {
-					binary::StreamHeader header;
-					pb::io::ZeroCopyInputStream* decompressed_stream(0);
+				binary::StreamHeader header;
 
-					if(pbx::read(header, low_level_stream)) {
-						switch(header.compression()) {
-						case binary::StreamHeader::COMPRESSION_NONE:
-							decompressed_stream = &low_level_stream;
-							break;
-						case binary::StreamHeader::COMPRESSION_GZIP:
-							decompressed_stream = new pb::io::GzipInputStream(&low_level_stream);
-							break;
-						case binary::StreamHeader::COMPRESSION_LZMA:
-							decompressed_stream = new pb::io::LzmaInputStream(&low_level_stream, true);
-							break;
-						default:
-							O3D_ASSERT(false);
-						}
+				for(size_t i(0); ok && i < num_blocks; ++i) {
+					const size_t offset(i * block_size);
+					const size_t size(std::min(block_size, model.size() - offset));
+					binary::StreamHeader::Block* block(header.add_blocks());
+					block->set_size(size);
+					ok = blocks[i].ok;
+
+					// Blocks that don't shrink are kept as they are
+					if(blocks[i].data.size() < size) {
+						block->set_compression(block_compression);
+					}
+					else {
+						blocks[i].data.assign(model, offset, size);
+					}
+
+					block->set_compressed_size(blocks[i].data.size());
+				}
 
-						if(decompressed_stream) {
-							Load load(pack, *decompressed_stream, erp);
-							root = load();
+				if(ok) {
+					pb::io::OstreamOutputStream low_level_stream(&stream);
+					pb::io::CodedOutputStream header_stream(&low_level_stream);
+					header_stream.WriteLittleEndian32(FOURCC);
+					ok = pbx::write(header, header_stream);
 
-							if(decompressed_stream != &low_level_stream)
-								delete decompressed_stream;
-						}
+					for(size_t i(0); ok && i < num_blocks; ++i) {
+						header_stream.WriteRaw(blocks[i].data.data(), blocks[i].data.size());
+						ok = !header_stream.HadError();
 					}
 				}
 
-				if(!root) stream.setstate(std::ios_base::failbit);
+				if(ok) return true;
 			}
 
-			return root;
+			stream.setstate(std::ios_base::failbit);
+			return false;
 		}
 
+		SaveOptions::SaveOptions()
+			: compression(COMPRESSION_LZMA)
+			, block_size(0)
+			, encode_geometry(false)
+			, position_bits(16)
+			, normal_bits(12)
+			, texture_provider(0)
+			, scale_textures_to_pot(false)
+			, deduplicate(false) { }
+
+		SaveReport::SaveReport()
+			: duplicates(0)
+			, bytes_saved(0) { }
+
 		bool SaveToBinaryStream(std::ostream& stream, Transform& root, TCompressionAlgorithm compression) {
+			SaveOptions options;
+			options.compression = compression;
+			return SaveToBinaryStream(stream, root, options);
+		}
+
+		bool SaveToBinaryStream(std::ostream& stream, Transform& root, TCompressionAlgorithm compression, size_t block_size) {
+			O3D_ASSERT(block_size > 0);
+			SaveOptions options;
+			options.compression = compression;
+			options.block_size = block_size;
+			return SaveToBinaryStream(stream, root, options);
+		}
+
+		bool SaveToBinaryStream(std::ostream& stream, Transform& root, const SaveOptions& options, SaveReport* report) {
 			pbx::log_handler lh;
 
+			if(report) *report = SaveReport();
+
+			if(options.block_size) return SaveInBlocks(stream, root, options, report);
+
 			if(stream.good()) {
 				pb::io::ZeroCopyOutputStream* low_level_stream(new pb::io::OstreamOutputStream(&stream));
 
@@ -2282,7 +3554,7 @@ namespace o3d {
 					pb::io::ZeroCopyOutputStream* compressed_stream(0);
 					binary::StreamHeader header;
 
-					switch(compression) {
+					switch(options.compression) {
 					case COMPRESSION_NONE:
 						compressed_stream = low_level_stream;
 						break;
@@ -2316,7 +3588,7 @@ namespace o3d {
 						// Next, serialize our model in compressed stream
 						if(ok) {
 							pb::io::CodedOutputStream model_stream(compressed_stream);
-							Publisher publish(model_stream);
+							Publisher publish(model_stream, options, report);
 							ok = publish(root);
 						}
 
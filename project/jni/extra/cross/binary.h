@@ -16,10 +16,12 @@
 
 #pragma once
 #include <iostream>
+#include "base/cross/config.h"
 #include "extra/cross/external_resource_provider.h"
 
 namespace o3d {
 	class Pack;
+	class Shape;
 	class Transform;
 }
 
@@ -46,6 +48,80 @@ namespace o3d {
 		  */
 		Transform* LoadFromBinaryStream(std::istream& stream, Pack& pack, IExternalResourceProvider& erp);
 
+		/** This interface gets notified by a {BinaryStreamLoader} as soon as
+		  * parts of the scenegraph become usable.
+		  */
+		class IBinaryLoadListener {
+		public:
+			virtual ~IBinaryLoadListener() {}
+
+			/** @brief A transform and its params have been received.
+			  *
+			  * The transform is already parented, and its shapes have been
+			  * announced through {OnShapeReady} before this gets called. Its
+			  * children have not been received yet. Does nothing by default.
+			  */
+			virtual void OnTransformReady(Transform& transform) {}
+
+			/** @brief A shape, with all its elements, buffers and materials,
+			  * has been attached to a transform.
+			  */
+			virtual void OnShapeReady(Transform& transform, Shape& shape) = 0;
+		};
+
+		/** @brief Incremental scenegraph deserializer.
+		  *
+		  * Same as {LoadFromBinaryStream}, except that atoms are consumed
+		  * in time-sliced steps so that the caller can keep rendering (and
+		  * reacting to input) while the scene is being rebuilt. The stream
+		  * format is dependency-ordered, so every transform is parented as
+		  * soon as it is received and every shape is complete by the time it
+		  * gets attached: a partially loaded scenegraph is always renderable.
+		  *
+		  * @note The stream, pack, resource provider and listener must outlive
+		  * the loader.
+		  */
+		class BinaryStreamLoader {
+		public:
+			enum Status {
+				STATUS_LOADING,
+				STATUS_DONE,
+				STATUS_FAILED,
+			};
+
+			BinaryStreamLoader(std::istream& stream, Pack& pack, IExternalResourceProvider& erp, IBinaryLoadListener* listener = 0);
+			~BinaryStreamLoader();
+
+			/** @brief Consume atoms until either the stream ends or the time
+			  * budget is spent.
+			  *
+			  * At least one atom is consumed per call, so progress is always made.
+			  *
+			  * @param budget_ms Time budget, in milliseconds. Zero or a negative
+			  *                  value means "run to completion".
+			  * @return          The loader's status after this step.
+			  */
+			Status Step(float budget_ms);
+
+			Status status() const { return mStatus; }
+
+			/// @return Fraction of the input stream consumed so far, in [0, 1].
+			float progress() const;
+
+			/** @return The root of the scenegraph as soon as it has been received,
+			  *         or <code>NULL</code>. It is only guaranteed to be complete
+			  *         once {status} is {STATUS_DONE}.
+			  */
+			Transform* root() const;
+
+		private:
+			struct Impl;
+			Impl*  mImpl;
+			Status mStatus;
+
+			O3D_DISALLOW_COPY_AND_ASSIGN(BinaryStreamLoader);
+		};
+
 		enum TCompressionAlgorithm {
 			COMPRESSION_NONE,
 			COMPRESSION_GZIP,
@@ -72,6 +148,92 @@ namespace o3d {
 		  */
 		bool SaveToBinaryStream(std::ostream& stream, Transform& root, TCompressionAlgorithm compression = COMPRESSION_LZMA);
 
+		/** @brief Serialize a scenegraph to a stream, in blocks compressed on their own.
+		  *
+		  * Same as {SaveToBinaryStream}, except that the serialized scenegraph
+		  * is cut in blocks, each compressed independently and listed in the
+		  * stream header, so that loaders can decompress them in parallel,
+		  * ahead of parsing. A block that <code>compression</code> doesn't make
+		  * smaller is stored uncompressed.
+		  *
+		  * @param block_size Size of the blocks before compression, in bytes.
+		  *                   Smaller blocks decompress in parallel better, but
+		  *                   compress worse.
+		  */
+		bool SaveToBinaryStream(std::ostream& stream, Transform& root, TCompressionAlgorithm compression, size_t block_size);
+
+		/** @brief Options of {SaveToBinaryStream}.
+		  *
+		  * By default, a scenegraph is saved the way
+		  * <code>SaveToBinaryStream(stream, root)</code> saves it.
+		  */
+		struct SaveOptions {
+			SaveOptions();
+
+			/// Compression algorithm. Defaults to {COMPRESSION_LZMA}.
+			TCompressionAlgorithm compression;
+
+			/** Size of the blocks the stream is cut in before compression, in
+			  * bytes, or 0, the default, to compress the stream as a whole.
+			  */
+			size_t block_size;
+
+			/** Whether to encode the geometry with a mesh codec rather than
+			  * leave it all to {compression}. Index buffers are coded against
+			  * a cache of the last indices used, losslessly; positions and
+			  * normals are quantized, as told by {position_bits} and
+			  * {normal_bits}. Defaults to false.
+			  */
+			bool encode_geometry;
+
+			/// Bits positions are quantized on, or 0 to keep them as they are. Defaults to 16.
+			unsigned position_bits;
+
+			/** Bits each of the two octahedral coordinates of normals is
+			  * quantized on, or 0 to keep them as they are. Defaults to 12.
+			  */
+			unsigned normal_bits;
+
+			/** Provider of the images of the textures, to embed them decoded,
+			  * with all their mips, so that loaders upload them without
+			  * decoding nor resampling them; or NULL, the default, to only
+			  * refer to textures by URI.
+			  */
+			IExternalResourceProvider* texture_provider;
+
+			/** Whether embedded textures are scaled up to power-of-two
+			  * dimensions, for renderers that don't support others. Defaults
+			  * to false.
+			  */
+			bool scale_textures_to_pot;
+
+			/** Whether buffers, effects, materials, curves and skins with the
+			  * same content as one sent before are sent as references to that
+			  * one, rather than once more. The name of the first one sent is
+			  * kept. Defaults to false.
+			  */
+			bool deduplicate;
+		};
+
+		/// @brief What {SaveToBinaryStream} saved.
+		struct SaveReport {
+			SaveReport();
+
+			/// Number of objects sent as references to an identical one.
+			unsigned duplicates;
+
+			/// Bytes of content those objects would have taken, before compression.
+			size_t bytes_saved;
+		};
+
+		/** @brief Serialize a scenegraph to a stream.
+		  *
+		  * Same as {SaveToBinaryStream}, with all the options.
+		  *
+		  * @param report If not NULL, filled with what was saved.
+		  */
+		bool SaveToBinaryStream(std::ostream& stream, Transform& root, const SaveOptions& options, SaveReport* report = 0);
+
 	} // namespace extra
 } // namespace o3d
 
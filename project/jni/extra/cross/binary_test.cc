@@ -0,0 +1,560 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file contains the tests of the binary scene format.
+
+#include <math.h>
+#include <sstream>
+#include "tests/common/win/testing_common.h"
+#include "core/cross/buffer.h"
+#include "core/cross/class_manager.h"
+#include "core/cross/material.h"
+#include "core/cross/object_manager.h"
+#include "core/cross/pack.h"
+#include "core/cross/primitive.h"
+#include "core/cross/service_dependency.h"
+#include "core/cross/shape.h"
+#include "core/cross/stream_bank.h"
+#include "core/cross/transform.h"
+#include "core/cross/worker_pool.h"
+#include "extra/cross/binary.h"
+#include "extra/cross/external_resource_provider.h"
+#include "import/cross/destination_buffer.h"
+
+namespace o3d {
+	namespace extra {
+
+		namespace {
+
+			class NoResources : public IExternalResourceProvider {
+			public:
+				virtual ExternalResource::Ref GetExternalResourceForURI(Pack& pack, const std::string& uri) {
+					return ExternalResource::Ref();
+				}
+			};
+
+			// Geometry read back from a loaded scene.
+			struct Geometry {
+				std::vector<float> positions;
+				std::vector<float> normals;
+				std::vector<uint32_t> indices;
+			};
+
+			// Returns the primitives of a transform's shapes.
+			std::vector<Primitive*> GetPrimitives(Transform* transform) {
+				std::vector<Primitive*> primitives;
+				const ShapeRefArray& shapes = transform->GetShapeRefs();
+
+				for(size_t ii = 0; ii < shapes.size(); ++ii) {
+					const ElementRefArray& elements = shapes[ii]->GetElementRefs();
+
+					for(size_t jj = 0; jj < elements.size(); ++jj) {
+						primitives.push_back(down_cast<Primitive*>(elements[jj].Get()));
+					}
+				}
+
+				return primitives;
+			}
+
+		}  // anonymous namespace
+
+		class BinaryTest : public testing::Test {
+		protected:
+			BinaryTest()
+				: class_manager_(g_service_locator),
+				  object_manager_(g_service_locator),
+				  registered_destination_buffer_(false) {
+				// Other tests may have registered it already.
+				if(!class_manager_->GetClassByClassName(DestinationBuffer::GetApparentClassName())) {
+					class_manager_->AddTypedClass<DestinationBuffer>();
+					registered_destination_buffer_ = true;
+				}
+			}
+
+			~BinaryTest() {
+				if(registered_destination_buffer_) {
+					class_manager_->RemoveClass(DestinationBuffer::GetApparentClass());
+				}
+			}
+
+			virtual void SetUp();
+			virtual void TearDown();
+
+			// Saves the scene with the given options.
+			std::string Save(const SaveOptions& options, SaveReport* report = NULL);
+
+			// Loads a scene in a new pack and returns its root.
+			Transform* Load(const std::string& scene);
+
+			// The pack the last scene was loaded in.
+			Pack* loaded_pack() {
+				return packs_.back();
+			}
+
+			Pack* CreatePack() {
+				Pack* pack = object_manager_->CreatePack();
+				packs_.push_back(pack);
+				return pack;
+			}
+
+			// The pack of the scene being saved.
+			Pack* pack() {
+				return packs_[0];
+			}
+
+			Transform* root() {
+				return root_;
+			}
+
+			// Adds a primitive to the root, with |count| positions and normals
+			// of 3 components, and |index_count| indices.
+			void AddPrimitive(const float* positions, const float* normals, size_t count, const uint32_t* indices, size_t index_count);
+
+			// Saves the scene with the geometry codec, loads it back and reads
+			// the geometry of its primitive.
+			bool RoundTrip(const SaveOptions& options, Geometry* geometry);
+
+		private:
+			ServiceDependency<ClassManager> class_manager_;
+			ServiceDependency<ObjectManager> object_manager_;
+			bool registered_destination_buffer_;
+			std::vector<Pack*> packs_;
+			Transform* root_;
+		};
+
+		void BinaryTest::SetUp() {
+			root_ = CreatePack()->Create<Transform>();
+		}
+
+		void BinaryTest::TearDown() {
+			for(size_t ii = 0; ii < packs_.size(); ++ii) {
+				object_manager_->DestroyPack(packs_[ii]);
+			}
+		}
+
+		void BinaryTest::AddPrimitive(const float* positions, const float* normals, size_t count, const uint32_t* indices, size_t index_count) {
+			VertexBuffer* vertex_buffer = pack()->Create<VertexBuffer>();
+			Field* position_field = vertex_buffer->CreateField(FloatField::GetApparentClass(), 3);
+			Field* normal_field = vertex_buffer->CreateField(FloatField::GetApparentClass(), 3);
+
+			// Buffers can't allocate no elements, they are left empty instead.
+			if(count) {
+				ASSERT_TRUE(vertex_buffer->AllocateElements(count));
+				position_field->SetFromFloats(positions, 3, 0, count);
+				normal_field->SetFromFloats(normals, 3, 0, count);
+			}
+
+			StreamBank* stream_bank = pack()->Create<StreamBank>();
+			ASSERT_TRUE(stream_bank->SetVertexStream(Stream::POSITION, 0, position_field, 0));
+			ASSERT_TRUE(stream_bank->SetVertexStream(Stream::NORMAL, 0, normal_field, 0));
+			IndexBuffer* index_buffer = pack()->Create<IndexBuffer>();
+
+			if(index_count) {
+				ASSERT_TRUE(index_buffer->AllocateElements(index_count));
+				index_buffer->index_field()->SetFromUInt32s(indices, 1, 0, index_count);
+			}
+
+			Primitive* primitive = pack()->Create<Primitive>();
+			primitive->set_stream_bank(stream_bank);
+			primitive->set_index_buffer(index_buffer);
+			primitive->set_primitive_type(Primitive::TRIANGLELIST);
+			primitive->set_number_vertices(count);
+			primitive->set_number_primitives(index_count / 3);
+			Shape* shape = pack()->Create<Shape>();
+			primitive->SetOwner(shape);
+			root_->AddShape(shape);
+		}
+
+		bool BinaryTest::RoundTrip(const SaveOptions& options, Geometry* geometry) {
+			Transform* loaded = Load(Save(options));
+
+			if(!loaded || (GetPrimitives(loaded).size() != 1)) {
+				return false;
+			}
+
+			Primitive* primitive = GetPrimitives(loaded)[0];
+			const Stream* position = primitive->stream_bank()->GetVertexStream(Stream::POSITION, 0);
+			const Stream* normal = primitive->stream_bank()->GetVertexStream(Stream::NORMAL, 0);
+
+			if(!position || !normal || !primitive->indexed()) {
+				return false;
+			}
+
+			const unsigned count = position->field().buffer()->num_elements();
+			geometry->positions.resize(count * 3);
+			geometry->normals.resize(count * 3);
+
+			if(count) {
+				position->field().GetAsFloats(0, &geometry->positions[0], 3, count);
+				normal->field().GetAsFloats(0, &geometry->normals[0], 3, count);
+			}
+
+			const unsigned index_count = primitive->index_buffer()->num_elements();
+			geometry->indices.resize(index_count);
+
+			if(index_count) {
+				// Index fields are 16 or 32 bits, depending on the renderer.
+				std::vector<float> indices(index_count);
+				primitive->index_buffer()->index_field()->GetAsFloats(0, &indices[0], 1, index_count);
+				geometry->indices.assign(indices.begin(), indices.end());
+			}
+
+			return true;
+		}
+
+		std::string BinaryTest::Save(const SaveOptions& options, SaveReport* report) {
+			std::ostringstream stream;
+			EXPECT_TRUE(SaveToBinaryStream(stream, *root_, options, report));
+			return stream.str();
+		}
+
+		Transform* BinaryTest::Load(const std::string& scene) {
+			NoResources resources;
+			std::istringstream stream(scene);
+			return LoadFromBinaryStream(stream, *CreatePack(), resources);
+		}
+
+		// Blocks are read from the stream as the loader gets to them, not all
+		// when it opens the stream.
+		TEST_F(BinaryTest, BlocksAreReadLazily) {
+			const size_t kBlockSize = 4096;
+			// Many more blocks than the loader decompresses ahead.
+			const size_t blocks = 8 * (2 * WorkerPool::GetNumberOfProcessors() + 8);
+			const std::string blob(blocks * kBlockSize, 'x');
+			root()->CreateParam<ParamString>("blob")->set_value(blob);
+			SaveOptions options;
+			options.compression = COMPRESSION_NONE;
+			options.block_size = kBlockSize;
+			const std::string scene(Save(options));
+
+			NoResources resources;
+			std::istringstream stream(scene);
+			BinaryStreamLoader loader(stream, *CreatePack(), resources);
+			ASSERT_EQ(BinaryStreamLoader::STATUS_LOADING, loader.status());
+			EXPECT_LT(static_cast<size_t>(stream.tellg()), scene.size() / 2);
+
+			ASSERT_EQ(BinaryStreamLoader::STATUS_DONE, loader.Step(0.f));
+			ASSERT_TRUE(loader.root() != NULL);
+			ParamString* param = loader.root()->GetParam<ParamString>("blob");
+			ASSERT_TRUE(param != NULL);
+			EXPECT_TRUE(param->value() == blob);
+		}
+
+		// A stream shorter than its header says is rejected when opened.
+		TEST_F(BinaryTest, TruncatedBlocksFail) {
+			root()->CreateParam<ParamString>("blob")->set_value(std::string(16384, 'x'));
+			SaveOptions options;
+			options.block_size = 1024;
+			const std::string scene(Save(options));
+			ASSERT_TRUE(Load(scene) != NULL);
+
+			NoResources resources;
+			std::istringstream stream(scene.substr(0, scene.size() - 1));
+			BinaryStreamLoader loader(stream, *CreatePack(), resources);
+			EXPECT_EQ(BinaryStreamLoader::STATUS_FAILED, loader.status());
+			EXPECT_TRUE(loader.root() == NULL);
+		}
+
+		// Indices are coded against a cache of the last ones used, or as a
+		// delta from the next unused one, and come back as they were.
+		TEST_F(BinaryTest, IndicesRoundTrip) {
+			const size_t kCount = 4096;
+			std::vector<float> vertices(kCount * 3, 0.f);
+			std::vector<uint32_t> indices;
+
+			// A strip of triangles sharing vertices, which hit the cache. Raw,
+			// these indices take two bytes each.
+			for(uint32_t ii = 2048; ii + 33 < kCount; ++ii) {
+				indices.push_back(ii);
+				indices.push_back(ii + 1);
+				indices.push_back(ii + 32);
+			}
+
+			// Backward and forward jumps, which miss it.
+			const uint32_t kJumps[] = { 4095, 0, 17, 2, 4094, 1, 2050, 2050, 2050 };
+			indices.insert(indices.end(), kJumps, kJumps + o3d_arraysize(kJumps));
+			AddPrimitive(&vertices[0], &vertices[0], kCount, &indices[0], indices.size());
+
+			SaveOptions options;
+			options.compression = COMPRESSION_NONE;
+			const size_t raw_size = Save(options).size();
+			options.encode_geometry = true;
+			options.position_bits = 0;
+			options.normal_bits = 0;
+			EXPECT_LT(Save(options).size(), raw_size);
+
+			Geometry geometry;
+			ASSERT_TRUE(RoundTrip(options, &geometry));
+			EXPECT_TRUE(geometry.indices == indices);
+			EXPECT_TRUE(geometry.positions == vertices);
+		}
+
+		// Positions come back within half a quantization step of each
+		// component's range, and components that don't vary come back exactly.
+		TEST_F(BinaryTest, PositionsWithinQuantizationError) {
+			const size_t kCount = 100;
+			std::vector<float> positions(kCount * 3);
+			std::vector<float> normals(kCount * 3, 0.f);
+			std::vector<uint32_t> indices;
+
+			for(size_t ii = 0; ii < kCount; ++ii) {
+				positions[ii * 3 + 0] = -50.f + 200.f * ((ii * 37) % kCount) / (kCount - 1);
+				positions[ii * 3 + 1] = sinf(ii * .1f);
+				positions[ii * 3 + 2] = 3.f;
+				normals[ii * 3 + 2] = 1.f;
+				indices.push_back(ii);
+			}
+
+			AddPrimitive(&positions[0], &normals[0], kCount, &indices[0], kCount - 1);
+			float range[3];
+
+			for(size_t cc = 0; cc < 3; ++cc) {
+				float lowest = positions[cc], highest = positions[cc];
+
+				for(size_t ii = 1; ii < kCount; ++ii) {
+					lowest = std::min(lowest, positions[ii * 3 + cc]);
+					highest = std::max(highest, positions[ii * 3 + cc]);
+				}
+
+				range[cc] = highest - lowest;
+			}
+
+			const unsigned kBits[] = { 16, 8 };
+
+			for(size_t bb = 0; bb < o3d_arraysize(kBits); ++bb) {
+				SaveOptions options;
+				options.compression = COMPRESSION_NONE;
+				options.encode_geometry = true;
+				options.position_bits = kBits[bb];
+				Geometry geometry;
+				ASSERT_TRUE(RoundTrip(options, &geometry));
+				ASSERT_EQ(positions.size(), geometry.positions.size());
+
+				for(size_t ii = 0; ii < positions.size(); ++ii) {
+					const float step = range[ii % 3] / ((1 << kBits[bb]) - 1);
+					EXPECT_NEAR(positions[ii], geometry.positions[ii], .5f * step * 1.05f) << "bits " << kBits[bb] << ", component " << ii;
+				}
+			}
+		}
+
+		// Normals come back of unit length, close to the originals, on both
+		// halves of the octahedron.
+		TEST_F(BinaryTest, NormalsOctahedral) {
+			const size_t kCount = 256;
+			std::vector<float> positions(kCount * 3, 0.f);
+			std::vector<float> normals;
+			std::vector<uint32_t> indices(kCount - 1);
+			const float kAxes[] = {
+				1.f, 0.f, 0.f, -1.f, 0.f, 0.f,
+				0.f, 1.f, 0.f, 0.f, -1.f, 0.f,
+				0.f, 0.f, 1.f, 0.f, 0.f, -1.f,
+			};
+			normals.assign(kAxes, kAxes + o3d_arraysize(kAxes));
+
+			// A spiral over the sphere, from pole to pole.
+			while(normals.size() < kCount * 3) {
+				const float t = float(normals.size()) / (kCount * 3);
+				const float z = 1.f - 2.f * t;
+				const float r = sqrtf(1.f - z * z);
+				normals.push_back(r * cosf(t * 40.f));
+				normals.push_back(r * sinf(t * 40.f));
+				normals.push_back(z);
+			}
+
+			AddPrimitive(&positions[0], &normals[0], kCount, &indices[0], indices.size());
+			const unsigned kBits[] = { 12, 8 };
+			// Largest angle between a normal and its decoded self, in radians.
+			const float kMaxAngle[] = { .001f, .02f };
+
+			for(size_t bb = 0; bb < o3d_arraysize(kBits); ++bb) {
+				SaveOptions options;
+				options.compression = COMPRESSION_NONE;
+				options.encode_geometry = true;
+				options.normal_bits = kBits[bb];
+				Geometry geometry;
+				ASSERT_TRUE(RoundTrip(options, &geometry));
+				ASSERT_EQ(normals.size(), geometry.normals.size());
+
+				for(size_t ii = 0; ii < normals.size(); ii += 3) {
+					const float* n = &geometry.normals[ii];
+					const float length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+					const float dot = (normals[ii] * n[0] + normals[ii + 1] * n[1] + normals[ii + 2] * n[2]) / length;
+					EXPECT_NEAR(1.f, length, 1e-5f) << "bits " << kBits[bb] << ", normal " << ii / 3;
+					EXPECT_LT(acosf(std::min(dot, 1.f)), kMaxAngle[bb]) << "bits " << kBits[bb] << ", normal " << ii / 3;
+				}
+			}
+		}
+
+		// Vertices all at the same place, zero-length normals and a triangle
+		// using a single vertex still load.
+		TEST_F(BinaryTest, DegenerateGeometry) {
+			const float kPositions[] = { 1.5f, -2.f, 7.f, 1.5f, -2.f, 7.f, 1.5f, -2.f, 7.f };
+			const float kNormals[9] = { 0.f };
+			const uint32_t kIndices[] = { 1, 1, 1 };
+			AddPrimitive(kPositions, kNormals, 3, kIndices, 3);
+			SaveOptions options;
+			options.compression = COMPRESSION_NONE;
+			options.encode_geometry = true;
+			Geometry geometry;
+			ASSERT_TRUE(RoundTrip(options, &geometry));
+			EXPECT_TRUE(geometry.positions == std::vector<float>(kPositions, kPositions + 9));
+			EXPECT_TRUE(geometry.indices == std::vector<uint32_t>(kIndices, kIndices + 3));
+			ASSERT_EQ(9u, geometry.normals.size());
+
+			for(size_t ii = 0; ii < 9; ii += 3) {
+				const float* n = &geometry.normals[ii];
+				EXPECT_NEAR(1.f, sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]), 1e-5f);
+			}
+		}
+
+		// Buffers without elements are left to the raw path.
+		TEST_F(BinaryTest, EmptyGeometry) {
+			AddPrimitive(NULL, NULL, 0, NULL, 0);
+			SaveOptions options;
+			options.compression = COMPRESSION_NONE;
+			options.encode_geometry = true;
+			Geometry geometry;
+			ASSERT_TRUE(RoundTrip(options, &geometry));
+			EXPECT_TRUE(geometry.positions.empty());
+			EXPECT_TRUE(geometry.normals.empty());
+			EXPECT_TRUE(geometry.indices.empty());
+		}
+
+		// Identical buffers are sent once, and both primitives load sharing it.
+		TEST_F(BinaryTest, IdenticalBuffersSentOnce) {
+			const float kPositions[] = { 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.f };
+			const float kNormals[] = { 0.f, 0.f, 1.f, 0.f, 0.f, 1.f, 0.f, 0.f, 1.f };
+			const uint32_t kIndices[] = { 0, 1, 2 };
+			AddPrimitive(kPositions, kNormals, 3, kIndices, 3);
+			AddPrimitive(kPositions, kNormals, 3, kIndices, 3);
+			SaveOptions options;
+			options.compression = COMPRESSION_NONE;
+			SaveReport report;
+			ASSERT_TRUE(Load(Save(options, &report)) != NULL);
+			EXPECT_EQ(0u, report.duplicates);
+			EXPECT_EQ(2u, loaded_pack()->GetByClass<VertexBuffer>().size());
+
+			options.deduplicate = true;
+			Transform* loaded = Load(Save(options, &report));
+			ASSERT_TRUE(loaded != NULL);
+			// The vertex buffer and the index buffer.
+			EXPECT_EQ(2u, report.duplicates);
+			EXPECT_LT(0u, report.bytes_saved);
+			EXPECT_EQ(1u, loaded_pack()->GetByClass<VertexBuffer>().size());
+			EXPECT_EQ(1u, loaded_pack()->GetByClass<IndexBuffer>().size());
+			std::vector<Primitive*> primitives(GetPrimitives(loaded));
+			ASSERT_EQ(2u, primitives.size());
+			EXPECT_NE(primitives[0]->stream_bank(), primitives[1]->stream_bank());
+			EXPECT_EQ(primitives[0]->index_buffer(), primitives[1]->index_buffer());
+			EXPECT_EQ(primitives[0]->stream_bank()->GetVertexStream(Stream::POSITION, 0)->field().buffer(),
+			          primitives[1]->stream_bank()->GetVertexStream(Stream::POSITION, 0)->field().buffer());
+		}
+
+		// Materials with the same param values are sent once, others aren't.
+		TEST_F(BinaryTest, IdenticalMaterialsSentOnce) {
+			const float kShininess[] = { 2.f, 2.f, 3.f };
+
+			for(size_t ii = 0; ii < o3d_arraysize(kShininess); ++ii) {
+				// Different geometry, so that only the materials are duplicates.
+				const float kPositions[] = { float(ii), 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.f };
+				const float kNormals[] = { 0.f, 0.f, 1.f, 0.f, 0.f, 1.f, 0.f, 0.f, float(ii) };
+				const uint32_t kIndices[] = { 0, 1, uint32_t(ii) };
+				AddPrimitive(kPositions, kNormals, 3, kIndices, 3);
+				Material* material = pack()->Create<Material>();
+				material->CreateParam<ParamFloat>("shininess")->set_value(kShininess[ii]);
+				GetPrimitives(root()).back()->set_material(material);
+			}
+
+			SaveOptions options;
+			options.compression = COMPRESSION_NONE;
+			options.deduplicate = true;
+			SaveReport report;
+			Transform* loaded = Load(Save(options, &report));
+			ASSERT_TRUE(loaded != NULL);
+			EXPECT_EQ(1u, report.duplicates);
+			EXPECT_EQ(2u, loaded_pack()->GetByClass<Material>().size());
+			EXPECT_EQ(3u, loaded_pack()->GetByClass<VertexBuffer>().size());
+
+			std::vector<Primitive*> primitives(GetPrimitives(loaded));
+			ASSERT_EQ(3u, primitives.size());
+			int with_two = 0;
+
+			for(size_t ii = 0; ii < primitives.size(); ++ii) {
+				ASSERT_TRUE(primitives[ii]->material() != NULL);
+				ParamFloat* shininess = primitives[ii]->material()->GetParam<ParamFloat>("shininess");
+				ASSERT_TRUE(shininess != NULL);
+
+				if(shininess->value() < 2.5f) {
+					++with_two;
+				}
+			}
+
+			EXPECT_EQ(2, with_two);
+		}
+
+		// Buffers without data are written to at runtime, so each keeps its own.
+		TEST_F(BinaryTest, BuffersWithoutDataNotShared) {
+			for(size_t ii = 0; ii < 2; ++ii) {
+				const float kPositions[] = { float(ii), 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.f };
+				const float kNormals[] = { 0.f, 0.f, 1.f, 0.f, 0.f, 1.f, 0.f, 0.f, float(ii) };
+				const uint32_t kIndices[] = { 0, 1, uint32_t(ii) };
+				AddPrimitive(kPositions, kNormals, 3, kIndices, 3);
+				StreamBank* stream_bank = GetPrimitives(root()).back()->stream_bank();
+				DestinationBuffer* buffer = pack()->Create<DestinationBuffer>();
+				Field* field = buffer->CreateField(FloatField::GetApparentClass(), 3);
+				ASSERT_TRUE(buffer->AllocateElements(3));
+				ASSERT_TRUE(stream_bank->SetVertexStream(Stream::TEXCOORD, 0, field, 0));
+			}
+
+			SaveOptions options;
+			options.compression = COMPRESSION_NONE;
+			options.deduplicate = true;
+			SaveReport report;
+			Transform* loaded = Load(Save(options, &report));
+			ASSERT_TRUE(loaded != NULL);
+			EXPECT_EQ(0u, report.duplicates);
+			EXPECT_EQ(2u, loaded_pack()->GetByClass<DestinationBuffer>().size());
+		}
+
+		// Objects with connected params aren't shared, their params may differ
+		// once evaluated.
+		TEST_F(BinaryTest, ConnectedParamsNotShared) {
+			ParamFloat* source = root()->CreateParam<ParamFloat>("source");
+			source->set_value(2.f);
+
+			for(size_t ii = 0; ii < 2; ++ii) {
+				const float kPositions[] = { float(ii), 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.f };
+				const float kNormals[] = { 0.f, 0.f, 1.f, 0.f, 0.f, 1.f, 0.f, 0.f, float(ii) };
+				const uint32_t kIndices[] = { 0, 1, uint32_t(ii) };
+				AddPrimitive(kPositions, kNormals, 3, kIndices, 3);
+				Primitive* primitive = GetPrimitives(root()).back();
+				Material* material = pack()->Create<Material>();
+				ASSERT_TRUE(material->CreateParam<ParamFloat>("shininess")->Bind(source));
+				primitive->set_material(material);
+			}
+
+			SaveOptions options;
+			options.compression = COMPRESSION_NONE;
+			options.deduplicate = true;
+			SaveReport report;
+			Transform* loaded = Load(Save(options, &report));
+			ASSERT_TRUE(loaded != NULL);
+			EXPECT_EQ(0u, report.duplicates);
+			EXPECT_EQ(2u, loaded_pack()->GetByClass<Material>().size());
+		}
+
+	}  // namespace extra
+}  // namespace o3d
@@ -20,37 +20,86 @@
 namespace o3d {
 	namespace extra {
 
-		void updateBoundingBoxes(Transform& root) {
-			BoundingBox box;
-			// Update children first, and add their bounding box to this
-			// entity's.
-			const TransformRefArray& children(root.GetChildrenRefs());
-
-			for(size_t i(0); i < children.size(); ++i) {
-				Transform& child(*children[i]);
-				updateBoundingBoxes(child);
-				BoundingBox childBox;
-				child.bounding_box().Mul(child.local_matrix(), &childBox);
-				childBox.Add(box, &box);
-			}
+		namespace {
+
+			void computeBoundingBox(Transform& root, bool all) {
+				BoundingBox box;
+				// Transforms whose local matrix is animated can move at any time,
+				// so their parent is never considered up to date.
+				bool dirty(false);
+				// Update children first, and add their bounding box to this
+				// entity's.
+				const TransformRefArray& children(root.GetChildrenRefs());
 
-			// Inflate this entity's bounding box with any geometry
-			// it might contain.
-			const ShapeRefArray& shapes(root.GetShapeRefs());
+				for(size_t i(0); i < children.size(); ++i) {
+					Transform& child(*children[i]);
 
-			for(size_t i(0); i < shapes.size(); ++i) {
-				// TODO:
-				// if (isBillBoardShape(shapes[i])) continue;
-				Shape& shape(*shapes[i]);
-				const ElementRefArray& elements(shape.GetElementRefs());
+					if(all || child.bounding_box_dirty()) {
+						computeBoundingBox(child, all);
+					}
 
-				for(size_t j(0); j < elements.size(); ++j) {
-					Element& element(*elements[j]);
-					element.bounding_box().Add(box, &box);
+					dirty = dirty || child.bounding_box_dirty() ||
+					        child.LocalMatrixHasInputConnection();
+					BoundingBox childBox;
+					child.bounding_box().Mul(child.local_matrix(), &childBox);
+					childBox.Add(box, &box);
+				}
+
+				// An instance contains the subtree of its prototype. The
+				// prototype isn't in the graph and doesn't flag its instances
+				// dirty when it changes, so they are always refitted.
+				Transform* prototype = root.instance_of();
+
+				if(prototype) {
+					if(all || prototype->bounding_box_dirty()) {
+						computeBoundingBox(*prototype, all);
+					}
+
+					dirty = true;
+					BoundingBox prototypeBox;
+					prototype->bounding_box().Mul(prototype->local_matrix(),
+					                              &prototypeBox);
+					prototypeBox.Add(box, &box);
+				}
+
+				// Inflate this entity's bounding box with any geometry
+				// it might contain.
+				const ShapeRefArray& shapes(root.GetShapeRefs());
+
+				for(size_t i(0); i < shapes.size(); ++i) {
+					// TODO:
+					// if (isBillBoardShape(shapes[i])) continue;
+					Shape& shape(*shapes[i]);
+					const ElementRefArray& elements(shape.GetElementRefs());
+
+					for(size_t j(0); j < elements.size(); ++j) {
+						Element& element(*elements[j]);
+
+						if(element.bounding_box_dirty()) {
+							element.UpdateBoundingBox();
+						}
+
+						element.bounding_box().Add(box, &box);
+					}
+				}
+
+				root.set_bounding_box(box);
+
+				if(!dirty) {
+					root.ClearBoundingBoxDirty();
 				}
 			}
 
-			root.set_bounding_box(box);
+		} // anonymous namespace
+
+		void updateBoundingBoxes(Transform& root) {
+			computeBoundingBox(root, true);
+		}
+
+		void refitBoundingBoxes(Transform& root) {
+			if(root.bounding_box_dirty()) {
+				computeBoundingBox(root, false);
+			}
 		}
 
 	} // extra
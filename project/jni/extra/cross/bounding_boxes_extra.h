@@ -27,6 +27,17 @@ namespace o3d {
 		 */
 		void updateBoundingBoxes(Transform& root);
 
+		/** @brief Update the bounding boxes of the dirty transforms of a tree.
+		 *
+		 * Only the transforms flagged by Transform::MarkBoundingBoxDirty are
+		 * visited, and only the elements whose position buffer changed are
+		 * measured again, so this is meant to be called every frame.
+		 * Transforms with an animated local matrix keep their parent dirty.
+		 *
+		 * @param root The root of the tree.
+		 */
+		void refitBoundingBoxes(Transform& root);
+
 	} // extra
 } // o3d
 
@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "extra/cross/resource_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+#include "core/cross/error.h"
+#include "core/cross/file_resource.h"
+#include "core/cross/image_utils.h"
+#include "core/cross/pack.h"
+#include "import/cross/memory_stream.h"
+
+namespace o3d {
+	namespace extra {
+
+		namespace {
+
+			/// Identifies the files of the disk cache, and their version.
+			const char kDiskCacheMagic[8] = { 'O', '3', 'D', 'I', 'M', 'G', '0', '1' };
+
+			/// How a bitmap is described in the disk cache, before its pixels.
+			struct DiskCacheBitmapHeader {
+				uint32_t format;
+				uint32_t width;
+				uint32_t height;
+				uint32_t num_mipmaps;
+				uint32_t semantic;
+			};
+
+			/// Size of the pixels a bitmap allocates, which always has room for all
+			/// the mips.
+			size_t GetBitmapSize(const Bitmap& bitmap) {
+				return bitmap.GetMipChainSize(image::ComputeMipMapCount(bitmap.width(), bitmap.height()));
+			}
+
+		} // anonymous namespace
+
+		const InterfaceId ResourceCache::kInterfaceId =
+		    InterfaceTraits<ResourceCache>::kInterfaceId;
+
+		ResourceCache::ResourceCache(ServiceLocator* service_locator)
+			: mServiceLocator(service_locator),
+			  mService(service_locator, this),
+			  mHits(0),
+			  mMisses(0) {
+		}
+
+		Texture* ResourceCache::GetTexture(Pack& pack, const std::string& uri, const ExternalResource& resource, bool* created) {
+			const Hash hash(HashContent(resource.data(), resource.size()));
+			Texture* texture(FindTexture(pack, hash));
+
+			if(created) *created = !texture;
+
+			if(texture) {
+				return texture;
+			}
+
+			BitmapRefArray bitmaps;
+
+			if(!LoadBitmaps(uri, resource, hash, &bitmaps)) {
+				O3D_ERROR(mServiceLocator) << "Failed to load bitmaps for texture at \"" << uri << "\"";
+				return NULL;
+			}
+
+			texture = pack.CreateTextureFromBitmaps(bitmaps, uri, true);
+
+			if(texture) {
+				AddTexture(hash, texture);
+			}
+
+			return texture;
+		}
+
+		void ResourceCache::AddTexture(Hash hash, Texture* texture) {
+			++mMisses;
+			mTextures[hash] = texture->GetWeakPointer();
+		}
+
+		ResourceCache::Hash ResourceCache::HashContent(const void* data, size_t size, Hash hash) {
+			const uint8_t* bytes(static_cast<const uint8_t*>(data));
+
+			for(size_t ii = 0; ii < size; ++ii) {
+				hash = (hash ^ bytes[ii]) * 1099511628211ULL;
+			}
+
+			return hash ^ (static_cast<uint64_t>(size) * 1099511628211ULL);
+		}
+
+		Texture* ResourceCache::FindTexture(Pack& pack, Hash hash) {
+			TextureMap::iterator found(mTextures.find(hash));
+
+			if(found == mTextures.end()) {
+				return NULL;
+			}
+
+			Texture* texture(found->second.Get());
+
+			if(!texture) {
+				mTextures.erase(found);
+				return NULL;
+			}
+
+			if(!pack.GetObjectById(texture->id())) {
+				pack.RegisterObject(texture);
+			}
+
+			++mHits;
+			return texture;
+		}
+
+		void ResourceCache::Purge() {
+			TextureMap::iterator iter(mTextures.begin());
+
+			while(iter != mTextures.end()) {
+				if(iter->second.Get()) {
+					++iter;
+				}
+				else {
+					mTextures.erase(iter++);
+				}
+			}
+		}
+
+		void ResourceCache::Clear() {
+			mTextures.clear();
+		}
+
+		bool ResourceCache::LoadBitmaps(const std::string& uri, const ExternalResource& resource, Hash hash, BitmapRefArray* bitmaps) {
+			if(!mDiskCacheDirectory.empty() && ReadDiskCache(hash, bitmaps)) {
+				return true;
+			}
+
+			MemoryReadStream mrs(resource.data(), resource.size());
+
+			if(!Bitmap::LoadFromStream(mServiceLocator, &mrs, uri, image::UNKNOWN, bitmaps)) {
+				return false;
+			}
+
+			if(!mDiskCacheDirectory.empty()) {
+				WriteDiskCache(hash, *bitmaps);
+			}
+
+			return true;
+		}
+
+		std::string ResourceCache::GetDiskCachePath(Hash hash) const {
+			char name[32];
+			snprintf(name, sizeof(name), "/%016llx.o3dimg", static_cast<unsigned long long>(hash));
+			return mDiskCacheDirectory + name;
+		}
+
+		bool ResourceCache::ReadDiskCache(Hash hash, BitmapRefArray* bitmaps) {
+			FileResource file(GetDiskCachePath(hash));
+
+			if(!file) {
+				return false;
+			}
+
+			MemoryReadStream stream(file.data(), file.size());
+			char magic[sizeof(kDiskCacheMagic)];
+			uint32_t count(0);
+
+			if(stream.Read(magic, sizeof(magic)) != sizeof(magic) ||
+			        memcmp(magic, kDiskCacheMagic, sizeof(magic)) ||
+			        stream.Read(&count, sizeof(count)) != sizeof(count)) {
+				return false;
+			}
+
+			BitmapRefArray loaded;
+
+			for(uint32_t ii = 0; ii < count; ++ii) {
+				DiskCacheBitmapHeader header;
+
+				if(stream.Read(&header, sizeof(header)) != sizeof(header) ||
+				        header.format == Texture::UNKNOWN_FORMAT ||
+				        header.format > Texture::DXT5 ||
+				        header.width == 0 || header.height == 0 ||
+				        !image::CheckImageDimensions(header.width, header.height) ||
+				        header.num_mipmaps == 0 ||
+				        header.num_mipmaps > image::ComputeMipMapCount(header.width, header.height) ||
+				        header.semantic > Bitmap::SLICE) {
+					return false;
+				}
+
+				Bitmap::Ref bitmap(new Bitmap(mServiceLocator));
+				bitmap->Allocate(static_cast<Texture::Format>(header.format),
+				                 header.width,
+				                 header.height,
+				                 header.num_mipmaps,
+				                 static_cast<Bitmap::Semantic>(header.semantic));
+
+				if(stream.Read(bitmap->image_data(), GetBitmapSize(*bitmap)) != GetBitmapSize(*bitmap)) {
+					return false;
+				}
+
+				loaded.push_back(bitmap);
+			}
+
+			bitmaps->swap(loaded);
+			return !bitmaps->empty();
+		}
+
+		void ResourceCache::WriteDiskCache(Hash hash, const BitmapRefArray& bitmaps) {
+			const std::string path(GetDiskCachePath(hash));
+			// Written under another name first, so that a reader never finds a
+			// partial file.
+			const std::string temp_path(path + ".tmp");
+			FILE* file(fopen(temp_path.c_str(), "wb"));
+
+			if(!file) {
+				O3D_LOG(WARNING) << "Can't write the image cache file " << temp_path;
+				return;
+			}
+
+			const uint32_t count(bitmaps.size());
+			bool written(fwrite(kDiskCacheMagic, sizeof(kDiskCacheMagic), 1, file) == 1 &&
+			             fwrite(&count, sizeof(count), 1, file) == 1);
+
+			for(uint32_t ii = 0; written && ii < count; ++ii) {
+				const Bitmap& bitmap(*bitmaps[ii]);
+				DiskCacheBitmapHeader header = {
+					bitmap.format(),
+					bitmap.width(),
+					bitmap.height(),
+					bitmap.num_mipmaps(),
+					bitmap.semantic(),
+				};
+				written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+				          fwrite(bitmap.image_data(), GetBitmapSize(bitmap), 1, file) == 1;
+			}
+
+			written = fclose(file) == 0 && written;
+
+			if(!written || rename(temp_path.c_str(), path.c_str()) != 0) {
+				O3D_LOG(WARNING) << "Can't write the image cache file " << path;
+				remove(temp_path.c_str());
+			}
+		}
+
+	} // namespace extra
+} // namespace o3d
+
+/* vim: set sw=2 ts=2 sts=2 expandtab ff=unix: */
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <map>
+#include <string>
+#include "core/cross/bitmap.h"
+#include "core/cross/external_resource.h"
+#include "core/cross/service_implementation.h"
+#include "core/cross/texture.h"
+
+namespace o3d {
+	class Pack;
+
+	namespace extra {
+
+		/** @brief Shares the textures of the binary scenes loaded across packs.
+		  *
+		  * When the service is registered, the binary loader asks it for the
+		  * textures of the scenes it loads. The images are still fetched, but a
+		  * texture already loaded from the same content, whatever its URI, is
+		  * added to the loading pack instead of being decoded and uploaded
+		  * again. URIs aren't keys: scenes from different providers can use the
+		  * same relative URI for different images.
+		  *
+		  * The cache only holds weak pointers: a texture lives as long as a pack
+		  * or an object refers to it, and is loaded again once it's gone.
+		  *
+		  * Optionally, the decoded images are also written to a directory, so
+		  * that textures loaded in an earlier run aren't decoded again.
+		  */
+		class ResourceCache {
+		public:
+			static const InterfaceId kInterfaceId;
+
+			typedef uint64_t Hash;
+
+			explicit ResourceCache(ServiceLocator* service_locator);
+
+			/** @brief Get the texture of an image.
+			  *
+			  * @param pack     Pack the texture is added to, or created in.
+			  * @param uri      URI the image was fetched from.
+			  * @param resource Content of the image file.
+			  * @param created  If not NULL, set to whether the texture was created
+			  *                 by this call rather than shared.
+			  * @return The texture, or NULL if the image couldn't be loaded.
+			  */
+			Texture* GetTexture(Pack& pack, const std::string& uri, const ExternalResource& resource, bool* created = NULL);
+
+			/** @brief Get the texture already created from some content.
+			  *
+			  * For images that aren't fetched, like the ones embedded in a scene.
+			  *
+			  * @param pack Pack the texture is added to, if it isn't already in it.
+			  * @param hash Hash of the content, from {HashContent}.
+			  * @return The texture, or NULL if none created from that content is alive.
+			  */
+			Texture* FindTexture(Pack& pack, Hash hash);
+
+			/// Shares a texture created from content hashed <code>hash</code>.
+			void AddTexture(Hash hash, Texture* texture);
+
+			/** @brief 64-bit FNV-1a hash of some content, with its size mixed in
+			  * so that contents differing only in length don't collide.
+			  *
+			  * @param hash The hash of the content before, to hash several
+			  *             pieces as one, or the default to start.
+			  */
+			static Hash HashContent(const void* data, size_t size, Hash hash = 14695981039346656037ULL);
+
+			/** @brief Set the directory decoded images are kept in.
+			  *
+			  * @param directory An existing directory, or an empty string, the
+			  *                  default, to keep no image on disk.
+			  */
+			void set_disk_cache_directory(const std::string& directory) {
+				mDiskCacheDirectory = directory;
+			}
+
+			/// Forgets the textures that were destroyed.
+			void Purge();
+
+			/// Forgets all the textures, which aren't shared with later loads anymore.
+			void Clear();
+
+			/// @return Number of textures found in the cache instead of being loaded.
+			unsigned hits() const {
+				return mHits;
+			}
+
+			/// @return Number of textures loaded.
+			unsigned misses() const {
+				return mMisses;
+			}
+
+		private:
+			typedef std::map<Hash, Texture::WeakPointerType> TextureMap;
+
+			/// Decode an image, from the disk cache if it is there.
+			bool LoadBitmaps(const std::string& uri, const ExternalResource& resource, Hash hash, BitmapRefArray* bitmaps);
+
+			std::string GetDiskCachePath(Hash hash) const;
+			bool ReadDiskCache(Hash hash, BitmapRefArray* bitmaps);
+			void WriteDiskCache(Hash hash, const BitmapRefArray& bitmaps);
+
+			ServiceLocator* mServiceLocator;
+			ServiceImplementation<ResourceCache> mService;
+			TextureMap mTextures;
+			std::string mDiskCacheDirectory;
+			unsigned mHits;
+			unsigned mMisses;
+
+			O3D_DISALLOW_COPY_AND_ASSIGN(ResourceCache);
+		};
+
+	} // namespace extra
+} // namespace o3d
+
+/* vim: set sw=2 ts=2 sts=2 expandtab ff=unix: */
@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file contains the tests of ResourceCache, through the binary loader.
+
+#include <sstream>
+#include "tests/common/win/testing_common.h"
+#include "core/cross/object_manager.h"
+#include "core/cross/pack.h"
+#include "core/cross/service_dependency.h"
+#include "core/cross/texture.h"
+#include "core/cross/transform.h"
+#include "extra/cross/binary.h"
+#include "extra/cross/resource_cache.h"
+
+namespace o3d {
+	namespace extra {
+
+		namespace {
+
+			class StringResource : public ExternalResource {
+			public:
+				explicit StringResource(const std::string& data)
+					: data_(data) {
+				}
+
+				virtual const uint8_t* const data() const {
+					return reinterpret_cast<const uint8_t*>(data_.data());
+				}
+
+				virtual size_t size() const {
+					return data_.size();
+				}
+
+			private:
+				std::string data_;
+			};
+
+			// Serves a 2x2 TGA image filled with one value, whatever the URI.
+			class ImageProvider : public IExternalResourceProvider {
+			public:
+				explicit ImageProvider(uint8_t value)
+					: requests_(0) {
+					static const uint8_t kHeader[18] = {
+						0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 2, 0, 24, 0,
+					};
+					image_.assign(reinterpret_cast<const char*>(kHeader), sizeof(kHeader));
+					image_.append(2 * 2 * 3, static_cast<char>(value));
+				}
+
+				virtual ExternalResource::Ref GetExternalResourceForURI(Pack& pack, const std::string& uri) {
+					++requests_;
+					return ExternalResource::Ref(new StringResource(image_));
+				}
+
+				int requests() const {
+					return requests_;
+				}
+
+			private:
+				std::string image_;
+				int requests_;
+			};
+
+		}  // anonymous namespace
+
+		class ResourceCacheTest : public testing::Test {
+		protected:
+			ResourceCacheTest()
+				: object_manager_(g_service_locator) {
+			}
+
+			virtual void SetUp();
+			virtual void TearDown();
+
+			// Saves the scene, with its images embedded if |provider| is set.
+			std::string Save(IExternalResourceProvider* provider);
+
+			// Loads a scene in a new pack and returns its texture.
+			Texture* Load(const std::string& scene, IExternalResourceProvider& provider);
+
+			ResourceCache* cache() {
+				return cache_;
+			}
+
+			// The texture of the saved scene.
+			Texture* texture() {
+				return texture_;
+			}
+
+		private:
+			ServiceDependency<ObjectManager> object_manager_;
+			ResourceCache* cache_;
+			std::vector<Pack*> packs_;
+			Transform* root_;
+			Texture* texture_;
+		};
+
+		void ResourceCacheTest::SetUp() {
+			cache_ = new ResourceCache(g_service_locator);
+			// A scene whose root refers to a texture by a relative URI.
+			Pack* pack = object_manager_->CreatePack();
+			packs_.push_back(pack);
+			root_ = pack->Create<Transform>();
+			Texture2D* texture = pack->CreateTexture2D(2, 2, Texture::XRGB8, 1, false);
+			ASSERT_TRUE(texture != NULL);
+			texture->CreateParam<ParamString>(O3D_STRING_CONSTANT("original_uri"))->set_value("texture.tga");
+			root_->CreateParam<ParamTexture>("texture")->set_value(texture);
+			texture_ = texture;
+		}
+
+		void ResourceCacheTest::TearDown() {
+			for(size_t ii = 0; ii < packs_.size(); ++ii) {
+				object_manager_->DestroyPack(packs_[ii]);
+			}
+
+			delete cache_;
+		}
+
+		std::string ResourceCacheTest::Save(IExternalResourceProvider* provider) {
+			SaveOptions options;
+			options.compression = COMPRESSION_NONE;
+			options.texture_provider = provider;
+			std::ostringstream stream;
+			EXPECT_TRUE(SaveToBinaryStream(stream, *root_, options));
+			return stream.str();
+		}
+
+		Texture* ResourceCacheTest::Load(const std::string& scene, IExternalResourceProvider& provider) {
+			Pack* pack = object_manager_->CreatePack();
+			packs_.push_back(pack);
+			std::istringstream stream(scene);
+			Transform* root = LoadFromBinaryStream(stream, *pack, provider);
+
+			if(!root) {
+				return NULL;
+			}
+
+			ParamTexture* param = root->GetParam<ParamTexture>("texture");
+			return param ? param->value() : NULL;
+		}
+
+		// The same relative URI, served by two providers, names two images.
+		TEST_F(ResourceCacheTest, SameUriFromTwoProviders) {
+			const std::string scene(Save(NULL));
+			ImageProvider red(0x20);
+			ImageProvider blue(0x80);
+			Texture* first = Load(scene, red);
+			Texture* second = Load(scene, blue);
+			ASSERT_TRUE(first != NULL);
+			ASSERT_TRUE(second != NULL);
+			EXPECT_NE(first, second);
+			EXPECT_EQ(1, red.requests());
+			EXPECT_EQ(1, blue.requests());
+			EXPECT_EQ(0u, cache()->hits());
+			EXPECT_EQ(2u, cache()->misses());
+		}
+
+		// The same bytes are decoded once, even from another provider.
+		TEST_F(ResourceCacheTest, SameContentIsShared) {
+			const std::string scene(Save(NULL));
+			ImageProvider provider(0x20);
+			ImageProvider same(0x20);
+			Texture* first = Load(scene, provider);
+			Texture* second = Load(scene, same);
+			ASSERT_TRUE(first != NULL);
+			EXPECT_EQ(first, second);
+			EXPECT_EQ(1, same.requests());
+			EXPECT_EQ(1u, cache()->hits());
+			EXPECT_EQ(1u, cache()->misses());
+		}
+
+		// A shared texture keeps the name of the scene that loaded it first.
+		TEST_F(ResourceCacheTest, SharedTextureKeepsItsName) {
+			texture()->set_name("wall");
+			const std::string wall(Save(NULL));
+			texture()->set_name("floor");
+			const std::string floor(Save(NULL));
+			ImageProvider provider(0x20);
+			Texture* first = Load(wall, provider);
+			ASSERT_TRUE(first != NULL);
+			EXPECT_EQ("wall", first->name());
+			Texture* second = Load(floor, provider);
+			EXPECT_EQ(first, second);
+			EXPECT_EQ("wall", first->name());
+		}
+
+		// Embedded images are used even when a texture from the same URI is
+		// cached, and are shared with the scenes embedding the same ones.
+		TEST_F(ResourceCacheTest, EmbeddedImagesWin) {
+			ImageProvider red(0x20);
+			ImageProvider blue(0x80);
+			const std::string embedded(Save(&red));
+			Texture* fetched = Load(Save(NULL), blue);
+			Texture* first = Load(embedded, blue);
+			Texture* second = Load(embedded, blue);
+			ASSERT_TRUE(fetched != NULL);
+			ASSERT_TRUE(first != NULL);
+			EXPECT_NE(fetched, first);
+			EXPECT_EQ(first, second);
+			EXPECT_EQ(1, blue.requests());
+			EXPECT_EQ(1u, cache()->hits());
+			EXPECT_EQ(2u, cache()->misses());
+		}
+
+	}  // namespace extra
+}  // namespace o3d
@@ -24,6 +24,7 @@
 #include "core/cross/texture.h"
 #include "core/cross/transform.h"
 #include "core/cross/file_resource.h"
+#include "core/cross/file_texture_source.h"
 #include "primitives.h"
 #include "render_graph.h"
 
@@ -105,6 +106,7 @@ namespace o3d_utils {
 
 		O3D_ASSERT(texture->IsA(Texture2D::GetApparentClass()));
 		texture->set_name(filename);
+		texture->set_source(new FileTextureSource(filename));
 		return down_cast<Texture2D*>(texture);
 	}
 
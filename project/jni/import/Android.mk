@@ -17,6 +17,7 @@ LOCAL_SRC_FILES := $(addprefix cross/, \
   collada.cc \
   collada_zip_archive.cc \
   destination_buffer.cc \
+  mapped_zip_archive.cc \
   memory_stream.cc \
   raw_data.cc \
   zip_archive.cc \
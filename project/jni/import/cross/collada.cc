@@ -35,8 +35,10 @@
 #include "core/cross/class_manager.h"
 #include "core/cross/curve.h"
 #include "core/cross/error.h"
+#include "core/cross/frame_profiler.h"
 #include "core/cross/function.h"
 #include "core/cross/ierror_status.h"
+#include "core/cross/lod_generator.h"
 #include "core/cross/math_utilities.h"
 #include "core/cross/matrix4_axis_rotation.h"
 #include "core/cross/matrix4_composition.h"
@@ -49,6 +51,8 @@
 #include "core/cross/skin.h"
 #include "core/cross/stream.h"
 #include "core/cross/file_resource.h"
+#include "core/cross/file_texture_source.h"
+#include "core/cross/worker_pool.h"
 #include "import/cross/collada.h"
 #include "import/cross/collada_zip_archive.h"
 #include "import/cross/destination_buffer.h"
@@ -106,6 +110,9 @@
 namespace o3d {
 	static const float kPi = 3.14159265358979f;
 
+	// Number of shapes logged a second, as models can have thousands.
+	static const unsigned kLoggedShapesPerSecond = 5;
+
 	const char* Collada::kLightingTypeParamName =
 	    COLLADA_STRING_CONSTANT("lightingType");
 
@@ -287,10 +294,12 @@ namespace o3d {
 	}
 
 	Collada::~Collada() {
+		ClearStagedData();
 		delete collada_zip_archive_;
 	}
 
 	void Collada::ClearData() {
+		ClearStagedData();
 		textures_.clear();
 		effects_.clear();
 		shapes_.clear();
@@ -319,6 +328,7 @@ namespace o3d {
 // Returns true on success.
 	bool Collada::ImportFile(const FilePath& filename, Transform* parent,
 	                         ParamFloat* animation_input) {
+		O3D_PROFILE_ZONE("Collada::ImportFile");
 		O3D_LOG(INFO) << "ImportFile:" << filename.value();
 		// Each time we start a new import, we need to clear out data from
 		// the last import (if any).
@@ -328,7 +338,7 @@ namespace o3d {
 		file_util::AbsolutePath(&base_path_);
 		bool status = false;
 
-		if(ZipArchive::IsZipFile(filename.value())) {
+		if(MappedZipArchive::IsZipFile(filename.value())) {
 			status = ImportZIP(filename, parent, animation_input);
 		}
 		else {
@@ -414,7 +424,11 @@ namespace o3d {
 		FCDocument* doc = FCollada::NewTopDocument();
 
 		if(doc) {
-			bool fc_status = FCollada::LoadDocumentFromFile(doc, filename.value().c_str());
+			bool fc_status;
+			{
+				O3D_PROFILE_ZONE("FCollada::LoadDocumentFromFile");
+				fc_status = FCollada::LoadDocumentFromFile(doc, filename.value().c_str());
+			}
 			status = ImportDAEDocument(doc, fc_status, parent, animation_input);
 			doc->Release();
 		}
@@ -430,6 +444,7 @@ namespace o3d {
 	                                bool fc_status,
 	                                Transform* parent,
 	                                ParamFloat* animation_input) {
+		O3D_PROFILE_ZONE("Collada::ImportDAEDocument");
 		O3D_LOG(INFO) << "ImportDAEDocument:";
 
 		if(!parent) {
@@ -444,6 +459,11 @@ namespace o3d {
 				FMVector3 up(up_axis.getX(), up_axis.getY(), up_axis.getZ());
 				// Transform the document to the given up vector
 				FCDocumentTools::StandardizeUpAxisAndLength(doc, up);
+
+				if(options_.num_threads > 0) {
+					StageConversions(doc);
+				}
+
 				// Import all the textures in the file. Even if they are not used by
 				// materials or models the user put them in the file and might need them
 				// at runtime.
@@ -490,6 +510,8 @@ namespace o3d {
 					delete instance_root_;
 					instance_root_ = NULL;
 				}
+
+				ClearStagedData();
 			}
 		}
 
@@ -1211,6 +1233,230 @@ namespace o3d {
 		return shape;
 	}
 
+	struct Collada::StagedGeometry {
+		StagedGeometry() : mesh(NULL) {}
+		FCDGeometryMesh* mesh;
+		// Old to new vertex indices, as filled by GenerateUniqueIndices().
+		TranslationMap translation_map;
+		// Tangents and binormals converted to the O3D convention, indexed by
+		// source.
+		std::map<size_t, std::vector<float> > flipped_sources;
+	};
+
+	struct Collada::StagedSkin {
+		Skin::InfluencesArray influences;
+	};
+
+	struct Collada::StagedImage {
+		StagedImage() : found(false) {}
+		// Content of the file when importing from a zip archive.
+		MappedZipArchive::Data zip_data;
+		// Where the file was found when importing from the file system.
+		bool found;
+		FilePath found_path;
+		ExternalResource::Ref resource;
+	};
+
+	class Collada::StageGeometryTask : public Closure {
+	public:
+		explicit StageGeometryTask(StagedGeometry* staged)
+			: staged_(staged) {}
+
+		virtual void Run() {
+			O3D_PROFILE_ZONE("Collada::StageGeometryTask");
+			FCDGeometryMesh* mesh = staged_->mesh;
+			FCDGeometryPolygonsTools::Triangulate(mesh);
+			FCDGeometryPolygonsTools::GenerateUniqueIndices(mesh, NULL,
+			        &staged_->translation_map);
+
+			for(size_t s = 0; s < mesh->GetSourceCount(); ++s) {
+				FCDGeometrySource* source = mesh->GetSource(s);
+				Stream::Semantic semantic = C2G3DSemantic(source->GetType());
+
+				// See BuildShape() for why these get negated.
+				if(semantic == Stream::TANGENT || semantic == Stream::BINORMAL) {
+					const float* source_data = source->GetData();
+					size_t num_values = source->GetDataCount();
+					std::vector<float>& values = staged_->flipped_sources[s];
+					values.resize(num_values);
+
+					for(size_t i = 0; i < num_values; ++i) {
+						values[i] = -source_data[i];
+					}
+				}
+			}
+		}
+
+	private:
+		StagedGeometry* staged_;
+	};
+
+	class Collada::StageSkinTask : public Closure {
+	public:
+		StageSkinTask(StagedSkin* staged,
+		              FCDSkinController* skin_controller,
+		              const TranslationMap* translation_map)
+			: staged_(staged),
+			  skin_controller_(skin_controller),
+			  translation_map_(translation_map) {}
+
+		virtual void Run() {
+			O3D_PROFILE_ZONE("Collada::StageSkinTask");
+			size_t num_vertices = 0;
+			TranslationMap::const_iterator end = translation_map_->end();
+
+			for(TranslationMap::const_iterator it = translation_map_->begin();
+			        it != end;
+			        ++it) {
+				num_vertices += it->second.size();
+			}
+
+			// Same as BuildSkinnedShape(): -1 joints refer to the bind shape,
+			// which lives past the last bone.
+			unsigned num_bones = static_cast<unsigned>(skin_controller_->GetJointCount());
+			staged_->influences.resize(num_vertices);
+
+			for(TranslationMap::const_iterator it = translation_map_->begin();
+			        it != end;
+			        ++it) {
+				const FCDSkinControllerVertex* vertex =
+				    skin_controller_->GetVertexInfluence(it->first);
+				size_t num_influences = vertex->GetPairCount();
+				const UInt32List& intlist = it->second;
+
+				for(size_t gg = 0; gg < intlist.size(); ++gg) {
+					Skin::Influences& influences = staged_->influences[intlist[gg]];
+					influences.reserve(num_influences);
+
+					for(size_t jj = 0; jj < num_influences; ++jj) {
+						const FCDJointWeightPair* weight_pair = vertex->GetPair(jj);
+						unsigned index = (weight_pair->jointIndex < 0) ? num_bones : weight_pair->jointIndex;
+						influences.push_back(Skin::Influence(index,
+						                                     weight_pair->weight));
+					}
+				}
+			}
+		}
+
+	private:
+		StagedSkin* staged_;
+		FCDSkinController* skin_controller_;
+		const TranslationMap* translation_map_;
+	};
+
+	class Collada::StageImageTask : public Closure {
+	public:
+		StageImageTask(StagedImage* staged,
+		               const FilePath& file_path,
+		               const ColladaZipArchive* zip_archive,
+		               const std::vector<FilePath>* file_paths)
+			: staged_(staged),
+			  file_path_(file_path),
+			  zip_archive_(zip_archive),
+			  file_paths_(file_paths) {}
+
+		virtual void Run() {
+			O3D_PROFILE_ZONE("Collada::StageImageTask");
+
+			if(zip_archive_) {
+				zip_archive_->GetFileData(file_path_.value(), &staged_->zip_data);
+			}
+			else {
+				staged_->found = FindFile(*file_paths_, file_path_,
+				                          &staged_->found_path);
+
+				if(staged_->found) {
+					staged_->resource = ExternalResource::Ref(
+					                        new FileResource(staged_->found_path.value()));
+				}
+			}
+		}
+
+	private:
+		StagedImage* staged_;
+		FilePath file_path_;
+		const ColladaZipArchive* zip_archive_;
+		const std::vector<FilePath>* file_paths_;
+	};
+
+	void Collada::StageConversions(FCDocument* doc) {
+		O3D_LOG(INFO) << "Collada::StageConversions: " << options_.num_threads
+		              << " threads";
+		WorkerPool pool(options_.num_threads);
+		// Meshes and images are independent from each other.
+		FCDGeometryLibrary* geometry_library = doc->GetGeometryLibrary();
+
+		for(size_t i = 0; i < geometry_library->GetEntityCount(); ++i) {
+			FCDGeometry* geom = geometry_library->GetEntity(i);
+
+			if(!geom->IsMesh()) continue;
+
+			StagedGeometry* staged = new StagedGeometry;
+			staged->mesh = geom->GetMesh();
+			staged_geometries_[geom] = staged;
+			pool.Post(new StageGeometryTask(staged));
+		}
+
+		FCDImageLibrary* image_library = doc->GetImageLibrary();
+
+		for(size_t i = 0; i < image_library->GetEntityCount(); ++i) {
+			FCDImage* image = image_library->GetEntity(i);
+			StagedImage* staged = new StagedImage;
+			staged_images_[image] = staged;
+			pool.Post(new StageImageTask(staged,
+			                             FilePath(std::string(image->GetFilename())),
+			                             collada_zip_archive_,
+			                             &options_.file_paths));
+		}
+
+		// Skins need the translation maps of their base meshes.
+		pool.Wait();
+		FCDControllerLibrary* controller_library = doc->GetControllerLibrary();
+
+		for(size_t i = 0; i < controller_library->GetEntityCount(); ++i) {
+			FCDController* controller = controller_library->GetEntity(i);
+
+			if(!controller->IsSkin()) continue;
+
+			std::map<FCDGeometry*, StagedGeometry*>::iterator geometry =
+			    staged_geometries_.find(controller->GetBaseGeometry());
+
+			if(geometry == staged_geometries_.end()) continue;
+
+			StagedSkin* staged = new StagedSkin;
+			staged_skins_[controller] = staged;
+			pool.Post(new StageSkinTask(staged,
+			                            controller->GetSkinController(),
+			                            &geometry->second->translation_map));
+		}
+
+		pool.Wait();
+	}
+
+	void Collada::ClearStagedData() {
+		for(std::map<FCDGeometry*, StagedGeometry*>::iterator it =
+		            staged_geometries_.begin();
+		        it != staged_geometries_.end(); ++it) {
+			delete it->second;
+		}
+
+		for(std::map<FCDController*, StagedSkin*>::iterator it =
+		            staged_skins_.begin();
+		        it != staged_skins_.end(); ++it) {
+			delete it->second;
+		}
+
+		for(std::map<FCDImage*, StagedImage*>::iterator it =
+		            staged_images_.begin();
+		        it != staged_images_.end(); ++it) {
+			delete it->second;
+		}
+
+		staged_geometries_.clear();
+		staged_skins_.clear();
+		staged_images_.clear();
+	}
+
 // Builds an O3D shape node corresponding to a given FCollada geometry
 // instance.
 	Shape* Collada::BuildShape(FCDocument* doc,
@@ -1218,7 +1464,7 @@ namespace o3d {
 	                           FCDGeometry* geom,
 	                           TranslationMap* translationMap,
 	                           const ObjectBase::Class* buffer_class) {
-		O3D_LOG(INFO) << "Collada::BuildShape\n";
+		O3D_LOG_RATE_LIMITED(INFO, kLoggedShapesPerSecond) << "Collada::BuildShape\n";
 		Shape* shape = NULL;
 		O3D_ASSERT(doc && geom_instance && geom);
 
@@ -1228,8 +1474,17 @@ namespace o3d {
 			shape->set_name(geom_name);
 			FCDGeometryMesh* mesh = geom->GetMesh();
 			O3D_ASSERT(mesh);
-			FCDGeometryPolygonsTools::Triangulate(mesh);
-			FCDGeometryPolygonsTools::GenerateUniqueIndices(mesh, NULL, translationMap);
+			std::map<FCDGeometry*, StagedGeometry*>::const_iterator staged =
+			    staged_geometries_.find(geom);
+
+			if(staged == staged_geometries_.end()) {
+				FCDGeometryPolygonsTools::Triangulate(mesh);
+				FCDGeometryPolygonsTools::GenerateUniqueIndices(mesh, NULL, translationMap);
+			}
+			else if(translationMap) {
+				*translationMap = staged->second->translation_map;
+			}
+
 			size_t num_polygons = mesh->GetPolygonsCount();
 			size_t num_indices = mesh->GetFaceVertexCount();
 
@@ -1295,7 +1550,12 @@ namespace o3d {
 				int stride = source->GetStride();
 				const float* source_data = source->GetData();
 
-				if(semantic == Stream::TANGENT || semantic == Stream::BINORMAL) {
+				if(staged != staged_geometries_.end() &&
+				        staged->second->flipped_sources.count(s)) {
+					fields[s]->SetFromFloats(&staged->second->flipped_sources[s][0],
+					                         stride, 0, num_vertices);
+				}
+				else if(semantic == Stream::TANGENT || semantic == Stream::BINORMAL) {
 					// FCollada uses the convention that the tangent points
 					// along -u and the binormal along -v in model space.
 					// Convert to the more common convention where the tangent
@@ -1412,6 +1672,7 @@ namespace o3d {
 				// Set the vertex streams for this primitive to the common set for this
 				// mesh.
 				primitive->set_stream_bank(stream_bank);
+				GenerateLods(pack_, primitive, options_.lod_levels);
 			}
 		}
 
@@ -1422,7 +1683,7 @@ namespace o3d {
 	                                  FCDControllerInstance* instance,
 	                                  NodeInstance* parent_node_instance,
 	                                  Transform* parent) {
-		O3D_LOG(INFO) << "Collada::BuildSkinnedShape\n";
+		O3D_LOG_RATE_LIMITED(INFO, kLoggedShapesPerSecond) << "Collada::BuildSkinnedShape\n";
 		// TODO(o3d): Handle chained controllers. Morph->Skin->...
 		// TODO(gman): Change this to correctly create the skin, separate from
 		//     ParamArray and SkinEval so that we can support instanced skins.
@@ -1570,11 +1831,25 @@ namespace o3d {
 			// jcayzac: handle -1 indices in <vertex_weights>
 			skin->SetInverseBindPoseMatrix(num_bones, inverse_bind_shape_matrix);
 			// Get Influences.
+			std::map<FCDController*, StagedSkin*>::const_iterator staged =
+			    staged_skins_.find(controller);
+			bool use_staged = staged != staged_skins_.end() &&
+			                  staged->second->influences.size() == num_vertices;
+
+			if(use_staged) {
+				const Skin::InfluencesArray& staged_influences =
+				    staged->second->influences;
+
+				for(size_t ii = 0; ii < num_vertices; ++ii) {
+					skin->SetVertexInfluences(ii, staged_influences[ii]);
+				}
+			}
+
 			// jcayzac: declare influences vector outside the loop, so that
 			// no unnecessary deallocation/reallocation occurs.
 			Skin::Influences influences;
 
-			for(size_t ii = 0; ii < num_vertices; ++ii) {
+			for(size_t ii = 0; !use_staged && ii < num_vertices; ++ii) {
 				// jcayzac: this reset the vector's size, but doesn't touch its memory
 				influences.clear();
 				unsigned old_index = new_to_old_indices[ii];
@@ -1901,23 +2176,39 @@ namespace o3d {
 		if(!tex) {
 			O3D_LOG(INFO) << "BuildTextureFromImage:" << uri.value();
 			Pack* tex_pack = options_.texture_pack ? options_.texture_pack : pack_;
-			std::string tempfile;
+			std::map<FCDImage*, StagedImage*>::iterator staged =
+			    staged_images_.find(image);
 
 			if(collada_zip_archive_) {
-				size_t data_size = 0;
-				char* data = collada_zip_archive_->GetFileData(file_path.value(), &data_size);
+				// Stored entries are decoded straight from the archive mapping.
+				MappedZipArchive::Data local_data;
+				const MappedZipArchive::Data* data = &local_data;
 
-				if(data) {
-					MemoryReadStream stream((const uint8_t*) data, data_size);
+				if(staged != staged_images_.end()) {
+					data = &staged->second->zip_data;
+				}
+				else {
+					collada_zip_archive_->GetFileData(file_path.value(), &local_data);
+				}
+
+				if(data->bytes()) {
+					MemoryReadStream stream(data->bytes(), data->size());
 					tex = Texture::Ref(tex_pack->CreateTextureFromStream(&stream, file_path.value(), true));
-					free(data);
 				}
 			}
 			else {
 				GetRelativePathIfPossible(base_path_, uri, &uri);
 			}
 
-			if(!tex) {
+			if(!tex && staged != staged_images_.end() && staged->second->resource) {
+				tex = Texture::Ref(
+				          tex_pack->CreateTextureFromExternalResource(
+				              uri.value(),
+				              *staged->second->resource,
+				              image::UNKNOWN,
+				              options_.generate_mipmaps));
+			}
+			else if(!tex) {
 				if(!FindFile(options_.file_paths, file_path, &file_path)) {
 					O3D_ERROR(service_locator_) << "Could not find file: " << file_path.value();
 					O3D_LOG(INFO) << "BuildTextureFromImage: could not find file: "
@@ -1932,6 +2223,10 @@ namespace o3d {
 				              resource,
 				              image::UNKNOWN,
 				              options_.generate_mipmaps));
+
+				if(tex) {
+					tex->set_source(new FileTextureSource(file_path.value()));
+				}
 			}
 
 			if(tex) {
@@ -1941,8 +2236,6 @@ namespace o3d {
 				original_uri_param->set_value(original_uri.value());
 			}
 
-			if(tempfile.size() > 0) ZipArchive::DeleteFile(tempfile);
-
 			textures_[tex_id] = tex;
 		}
 
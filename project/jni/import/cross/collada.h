@@ -49,6 +49,7 @@ class FCDCamera;
 class FCDSceneNode;
 class FCDGeometry;
 class FCDGeometryInstance;
+class FCDController;
 class FCDControllerInstance;
 class FCDMaterial;
 class FCDEffect;
@@ -137,7 +138,9 @@ namespace o3d {
 				  up_axis(0.0f, 0.0f, 0.0f),
 				  base_path(FilePath::kCurrentDirectory),
 				  texture_pack(NULL),
-				  store_textures_by_basename(false) {}
+				  store_textures_by_basename(false),
+				  num_threads(0),
+				  lod_levels(0) {}
 			// Whether or not to generate mip-maps on the textures we load.
 			bool generate_mipmaps;
 
@@ -159,6 +162,15 @@ namespace o3d {
 			// When storing and matching textures only the basename will be used.
 			// Ie, "foo/bar/baz.jpg" becomes just "baz.jpg"
 			bool store_textures_by_basename;
+
+			// Number of worker threads used to convert geometries, skins and
+			// to fetch image files before the O3D objects get built. 0 converts
+			// everything serially on the calling thread.
+			unsigned int num_threads;
+
+			// Maximum number of simplified levels of detail to generate for
+			// each triangle list primitive. 0 doesn't generate any.
+			unsigned int lod_levels;
 		};
 
 		// Collada Param Names.
@@ -397,6 +409,16 @@ namespace o3d {
 		// instanced more than once.
 		NodeInstance* FindNodeInstanceFast(FCDSceneNode* node);
 
+		// Converts every mesh, skin and image of the document on a pool of
+		// options_.num_threads workers, ahead of the Build* methods which then
+		// pick up the results instead of doing the work themselves. Only
+		// FCollada data and plain memory are touched by the workers; all O3D
+		// objects are still created on the calling thread.
+		void StageConversions(FCDocument* doc);
+
+		// Frees whatever StageConversions() produced.
+		void ClearStagedData();
+
 		// Clears out any residual data from the last import.  Doesn't
 		// affect the Pack or the options, just intermediate data structures
 		// in this object.
@@ -452,6 +474,17 @@ namespace o3d {
 
 		ColladaZipArchive* collada_zip_archive_;
 
+		// Results of StageConversions(), indexed by FCollada entity.
+		struct StagedGeometry;
+		struct StagedSkin;
+		struct StagedImage;
+		class StageGeometryTask;
+		class StageSkinTask;
+		class StageImageTask;
+		std::map<FCDGeometry*, StagedGeometry*> staged_geometries_;
+		std::map<FCDController*, StagedSkin*> staged_skins_;
+		std::map<FCDImage*, StagedImage*> staged_images_;
+
 		// Some temporaries used by the state importer
 		bool cull_enabled_;
 		bool cull_front_;
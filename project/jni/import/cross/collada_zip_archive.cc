@@ -38,23 +38,20 @@
 #include "base/cross/string_util.h"
 #include "import/cross/collada_zip_archive.h"
 
-using std::vector;
 using std::string;
 
 namespace o3d {
 
 	ColladaZipArchive::ColladaZipArchive(const std::string& zip_filename,
 	                                     int* result)
-		: ZipArchive(zip_filename, result) {
+		: MappedZipArchive(zip_filename, result) {
 		if(result && (*result == 0)) {
 			O3D_LOG(INFO) << "ColladaZipArchive(\"" << zip_filename << "\")";
 			// look through the archive and locate the first file with a .dae extension
-			vector<ZipFileInfo> infolist;
-			GetInformationList(&infolist);
 			bool dae_found = false;
 
-			for(vector<ZipFileInfo>::size_type i = 0; i < infolist.size(); ++i) {
-				const char* name = infolist[i].name.c_str();
+			for(size_t i = 0; i < GetEntryCount(); ++i) {
+				const char* name = GetEntry(i).name.c_str();
 				O3D_LOG(INFO) << "Found file <" << zip_filename << ">/" << name;
 				int length = strlen(name);
 
@@ -62,7 +59,7 @@ namespace o3d {
 					const char* suffix = name + length - 4;
 
 					if(!base::strcasecmp(suffix, ".dae")) {
-						dae_pathname_ = name;
+						dae_pathname_ = std::string("/") + name;
 						dae_directory_ = dae_pathname_;
 						RemoveLastPathComponent(&dae_directory_);
 						dae_found = true;
@@ -80,7 +77,7 @@ namespace o3d {
 
 // Convert paths relative to the collada file to archive paths
 	char*  ColladaZipArchive::GetColladaAssetData(const string& filename,
-	        size_t* size) {
+	        size_t* size) const {
 		return GetRelativeFileData(filename, dae_directory_, size);
 	}
 }  // end namespace o3d
@@ -38,14 +38,14 @@
 #ifndef O3D_IMPORT_CROSS_COLLADA_ZIP_ARCHIVE_H_
 #define O3D_IMPORT_CROSS_COLLADA_ZIP_ARCHIVE_H_
 
-#include "import/cross/zip_archive.h"
+#include "import/cross/mapped_zip_archive.h"
 
 #include <string>
 #include <vector>
 
 namespace o3d {
 
-	class ColladaZipArchive : public ZipArchive {
+	class ColladaZipArchive : public MappedZipArchive {
 	public:
 		ColladaZipArchive(const std::string& zip_filename, int* result);
 
@@ -58,8 +58,8 @@ namespace o3d {
 		// Returns NULL if |filename| doesn't match any in the archive
 		// or an error occurs.  The caller must call free() on the returned pointer
 		//
-		virtual char*  GetColladaAssetData(const std::string& filename,
-		                                   size_t* size);
+		char*  GetColladaAssetData(const std::string& filename,
+		                           size_t* size) const;
 
 		const std::string& GetColladaPath() const { return dae_pathname_; }
 		const std::string& GetColladaDirectory() const { return dae_directory_; }
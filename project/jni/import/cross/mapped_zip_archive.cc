@@ -0,0 +1,345 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "import/cross/mapped_zip_archive.h"
+#include "base/cross/log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+namespace o3d {
+
+	namespace {
+
+		const uint32_t kLocalHeaderSignature = 0x04034b50;
+		const uint32_t kCentralHeaderSignature = 0x02014b50;
+		const uint32_t kEndOfCentralDirectorySignature = 0x06054b50;
+		const size_t kLocalHeaderSize = 30;
+		const size_t kCentralHeaderSize = 46;
+		const size_t kEndOfCentralDirectorySize = 22;
+		// The end of central directory record is followed by a comment of at
+		// most 64KB.
+		const size_t kMaxCommentSize = 0xffff;
+
+		const unsigned kMethodStored = 0;
+		const unsigned kMethodDeflated = 8;
+		const unsigned kFlagEncrypted = 1;
+
+		inline uint16_t ReadUInt16(const uint8_t* p) {
+			return static_cast<uint16_t>(p[0] | (p[1] << 8));
+		}
+
+		inline uint32_t ReadUInt32(const uint8_t* p) {
+			return static_cast<uint32_t>(p[0]) |
+			       (static_cast<uint32_t>(p[1]) << 8) |
+			       (static_cast<uint32_t>(p[2]) << 16) |
+			       (static_cast<uint32_t>(p[3]) << 24);
+		}
+
+		// The archive is rooted at '/', but names are stored without it.
+		inline std::string ActualFilename(const std::string& filename) {
+			return filename.find('/') == 0 ? filename.substr(1) : filename;
+		}
+
+	}  // anonymous namespace
+
+	struct MappedZipArchive::Reader::Inflater {
+		z_stream stream;
+	};
+
+	MappedZipArchive::Reader::Reader(const MappedZipArchive& archive,
+	                                 const Entry& entry)
+		: data_(archive.data(entry)),
+		  remaining_(entry.method == kMethodStored ? entry.uncompressed_size
+		             : entry.compressed_size),
+		  inflater_(NULL),
+		  failed_(false) {
+		if(entry.method == kMethodDeflated) {
+			inflater_ = new Inflater;
+			memset(&inflater_->stream, 0, sizeof(inflater_->stream));
+
+			// Negative window bits: raw deflate data, without zlib header.
+			if(inflateInit2(&inflater_->stream, -MAX_WBITS) != Z_OK) {
+				delete inflater_;
+				inflater_ = NULL;
+				failed_ = true;
+			}
+			else {
+				inflater_->stream.next_in = const_cast<Bytef*>(data_);
+				inflater_->stream.avail_in = static_cast<uInt>(remaining_);
+			}
+		}
+		else if(entry.method != kMethodStored) {
+			O3D_LOG(ERROR) << "Unsupported compression method " << entry.method
+			               << " for " << entry.name;
+			failed_ = true;
+		}
+	}
+
+	MappedZipArchive::Reader::~Reader() {
+		if(inflater_) {
+			inflateEnd(&inflater_->stream);
+			delete inflater_;
+		}
+	}
+
+	size_t MappedZipArchive::Reader::Read(void* buffer, size_t size) {
+		if(failed_ || size == 0) return 0;
+
+		if(!inflater_) {
+			size_t bytes_to_read = size < remaining_ ? size : remaining_;
+			memcpy(buffer, data_, bytes_to_read);
+			data_ += bytes_to_read;
+			remaining_ -= bytes_to_read;
+			return bytes_to_read;
+		}
+
+		z_stream& stream = inflater_->stream;
+		stream.next_out = static_cast<Bytef*>(buffer);
+		stream.avail_out = static_cast<uInt>(size);
+		int status = inflate(&stream, Z_SYNC_FLUSH);
+
+		if(status != Z_OK && status != Z_STREAM_END) {
+			O3D_LOG(ERROR) << "Corrupted zip entry (zlib error " << status << ")";
+			failed_ = true;
+		}
+
+		return size - stream.avail_out;
+	}
+
+	MappedZipArchive::Data::Data()
+		: bytes_(NULL),
+		  size_(0),
+		  buffer_(NULL) {
+	}
+
+	MappedZipArchive::Data::~Data() {
+		free(buffer_);
+	}
+
+	MappedZipArchive::MappedZipArchive(const std::string& zip_filename,
+	                                   int* result)
+		: file_(zip_filename) {
+		bool ok = file_ && ReadCentralDirectory();
+
+		if(result) *result = ok ? 0 : -1;
+	}
+
+	MappedZipArchive::~MappedZipArchive() {
+	}
+
+	bool MappedZipArchive::ReadCentralDirectory() {
+		const uint8_t* begin = file_.data();
+		size_t size = file_.size();
+
+		if(size < kEndOfCentralDirectorySize) return false;
+
+		// Look for the end of central directory record, backwards.
+		const uint8_t* eocd = NULL;
+		size_t lowest = size > kEndOfCentralDirectorySize + kMaxCommentSize ?
+		                size - kEndOfCentralDirectorySize - kMaxCommentSize : 0;
+
+		for(size_t offset = size - kEndOfCentralDirectorySize + 1; offset-- > lowest;) {
+			if(ReadUInt32(begin + offset) == kEndOfCentralDirectorySignature) {
+				eocd = begin + offset;
+				break;
+			}
+		}
+
+		if(!eocd) return false;
+
+		size_t num_entries = ReadUInt16(eocd + 10);
+		size_t directory_offset = ReadUInt32(eocd + 16);
+		entries_.reserve(num_entries);
+
+		for(size_t i = 0; i < num_entries; ++i) {
+			if(directory_offset + kCentralHeaderSize > size) return false;
+
+			const uint8_t* header = begin + directory_offset;
+
+			if(ReadUInt32(header) != kCentralHeaderSignature) return false;
+
+			size_t name_length = ReadUInt16(header + 28);
+			size_t header_length = kCentralHeaderSize + name_length +
+			                       ReadUInt16(header + 30) + ReadUInt16(header + 32);
+
+			if(directory_offset + header_length > size) return false;
+
+			Entry entry;
+			entry.name.assign(reinterpret_cast<const char*>(header) + kCentralHeaderSize,
+			                  name_length);
+			entry.method = ReadUInt16(header + 10);
+			entry.compressed_size = ReadUInt32(header + 20);
+			entry.uncompressed_size = ReadUInt32(header + 24);
+			size_t local_offset = ReadUInt32(header + 42);
+			directory_offset += header_length;
+
+			if(ReadUInt16(header + 8) & kFlagEncrypted) {
+				O3D_LOG(WARNING) << "Skipping encrypted zip entry " << entry.name;
+				continue;
+			}
+
+			// The local header repeats the name but may have its own extra
+			// field, so the data offset has to be read from there.
+			if(local_offset + kLocalHeaderSize > size) return false;
+
+			const uint8_t* local_header = begin + local_offset;
+
+			if(ReadUInt32(local_header) != kLocalHeaderSignature) return false;
+
+			entry.data_offset = local_offset + kLocalHeaderSize +
+			                    ReadUInt16(local_header + 26) +
+			                    ReadUInt16(local_header + 28);
+
+			if(entry.data_offset > size ||
+			   entry.compressed_size > size - entry.data_offset) return false;
+
+			// Stored entries are handed out in place for their uncompressed
+			// size, so both sizes have to agree.
+			if(entry.method == kMethodStored &&
+			   entry.compressed_size != entry.uncompressed_size) {
+				O3D_LOG(ERROR) << "Stored zip entry " << entry.name
+				               << " has mismatched sizes";
+				return false;
+			}
+
+			index_[entry.name] = entries_.size();
+			entries_.push_back(entry);
+		}
+
+		return true;
+	}
+
+	const MappedZipArchive::Entry* MappedZipArchive::FindEntry(
+	    const std::string& filename) const {
+		std::tr1::unordered_map<std::string, size_t>::const_iterator it =
+		    index_.find(ActualFilename(filename));
+		return it == index_.end() ? NULL : &entries_[it->second];
+	}
+
+	bool MappedZipArchive::GetFileData(const std::string& filename,
+	                                   Data* data) const {
+		const Entry* entry = FindEntry(filename);
+
+		if(!entry) {
+			O3D_LOG(ERROR) << "file " << filename << " not found in the zipfile";
+			return false;
+		}
+
+		free(data->buffer_);
+		data->buffer_ = NULL;
+
+		if(entry->method == kMethodStored) {
+			data->bytes_ = this->data(*entry);
+			data->size_ = entry->uncompressed_size;
+			return true;
+		}
+
+		size_t size = 0;
+		data->buffer_ = GetFileData(filename, &size);
+		data->bytes_ = reinterpret_cast<const uint8_t*>(data->buffer_);
+		data->size_ = size;
+		return data->buffer_ != NULL;
+	}
+
+	char* MappedZipArchive::GetFileData(const std::string& filename,
+	                                    size_t* size) const {
+		const Entry* entry = FindEntry(filename);
+
+		if(!entry) {
+			O3D_LOG(ERROR) << "file " << filename << " not found in the zipfile";
+			return NULL;
+		}
+
+		// The central directory gives the exact size, so there is a single
+		// allocation and no intermediate buffer.
+		char* buffer = static_cast<char*>(malloc(entry->uncompressed_size + 1));
+
+		if(!buffer) return NULL;
+
+		Reader reader(*this, *entry);
+		size_t total = 0;
+
+		while(total < entry->uncompressed_size) {
+			size_t bytes_read = reader.Read(buffer + total,
+			                                entry->uncompressed_size - total);
+
+			if(bytes_read == 0) break;
+
+			total += bytes_read;
+		}
+
+		if(reader.failed() || total != entry->uncompressed_size) {
+			O3D_LOG(ERROR) << "error reading " << filename << " from the zipfile";
+			free(buffer);
+			return NULL;
+		}
+
+		buffer[total] = 0;
+
+		if(size) *size = total;
+
+		return buffer;
+	}
+
+	char* MappedZipArchive::GetRelativeFileData(const std::string& relative_path,
+	        const std::string& root_path,
+	        size_t* size) const {
+		std::string path(relative_path);
+
+		if(path.empty() || path[0] != '/') {
+			std::string base_path(root_path);
+
+			while(path.size() >= 2 && path[0] == '.' && path[1] == '/') {
+				path = path.substr(2);  // strip off leading ./'s
+			}
+
+			while(path.find("../") == 0) {
+				path = path.substr(3);  // strip off a leading ../
+				RemoveLastPathComponent(&base_path);
+			}
+
+			path = base_path + path;
+		}
+
+		return GetFileData(path, size);
+	}
+
+	bool MappedZipArchive::IsZipFile(const std::string& filename) {
+		int result;
+		MappedZipArchive archive(filename, &result);
+		return result == 0;
+	}
+
+	void MappedZipArchive::RemoveLastPathComponent(std::string* path) {
+		// This gets rid of trailing slashes, if any.
+		while(!path->empty() && (*path)[path->size() - 1] == '/') {
+			path->resize(path->size() - 1);
+		}
+
+		std::string::size_type index = path->find_last_of('/');
+
+		if(index == std::string::npos) {
+			*path = "";
+		}
+		else {
+			path->resize(index + 1);  // keep a trailing '/'
+		}
+	}
+
+}  // namespace o3d
+
+/* vim: set sw=2 ts=2 sts=2 expandtab ff=unix: */
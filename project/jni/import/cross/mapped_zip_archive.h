@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <tr1/unordered_map>
+#include "base/cross/config.h"
+#include "core/cross/file_resource.h"
+
+namespace o3d {
+
+	// A read-only zip archive that maps the whole file in memory and indexes
+	// its central directory once, when opened.
+	//
+	// Stored entries are handed out without any copy; deflated entries are
+	// inflated straight from the mapping, either at once or in chunks with a
+	// Reader. The archive is never modified after it has been opened, so
+	// entries may be read concurrently from several threads.
+	//
+	// Entry names follow the ZipArchive convention: paths use '/' and may
+	// start with a '/' standing for the root of the archive.
+	class MappedZipArchive {
+	public:
+		struct Entry {
+			// Name as stored in the archive, without any leading '/'.
+			std::string name;
+			// 0 (stored) or 8 (deflated). Other methods can't be read.
+			unsigned method;
+			size_t compressed_size;
+			size_t uncompressed_size;
+			// Offset of the entry data from the start of the file.
+			size_t data_offset;
+		};
+
+		// Reads an entry sequentially, inflating it on the fly if needed.
+		class Reader {
+		public:
+			Reader(const MappedZipArchive& archive, const Entry& entry);
+			~Reader();
+
+			// Similar to fread(): copies at most |size| bytes into |buffer| and
+			// returns how many were copied. Returns 0 at the end of the entry or
+			// on error.
+			size_t Read(void* buffer, size_t size);
+
+			// Whether the entry couldn't be read completely.
+			bool failed() const {
+				return failed_;
+			}
+
+		private:
+			struct Inflater;
+			const uint8_t* data_;
+			size_t remaining_;
+			Inflater* inflater_;
+			bool failed_;
+
+			O3D_DISALLOW_COPY_AND_ASSIGN(Reader);
+		};
+
+		// The content of an entry. Points straight into the mapping for stored
+		// entries, to an inflated copy owned by this object otherwise.
+		class Data {
+		public:
+			Data();
+			~Data();
+
+			const uint8_t* bytes() const {
+				return bytes_;
+			}
+			size_t size() const {
+				return size_;
+			}
+
+		private:
+			friend class MappedZipArchive;
+			const uint8_t* bytes_;
+			size_t size_;
+			char* buffer_;
+
+			O3D_DISALLOW_COPY_AND_ASSIGN(Data);
+		};
+
+		// Returns 0 in |result| on success.
+		MappedZipArchive(const std::string& zip_filename, int* result);
+		virtual ~MappedZipArchive();
+
+		size_t GetEntryCount() const {
+			return entries_.size();
+		}
+		const Entry& GetEntry(size_t index) const {
+			return entries_[index];
+		}
+
+		// Returns NULL if |filename| doesn't match any entry.
+		const Entry* FindEntry(const std::string& filename) const;
+
+		// Gets the content of |filename| in |data|, inflating it if needed.
+		// Returns false if there is no such entry or it can't be read.
+		bool GetFileData(const std::string& filename, Data* data) const;
+
+		// Same as ZipArchive::GetFileData(): the caller must free() the
+		// returned buffer, which holds an extra terminating zero byte.
+		char* GetFileData(const std::string& filename, size_t* size) const;
+
+		// Same as GetFileData(), |relative_path| being taken relative to
+		// |root_path| and possibly containing "../" elements.
+		char* GetRelativeFileData(const std::string& relative_path,
+		                          const std::string& root_path,
+		                          size_t* size) const;
+
+		// Tests the given file to see if it is a zip file this class can read.
+		static bool IsZipFile(const std::string& filename);
+
+		// Assumes |path| is UTF8 with '/' as the path separator.
+		static void RemoveLastPathComponent(std::string* path);
+
+	private:
+		bool ReadCentralDirectory();
+
+		const uint8_t* data(const Entry& entry) const {
+			return file_.data() + entry.data_offset;
+		}
+
+		FileResource file_;
+		std::vector<Entry> entries_;
+		std::tr1::unordered_map<std::string, size_t> index_;
+
+		O3D_DISALLOW_COPY_AND_ASSIGN(MappedZipArchive);
+	};
+
+}  // namespace o3d
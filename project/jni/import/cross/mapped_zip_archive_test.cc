@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file contains unit tests for the memory-mapped zip archive.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "tests/common/win/testing_common.h"
+#include "import/cross/mapped_zip_archive.h"
+
+namespace o3d {
+
+	namespace {
+
+		void AppendUInt16(std::string* out, unsigned value) {
+			out->push_back(static_cast<char>(value & 0xff));
+			out->push_back(static_cast<char>((value >> 8) & 0xff));
+		}
+
+		void AppendUInt32(std::string* out, unsigned value) {
+			AppendUInt16(out, value & 0xffff);
+			AppendUInt16(out, value >> 16);
+		}
+
+		struct TestEntry {
+			std::string name;
+			std::string content;
+			bool deflate;
+		};
+
+		// Writes a minimal zip file holding |entries|.
+		std::string MakeZip(const std::vector<TestEntry>& entries) {
+			std::string zip;
+			std::string directory;
+
+			for(size_t i = 0; i < entries.size(); ++i) {
+				const TestEntry& entry = entries[i];
+				std::string data = entry.content;
+
+				if(entry.deflate) {
+					z_stream stream;
+					memset(&stream, 0, sizeof(stream));
+					deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS,
+					             8, Z_DEFAULT_STRATEGY);
+					data.resize(deflateBound(&stream, entry.content.size()));
+					stream.next_in = (Bytef*) entry.content.data();
+					stream.avail_in = entry.content.size();
+					stream.next_out = (Bytef*) &data[0];
+					stream.avail_out = data.size();
+					deflate(&stream, Z_FINISH);
+					data.resize(stream.total_out);
+					deflateEnd(&stream);
+				}
+
+				unsigned crc = crc32(0, (const Bytef*) entry.content.data(),
+				                     entry.content.size());
+				unsigned offset = zip.size();
+				AppendUInt32(&zip, 0x04034b50);
+				AppendUInt16(&zip, 20);
+				AppendUInt16(&zip, 0);
+				AppendUInt16(&zip, entry.deflate ? 8 : 0);
+				AppendUInt32(&zip, 0);
+				AppendUInt32(&zip, crc);
+				AppendUInt32(&zip, data.size());
+				AppendUInt32(&zip, entry.content.size());
+				AppendUInt16(&zip, entry.name.size());
+				AppendUInt16(&zip, 4);
+				zip += entry.name;
+				zip += "pad!";
+				zip += data;
+				AppendUInt32(&directory, 0x02014b50);
+				AppendUInt16(&directory, 20);
+				AppendUInt16(&directory, 20);
+				AppendUInt16(&directory, 0);
+				AppendUInt16(&directory, entry.deflate ? 8 : 0);
+				AppendUInt32(&directory, 0);
+				AppendUInt32(&directory, crc);
+				AppendUInt32(&directory, data.size());
+				AppendUInt32(&directory, entry.content.size());
+				AppendUInt16(&directory, entry.name.size());
+				AppendUInt16(&directory, 0);
+				AppendUInt16(&directory, 0);
+				AppendUInt16(&directory, 0);
+				AppendUInt16(&directory, 0);
+				AppendUInt32(&directory, 0);
+				AppendUInt32(&directory, offset);
+				directory += entry.name;
+			}
+
+			unsigned directory_offset = zip.size();
+			zip += directory;
+			AppendUInt32(&zip, 0x06054b50);
+			AppendUInt16(&zip, 0);
+			AppendUInt16(&zip, 0);
+			AppendUInt16(&zip, entries.size());
+			AppendUInt16(&zip, entries.size());
+			AppendUInt32(&zip, directory.size());
+			AppendUInt32(&zip, directory_offset);
+			AppendUInt16(&zip, 0);
+			return zip;
+		}
+
+		// Overwrites the little endian 32 bit value at |offset| of |zip|.
+		void PatchUInt32(std::string* zip, size_t offset, unsigned value) {
+			std::string bytes;
+			AppendUInt32(&bytes, value);
+			zip->replace(offset, bytes.size(), bytes);
+		}
+
+		// Writes |zip| to a temporary file and returns its name.
+		std::string WriteTemporaryZip(const std::string& zip) {
+			char path[] = "/tmp/mapped_zip_archive_testXXXXXX";
+			int fd = mkstemp(path);
+
+			if(fd < 0) return std::string();
+
+			ssize_t written = write(fd, zip.data(), zip.size());
+			close(fd);
+
+			if(written != static_cast<ssize_t>(zip.size())) {
+				unlink(path);
+				return std::string();
+			}
+
+			return path;
+		}
+
+		// Offset of the first central directory header of |zip|.
+		size_t DirectoryOffset(const std::string& zip) {
+			const unsigned char* eocd =
+			    reinterpret_cast<const unsigned char*>(zip.data()) + zip.size() - 22;
+			return eocd[16] | (eocd[17] << 8) | (eocd[18] << 16) |
+			       (static_cast<size_t>(eocd[19]) << 24);
+		}
+
+	}  // anonymous namespace
+
+	class MappedZipArchiveTest : public testing::Test {
+	protected:
+		virtual void SetUp() {
+			big_.reserve(100000);
+
+			for(int i = 0; i < 100000; ++i) {
+				big_.push_back(static_cast<char>('a' + (i * 7) % 13));
+			}
+
+			std::vector<TestEntry> entries(3);
+			entries[0].name = "models/scene.dae";
+			entries[0].content = "<COLLADA/>";
+			entries[0].deflate = false;
+			entries[1].name = "images/big.png";
+			entries[1].content = big_;
+			entries[1].deflate = true;
+			entries[2].name = "empty.txt";
+			entries[2].deflate = true;
+			char path[] = "/tmp/mapped_zip_archive_testXXXXXX";
+			int fd = mkstemp(path);
+			ASSERT_GE(fd, 0);
+			std::string zip = MakeZip(entries);
+			ASSERT_EQ(static_cast<ssize_t>(zip.size()),
+			          write(fd, zip.data(), zip.size()));
+			close(fd);
+			filename_ = path;
+		}
+
+		virtual void TearDown() {
+			unlink(filename_.c_str());
+		}
+
+		std::string filename_;
+		std::string big_;
+	};
+
+	TEST_F(MappedZipArchiveTest, Index) {
+		int result = -1;
+		MappedZipArchive archive(filename_, &result);
+		ASSERT_EQ(0, result);
+		EXPECT_EQ(3u, archive.GetEntryCount());
+		EXPECT_EQ("models/scene.dae", archive.GetEntry(0).name);
+		EXPECT_TRUE(archive.FindEntry("/images/big.png") != NULL);
+		EXPECT_TRUE(archive.FindEntry("images/big.png") != NULL);
+		EXPECT_TRUE(archive.FindEntry("images/BIG.png") == NULL);
+		EXPECT_TRUE(MappedZipArchive::IsZipFile(filename_));
+		EXPECT_FALSE(MappedZipArchive::IsZipFile(filename_ + ".missing"));
+	}
+
+	TEST_F(MappedZipArchiveTest, StoredEntryIsNotCopied) {
+		int result = -1;
+		MappedZipArchive archive(filename_, &result);
+		ASSERT_EQ(0, result);
+		MappedZipArchive::Data data;
+		ASSERT_TRUE(archive.GetFileData("/models/scene.dae", &data));
+		EXPECT_EQ("<COLLADA/>", std::string((const char*) data.bytes(), data.size()));
+		MappedZipArchive::Data again;
+		ASSERT_TRUE(archive.GetFileData("models/scene.dae", &again));
+		EXPECT_EQ(data.bytes(), again.bytes());
+	}
+
+	TEST_F(MappedZipArchiveTest, DeflatedEntry) {
+		int result = -1;
+		MappedZipArchive archive(filename_, &result);
+		ASSERT_EQ(0, result);
+		size_t size = 0;
+		char* data = archive.GetFileData("/images/big.png", &size);
+		ASSERT_TRUE(data != NULL);
+		EXPECT_EQ(big_.size(), size);
+		EXPECT_EQ(0, data[size]);
+		EXPECT_TRUE(big_ == std::string(data, size));
+		free(data);
+		data = archive.GetFileData("empty.txt", &size);
+		ASSERT_TRUE(data != NULL);
+		EXPECT_EQ(0u, size);
+		free(data);
+		EXPECT_TRUE(archive.GetFileData("missing", &size) == NULL);
+	}
+
+	TEST_F(MappedZipArchiveTest, StreamingReader) {
+		int result = -1;
+		MappedZipArchive archive(filename_, &result);
+		ASSERT_EQ(0, result);
+		const MappedZipArchive::Entry* entry = archive.FindEntry("images/big.png");
+		ASSERT_TRUE(entry != NULL);
+		MappedZipArchive::Reader reader(archive, *entry);
+		std::string content;
+		char chunk[333];
+		size_t bytes_read;
+
+		while((bytes_read = reader.Read(chunk, sizeof(chunk))) > 0) {
+			content.append(chunk, bytes_read);
+		}
+
+		EXPECT_FALSE(reader.failed());
+		EXPECT_TRUE(big_ == content);
+	}
+
+	TEST_F(MappedZipArchiveTest, RelativePaths) {
+		int result = -1;
+		MappedZipArchive archive(filename_, &result);
+		ASSERT_EQ(0, result);
+		size_t size = 0;
+		char* data = archive.GetRelativeFileData("../images/big.png",
+		             "/models/", &size);
+		ASSERT_TRUE(data != NULL);
+		EXPECT_EQ(big_.size(), size);
+		free(data);
+	}
+
+	TEST(MappedZipArchiveCorruptTest, StoredSizesMustAgree) {
+		std::vector<TestEntry> entries(1);
+		entries[0].name = "scene.dae";
+		entries[0].content = "<COLLADA/>";
+		entries[0].deflate = false;
+		std::string zip = MakeZip(entries);
+		// Claim a larger uncompressed size than what is stored.
+		PatchUInt32(&zip, DirectoryOffset(zip) + 24, 1 << 20);
+		std::string filename = WriteTemporaryZip(zip);
+		ASSERT_FALSE(filename.empty());
+		int result = 0;
+		MappedZipArchive archive(filename, &result);
+		EXPECT_NE(0, result);
+		EXPECT_TRUE(archive.FindEntry("scene.dae") == NULL);
+		unlink(filename.c_str());
+	}
+
+	TEST(MappedZipArchiveCorruptTest, EntryPastTheEnd) {
+		std::vector<TestEntry> entries(1);
+		entries[0].name = "scene.dae";
+		entries[0].content = "<COLLADA/>";
+		entries[0].deflate = false;
+		std::string zip = MakeZip(entries);
+		// Both sizes agree, but run past the end of the file.
+		size_t header = DirectoryOffset(zip);
+		PatchUInt32(&zip, header + 20, 0xfffffff0u);
+		PatchUInt32(&zip, header + 24, 0xfffffff0u);
+		std::string filename = WriteTemporaryZip(zip);
+		ASSERT_FALSE(filename.empty());
+		int result = 0;
+		MappedZipArchive archive(filename, &result);
+		EXPECT_NE(0, result);
+		EXPECT_TRUE(archive.FindEntry("scene.dae") == NULL);
+		unlink(filename.c_str());
+	}
+
+}  // namespace o3d
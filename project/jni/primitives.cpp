@@ -60,16 +60,8 @@ namespace o3d_utils {
 	 *     on.
 	 */
 	void Primitives::SetBoundingBoxAndZSortPoint(Element* element) {
-		BoundingBox boundingBox;
-		element->GetBoundingBox(0, &boundingBox);
-		Point3 minExtent = boundingBox.min_extent();
-		Point3 maxExtent = boundingBox.max_extent();
-		element->set_bounding_box(boundingBox);
+		element->UpdateBoundingBox();
 		element->set_cull(true);
-		element->set_z_sort_point(Float3(
-		                              (minExtent.getX() + maxExtent.getX()) / 2.0f,
-		                              (minExtent.getY() + maxExtent.getY()) / 2.0f,
-		                              (minExtent.getZ() + maxExtent.getZ()) / 2.0f));
 	};
 
 	void Primitives::ApplyMatrix(
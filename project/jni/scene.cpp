@@ -259,6 +259,92 @@ namespace o3d_utils {
 	}
 
 
+	BinarySceneLoader::BinarySceneLoader(
+	    Client* client,
+	    ViewInfo* view_info,
+	    const std::string& filename,
+	    extra::IExternalResourceProvider& external_resource_provider)
+		: view_info_(view_info),
+		  pack_(client->CreatePack()),
+		  stream_(filename.c_str(), std::ios::in | std::ios::binary),
+		  loader_(NULL) {
+		if(stream_.is_open()) {
+			loader_ = new extra::BinaryStreamLoader(
+			    stream_, *pack_, external_resource_provider, this);
+		}
+		else {
+			O3D_LOG(ERROR) << "Can't open " << filename;
+		}
+	}
+
+	BinarySceneLoader::~BinarySceneLoader() {
+		delete loader_;
+
+		// The pack is still ours if Finish() didn't hand it over.
+		if(pack_) {
+			Transform* root = pack_->root();
+
+			if(root) root->SetParent(NULL);
+
+			pack_->service_locator()->GetService<ObjectManager>()->DestroyPack(pack_);
+		}
+	}
+
+	bool BinarySceneLoader::Step(float budget_ms) {
+		if(!loader_) return false;
+
+		if(loader_->status() == extra::BinaryStreamLoader::STATUS_LOADING &&
+		        loader_->Step(budget_ms) == extra::BinaryStreamLoader::STATUS_LOADING) {
+			return true;
+		}
+
+		return false;
+	}
+
+	float BinarySceneLoader::progress() const {
+		return loader_ ? loader_->progress() : 0.0f;
+	}
+
+	Transform* BinarySceneLoader::root() const {
+		return loader_ ? loader_->root() : NULL;
+	}
+
+	Scene* BinarySceneLoader::Finish() {
+		if(!pack_ || !loader_ ||
+		        loader_->status() != extra::BinaryStreamLoader::STATUS_DONE) {
+			return NULL;
+		}
+
+		// A stream without any transform loads "successfully" but has no
+		// scene to hand over; the pack is destroyed with the loader.
+		if(!loader_->root()) {
+			O3D_LOG(ERROR) << "Binary scene has no root transform";
+			return NULL;
+		}
+
+		Pack* pack = pack_;
+		pack_ = NULL;
+		pack->set_root(loader_->root());
+		// Catch anything that wasn't reachable from an attachment.
+		Materials::PrepareMaterials(pack, view_info_, 0);
+		Scene::PrepareShapes(pack);
+		return new Scene(pack, pack->root(), pack->root()->GetParam<ParamFloat>("time"));
+	}
+
+	void BinarySceneLoader::OnShapeReady(Transform& transform, Shape& shape) {
+		const ElementRefArray& elements = shape.GetElementRefs();
+
+		for(size_t ee = 0; ee < elements.size(); ++ee) {
+			Material* material = elements[ee]->material();
+
+			if(material && prepared_materials_.insert(material).second) {
+				Materials::PrepareMaterial(pack_, view_info_, material, "");
+			}
+		}
+
+		Scene::PrepareShape(pack_, &shape);
+	}
+
 	Scene::Scene(Pack* pack, Transform* root, ParamFloat* time)
 		: pack_(pack),
 		  root_(root),
@@ -287,7 +373,10 @@ namespace o3d_utils {
 	}
 
 	void Scene::SetAnimationTime(float timeInSeconds) {
-		time_->set_value(timeInSeconds);
+		// Binary scenes only have a time param if their exporter wrote one.
+		if(time_) {
+			time_->set_value(timeInSeconds);
+		}
 	}
 
 	class Cloner {
@@ -799,5 +888,315 @@ namespace o3d_utils {
 		return Cloner::Clone(client, this);
 	}
 
+	// Makes the copies of the skinned shapes of a scene an instance needs,
+	// sharing everything they can with the shapes of the scene: index
+	// buffers, materials, skins, and the vertex streams that are not skinned.
+	class Instancer {
+	public:
+		Instancer(Pack* pack, Transform* instance)
+			: pack_(pack),
+			  instance_(instance) {
+		}
+
+		// Gives the instance its own copy of each skinned shape under |root|.
+		void InstanceSkinnedShapes(Transform* root) {
+			TransformArray transforms = root->GetTransformsInTree();
+
+			for(size_t ii = 0; ii < transforms.size(); ++ii) {
+				const ShapeRefArray& shapes = transforms[ii]->GetShapeRefs();
+
+				for(size_t jj = 0; jj < shapes.size(); ++jj) {
+					Shape* shape = shapes[jj];
+
+					if(instanced_shapes_.insert(shape).second && IsSkinned(shape)) {
+						instance_->SetInstanceShape(shape, InstanceShape(shape));
+					}
+				}
+			}
+		}
+
+	private:
+		static SkinEval* GetSkinEval(const ParamVertexBufferStream* param) {
+			Param* input = param->input_connection();
+
+			if(input && input->owner() &&
+			        input->owner()->IsA(SkinEval::GetApparentClass())) {
+				return down_cast<SkinEval*>(input->owner());
+			}
+
+			return NULL;
+		}
+
+		static bool IsSkinned(StreamBank* stream_bank) {
+			if(!stream_bank) {
+				return false;
+			}
+
+			const StreamParamVector& params = stream_bank->vertex_stream_params();
+
+			for(size_t ii = 0; ii < params.size(); ++ii) {
+				if(GetSkinEval(params[ii])) {
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		static bool IsSkinned(Shape* shape) {
+			const ElementRefArray& elements = shape->GetElementRefs();
+
+			for(size_t ii = 0; ii < elements.size(); ++ii) {
+				if(elements[ii]->IsA(Primitive::GetApparentClass()) &&
+				        IsSkinned(down_cast<Primitive*>(elements[ii].Get())->stream_bank())) {
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		Shape* InstanceShape(Shape* src_shape) {
+			Shape* dst_shape = pack_->Create<Shape>();
+			dst_shape->set_name(src_shape->name());
+			const ElementRefArray& elements = src_shape->GetElementRefs();
+
+			for(size_t ii = 0; ii < elements.size(); ++ii) {
+				if(!elements[ii]->IsA(Primitive::GetApparentClass())) {
+					O3D_LOG(ERROR) << "Element " << elements[ii]->name()
+					               << " of skinned shape " << src_shape->name()
+					               << " is not a Primitive and won't be instanced";
+					continue;
+				}
+
+				Primitive* src = down_cast<Primitive*>(elements[ii].Get());
+				Primitive* dst = pack_->Create<Primitive>();
+				dst->CopyParams(src);
+				dst->set_name(src->name());
+				dst->set_number_vertices(src->number_vertices());
+				dst->set_number_primitives(src->number_primitives());
+				dst->set_primitive_type(src->primitive_type());
+				dst->set_start_index(src->start_index());
+				dst->set_index_buffer(src->index_buffer());
+				dst->set_stream_bank(InstanceStreamBank(src->stream_bank()));
+				dst->SetOwner(dst_shape);
+				const DrawElementRefArray& draw_elements = src->GetDrawElementRefs();
+
+				for(size_t jj = 0; jj < draw_elements.size(); ++jj) {
+					dst->CreateDrawElement(pack_, draw_elements[jj]->material());
+				}
+			}
+
+			return dst_shape;
+		}
+
+		StreamBank* InstanceStreamBank(StreamBank* src) {
+			if(!IsSkinned(src)) {
+				return src;
+			}
+
+			std::map<StreamBank*, StreamBank*>::iterator iter =
+			    stream_banks_.find(src);
+
+			if(iter != stream_banks_.end()) {
+				return iter->second;
+			}
+
+			StreamBank* dst = pack_->Create<StreamBank>();
+			dst->set_name(src->name());
+			const StreamParamVector& params = src->vertex_stream_params();
+
+			for(size_t ii = 0; ii < params.size(); ++ii) {
+				const Stream& stream = params[ii]->stream();
+				SkinEval* skin_eval = GetSkinEval(params[ii]);
+
+				if(skin_eval) {
+					// The skinned vertices of the instance go to its own buffer.
+					dst->SetVertexStream(stream.semantic(),
+					                     stream.semantic_index(),
+					                     InstanceField(&stream.field()),
+					                     stream.start_index());
+					dst->BindStream(InstanceSkinEval(skin_eval),
+					                stream.semantic(),
+					                stream.semantic_index());
+				}
+				else {
+					dst->SetVertexStream(stream.semantic(),
+					                     stream.semantic_index(),
+					                     &stream.field(),
+					                     stream.start_index());
+				}
+			}
+
+			stream_banks_[src] = dst;
+			return dst;
+		}
+
+		Field* InstanceField(Field* src_field) {
+			Buffer* src = src_field->buffer();
+			std::map<Buffer*, Buffer*>::iterator iter = buffers_.find(src);
+
+			if(iter == buffers_.end()) {
+				Buffer* dst = down_cast<Buffer*>(
+				                  pack_->CreateObjectByClass(src->GetClass()));
+				const FieldRefArray& fields = src->fields();
+
+				for(size_t ii = 0; ii < fields.size(); ++ii) {
+					dst->CreateField(fields[ii]->GetClass(),
+					                 fields[ii]->num_components());
+				}
+
+				dst->AllocateElements(src->num_elements());
+
+				for(size_t ii = 0; ii < fields.size(); ++ii) {
+					dst->fields()[ii]->Copy(*fields[ii]);
+				}
+
+				iter = buffers_.insert(std::make_pair(src, dst)).first;
+			}
+
+			const FieldRefArray& src_fields = src->fields();
+
+			for(size_t ii = 0; ii < src_fields.size(); ++ii) {
+				if(src_fields[ii] == src_field) {
+					return iter->second->fields()[ii];
+				}
+			}
+
+			O3D_NEVER_REACHED();
+			return NULL;
+		}
+
+		// Copies |src| with its own bone matrices, which the instance sets
+		// from the bones of the scene at its animation time.
+		SkinEval* InstanceSkinEval(SkinEval* src) {
+			std::map<SkinEval*, SkinEval*>::iterator iter = skin_evals_.find(src);
+
+			if(iter != skin_evals_.end()) {
+				return iter->second;
+			}
+
+			SkinEval* dst = pack_->Create<SkinEval>();
+			dst->set_name(src->name());
+			dst->set_skin(src->skin());
+			InstanceMatrix(src->GetParam<ParamMatrix4>(SkinEval::kBaseParamName),
+			               dst->GetParam<ParamMatrix4>(SkinEval::kBaseParamName));
+			ParamArray* src_matrices = src->matrices();
+
+			if(src_matrices && src_matrices->size() > 0) {
+				ParamArray* dst_matrices = pack_->Create<ParamArray>();
+				dst_matrices->CreateParam<ParamMatrix4>(src_matrices->size() - 1);
+
+				for(unsigned ii = 0; ii < src_matrices->size(); ++ii) {
+					InstanceMatrix(src_matrices->GetParam<ParamMatrix4>(ii),
+					               dst_matrices->GetParam<ParamMatrix4>(ii));
+				}
+
+				dst->set_matrices(dst_matrices);
+			}
+
+			const StreamParamVector& params = src->vertex_stream_params();
+
+			for(size_t ii = 0; ii < params.size(); ++ii) {
+				const Stream& stream = params[ii]->stream();
+				dst->SetVertexStream(stream.semantic(),
+				                     stream.semantic_index(),
+				                     &stream.field(),
+				                     stream.start_index());
+				Param* input = params[ii]->input_connection();
+
+				if(input && input->owner()) {
+					dst->BindStream(down_cast<VertexSource*>(input->owner()),
+					                stream.semantic(),
+					                stream.semantic_index());
+				}
+			}
+
+			skin_evals_[src] = dst;
+			return dst;
+		}
+
+		// Makes |dst| follow the world matrix of the transform |src| is bound
+		// to, in the instance, or copies the value of |src|.
+		void InstanceMatrix(ParamMatrix4* src, ParamMatrix4* dst) {
+			if(!src || !dst) {
+				return;
+			}
+
+			Param* input = src->input_connection();
+
+			if(input && input->owner() &&
+			        input->owner()->IsA(Transform::GetApparentClass()) &&
+			        input->name() == Transform::kWorldMatrixParamName) {
+				instance_->AddInstanceMatrix(down_cast<Transform*>(input->owner()), dst);
+			}
+			else if(input) {
+				dst->Bind(input);
+			}
+			else {
+				dst->set_value(src->value());
+			}
+		}
+
+		Pack* pack_;
+		Transform* instance_;
+		std::set<Shape*> instanced_shapes_;
+		std::map<StreamBank*, StreamBank*> stream_banks_;
+		std::map<SkinEval*, SkinEval*> skin_evals_;
+		std::map<Buffer*, Buffer*> buffers_;
+	};
+
+	SceneInstance* Scene::CreateInstance() const {
+		Pack* pack =
+		    pack_->service_locator()->GetService<ObjectManager>()->CreatePack();
+		Transform* root = pack->Create<Transform>();
+		root->set_name(root_->name() + "_instance");
+		root->set_instance_of(root_);
+		ParamFloat* time = NULL;
+
+		if(time_ && time_->owner() == root_) {
+			time = root->CreateParam<ParamFloat>(time_->name());
+			time->set_value(time_->value());
+		}
+
+		Instancer instancer(pack, root);
+		instancer.InstanceSkinnedShapes(root_);
+		return new SceneInstance(pack, root, time);
+	}
+
+	SceneInstance::SceneInstance(Pack* pack, Transform* root, ParamFloat* time)
+		: pack_(pack),
+		  root_(root),
+		  time_(time) {
+	}
+
+	SceneInstance::~SceneInstance() {
+		root_->SetParent(NULL);
+		root_->set_instance_of(NULL);
+		pack_->Destroy();
+	}
+
+	void SceneInstance::SetParent(Transform* parent) {
+		root_->SetParent(parent);
+	}
+
+	void SceneInstance::SetLocalMatrix(const Matrix4& mat) {
+		root_->set_local_matrix(mat);
+	}
+
+	void SceneInstance::SetLocalMatrix(const float* mat) {
+		root_->set_local_matrix(Matrix4(
+		                            Vector4(mat[0], mat[1], mat[2], mat[3]),
+		                            Vector4(mat[4], mat[5], mat[6], mat[7]),
+		                            Vector4(mat[8], mat[9], mat[10], mat[11]),
+		                            Vector4(mat[12], mat[13], mat[14], mat[15])));
+	}
+
+	void SceneInstance::SetAnimationTime(float timeInSeconds) {
+		if(time_) {
+			time_->set_value(timeInSeconds);
+		}
+	}
+
 }  // namespace o3d_utils
 
@@ -19,6 +19,7 @@
 
 #include <string>
 #include <set>
+#include <fstream>
 #include "core/cross/types.h"
 #include "extra/cross/binary.h"
 
@@ -37,6 +38,7 @@ namespace o3d {
 namespace o3d_utils {
 
 	class ViewInfo;
+	class SceneInstance;
 
 	class StringList {
 	public:
@@ -91,6 +93,18 @@ namespace o3d_utils {
 		// TODO(gman): Need to pass in effect/material pack :-(
 		Scene* Clone(o3d::Client* client) const;
 
+		// Creates an instance of the scene, which draws the transforms,
+		// shapes and materials of this scene, sharing them and their buffers,
+		// params caches and animation curves, at its own place and animation
+		// time. Only the skinned shapes are copied, to hold the vertices
+		// skinned for the instance. Much cheaper than Clone, for crowds and
+		// repeated props.
+		//
+		// The scene must outlive its instances. Once it has instances, the
+		// scene itself shouldn't be parented: its animation time is the one
+		// of the last instance drawn.
+		SceneInstance* CreateInstance() const;
+
 		void SetParent(o3d::Transform* parent);
 		void SetLocalMatrix(const o3d::Matrix4& mat);
 		void SetLocalMatrix(const float* mat);
@@ -104,6 +118,7 @@ namespace o3d_utils {
 
 	private:
 		friend class Cloner;
+		friend class BinarySceneLoader;
 
 		Scene(o3d::Pack* pack, o3d::Transform* root, o3d::ParamFloat* time);
 
@@ -112,6 +127,68 @@ namespace o3d_utils {
 		o3d::ParamFloat* time_;
 	};
 
+// An instance of a Scene. See Scene::CreateInstance.
+	class SceneInstance {
+	public:
+		~SceneInstance();
+
+		o3d::Transform* root() const {
+			return root_;
+		}
+
+		void SetParent(o3d::Transform* parent);
+		void SetLocalMatrix(const o3d::Matrix4& mat);
+		void SetLocalMatrix(const float* mat);
+		void SetAnimationTime(float timeInSeconds);
+
+	private:
+		friend class Scene;
+
+		SceneInstance(o3d::Pack* pack, o3d::Transform* root, o3d::ParamFloat* time);
+
+		// Holds the root and the skinned shapes of this instance only.
+		o3d::Pack* pack_;
+		o3d::Transform* root_;
+		o3d::ParamFloat* time_;
+	};
+
+// Loads a binary scene a few atoms at a time. Materials and shapes are
+// prepared as soon as they are received, so the partially loaded scene
+// (see root()) can be parented and rendered while loading goes on.
+	class BinarySceneLoader : public o3d::extra::IBinaryLoadListener {
+	public:
+		BinarySceneLoader(
+		    o3d::Client* client,
+		    o3d_utils::ViewInfo* view_info,
+		    const std::string& filename,
+		    o3d::extra::IExternalResourceProvider& external_resource_provider);
+		~BinarySceneLoader();
+
+		// Spends at most budget_ms milliseconds loading. Returns true while
+		// there is more to load.
+		bool Step(float budget_ms);
+
+		// Fraction of the file consumed so far, in [0, 1].
+		float progress() const;
+
+		// Root of the partially loaded scene, or NULL if not received yet.
+		o3d::Transform* root() const;
+
+		// Returns the loaded scene, or NULL if loading failed or isn't over.
+		// The caller takes ownership of the scene.
+		Scene* Finish();
+
+		// IBinaryLoadListener implementation.
+		virtual void OnShapeReady(o3d::Transform& transform, o3d::Shape& shape);
+
+	private:
+		o3d_utils::ViewInfo* view_info_;
+		o3d::Pack* pack_;
+		std::ifstream stream_;
+		o3d::extra::BinaryStreamLoader* loader_;
+		std::set<o3d::Material*> prepared_materials_;
+	};
+
 }  // namespace o3d_utils
 
 #endif  // O3D_UTILS_SCENE_H_
@@ -86,6 +86,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <limits.h>
 #else // OTHER... 
 #error "Unsupported platform."
 #endif // LINUX || __PPU__ || __ANDROID__
@@ -342,3 +342,6 @@ xmlNode* FArchiveXML::AddPhysicsParameter(xmlNode* parentNode, const char* name,
 	}
 	return paramNode;
 }
+
+// FAXInstanceExport.cpp uses it too, but can't instantiate it from there.
+template xmlNode* FArchiveXML::AddPhysicsParameter(xmlNode*, const char*, FCDParameterAnimatableVector3&);
@@ -32,6 +32,7 @@
 //  Based on original Protocol Buffers design by
 //  Sanjay Ghemawat, Jeff Dean, and others.
 
+#include <istream>
 #include <stack>
 #include <google/protobuf/stubs/hash.h>
 
@@ -11,6 +11,7 @@ LOCAL_C_INCLUDES += \
 LOCAL_SRC_FILES := $(addprefix cross/, \
   base64.cc \
   dataurl.cc \
+  json_writer.cc \
   )
 
 include $(O3D_BUILD_MODULE)
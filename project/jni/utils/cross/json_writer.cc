@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/cross/json_writer.h"
+#include <math.h>
+#include <stdio.h>
+
+namespace o3d {
+
+	JsonWriter::JsonWriter(int indent_spaces)
+		: indent_spaces_(indent_spaces),
+		  compacting_level_(0),
+		  after_property_name_(false) {
+	}
+
+	void JsonWriter::OpenObject() {
+		OpenBlock('{');
+	}
+
+	void JsonWriter::CloseObject() {
+		CloseBlock('}');
+	}
+
+	void JsonWriter::OpenArray() {
+		OpenBlock('[');
+	}
+
+	void JsonWriter::CloseArray() {
+		CloseBlock(']');
+	}
+
+	void JsonWriter::BeginCompacting() {
+		++compacting_level_;
+	}
+
+	void JsonWriter::EndCompacting() {
+		--compacting_level_;
+	}
+
+	void JsonWriter::WritePropertyName(const std::string& name) {
+		BeginValue();
+		WriteQuoted(name);
+		output_ += IsCompact() ? ":" : ": ";
+		after_property_name_ = true;
+	}
+
+	void JsonWriter::WriteBool(bool value) {
+		BeginValue();
+		output_ += value ? "true" : "false";
+	}
+
+	void JsonWriter::WriteInt(int value) {
+		char buffer[16];
+		snprintf(buffer, sizeof(buffer), "%d", value);
+		BeginValue();
+		output_ += buffer;
+	}
+
+	void JsonWriter::WriteUnsignedInt(unsigned int value) {
+		char buffer[16];
+		snprintf(buffer, sizeof(buffer), "%u", value);
+		BeginValue();
+		output_ += buffer;
+	}
+
+	void JsonWriter::WriteUInt64(uint64_t value) {
+		char buffer[24];
+		snprintf(buffer, sizeof(buffer), "%llu",
+		         static_cast<unsigned long long>(value));
+		BeginValue();
+		output_ += buffer;
+	}
+
+	void JsonWriter::WriteFloat(float value) {
+		// JSON has no representation for infinities and NaNs.
+		if(isnan(value) || isinf(value)) {
+			WriteNull();
+			return;
+		}
+
+		char buffer[32];
+		snprintf(buffer, sizeof(buffer), "%.9g", value);
+		BeginValue();
+		output_ += buffer;
+	}
+
+	void JsonWriter::WriteString(const std::string& value) {
+		BeginValue();
+		WriteQuoted(value);
+	}
+
+	void JsonWriter::WriteNull() {
+		BeginValue();
+		output_ += "null";
+	}
+
+	void JsonWriter::BeginValue() {
+		if(after_property_name_) {
+			after_property_name_ = false;
+			return;
+		}
+
+		if(!block_is_empty_.empty()) {
+			if(!block_is_empty_.back()) {
+				output_ += ',';
+			}
+
+			block_is_empty_.back() = false;
+			WriteNewLine();
+		}
+	}
+
+	void JsonWriter::OpenBlock(char open) {
+		BeginValue();
+		output_ += open;
+		block_is_compact_.push_back(compacting_level_ > 0 || IsCompact());
+		block_is_empty_.push_back(true);
+	}
+
+	void JsonWriter::CloseBlock(char close) {
+		bool empty = block_is_empty_.back();
+		block_is_empty_.pop_back();
+
+		if(!empty) {
+			WriteNewLine();
+		}
+
+		block_is_compact_.pop_back();
+		output_ += close;
+	}
+
+	bool JsonWriter::IsCompact() const {
+		return !indent_spaces_ ||
+		       (!block_is_compact_.empty() && block_is_compact_.back());
+	}
+
+	void JsonWriter::WriteNewLine() {
+		if(IsCompact()) {
+			return;
+		}
+
+		output_ += '\n';
+		output_.append(block_is_empty_.size() * indent_spaces_, ' ');
+	}
+
+	void JsonWriter::WriteQuoted(const std::string& value) {
+		output_ += '"';
+
+		for(size_t ii = 0; ii < value.size(); ++ii) {
+			unsigned char c = value[ii];
+
+			switch(c) {
+			case '"':
+				output_ += "\\\"";
+				break;
+			case '\\':
+				output_ += "\\\\";
+				break;
+			case '\n':
+				output_ += "\\n";
+				break;
+			case '\r':
+				output_ += "\\r";
+				break;
+			case '\t':
+				output_ += "\\t";
+				break;
+			default:
+				if(c < 0x20) {
+					char buffer[8];
+					snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+					output_ += buffer;
+				}
+				else {
+					output_ += c;
+				}
+			}
+		}
+
+		output_ += '"';
+	}
+
+}  // namespace o3d
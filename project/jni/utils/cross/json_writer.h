@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "utils/cross/structured_writer.h"
+
+namespace o3d {
+
+	// A StructuredWriter producing JSON text into a string. Objects and
+	// arrays opened between BeginCompacting and EndCompacting are written on
+	// a single line.
+	class JsonWriter : public StructuredWriter {
+	public:
+		// Parameters:
+		//   indent_spaces: number of spaces to indent nested blocks with. If
+		//       0, everything is written on a single line.
+		explicit JsonWriter(int indent_spaces);
+
+		virtual void OpenObject();
+		virtual void CloseObject();
+		virtual void OpenArray();
+		virtual void CloseArray();
+		virtual void BeginCompacting();
+		virtual void EndCompacting();
+		virtual void WritePropertyName(const std::string& name);
+		virtual void WriteBool(bool value);
+		virtual void WriteInt(int value);
+		virtual void WriteUnsignedInt(unsigned int value);
+		virtual void WriteUInt64(uint64_t value);
+		virtual void WriteFloat(float value);
+		virtual void WriteString(const std::string& value);
+		virtual void WriteNull();
+
+		// Returns the text written so far.
+		const std::string& output() const {
+			return output_;
+		}
+
+	private:
+		// Writes what goes before a value or a property name.
+		void BeginValue();
+
+		// Returns true if the innermost open block is written on one line.
+		bool IsCompact() const;
+
+		void OpenBlock(char open);
+		void CloseBlock(char close);
+		void WriteNewLine();
+		void WriteQuoted(const std::string& value);
+
+		std::string output_;
+		int indent_spaces_;
+		int compacting_level_;
+		// For each open block, whether nothing was written in it yet.
+		std::vector<bool> block_is_empty_;
+		// For each open block, whether it is written on one line.
+		std::vector<bool> block_is_compact_;
+		bool after_property_name_;
+
+		O3D_DISALLOW_COPY_AND_ASSIGN(JsonWriter);
+	};
+
+}  // namespace o3d
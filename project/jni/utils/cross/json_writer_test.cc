@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file contains the tests of the JSON writer.
+
+#include "tests/common/win/testing_common.h"
+#include "utils/cross/json_writer.h"
+
+namespace o3d {
+
+	TEST(JsonWriterTest, WritesCompactValues) {
+		JsonWriter writer(0);
+		writer.OpenObject();
+		writer.WritePropertyName("a");
+		writer.OpenArray();
+		writer.WriteInt(-1);
+		writer.WriteUnsignedInt(2);
+		writer.WriteUInt64(5000000000ULL);
+		writer.WriteFloat(0.5f);
+		writer.WriteBool(true);
+		writer.WriteNull();
+		writer.CloseArray();
+		writer.WritePropertyName("b");
+		writer.WriteString("say \"hi\"\n");
+		writer.WritePropertyName("c");
+		writer.OpenObject();
+		writer.CloseObject();
+		writer.CloseObject();
+		EXPECT_EQ("{\"a\":[-1,2,5000000000,0.5,true,null],\"b\":\"say \\\"hi\\\"\\n\",\"c\":{}}",
+		          writer.output());
+	}
+
+	TEST(JsonWriterTest, Indents) {
+		JsonWriter writer(2);
+		writer.OpenObject();
+		writer.WritePropertyName("a");
+		writer.OpenArray();
+		writer.WriteInt(1);
+		writer.BeginCompacting();
+		writer.OpenObject();
+		writer.WritePropertyName("b");
+		writer.WriteInt(2);
+		writer.CloseObject();
+		writer.EndCompacting();
+		writer.CloseArray();
+		writer.CloseObject();
+		EXPECT_EQ("{\n  \"a\": [\n    1,\n    {\"b\":2}\n  ]\n}", writer.output());
+	}
+
+}  // namespace o3d
@@ -82,6 +82,9 @@ namespace o3d {
 		// Writes an unsigned integer value.
 		virtual void WriteUnsignedInt(unsigned int value) = 0;
 
+		// Writes a 64 bit unsigned integer value.
+		virtual void WriteUInt64(uint64_t value) = 0;
+
 		// Writes a float value.
 		virtual void WriteFloat(float value) = 0;
 
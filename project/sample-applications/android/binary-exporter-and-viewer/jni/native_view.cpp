@@ -39,6 +39,7 @@ NativeView::NativeView(size_t width, size_t height)
 , mObjectManager(new o3d::ObjectManager(&mServiceLocator))
 , mProfiler(new o3d::Profiler(&mServiceLocator))
 , mFeatures(new o3d::Features(&mServiceLocator))
+, mResourceCache(new o3d::extra::ResourceCache(&mServiceLocator))
 , mClient(new o3d::Client(&mServiceLocator))
 , mPack(0)
 , mRoot(0)
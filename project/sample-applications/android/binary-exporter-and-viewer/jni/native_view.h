@@ -32,6 +32,7 @@
 #include "core/cross/transform.h"
 #include "core/cross/types.h"
 #include <extra/cross/binary.h>
+#include <extra/cross/resource_cache.h>
 #include <scene.h>
 #include <camera.h>
 #include <render_graph.h>
@@ -64,6 +65,8 @@ class NativeView: public o3d::extra::IExternalResourceProvider {
   o3d::base::scoped_ptr<o3d::ObjectManager>     mObjectManager;
   o3d::base::scoped_ptr<o3d::Profiler>          mProfiler;
   o3d::base::scoped_ptr<o3d::Features>          mFeatures;
+  // Shares the textures of the scenes loaded one after the other.
+  o3d::base::scoped_ptr<o3d::extra::ResourceCache> mResourceCache;
   o3d::base::scoped_ptr<o3d::Client>            mClient;
   o3d::Pack*                                    mPack;
   o3d::Transform*                               mRoot;
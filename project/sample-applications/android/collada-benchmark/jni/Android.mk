@@ -0,0 +1,25 @@
+#
+# Copyright (C) 2010 Tonchidot Corporation.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+LOCAL_PATH      := $(call my-dir)
+include $(CLEAR_VARS)
+LOCAL_MODULE    := o3dbenchmark
+LOCAL_STATIC_LIBRARIES := o3dcombined
+LOCAL_CFLAGS    := -Werror
+LOCAL_LDLIBS    := -lEGL
+LOCAL_SRC_FILES := benchmark_main.cpp
+include $(BUILD_EXECUTABLE)
+include $(O3D_IMPORT_COMBINED_LIBRARY)
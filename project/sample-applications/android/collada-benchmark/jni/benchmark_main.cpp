@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Runs o3d_utils::Benchmark over COLLADA models, rendering offscreen.
+// See HOW_TO_RUN.txt.
+
+#ifndef O3D_HEADLESS
+#include <EGL/egl.h>
+#endif
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "core/cross/service_locator.h"
+#include "core/cross/evaluation_counter.h"
+#include "core/cross/client.h"
+#include "core/cross/client_info.h"
+#include "core/cross/class_manager.h"
+#include "core/cross/display_window.h"
+#include "core/cross/features.h"
+#include "core/cross/object_manager.h"
+#include "core/cross/profiler.h"
+#include "core/cross/renderer.h"
+#ifdef O3D_HEADLESS
+#include "core/cross/renderer_stub.h"
+#endif
+#include "core/cross/transform.h"
+#include "utils/cross/json_writer.h"
+#include <benchmark.h>
+#include <render_graph.h>
+
+namespace {
+
+const int kWidth = 512;
+const int kHeight = 512;
+
+class fake_window_t: public o3d::DisplayWindow {
+ public:
+  ~fake_window_t() { }
+};
+
+#ifndef O3D_HEADLESS
+// Makes an offscreen OpenGL ES 2 context current, for the renderer to use.
+bool CreateOffscreenContext() {
+  EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  if (display == EGL_NO_DISPLAY || !eglInitialize(display, 0, 0)) {
+    fprintf(stderr, "Can't initialize EGL\n");
+    return false;
+  }
+  const EGLint config_attribs[] = {
+    EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+    EGL_RED_SIZE, 8,
+    EGL_GREEN_SIZE, 8,
+    EGL_BLUE_SIZE, 8,
+    EGL_DEPTH_SIZE, 16,
+    EGL_NONE
+  };
+  EGLConfig config;
+  EGLint num_configs = 0;
+  if (!eglChooseConfig(display, config_attribs, &config, 1, &num_configs) ||
+      num_configs == 0) {
+    fprintf(stderr, "No EGL config for an OpenGL ES 2 pbuffer\n");
+    return false;
+  }
+  const EGLint surface_attribs[] = {
+    EGL_WIDTH, kWidth,
+    EGL_HEIGHT, kHeight,
+    EGL_NONE
+  };
+  EGLSurface surface = eglCreatePbufferSurface(display, config, surface_attribs);
+  const EGLint context_attribs[] = {
+    EGL_CONTEXT_CLIENT_VERSION, 2,
+    EGL_NONE
+  };
+  EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, context_attribs);
+  if (surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT ||
+      !eglMakeCurrent(display, surface, surface, context)) {
+    fprintf(stderr, "Can't create an offscreen EGL context\n");
+    return false;
+  }
+  return true;
+}
+#endif
+
+bool IsColladaFile(const std::string& path) {
+  return path.size() > 4 && strcasecmp(path.c_str() + path.size() - 4, ".dae") == 0;
+}
+
+// Appends |path| if it is a COLLADA file, or the COLLADA files under it if
+// it is a directory.
+void FindColladaFiles(const std::string& path, std::vector<std::string>* files) {
+  struct stat info;
+  if (stat(path.c_str(), &info) != 0) {
+    fprintf(stderr, "Can't find %s\n", path.c_str());
+    return;
+  }
+  if (!S_ISDIR(info.st_mode)) {
+    if (IsColladaFile(path)) files->push_back(path);
+    return;
+  }
+  DIR* dir = opendir(path.c_str());
+  if (!dir) return;
+  std::vector<std::string> entries;
+  while (struct dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] != '.') entries.push_back(path + "/" + entry->d_name);
+  }
+  closedir(dir);
+  // Same order on every run.
+  std::sort(entries.begin(), entries.end());
+  for (size_t ii = 0; ii < entries.size(); ++ii) {
+    FindColladaFiles(entries[ii], files);
+  }
+}
+
+int Usage(const char* program) {
+  fprintf(stderr,
+          "Usage: %s [-o FILE] [-frames N] [-steps N] [-rays N] [-threads N] "
+          "MODEL_OR_DIRECTORY...\n", program);
+  return 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  o3d_utils::Benchmark::Options options;
+  const char* output_path = 0;
+  std::vector<std::string> files;
+  for (int ii = 1; ii < argc; ++ii) {
+    std::string arg(argv[ii]);
+    bool has_value = ii + 1 < argc;
+    if (arg == "-o" && has_value) {
+      output_path = argv[++ii];
+    } else if (arg == "-frames" && has_value) {
+      options.num_frames = atoi(argv[++ii]);
+    } else if (arg == "-steps" && has_value) {
+      options.num_animation_steps = atoi(argv[++ii]);
+    } else if (arg == "-rays" && has_value) {
+      options.num_rays = atoi(argv[++ii]);
+    } else if (arg == "-threads" && has_value) {
+      options.import_threads = atoi(argv[++ii]);
+    } else if (arg[0] == '-') {
+      return Usage(argv[0]);
+    } else {
+      FindColladaFiles(arg, &files);
+    }
+  }
+  if (files.empty()) return Usage(argv[0]);
+
+  o3d::ServiceLocator service_locator;
+#ifdef O3D_HEADLESS
+  // The host build draws nothing, so the frames only measure the CPU side
+  // of rendering: traversal, culling, sorting and state changes.
+  o3d::Renderer* renderer = o3d::RendererStub::CreateDefault(&service_locator);
+#else
+  if (!CreateOffscreenContext()) return 1;
+  o3d::Renderer* renderer = o3d::Renderer::CreateDefaultRenderer(&service_locator);
+#endif
+  o3d::EvaluationCounter evaluation_counter(&service_locator);
+  o3d::ClassManager class_manager(&service_locator);
+  o3d::ClientInfoManager client_info_manager(&service_locator);
+  o3d::ObjectManager object_manager(&service_locator);
+  o3d::Profiler profiler(&service_locator);
+  o3d::Features features(&service_locator);
+  o3d::Client client(&service_locator);
+  if (renderer->Init(fake_window_t(), true) != o3d::Renderer::SUCCESS) {
+    fprintf(stderr, "Can't initialize the renderer\n");
+    return 1;
+  }
+  client.Init();
+  renderer->Resize(kWidth, kHeight);
+  o3d::Pack* pack = client.CreatePack();
+  o3d::Transform* root = pack->Create<o3d::Transform>();
+  o3d_utils::ViewInfo* view = o3d_utils::ViewInfo::CreateBasicView(
+      pack, root, client.render_graph_root());
+
+  o3d::JsonWriter writer(2);
+  o3d_utils::Benchmark benchmark(&client, view, &writer, options);
+  int failures = 0;
+  benchmark.Begin();
+  for (size_t ii = 0; ii < files.size(); ++ii) {
+    if (!benchmark.RunModel(files[ii])) ++failures;
+  }
+  benchmark.End();
+
+  FILE* output = output_path ? fopen(output_path, "w") : stdout;
+  if (!output) {
+    fprintf(stderr, "Can't write %s\n", output_path);
+    return 1;
+  }
+  fprintf(output, "%s\n", writer.output().c_str());
+  if (output != stdout) fclose(output);
+  fprintf(stderr, "%u models, %d failed to import\n",
+          static_cast<unsigned>(files.size()), failures);
+  delete view;
+  return failures ? 2 : 0;
+}
+
+/* vim: set sw=2 ts=2 sts=2 expandtab ff=unix: */
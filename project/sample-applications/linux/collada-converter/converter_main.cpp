@@ -0,0 +1,391 @@
+/*
+ * Copyright (C) 2010 Tonchidot Corporation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Converts COLLADA models to the binary format, several at a time, and
+// reports how long each took and how big it got. See HOW_TO_RUN.txt.
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "core/cross/service_locator.h"
+#include "core/cross/evaluation_counter.h"
+#include "core/cross/client.h"
+#include "core/cross/client_info.h"
+#include "core/cross/class_manager.h"
+#include "core/cross/display_window.h"
+#include "core/cross/features.h"
+#include "core/cross/file_resource.h"
+#include "core/cross/frame_profiler.h"
+#include "core/cross/object_manager.h"
+#include "core/cross/profiler.h"
+#include "core/cross/renderer_stub.h"
+#include "core/cross/shape.h"
+#include "core/cross/transform.h"
+#include "extra/cross/binary.h"
+#include "extra/cross/bounding_boxes_extra.h"
+#include "import/cross/collada.h"
+#include "utils/cross/json_writer.h"
+#include <materials.h>
+#include <render_graph.h>
+#include <scene.h>
+
+namespace {
+
+const int kWidth = 64;
+const int kHeight = 64;
+
+class fake_window_t: public o3d::DisplayWindow {
+ public:
+  ~fake_window_t() { }
+};
+
+// Loads the images of the textures to embed from the file system.
+class FileResourceProvider : public o3d::extra::IExternalResourceProvider {
+ public:
+  virtual o3d::ExternalResource::Ref GetExternalResourceForURI(
+      o3d::Pack& pack, const std::string& uri) {
+    o3d::ExternalResource::Ref resource(new o3d::FileResource(uri));
+    if (!resource->data()) return o3d::ExternalResource::Ref();
+    return resource;
+  }
+};
+
+struct Options {
+  Options() : num_jobs(1), import_threads(0), output_dir(0), stats_path(0) { }
+
+  int num_jobs;
+  unsigned import_threads;
+  const char* output_dir;
+  const char* stats_path;
+  o3d::extra::SaveOptions save;
+};
+
+bool HasExtension(const std::string& path, const char* extension) {
+  size_t length = strlen(extension);
+  return path.size() > length &&
+         strcasecmp(path.c_str() + path.size() - length, extension) == 0;
+}
+
+bool IsModelFile(const std::string& path) {
+  return HasExtension(path, ".dae") || HasExtension(path, ".zip");
+}
+
+// Appends |path| if it is a model, or the models under it if it is a
+// directory.
+void FindModelFiles(const std::string& path, std::vector<std::string>* files) {
+  struct stat info;
+  if (stat(path.c_str(), &info) != 0) {
+    fprintf(stderr, "Can't find %s\n", path.c_str());
+    return;
+  }
+  if (!S_ISDIR(info.st_mode)) {
+    if (IsModelFile(path)) files->push_back(path);
+    return;
+  }
+  DIR* dir = opendir(path.c_str());
+  if (!dir) return;
+  std::vector<std::string> entries;
+  while (struct dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] != '.') entries.push_back(path + "/" + entry->d_name);
+  }
+  closedir(dir);
+  // Same order on every run.
+  std::sort(entries.begin(), entries.end());
+  for (size_t ii = 0; ii < entries.size(); ++ii) {
+    FindModelFiles(entries[ii], files);
+  }
+}
+
+unsigned GetFileSize(const std::string& path) {
+  struct stat info;
+  return stat(path.c_str(), &info) == 0 ? static_cast<unsigned>(info.st_size) : 0;
+}
+
+// The model with its extension replaced by .o3db, in |output_dir| if set.
+std::string GetOutputPath(const std::string& input, const char* output_dir) {
+  std::string path(input, 0, input.size() - 4);
+  if (output_dir) {
+    size_t slash = path.rfind('/');
+    path = std::string(output_dir) + "/" +
+           (slash == std::string::npos ? path : path.substr(slash + 1));
+  }
+  return path + ".o3db";
+}
+
+double GetElapsedMs(uint64_t start_ns) {
+  return (o3d::FrameProfiler::GetTimeNs() - start_ns) / 1000000.0;
+}
+
+// Imports a model, prepares it the way Scene::LoadScene does, and saves
+// it. Writes an object with the timings and sizes.
+bool ConvertModel(o3d::Client* client,
+                  o3d_utils::ViewInfo* view,
+                  const std::string& input,
+                  const Options& options,
+                  o3d::StructuredWriter* writer) {
+  const std::string output(GetOutputPath(input, options.output_dir));
+  writer->OpenObject();
+  writer->WritePropertyName("file");
+  writer->WriteString(input);
+  writer->WritePropertyName("output");
+  writer->WriteString(output);
+  writer->WritePropertyName("inputBytes");
+  writer->WriteUnsignedInt(GetFileSize(input));
+
+  o3d::Pack* pack = client->CreatePack();
+  o3d::Transform* root = pack->Create<o3d::Transform>();
+  pack->set_root(root);
+  o3d::ParamFloat* time = root->CreateParam<o3d::ParamFloat>("time");
+  o3d::Collada::Options collada_options;
+  collada_options.up_axis = o3d::Vector3(0.0f, 1.0f, 0.0f);
+  collada_options.num_threads = options.import_threads;
+  uint64_t start = o3d::FrameProfiler::GetTimeNs();
+  bool succeeded = o3d::Collada::Import(pack, input, root, time, collada_options);
+  if (succeeded) o3d_utils::Materials::PrepareMaterials(pack, view, NULL);
+  writer->WritePropertyName("importMs");
+  writer->WriteFloat(static_cast<float>(GetElapsedMs(start)));
+
+  if (succeeded) {
+    // Draw elements, bounding boxes, z-sort points and missing texcoords.
+    start = o3d::FrameProfiler::GetTimeNs();
+    o3d_utils::Scene::PrepareShapes(pack);
+    o3d::extra::updateBoundingBoxes(*root);
+    writer->WritePropertyName("prepareMs");
+    writer->WriteFloat(static_cast<float>(GetElapsedMs(start)));
+    writer->WritePropertyName("shapes");
+    writer->WriteUnsignedInt(pack->GetByClass<o3d::Shape>().size());
+
+    start = o3d::FrameProfiler::GetTimeNs();
+    o3d::extra::SaveReport report;
+    std::ofstream stream(output.c_str(), std::ios::binary | std::ios::trunc);
+    succeeded = stream.is_open() &&
+                o3d::extra::SaveToBinaryStream(stream, *root, options.save, &report);
+    stream.close();
+    succeeded = succeeded && !stream.fail();
+    writer->WritePropertyName("exportMs");
+    writer->WriteFloat(static_cast<float>(GetElapsedMs(start)));
+    writer->WritePropertyName("outputBytes");
+    writer->WriteUnsignedInt(succeeded ? GetFileSize(output) : 0);
+    writer->WritePropertyName("duplicates");
+    writer->WriteUnsignedInt(report.duplicates);
+    writer->WritePropertyName("bytesSaved");
+    writer->WriteUnsignedInt(static_cast<unsigned>(report.bytes_saved));
+    if (!succeeded) remove(output.c_str());
+  }
+
+  writer->WritePropertyName("succeeded");
+  writer->WriteBool(succeeded);
+  writer->CloseObject();
+  pack->service_locator()->GetService<o3d::ObjectManager>()->DestroyPack(pack);
+  return succeeded;
+}
+
+// Converts every |num_jobs|th model from |first|, and writes one line per
+// model to |output_fd|: the index of the model, a tab, and its statistics
+// as JSON.
+void RunJob(const std::vector<std::string>& files,
+            size_t first,
+            const Options& options,
+            int output_fd) {
+  // Nothing is drawn, so the stub renderer will do: the buffers keep their
+  // data in memory, where the exporter reads it from.
+  o3d::ServiceLocator service_locator;
+  o3d::Renderer* renderer = o3d::RendererStub::CreateDefault(&service_locator);
+  o3d::EvaluationCounter evaluation_counter(&service_locator);
+  o3d::ClassManager class_manager(&service_locator);
+  o3d::ClientInfoManager client_info_manager(&service_locator);
+  o3d::ObjectManager object_manager(&service_locator);
+  o3d::Profiler profiler(&service_locator);
+  o3d::Features features(&service_locator);
+  o3d::Client client(&service_locator);
+  if (renderer->Init(fake_window_t(), true) != o3d::Renderer::SUCCESS) {
+    fprintf(stderr, "Can't initialize the renderer\n");
+    return;
+  }
+  client.Init();
+  renderer->Resize(kWidth, kHeight);
+  o3d::Pack* pack = client.CreatePack();
+  o3d::Transform* root = pack->Create<o3d::Transform>();
+  o3d_utils::ViewInfo* view = o3d_utils::ViewInfo::CreateBasicView(
+      pack, root, client.render_graph_root());
+
+  for (size_t ii = first; ii < files.size(); ii += options.num_jobs) {
+    o3d::JsonWriter writer(0);
+    bool converted = ConvertModel(&client, view, files[ii], options, &writer);
+    fprintf(stderr, "%s %s\n", converted ? "Converted" : "Failed to convert",
+            files[ii].c_str());
+    char index[16];
+    snprintf(index, sizeof(index), "%u\t", static_cast<unsigned>(ii));
+    // One write per line, so that the lines of the jobs don't interleave.
+    std::string line(index + writer.output() + "\n");
+    if (write(output_fd, line.data(), line.size()) !=
+        static_cast<ssize_t>(line.size())) {
+      break;
+    }
+  }
+  delete view;
+}
+
+bool ParseCompression(const std::string& name,
+                      o3d::extra::TCompressionAlgorithm* compression) {
+  if (name == "none") {
+    *compression = o3d::extra::COMPRESSION_NONE;
+  } else if (name == "gzip") {
+    *compression = o3d::extra::COMPRESSION_GZIP;
+  } else if (name == "lzma") {
+    *compression = o3d::extra::COMPRESSION_LZMA;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+int Usage(const char* program) {
+  fprintf(stderr,
+          "Usage: %s [-o DIR] [-j N] [-stats FILE] [-threads N] "
+          "[-compression none|gzip|lzma] [-blocks KB] [-encode-geometry] "
+          "[-embed-textures] [-pot] [-dedup] MODEL_OR_DIRECTORY...\n", program);
+  return 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  FileResourceProvider resource_provider;
+  std::vector<std::string> files;
+  for (int ii = 1; ii < argc; ++ii) {
+    std::string arg(argv[ii]);
+    bool has_value = ii + 1 < argc;
+    if (arg == "-o" && has_value) {
+      options.output_dir = argv[++ii];
+    } else if (arg == "-j" && has_value) {
+      options.num_jobs = std::max(1, atoi(argv[++ii]));
+    } else if (arg == "-stats" && has_value) {
+      options.stats_path = argv[++ii];
+    } else if (arg == "-threads" && has_value) {
+      options.import_threads = atoi(argv[++ii]);
+    } else if (arg == "-compression" && has_value) {
+      if (!ParseCompression(argv[++ii], &options.save.compression)) {
+        return Usage(argv[0]);
+      }
+    } else if (arg == "-blocks" && has_value) {
+      options.save.block_size = atoi(argv[++ii]) * 1024;
+    } else if (arg == "-encode-geometry") {
+      options.save.encode_geometry = true;
+    } else if (arg == "-embed-textures") {
+      options.save.texture_provider = &resource_provider;
+    } else if (arg == "-pot") {
+      options.save.scale_textures_to_pot = true;
+    } else if (arg == "-dedup") {
+      options.save.deduplicate = true;
+    } else if (arg[0] == '-') {
+      return Usage(argv[0]);
+    } else {
+      FindModelFiles(arg, &files);
+    }
+  }
+  if (files.empty()) return Usage(argv[0]);
+  options.num_jobs = std::min(options.num_jobs, static_cast<int>(files.size()));
+
+  // Each job is a process, as the object managers aren't thread-safe, and a
+  // model that crashes the importer only fails its job.
+  int fds[2];
+  if (pipe(fds) != 0) {
+    fprintf(stderr, "Can't create a pipe\n");
+    return 1;
+  }
+  uint64_t start = o3d::FrameProfiler::GetTimeNs();
+  for (int jj = 0; jj < options.num_jobs; ++jj) {
+    pid_t pid = fork();
+    if (pid == 0) {
+      close(fds[0]);
+      RunJob(files, jj, options, fds[1]);
+      close(fds[1]);
+      _exit(0);
+    }
+    if (pid < 0) fprintf(stderr, "Can't start job %d\n", jj);
+  }
+  close(fds[1]);
+
+  std::vector<std::string> results(files.size());
+  std::string pending;
+  char buffer[4096];
+  ssize_t size;
+  while ((size = read(fds[0], buffer, sizeof(buffer))) > 0) {
+    pending.append(buffer, size);
+    size_t end;
+    while ((end = pending.find('\n')) != std::string::npos) {
+      size_t tab = pending.find('\t');
+      size_t index = strtoul(pending.c_str(), NULL, 10);
+      if (tab < end && index < results.size()) {
+        results[index] = pending.substr(tab + 1, end - tab - 1);
+      }
+      pending.erase(0, end + 1);
+    }
+  }
+  close(fds[0]);
+  while (wait(NULL) > 0) { }
+
+  // Models whose job died before reporting them failed too.
+  int failures = 0;
+  std::string report("{\"timeMs\":");
+  char number[32];
+  snprintf(number, sizeof(number), "%.1f", GetElapsedMs(start));
+  report += number;
+  report += ",\"files\":[\n";
+  for (size_t ii = 0; ii < files.size(); ++ii) {
+    if (results[ii].empty() ||
+        results[ii].find("\"succeeded\":true") == std::string::npos) {
+      ++failures;
+    }
+    if (results[ii].empty()) {
+      o3d::JsonWriter writer(0);
+      writer.OpenObject();
+      writer.WritePropertyName("file");
+      writer.WriteString(files[ii]);
+      writer.WritePropertyName("succeeded");
+      writer.WriteBool(false);
+      writer.CloseObject();
+      results[ii] = writer.output();
+    }
+    report += results[ii];
+    report += ii + 1 < files.size() ? ",\n" : "\n";
+  }
+  report += "]}";
+
+  FILE* output = options.stats_path ? fopen(options.stats_path, "w") : stdout;
+  if (!output) {
+    fprintf(stderr, "Can't write %s\n", options.stats_path);
+    return 1;
+  }
+  fprintf(output, "%s\n", report.c_str());
+  if (output != stdout) fclose(output);
+  fprintf(stderr, "%u models, %d failed\n",
+          static_cast<unsigned>(files.size()), failures);
+  return failures ? 2 : 0;
+}
+
+/* vim: set sw=2 ts=2 sts=2 expandtab ff=unix: */